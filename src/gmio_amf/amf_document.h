@@ -319,7 +319,11 @@ struct gmio_amf_document {
             uint32_t metadata_index,
             struct gmio_amf_metadata* ptr_metadata);
 
-    /*! Function that retrieves the i-th \c triangle within a mesh \c volume */
+    /*! Function that retrieves the i-th \c triangle within a mesh \c volume
+     *
+     *  Function not required(can be set to \c NULL) if
+     *  func_get_object_mesh_volume_triangles() is provided and never reports
+     *  triangles with attributes */
     void (*func_get_object_mesh_volume_triangle)(
             const void* cookie,
             const struct gmio_amf_object_mesh_element_index* volume_index,
@@ -347,6 +351,59 @@ struct gmio_amf_document {
             uint32_t constellation_index,
             uint32_t instance_index,
             struct gmio_amf_instance* ptr_instance);
+
+    /*! Optional function that retrieves in bulk the coordinates of the
+     *  vertices <tt>[first_vertex_index .. first_vertex_index + count[</tt>
+     *  of a \c mesh element
+     *
+     *  \p coords is an array of \p count items to be filled.\n
+     *  If not \c NULL then it is used instead of func_get_object_mesh_element()
+     *  for vertices. This avoids the overhead of one call and one
+     *  gmio_amf_vertex per vertex.
+     *
+     *  Returns \c true if none of the \p count vertices has attributes(color,
+     *  normal or metadata). Otherwise \p coords is ignored and the vertices
+     *  are retrieved again with func_get_object_mesh_element(), so attributes
+     *  are written */
+    bool (*func_get_object_mesh_vertices)(
+            const void* cookie,
+            const struct gmio_amf_object_mesh_element_index* mesh_index,
+            uint32_t first_vertex_index,
+            uint32_t count,
+            struct gmio_vec3d* coords);
+
+    /*! Optional function that retrieves in bulk the triangles
+     *  <tt>[first_triangle_index .. first_triangle_index + count[</tt> of a
+     *  mesh \c volume
+     *
+     *  \p vertex_ids is an array of <tt>3 * count</tt> items to be filled with
+     *  the v1, v2, v3 vertex indexes of each triangle.\n
+     *  If not \c NULL then it is used instead of
+     *  func_get_object_mesh_volume_triangle().
+     *
+     *  Returns \c true if none of the \p count triangles has attributes(color
+     *  or texmap). Otherwise \p vertex_ids is ignored and the triangles are
+     *  retrieved again with func_get_object_mesh_volume_triangle(), which
+     *  then must not be \c NULL */
+    bool (*func_get_object_mesh_volume_triangles)(
+            const void* cookie,
+            const struct gmio_amf_object_mesh_element_index* volume_index,
+            uint32_t first_triangle_index,
+            uint32_t count,
+            uint32_t* vertex_ids);
+
+    /*! Optional function that returns the total count of elements to be
+     *  written, used as the maximum value of the task progress
+     *
+     *  This is the sum of the document metadata, materials and textures counts
+     *  plus the vertex, edge and triangle counts of all meshes and the
+     *  instance counts of all constellations.
+     *
+     *  If \c NULL then the maximum value of the task progress is refined while
+     *  the document is written : it grows as meshes, volumes and
+     *  constellations are reached, so the document is never traversed just to
+     *  count its elements */
+    intmax_t (*func_get_total_element_count)(const void* cookie);
 };
 
 /*! @} */
@@ -0,0 +1,148 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+/*! \file amf_document_creator.h
+ *  Declaration of gmio_amf_document_creator
+ *
+ *  \addtogroup gmio_amf
+ *  @{
+ */
+
+#pragma once
+
+#include "amf_global.h"
+#include "amf_document.h"
+
+#include <stddef.h>
+
+/*! Provides an interface for the creation of the underlying(hidden) user AMF
+ *  document, this is the reading counterpart of gmio_amf_document
+ *
+ *  Elements are handed over as soon as they are parsed, so counts fields(eg
+ *  gmio_amf_object::mesh_count) are not known and left to zero. Mesh vertices
+ *  and volume triangles are handed over by batches of consecutive elements.
+ *
+ *  All pointer arguments are owned by the reader and are valid only during the
+ *  call.
+ *
+ *  \note Colors of objects, volumes, vertices and triangles, vertex normals,
+ *        edges, texture maps, textures and formulas are not read
+ */
+struct gmio_amf_document_creator
+{
+    /*! Opaque pointer on the user AMF document, passed as first argument to
+     *  hook functions */
+    void* cookie;
+
+    /* All function pointers are optional (ie can be set to NULL) */
+
+    /*! Optional function that handles the beginning of the document, ie the
+     *  <tt><amf></tt> element */
+    void (*func_begin_document)(void* cookie, enum gmio_amf_unit unit);
+
+    /*! Optional function that adds the i-th document sub-element
+     *
+     *  \p element_index is the index of the sub-element within the elements of
+     *  the same type.\n
+     *  The type of \p ptr_element depends on \p element :
+     *   Element type | gmio type              | Call time
+     *  --------------|------------------------|--------------------------------
+     *  OBJECT        | gmio_amf_object        | <tt><object></tt> start tag
+     *  MATERIAL      | gmio_amf_material      | <tt></material></tt> end tag
+     *  CONSTELLATION | gmio_amf_constellation | <tt><constellation></tt> start tag
+     *  METADATA      | gmio_amf_metadata      | <tt></metadata></tt> end tag
+     */
+    void (*func_add_document_element)(
+            void* cookie,
+            enum gmio_amf_document_element element,
+            uint32_t element_index,
+            const void* ptr_element);
+
+    /*! Optional function that adds the i-th metadata attached to a document
+     *  sub-element(only MATERIAL, OBJECT or CONSTELLATION) */
+    void (*func_add_document_element_metadata)(
+            void* cookie,
+            enum gmio_amf_document_element element,
+            uint32_t element_index,
+            uint32_t metadata_index,
+            const struct gmio_amf_metadata* metadata);
+
+    /*! Optional function that handles the beginning of the i-th \c mesh within
+     *  an \c object element */
+    void (*func_begin_object_mesh)(
+            void* cookie, uint32_t object_index, uint32_t mesh_index);
+
+    /*! Optional function that adds a batch of consecutive vertices to a mesh
+     *
+     *  \p first_vertex_index identifies the mesh and the index of the first
+     *  vertex of the batch. \p coords points to an array of \p count vertex
+     *  coordinates */
+    void (*func_add_object_mesh_vertices)(
+            void* cookie,
+            const struct gmio_amf_object_mesh_element_index* first_vertex_index,
+            const struct gmio_vec3d* coords,
+            uint32_t count);
+
+    /*! Optional function that adds a \c volume to a mesh
+     *
+     *  Only gmio_amf_volume::materialid and gmio_amf_volume::type are set */
+    void (*func_add_object_mesh_volume)(
+            void* cookie,
+            const struct gmio_amf_object_mesh_element_index* volume_index,
+            const struct gmio_amf_volume* volume);
+
+    /*! Optional function that adds a batch of consecutive triangles to a mesh
+     *  \c volume
+     *
+     *  \p first_triangle_index is the index of the first triangle of the batch
+     *  within the volume. \p vertex_ids points to an array of <tt>3*count</tt>
+     *  indexes, ie <tt>v1 v2 v3</tt> of each triangle */
+    void (*func_add_object_mesh_volume_triangles)(
+            void* cookie,
+            const struct gmio_amf_object_mesh_element_index* volume_index,
+            uint32_t first_triangle_index,
+            const uint32_t* vertex_ids,
+            uint32_t count);
+
+    /*! Optional function that adds the i-th \c instance within a
+     *  \c constellation element */
+    void (*func_add_constellation_instance)(
+            void* cookie,
+            uint32_t constellation_index,
+            uint32_t instance_index,
+            const struct gmio_amf_instance* instance);
+
+    /*! Optional function that finalizes creation of the user document
+     *
+     *  The function is called at the end of the read process, ie. after the
+     *  <tt></amf></tt> end tag */
+    void (*func_end_document)(void* cookie);
+};
+
+/*! @} */
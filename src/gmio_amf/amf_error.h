@@ -62,7 +62,8 @@ enum gmio_amf_error
     GMIO_AMF_ERROR_NULL_FUNC_GET_OBJECT_MESH_ELEMENT,
 
     /*! Function pointer gmio_amf_document::func_get_object_mesh_volume_triangle
-     *  is \c NULL */
+     *  is \c NULL while gmio_amf_document::func_get_object_mesh_volume_triangles
+     *  is also \c NULL or reports triangles with attributes */
     GMIO_AMF_ERROR_NULL_FUNC_GET_OBJECT_MESH_VOLUME_TRIANGLE,
 
     /*! Function pointer gmio_amf_document::func_get_document_element_metadata
@@ -75,7 +76,21 @@ enum gmio_amf_error
 
     /*! Function pointer gmio_amf_document::func_get_object_mesh_element_metadata
      *  is \c NULL while some metadata is attached to a mesh element */
-    GMIO_AMF_ERROR_NULL_FUNC_GET_OBJECT_MESH_ELEMENT_METADATA
+    GMIO_AMF_ERROR_NULL_FUNC_GET_OBJECT_MESH_ELEMENT_METADATA,
+
+    /*! The XML contents are malformed(eg. unbalanced tags, unexpected end of
+     *  stream) or the root element is not <tt><amf></tt> */
+    GMIO_AMF_ERROR_XML_SYNTAX,
+
+    /*! Some XML tag is too long to fit in gmio_amf_read_options::stream_memblock */
+    GMIO_AMF_ERROR_XML_TOKEN_TOO_LONG,
+
+    /*! The ZIP archive entry cannot be read : it is encrypted or its
+     *  compression method is neither "deflate" nor "no compression" */
+    GMIO_AMF_ERROR_ZIP_UNSUPPORTED_ENTRY,
+
+    /*! CRC-32 of the uncompressed ZIP entry does not match the archive */
+    GMIO_AMF_ERROR_ZIP_CRC32_MISMATCH
 };
 
 /*! @} */
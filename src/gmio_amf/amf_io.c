@@ -37,13 +37,29 @@
 #include "../gmio_core/internal/helper_memblock.h"
 #include "../gmio_core/internal/helper_stream.h"
 #include "../gmio_core/internal/helper_task_iface.h"
+#include "../gmio_core/internal/min_max.h"
 #include "../gmio_core/internal/ostringstream.h"
+#include "../gmio_core/internal/thread.h"
 #include "../gmio_core/internal/zip_utils.h"
+#include "../gmio_core/internal/zlib_pdeflate.h"
 #include "../gmio_core/internal/zlib_utils.h"
 
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 #include <zlib.h>
 
+enum {
+    /* Count of mesh elements formatted by a job */
+    GMIO_AMF_FORMAT_CHUNK_SIZE = 16 * 1024,
+    /* Size of the ostringstream buffer of a format job */
+    GMIO_AMF_FORMAT_BUFFER_SIZE = 16 * 1024, /* 16KB */
+    /* Count of mesh elements retrieved by a bulk document callback */
+    GMIO_AMF_WRITE_BATCH_SIZE = 256
+};
+
+struct gmio_amf_format_job;
+
 /* Writing(output) context */
 struct gmio_amf_wcontext
 {
@@ -53,6 +69,7 @@ struct gmio_amf_wcontext
     const struct gmio_task_iface* task_iface;
     intmax_t task_progress_current;
     intmax_t task_progress_max;
+    bool task_progress_max_refine;
     struct gmio_ostringstream_format_float f64_format;
     int error;
 
@@ -63,6 +80,11 @@ struct gmio_amf_wcontext
     uintmax_t z_compressed_size;
     uintmax_t z_uncompressed_size;
     uint32_t z_crc32;
+    struct gmio_zlib_pdeflate* z_pdeflate; /* Non-null if parallel deflate */
+
+    /* Jobs formatting mesh elements concurrently */
+    struct gmio_amf_format_job* format_jobs;
+    unsigned format_job_count;
 };
 
 /* Helper to set error code of the writing context */
@@ -80,6 +102,15 @@ GMIO_INLINE void gmio_amf_wcontext_incr_task_progress(
     ++(context->task_progress_current);
 }
 
+/* Helper to add \p count elements to the maximum of the task progress, unless
+ * it was given upfront */
+GMIO_INLINE void gmio_amf_wcontext_add_task_progress_max(
+        struct gmio_amf_wcontext* context, uint32_t count)
+{
+    if (context->task_progress_max_refine)
+        context->task_progress_max += count;
+}
+
 /* Writes double value or its formula (if any) to stream */
 static void gmio_amf_write_double(
         struct gmio_amf_wcontext* context,
@@ -294,11 +325,13 @@ static bool gmio_amf_write_mesh_object_element_metadata(
     return gmio_no_error(context->error);
 }
 
-/* Writes gmio_amf_mesh to stream */
-static bool gmio_amf_write_mesh(
+/* Writes mesh <vertex> elements [first, first + count[ to stream, retrieved
+ * one by one with gmio_amf_document::func_get_object_mesh_element() */
+static bool gmio_amf_write_mesh_vertices_each(
         struct gmio_amf_wcontext* context,
-        const struct gmio_amf_mesh* mesh,
-        const struct gmio_amf_object_mesh_element_index* base_mesh_element_index)
+        const struct gmio_amf_object_mesh_element_index* base_mesh_element_index,
+        uint32_t first,
+        uint32_t count)
 {
     const struct gmio_amf_document* doc = context->document;
     struct gmio_ostringstream* sstream = &context->sstream;
@@ -306,11 +339,9 @@ static bool gmio_amf_write_mesh(
             *base_mesh_element_index;
     const struct gmio_ostringstream_format_float* f64_format =
             &context->f64_format;
-    /* Write mesh <vertices> element */
     mesh_elt_index.element_type = GMIO_AMF_MESH_ELEMENT_VERTEX;
     struct gmio_amf_vertex vertex = {0};
-    gmio_ostringstream_write_chararray(sstream, "<mesh>\n<vertices>\n");
-    for (uint32_t ivert = 0; ivert < mesh->vertex_count; ++ivert) {
+    for (uint32_t ivert = first; ivert < first + count; ++ivert) {
         mesh_elt_index.value = ivert;
         doc->func_get_object_mesh_element(
                     doc->cookie, &mesh_elt_index, &vertex);
@@ -348,6 +379,293 @@ static bool gmio_amf_write_mesh(
         if (gmio_error(context->error))
             return false;
     }
+    return gmio_no_error(context->error);
+}
+
+/* Writes mesh <vertex> elements [first, first + count[ to stream
+ *
+ * Vertices are retrieved in bulk when possible, a batch reported with
+ * attributes is written again from the per-element callbacks */
+static bool gmio_amf_write_mesh_vertices(
+        struct gmio_amf_wcontext* context,
+        const struct gmio_amf_object_mesh_element_index* base_mesh_element_index,
+        uint32_t first,
+        uint32_t count)
+{
+    const struct gmio_amf_document* doc = context->document;
+    if (doc->func_get_object_mesh_vertices == NULL) {
+        return gmio_amf_write_mesh_vertices_each(
+                    context, base_mesh_element_index, first, count);
+    }
+    struct gmio_ostringstream* sstream = &context->sstream;
+    struct gmio_amf_object_mesh_element_index mesh_elt_index =
+            *base_mesh_element_index;
+    const struct gmio_ostringstream_format_float* f64_format =
+            &context->f64_format;
+    struct gmio_vec3d coords[GMIO_AMF_WRITE_BATCH_SIZE];
+    mesh_elt_index.element_type = GMIO_AMF_MESH_ELEMENT_VERTEX;
+    for (uint32_t ivert = first; ivert < first + count; ) {
+        const uint32_t batch_count =
+                GMIO_MIN(first + count - ivert, GMIO_AMF_WRITE_BATCH_SIZE);
+        const bool batch_bare =
+                doc->func_get_object_mesh_vertices(
+                    doc->cookie, &mesh_elt_index, ivert, batch_count, coords);
+        if (batch_bare) {
+            for (uint32_t i = 0; i < batch_count; ++i) {
+                gmio_ostringstream_write_chararray(
+                            sstream, "<vertex><coordinates><x>");
+                gmio_ostringstream_write_f64(sstream, coords[i].x, f64_format);
+                gmio_ostringstream_write_chararray(sstream, "</x><y>");
+                gmio_ostringstream_write_f64(sstream, coords[i].y, f64_format);
+                gmio_ostringstream_write_chararray(sstream, "</y><z>");
+                gmio_ostringstream_write_f64(sstream, coords[i].z, f64_format);
+                gmio_ostringstream_write_chararray(
+                            sstream, "</z></coordinates></vertex>\n");
+            }
+            context->task_progress_current += batch_count;
+        }
+        else {
+            gmio_amf_write_mesh_vertices_each(
+                        context, base_mesh_element_index, ivert, batch_count);
+        }
+        ivert += batch_count;
+        if (gmio_error(context->error))
+            return false;
+    }
+    return gmio_no_error(context->error);
+}
+
+/* Writes <triangle> elements [first, first + count[ of a mesh volume to
+ * stream, retrieved one by one with
+ * gmio_amf_document::func_get_object_mesh_volume_triangle() */
+static bool gmio_amf_write_mesh_volume_triangles_each(
+        struct gmio_amf_wcontext* context,
+        const struct gmio_amf_object_mesh_element_index* volume_index,
+        uint32_t first,
+        uint32_t count)
+{
+    const struct gmio_amf_document* doc = context->document;
+    struct gmio_ostringstream* sstream = &context->sstream;
+    if (doc->func_get_object_mesh_volume_triangle == NULL) {
+        return gmio_amf_wcontext_set_error(
+                    context,
+                    GMIO_AMF_ERROR_NULL_FUNC_GET_OBJECT_MESH_VOLUME_TRIANGLE);
+    }
+    struct gmio_amf_triangle triangle = {0};
+    for (uint32_t itri = first; itri < first + count; ++itri) {
+        doc->func_get_object_mesh_volume_triangle(
+                    doc->cookie, volume_index, itri, &triangle);
+        gmio_ostringstream_write_chararray(sstream, "<triangle>");
+        /* Write triangle <color> element */
+        if (triangle.has_color)
+            gmio_amf_write_color(context, &triangle.color);
+        /* Write triangle <v1> <v2> <v3> elements */
+        gmio_ostringstream_write_chararray(sstream, "<v1>");
+        gmio_ostringstream_write_u32(sstream, triangle.v1);
+        gmio_ostringstream_write_chararray(sstream, "</v1><v2>");
+        gmio_ostringstream_write_u32(sstream, triangle.v2);
+        gmio_ostringstream_write_chararray(sstream, "</v2><v3>");
+        gmio_ostringstream_write_u32(sstream, triangle.v3);
+        gmio_ostringstream_write_chararray(sstream, "</v3>");
+        /* Write triangle <texmap> element */
+        if (triangle.has_texmap)
+            gmio_amf_write_texmap(sstream, &triangle.texmap);
+        gmio_ostringstream_write_chararray(sstream, "</triangle>\n");
+        gmio_amf_wcontext_incr_task_progress(context);
+        if (gmio_error(context->error))
+            return false;
+    }
+    return gmio_no_error(context->error);
+}
+
+/* Writes <triangle> elements [first, first + count[ of a mesh volume to
+ * stream
+ *
+ * Triangles are retrieved in bulk when possible, a batch reported with
+ * attributes is written again from the per-element callback */
+static bool gmio_amf_write_mesh_volume_triangles(
+        struct gmio_amf_wcontext* context,
+        const struct gmio_amf_object_mesh_element_index* volume_index,
+        uint32_t first,
+        uint32_t count)
+{
+    const struct gmio_amf_document* doc = context->document;
+    if (doc->func_get_object_mesh_volume_triangles == NULL) {
+        return gmio_amf_write_mesh_volume_triangles_each(
+                    context, volume_index, first, count);
+    }
+    struct gmio_ostringstream* sstream = &context->sstream;
+    uint32_t vertex_ids[3 * GMIO_AMF_WRITE_BATCH_SIZE];
+    for (uint32_t itri = first; itri < first + count; ) {
+        const uint32_t batch_count =
+                GMIO_MIN(first + count - itri, GMIO_AMF_WRITE_BATCH_SIZE);
+        const bool batch_bare =
+                doc->func_get_object_mesh_volume_triangles(
+                    doc->cookie, volume_index, itri, batch_count, vertex_ids);
+        if (batch_bare) {
+            for (uint32_t i = 0; i < batch_count; ++i) {
+                const uint32_t* tri_ids = vertex_ids + 3 * i;
+                gmio_ostringstream_write_chararray(sstream, "<triangle><v1>");
+                gmio_ostringstream_write_u32(sstream, tri_ids[0]);
+                gmio_ostringstream_write_chararray(sstream, "</v1><v2>");
+                gmio_ostringstream_write_u32(sstream, tri_ids[1]);
+                gmio_ostringstream_write_chararray(sstream, "</v2><v3>");
+                gmio_ostringstream_write_u32(sstream, tri_ids[2]);
+                gmio_ostringstream_write_chararray(
+                            sstream, "</v3></triangle>\n");
+            }
+            context->task_progress_current += batch_count;
+        }
+        else {
+            gmio_amf_write_mesh_volume_triangles_each(
+                        context, volume_index, itri, batch_count);
+        }
+        itri += batch_count;
+        if (gmio_error(context->error))
+            return false;
+    }
+    return gmio_no_error(context->error);
+}
+
+/* Function writing mesh elements [first, first + count[ to stream */
+typedef bool (*gmio_amf_write_mesh_range_func_t)(
+        struct gmio_amf_wcontext* context,
+        const struct gmio_amf_object_mesh_element_index* index,
+        uint32_t first,
+        uint32_t count);
+
+/* Range of mesh elements formatted in its own thread */
+struct gmio_amf_format_job
+{
+    /* Copy of the writing context, its ostringstream appending to text */
+    struct gmio_amf_wcontext context;
+    char* sstream_buff;
+    gmio_amf_write_mesh_range_func_t func_write;
+    struct gmio_amf_object_mesh_element_index index;
+    uint32_t first;
+    uint32_t count;
+    char* text;
+    size_t text_len;
+    size_t text_capacity;
+    struct gmio_thread* thread;
+};
+
+/* Function called through gmio_ostringstream::func_stream_write of a format
+ * job, appends to gmio_amf_format_job::text */
+static size_t gmio_amf_format_job_append(
+        void* cookie, struct gmio_stream* stream, const char* ptr, size_t len)
+{
+    struct gmio_amf_format_job* job = (struct gmio_amf_format_job*)cookie;
+    GMIO_UNUSED(stream);
+    if (job->text_len + len > job->text_capacity) {
+        const size_t capacity = GMIO_MAX(2 * job->text_capacity, job->text_len + len);
+        char* text = realloc(job->text, capacity);
+        if (text == NULL) {
+            job->context.error = GMIO_ERROR_MEMORY_ALLOC;
+            return 0;
+        }
+        job->text = text;
+        job->text_capacity = capacity;
+    }
+    memcpy(job->text + job->text_len, ptr, len);
+    job->text_len += len;
+    return len;
+}
+
+/* Formats the mesh elements of a job */
+static void gmio_amf_format_job_run(void* arg)
+{
+    struct gmio_amf_format_job* job = (struct gmio_amf_format_job*)arg;
+    job->func_write(&job->context, &job->index, job->first, job->count);
+    gmio_ostringstream_flush(&job->context.sstream);
+}
+
+/* Writes mesh elements [0, count[ to stream, formatting ranges of elements
+ * concurrently if enabled(see gmio_amf_write_options::format_thread_count) */
+static bool gmio_amf_write_mesh_range(
+        struct gmio_amf_wcontext* context,
+        gmio_amf_write_mesh_range_func_t func_write,
+        const struct gmio_amf_object_mesh_element_index* index,
+        uint32_t count)
+{
+    uint32_t first = 0;
+    if (context->format_job_count < 2 || count < 2 * GMIO_AMF_FORMAT_CHUNK_SIZE)
+        return func_write(context, index, 0, count);
+
+    while (first < count && gmio_no_error(context->error)) {
+        unsigned job_count = 0;
+        /* Split next elements into chunks, the calling thread takes the first
+         * one and any chunk whose thread could not be started */
+        while (job_count < context->format_job_count && first < count) {
+            struct gmio_amf_format_job* job = &context->format_jobs[job_count];
+            job->context = *context;
+            job->context.sstream =
+                    gmio_ostringstream(
+                        gmio_stream_null(),
+                        gmio_string(
+                            job->sstream_buff, 0, GMIO_AMF_FORMAT_BUFFER_SIZE));
+            job->context.sstream.cookie = job;
+            job->context.sstream.func_stream_write = gmio_amf_format_job_append;
+            job->context.task_progress_current = 0;
+            job->context.format_job_count = 0;
+            job->func_write = func_write;
+            job->index = *index;
+            job->first = first;
+            job->count = GMIO_MIN(count - first, GMIO_AMF_FORMAT_CHUNK_SIZE);
+            job->text_len = 0;
+            job->thread =
+                    job_count > 0 ?
+                        gmio_thread_create(gmio_amf_format_job_run, job) :
+                        NULL;
+            first += job->count;
+            ++job_count;
+        }
+        /* Stitch formatted texts in document order */
+        for (unsigned i = 0; i < job_count; ++i) {
+            struct gmio_amf_format_job* job = &context->format_jobs[i];
+            if (job->thread != NULL) {
+                gmio_thread_join(job->thread);
+                job->thread = NULL;
+            }
+            else if (gmio_no_error(context->error)) {
+                gmio_amf_format_job_run(job);
+            }
+            if (gmio_error(context->error))
+                continue;
+            if (gmio_error(job->context.error)) {
+                context->error = job->context.error;
+                continue;
+            }
+            context->task_progress_current += job->context.task_progress_current;
+            gmio_ostringstream_write_nstr(
+                        &context->sstream, job->text, job->text_len);
+        }
+    }
+    return gmio_no_error(context->error);
+}
+
+/* Writes gmio_amf_mesh to stream */
+static bool gmio_amf_write_mesh(
+        struct gmio_amf_wcontext* context,
+        const struct gmio_amf_mesh* mesh,
+        const struct gmio_amf_object_mesh_element_index* base_mesh_element_index)
+{
+    const struct gmio_amf_document* doc = context->document;
+    struct gmio_ostringstream* sstream = &context->sstream;
+    struct gmio_amf_object_mesh_element_index mesh_elt_index =
+            *base_mesh_element_index;
+    const struct gmio_ostringstream_format_float* f64_format =
+            &context->f64_format;
+    /* Write mesh <vertices> element */
+    gmio_ostringstream_write_chararray(sstream, "<mesh>\n<vertices>\n");
+    if (!gmio_amf_write_mesh_range(
+                context,
+                gmio_amf_write_mesh_vertices,
+                base_mesh_element_index,
+                mesh->vertex_count))
+    {
+        return false;
+    }
     /* Write mesh vertices <edge> elements */
     if (mesh->edge_count > 0) {
         mesh_elt_index.element_type = GMIO_AMF_MESH_ELEMENT_EDGE;
@@ -387,6 +705,8 @@ static bool gmio_amf_write_mesh(
             mesh_elt_index.value = ivol;
             doc->func_get_object_mesh_element(
                         doc->cookie, &mesh_elt_index, &volume);
+            gmio_amf_wcontext_add_task_progress_max(
+                        context, volume.triangle_count);
             /* Write <volume ...> element begin */
             gmio_ostringstream_write_chararray(sstream, "<volume");
             gmio_ostringstream_write_xmlattr_u32(
@@ -411,31 +731,13 @@ static bool gmio_amf_write_mesh(
             if (volume.has_color)
                 gmio_amf_write_color(context, &volume.color);
             /* Write <triangle> elements */
-            if (volume.triangle_count > 0) {
-                struct gmio_amf_triangle triangle = {0};
-                for (uint32_t itri = 0; itri < volume.triangle_count; ++itri) {
-                    doc->func_get_object_mesh_volume_triangle(
-                                doc->cookie, &mesh_elt_index, itri, &triangle);
-                    gmio_ostringstream_write_chararray(sstream, "<triangle>");
-                    /* Write triangle <color> element */
-                    if (triangle.has_color)
-                        gmio_amf_write_color(context, &triangle.color);
-                    /* Write triangle <v1> <v2> <v3> elements */
-                    gmio_ostringstream_write_chararray(sstream, "<v1>");
-                    gmio_ostringstream_write_u32(sstream, triangle.v1);
-                    gmio_ostringstream_write_chararray(sstream, "</v1><v2>");
-                    gmio_ostringstream_write_u32(sstream, triangle.v2);
-                    gmio_ostringstream_write_chararray(sstream, "</v2><v3>");
-                    gmio_ostringstream_write_u32(sstream, triangle.v3);
-                    gmio_ostringstream_write_chararray(sstream, "</v3>");
-                    /* Write triangle <texmap> element */
-                    if (triangle.has_texmap)
-                        gmio_amf_write_texmap(sstream, &triangle.texmap);
-                    gmio_ostringstream_write_chararray(sstream, "</triangle>\n");
-                    gmio_amf_wcontext_incr_task_progress(context);
-                    if (gmio_error(context->error))
-                        return false;
-                }
+            if (!gmio_amf_write_mesh_range(
+                        context,
+                        gmio_amf_write_mesh_volume_triangles,
+                        &mesh_elt_index,
+                        volume.triangle_count))
+            {
+                return false;
             }
             gmio_ostringstream_write_chararray(sstream, "</volume>\n");
         }
@@ -484,6 +786,10 @@ static bool gmio_amf_write_root_objects(struct gmio_amf_wcontext* context)
             struct gmio_amf_mesh mesh = {0};
             for (uint32_t imesh = 0; imesh < object.mesh_count; ++imesh) {
                 doc->func_get_object_mesh(doc->cookie, iobj, imesh, &mesh);
+                gmio_amf_wcontext_add_task_progress_max(
+                            context, mesh.vertex_count);
+                gmio_amf_wcontext_add_task_progress_max(
+                            context, mesh.edge_count);
                 struct gmio_amf_object_mesh_element_index base_mesh_elt_index;
                 base_mesh_elt_index.object_index = iobj;
                 base_mesh_elt_index.mesh_index = imesh;
@@ -545,6 +851,8 @@ static bool gmio_amf_write_root_constellations(struct gmio_amf_wcontext* context
         doc->func_get_document_element(
                     doc->cookie,
                     GMIO_AMF_DOCUMENT_ELEMENT_CONSTELLATION, icons, &constellation);
+        gmio_amf_wcontext_add_task_progress_max(
+                    context, constellation.instance_count);
         gmio_ostringstream_write_chararray(sstream, "<constellation");
         gmio_ostringstream_write_xmlattr_u32(sstream, "id", constellation.id);
         gmio_ostringstream_write_chararray(sstream, ">\n");
@@ -620,7 +928,9 @@ static bool gmio_amf_check_document(
     else if (doc->func_get_object_mesh_element == NULL) {
         *error = GMIO_AMF_ERROR_NULL_FUNC_GET_OBJECT_MESH_ELEMENT;
     }
-    else if (doc->func_get_object_mesh_volume_triangle == NULL) {
+    else if (doc->func_get_object_mesh_volume_triangle == NULL
+             && doc->func_get_object_mesh_volume_triangles == NULL)
+    {
         *error = GMIO_AMF_ERROR_NULL_FUNC_GET_OBJECT_MESH_VOLUME_TRIANGLE;
     }
     return gmio_no_error(*error);
@@ -640,6 +950,21 @@ static size_t gmio_amf_ostringstream_write_zlib(
     int z_retcode = Z_OK;
 
     context->z_uncompressed_size += len;
+    if (context->z_pdeflate != NULL) {
+        const bool finish = context->z_flush == Z_FINISH;
+        total_written_len =
+                gmio_zlib_pdeflate_write(
+                    context->z_pdeflate,
+                    stream,
+                    ptr_u8,
+                    len,
+                    finish,
+                    &context->error);
+        if (finish)
+            context->z_crc32 = gmio_zlib_pdeflate_crc32(context->z_pdeflate);
+        context->z_compressed_size += total_written_len;
+        return total_written_len;
+    }
     context->z_crc32 = gmio_zlib_crc32_update(context->z_crc32, ptr_u8, len);
 
     gmio_zlib_assign_zstream_in(z_stream, ptr_u8, len);
@@ -749,51 +1074,6 @@ static size_t gmio_amf_ostringstream_write(
     return len_written;
 }
 
-/* Returns computation upper limit of the task progress */
-static intmax_t gmio_amf_task_progress_max(const struct gmio_amf_document* doc)
-{
-    intmax_t progress_max = 0;
-    progress_max += doc->metadata_count;
-    progress_max += doc->material_count;
-    progress_max += doc->texture_count;
-    /* Add total object(vertex_count + edge_count + triangle_count) */
-    struct gmio_amf_object object = {0};
-    for (uint32_t iobj = 0; iobj < doc->object_count; ++iobj) {
-        doc->func_get_document_element(
-                    doc->cookie,
-                    GMIO_AMF_DOCUMENT_ELEMENT_OBJECT, iobj, &object);
-        struct gmio_amf_mesh mesh = {0};
-        for (uint32_t imesh = 0; imesh < object.mesh_count; ++imesh) {
-            doc->func_get_object_mesh(doc->cookie, iobj, imesh, &mesh);
-            progress_max += mesh.vertex_count;
-            progress_max += mesh.edge_count;
-            struct gmio_amf_object_mesh_element_index mesh_elt_index;
-            mesh_elt_index.element_type = GMIO_AMF_MESH_ELEMENT_VOLUME;
-            mesh_elt_index.object_index = iobj;
-            mesh_elt_index.mesh_index = imesh;
-            mesh_elt_index.value = 0;
-            for (uint32_t ivol = 0; ivol < mesh.volume_count; ++ivol) {
-                struct gmio_amf_volume volume = {0};
-                mesh_elt_index.value = ivol;
-                doc->func_get_object_mesh_element(
-                            doc->cookie, &mesh_elt_index, &volume);
-                progress_max += volume.triangle_count;
-            }
-        }
-    }
-    /* Add total constellation(instance_count) */
-    struct gmio_amf_constellation constellation = {0};
-    for (uint32_t icons = 0; icons < doc->constellation_count; ++icons) {
-        doc->func_get_document_element(
-                    doc->cookie,
-                    GMIO_AMF_DOCUMENT_ELEMENT_CONSTELLATION,
-                    icons,
-                    &constellation);
-        progress_max += constellation.instance_count;
-    }
-    return progress_max;
-}
-
 struct gmio_zip_entry_filename {
     const char* ptr;
     uint16_t len;
@@ -815,6 +1095,41 @@ static struct gmio_zip_entry_filename gmio_amf_zip_entry_filename(
     return zip_filename;
 }
 
+/* Allocates the jobs formatting mesh elements concurrently, does nothing if
+ * \p thread_count < 2 or threads are not supported */
+static bool gmio_amf_wcontext_create_format_jobs(
+        struct gmio_amf_wcontext* context, unsigned thread_count)
+{
+#ifndef GMIO_HAVE_THREADS
+    thread_count = 1;
+#endif
+    if (thread_count < 2)
+        return true;
+    context->format_jobs =
+            calloc(thread_count, sizeof(struct gmio_amf_format_job));
+    if (context->format_jobs == NULL)
+        return gmio_amf_wcontext_set_error(context, GMIO_ERROR_MEMORY_ALLOC);
+    context->format_job_count = thread_count;
+    for (unsigned i = 0; i < thread_count; ++i) {
+        struct gmio_amf_format_job* job = &context->format_jobs[i];
+        job->sstream_buff = malloc(GMIO_AMF_FORMAT_BUFFER_SIZE);
+        if (job->sstream_buff == NULL)
+            return gmio_amf_wcontext_set_error(context, GMIO_ERROR_MEMORY_ALLOC);
+    }
+    return true;
+}
+
+/* Releases the jobs formatting mesh elements concurrently */
+static void gmio_amf_wcontext_release_format_jobs(
+        struct gmio_amf_wcontext* context)
+{
+    for (unsigned i = 0; i < context->format_job_count; ++i) {
+        free(context->format_jobs[i].sstream_buff);
+        free(context->format_jobs[i].text);
+    }
+    free(context->format_jobs);
+}
+
 /* Writes AMF file data, plain text or compressed(ZIP)
  * This function satisfies the signature required by gmio_zip_write_single_file()
  */
@@ -882,13 +1197,27 @@ int gmio_amf_write(
     context.document = doc;
     context.task_iface = &opts->task_iface;
     context.task_progress_current = 0;
-    if (context.task_iface->func_handle_progress != NULL)
-        context.task_progress_max += gmio_amf_task_progress_max(doc);
+    if (context.task_iface->func_handle_progress != NULL) {
+        if (doc->func_get_total_element_count != NULL) {
+            context.task_progress_max =
+                    doc->func_get_total_element_count(doc->cookie);
+        }
+        else {
+            context.task_progress_max_refine = true;
+            context.task_progress_max =
+                    (intmax_t)doc->metadata_count
+                    + doc->material_count
+                    + doc->texture_count;
+        }
+    }
     context.f64_format.printf_format = f64_stdio_format.array;
     context.f64_format.text_format = opts->float64_format;
     context.f64_format.precision =
             opts->float64_prec != 0 ? opts->float64_prec : 16;
 
+    if (!gmio_amf_wcontext_create_format_jobs(&context, opts->format_thread_count))
+        goto label_end;
+
     if (opts->create_zip_archive) {
         /* Initialize internal zlib stream for compression */
         const size_t mblock_halfsize = memblock->size / 2;
@@ -908,6 +1237,11 @@ int gmio_amf_write(
         if (gmio_error(context.error))
             goto label_end;
         context.z_flush = Z_NO_FLUSH;
+        if (opts->thread_count > 1) {
+            context.z_pdeflate =
+                    gmio_zlib_pdeflate_create(
+                        &opts->z_compress_options, opts->thread_count);
+        }
         /* Write ZIP file */
         struct gmio_zip_file_entry file_entry = {0};
         file_entry.compress_method = GMIO_ZIP_COMPRESS_METHOD_DEFLATE;
@@ -930,6 +1264,8 @@ int gmio_amf_write(
 label_end:
     if (opts->create_zip_archive)
         deflateEnd(&context.z_stream);
+    gmio_zlib_pdeflate_destroy(context.z_pdeflate);
+    gmio_amf_wcontext_release_format_jobs(&context);
     gmio_memblock_helper_release(&mblock_helper);
     return context.error;
 }
@@ -942,8 +1278,14 @@ int gmio_amf_write_file(
     const bool compress = opts != NULL ? opts->create_zip_archive : false;
     FILE* file = fopen(filepath, compress ? "wb" : "w");
     int error = GMIO_ERROR_OK;
+    struct gmio_stream wbstream = gmio_stream_null();
     if (file != NULL) {
         struct gmio_stream stream = gmio_stream_stdio(file);
+        if (opts != NULL && opts->use_file_writebehind) {
+            wbstream = gmio_stream_writebehind(&stream, 0, 0);
+            if (wbstream.cookie != NULL)
+                stream = wbstream;
+        }
         if (compress && opts->zip_entry_filename_len == 0) {
             /* opts->zip_entry_filename is empty then try to take the filename
              * part of filepath */
@@ -968,6 +1310,8 @@ int gmio_amf_write_file(
     }
 
 label_end:
+    if (gmio_stream_writebehind_close(&wbstream) != 0 && gmio_no_error(error))
+        error = GMIO_ERROR_STREAM;
     if (file != NULL)
         fclose(file);
     return error;
@@ -38,11 +38,60 @@
 
 #include "amf_global.h"
 #include "amf_document.h"
+#include "amf_document_creator.h"
 #include "amf_io_options.h"
 #include "../gmio_core/stream.h"
 
 GMIO_C_LINKAGE_BEGIN
 
+/*! Reads AMF document from stream
+ *
+ *  The input can be a plain XML AMF document or a ZIP archive whose first file
+ *  entry is the AMF document(as written by gmio_amf_write() with
+ *  gmio_amf_write_options::create_zip_archive). The ZIP entry can use the
+ *  Zip64 format extensions.
+ *
+ *  Contents are parsed on the fly, the document is never loaded in memory :
+ *  in case of ZIP archive the first half of the memory pointed to by
+ *  gmio_amf_read_options::stream_memblock holds compressed data and the second
+ *  half holds the inflated XML contents.
+ *
+ *  Elements of the document are handed over to \p creator as soon as they are
+ *  parsed, see gmio_amf_document_creator.
+ *
+ *  \pre <tt> stream != NULL </tt>
+ *
+ *  \p creator may be \c NULL, then contents are just checked
+ *
+ *  \p options may be \c NULL in this case default values are used
+ *
+ *  \return Error code (see gmio_core/error.h and amf_error.h)
+ *
+ *  \sa gmio_amf_read_file()
+ */
+GMIO_API int gmio_amf_read(
+                struct gmio_stream* stream,
+                const struct gmio_amf_document_creator* creator,
+                const struct gmio_amf_read_options* options);
+
+/*! Reads AMF document from a file
+ *
+ *  This is just a facility function over gmio_amf_read(). The internal stream
+ *  object is created to read file at \p filepath
+ *
+ *  \pre <tt> filepath != \c NULL </tt>\n
+ *       The file is opened with \c fopen() so \p filepath shall follow the file
+ *       name specifications of the running environment
+ *
+ *  \return Error code (see gmio_core/error.h and amf_error.h)
+ *
+ *  \sa gmio_amf_read(), gmio_stream_stdio(FILE*)
+ */
+GMIO_API int gmio_amf_read_file(
+                const char* filepath,
+                const struct gmio_amf_document_creator* creator,
+                const struct gmio_amf_read_options* options);
+
 /*! Writes AMF document to stream
  *
  *  When gmio_amf_write_options::create_zip_archive is \c ON then a compressed
@@ -42,6 +42,42 @@
 #include "../gmio_core/text_format.h"
 #include "../gmio_core/zlib_compress.h"
 
+/*! Options of function gmio_amf_read()
+ *
+ *  Initialising gmio_amf_read_options with \c {0} (or \c {} in C++) is the
+ *  convenient way to set default values(passing \c NULL to gmio_amf_read() has
+ *  the same effect).
+ */
+struct gmio_amf_read_options
+{
+    /*! Used by the stream to bufferize I/O operations
+     *
+     *  If null, then a temporary memblock is created with the global default
+     *  constructor function
+     *
+     *  It bounds the memory used by the reader whatever the size of the
+     *  document. It must be large enough to hold any XML tag.
+     *
+     *  \sa gmio_memblock_isnull()
+     *  \sa gmio_memblock_default() */
+    struct gmio_memblock stream_memblock;
+
+    /*! Optional interface by which the I/O operation can be controlled
+     *
+     *  Progress is the count of bytes read from the input stream, its maximum
+     *  is gmio_stream::func_size() */
+    struct gmio_task_iface task_iface;
+
+    /*! Flag allowing to disable checking of the current locale's numeric
+     *  formatting category
+     *
+     *  If \c false then \c LC_NUMERIC is checked to be "C" or "POSIX". If check
+     *  fails then the function returns \c GMIO_ERROR_BAD_LC_NUMERIC
+     *
+     *  \c LC_NUMERIC checking is enabled by default. */
+    bool dont_check_lc_numeric;
+};
+
 /*! Options of function gmio_amf_write()
  *
  *  Initialising gmio_amf_write_options with \c {0} (or \c {} in C++) is the
@@ -62,7 +98,12 @@ struct gmio_amf_write_options
 
     /*! The format used when writting double values as strings.
      *  Defaults to \c GMIO_FLOAT_TEXT_FORMAT_DECIMAL_LOWERCASE when calling
-     *  gmio_amf_write() with \c options==NULL */
+     *  gmio_amf_write() with \c options==NULL
+     *
+     *  When gmio is built with <tt>GMIO_FLOAT2STR_LIB=ryu</tt> and
+     *  <tt>float64_prec <= 9</tt>, the GMIO_FLOAT_TEXT_FORMAT_SHORTEST_xxx
+     *  formats write values exactly representable as \c float with the
+     *  shortest text that reads back to the same \c float */
     enum gmio_float_text_format float64_format;
 
     /*! The maximum number of significant digits when writting \c double values.
@@ -89,6 +130,52 @@ struct gmio_amf_write_options
     /*! Options for the zlib(deflate) compression.
      *  Applicable only if <tt>create_zip_archive==true</tt> */
     struct gmio_zlib_compress_options z_compress_options;
+
+    /*! Count of threads used for the zlib(deflate) compression.
+     *  Applicable only if <tt>create_zip_archive==true</tt>
+     *
+     *  If greater than \c 1 then gmio_amf_write() starts
+     *  <tt>thread_count - 1</tt> additional threads. The XML contents are split
+     *  into blocks of 128KB deflated concurrently, each one with a dictionary
+     *  primed from the tail of the previous block, then written in order as
+     *  a single deflate stream. The calling thread keeps serializing the
+     *  document and deflates blocks too when it has to wait for output.
+     *
+     *  Compressed output is slightly larger than with a single thread. Memory
+     *  used is roughly <tt>2 * thread_count * 300KB</tt>.
+     *  gmio_zlib_compress_options::func_alloc and
+     *  gmio_zlib_compress_options::func_free must then be thread-safe.
+     *
+     *  Ignored if threads are not supported on the target platform.
+     *
+     *  Value \c 0 (the default) has the same effect as \c 1. */
+    unsigned thread_count;
+
+    /*! Count of threads formatting mesh elements as XML text
+     *
+     *  If greater than \c 1 then the vertices and volume triangles of large
+     *  meshes are split into ranges formatted concurrently by
+     *  \p format_thread_count threads(including the calling one) into
+     *  per-thread buffers, then written in document order to the output
+     *  stream or to the zlib compression.
+     *
+     *  In that case gmio_amf_document::func_get_object_mesh_element(),
+     *  gmio_amf_document::func_get_object_mesh_element_metadata(),
+     *  gmio_amf_document::func_get_object_mesh_volume_triangle() and their
+     *  bulk variants are called from several threads at the same time and
+     *  must be thread-safe.
+     *  gmio_task_iface functions are still called from the calling thread.
+     *
+     *  Ignored if threads are not supported on the target platform.
+     *
+     *  Value \c 0 (the default) has the same effect as \c 1. */
+    unsigned format_thread_count;
+
+    /*! Flag allowing gmio_amf_write_file() to write the output file from a
+     *  background thread(see gmio_stream_writebehind()), so output I/O
+     *  overlaps with the serialization of the document.
+     *  Useful only with gmio_amf_write_file(), ignored otherwise */
+    bool use_file_writebehind;
 };
 
 /*! @} */
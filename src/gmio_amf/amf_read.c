@@ -0,0 +1,1387 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "amf_io.h"
+#include "amf_error.h"
+
+#include "../gmio_core/error.h"
+#include "../gmio_core/internal/byte_codec.h"
+#include "../gmio_core/internal/error_check.h"
+#include "../gmio_core/internal/helper_memblock.h"
+#include "../gmio_core/internal/helper_stream.h"
+#include "../gmio_core/internal/helper_task_iface.h"
+#include "../gmio_core/internal/min_max.h"
+#include "../gmio_core/internal/stream_skip.h"
+#include "../gmio_core/internal/string_ascii_utils.h"
+#include "../gmio_core/internal/zip_utils.h"
+#include "../gmio_core/internal/zlib_utils.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+/* Max count of vertices(or triangles) handed over in one creator call */
+#define GMIO_AMF_READ_BATCH_SIZE 256
+/* Max length of collected XML text contents, longer texts are truncated */
+#define GMIO_AMF_READ_TEXT_MAXLEN 1024
+/* Max depth of XML elements of interest */
+#define GMIO_AMF_READ_DEPTH_MAX 16
+
+/* XML elements of interest within AMF document */
+enum gmio_amf_xml_element
+{
+    GMIO_AMF_XML_NONE = 0,
+    GMIO_AMF_XML_AMF,
+    GMIO_AMF_XML_OBJECT,
+    GMIO_AMF_XML_MESH,
+    GMIO_AMF_XML_VERTICES,
+    GMIO_AMF_XML_VERTEX,
+    GMIO_AMF_XML_COORDINATES,
+    GMIO_AMF_XML_X,
+    GMIO_AMF_XML_Y,
+    GMIO_AMF_XML_Z,
+    GMIO_AMF_XML_VOLUME,
+    GMIO_AMF_XML_TRIANGLE,
+    GMIO_AMF_XML_V1,
+    GMIO_AMF_XML_V2,
+    GMIO_AMF_XML_V3,
+    GMIO_AMF_XML_METADATA,
+    GMIO_AMF_XML_MATERIAL,
+    GMIO_AMF_XML_COLOR,
+    GMIO_AMF_XML_R,
+    GMIO_AMF_XML_G,
+    GMIO_AMF_XML_B,
+    GMIO_AMF_XML_A,
+    GMIO_AMF_XML_CONSTELLATION,
+    GMIO_AMF_XML_INSTANCE,
+    GMIO_AMF_XML_DELTAX,
+    GMIO_AMF_XML_DELTAY,
+    GMIO_AMF_XML_DELTAZ,
+    GMIO_AMF_XML_RX,
+    GMIO_AMF_XML_RY,
+    GMIO_AMF_XML_RZ
+};
+
+/* Name of an XML element and its expected parent */
+struct gmio_amf_xml_element_def
+{
+    const char* name;
+    size_t name_len;
+    enum gmio_amf_xml_element element;
+    enum gmio_amf_xml_element parent;
+};
+
+/* Most frequent elements come first */
+static const struct gmio_amf_xml_element_def gmio_amf_xml_element_defs[] = {
+    { "x", 1, GMIO_AMF_XML_X, GMIO_AMF_XML_COORDINATES },
+    { "y", 1, GMIO_AMF_XML_Y, GMIO_AMF_XML_COORDINATES },
+    { "z", 1, GMIO_AMF_XML_Z, GMIO_AMF_XML_COORDINATES },
+    { "v1", 2, GMIO_AMF_XML_V1, GMIO_AMF_XML_TRIANGLE },
+    { "v2", 2, GMIO_AMF_XML_V2, GMIO_AMF_XML_TRIANGLE },
+    { "v3", 2, GMIO_AMF_XML_V3, GMIO_AMF_XML_TRIANGLE },
+    { "vertex", 6, GMIO_AMF_XML_VERTEX, GMIO_AMF_XML_VERTICES },
+    { "coordinates", 11, GMIO_AMF_XML_COORDINATES, GMIO_AMF_XML_VERTEX },
+    { "triangle", 8, GMIO_AMF_XML_TRIANGLE, GMIO_AMF_XML_VOLUME },
+    { "amf", 3, GMIO_AMF_XML_AMF, GMIO_AMF_XML_NONE },
+    { "object", 6, GMIO_AMF_XML_OBJECT, GMIO_AMF_XML_AMF },
+    { "mesh", 4, GMIO_AMF_XML_MESH, GMIO_AMF_XML_OBJECT },
+    { "vertices", 8, GMIO_AMF_XML_VERTICES, GMIO_AMF_XML_MESH },
+    { "volume", 6, GMIO_AMF_XML_VOLUME, GMIO_AMF_XML_MESH },
+    /* Parent of <metadata> is checked separately */
+    { "metadata", 8, GMIO_AMF_XML_METADATA, GMIO_AMF_XML_NONE },
+    { "material", 8, GMIO_AMF_XML_MATERIAL, GMIO_AMF_XML_AMF },
+    { "color", 5, GMIO_AMF_XML_COLOR, GMIO_AMF_XML_MATERIAL },
+    { "r", 1, GMIO_AMF_XML_R, GMIO_AMF_XML_COLOR },
+    { "g", 1, GMIO_AMF_XML_G, GMIO_AMF_XML_COLOR },
+    { "b", 1, GMIO_AMF_XML_B, GMIO_AMF_XML_COLOR },
+    { "a", 1, GMIO_AMF_XML_A, GMIO_AMF_XML_COLOR },
+    { "constellation", 13, GMIO_AMF_XML_CONSTELLATION, GMIO_AMF_XML_AMF },
+    { "instance", 8, GMIO_AMF_XML_INSTANCE, GMIO_AMF_XML_CONSTELLATION },
+    { "deltax", 6, GMIO_AMF_XML_DELTAX, GMIO_AMF_XML_INSTANCE },
+    { "deltay", 6, GMIO_AMF_XML_DELTAY, GMIO_AMF_XML_INSTANCE },
+    { "deltaz", 6, GMIO_AMF_XML_DELTAZ, GMIO_AMF_XML_INSTANCE },
+    { "rx", 2, GMIO_AMF_XML_RX, GMIO_AMF_XML_INSTANCE },
+    { "ry", 2, GMIO_AMF_XML_RY, GMIO_AMF_XML_INSTANCE },
+    { "rz", 2, GMIO_AMF_XML_RZ, GMIO_AMF_XML_INSTANCE }
+};
+
+/* Source of the XML contents */
+enum gmio_amf_xml_source
+{
+    GMIO_AMF_XML_SOURCE_PLAIN,
+    GMIO_AMF_XML_SOURCE_ZIP_DEFLATE,
+    GMIO_AMF_XML_SOURCE_ZIP_STORED
+};
+
+/* Reading(input) context */
+struct gmio_amf_rcontext
+{
+    struct gmio_stream* stream;
+    const struct gmio_amf_document_creator* creator;
+    const struct gmio_task_iface* task_iface;
+    intmax_t task_progress_current;
+    intmax_t task_progress_max;
+    int error;
+
+    /* XML contents buffer, [xml_at, xml_end[ being not parsed yet */
+    char* xml_buff;
+    size_t xml_capacity;
+    char* xml_at;
+    char* xml_end;
+    bool xml_eof;
+
+    /* ZIP specific */
+    enum gmio_amf_xml_source source;
+    struct gmio_memblock zin_memblock;
+    struct z_stream_s z_stream;
+    bool z_init;
+    bool z_end;
+    uintmax_t zip_stored_remaining;
+    bool zip_use_data_descriptor;
+    uint32_t zip_crc32;
+    uint32_t zip_expected_crc32;
+
+    /* Stack of the XML elements of interest */
+    enum gmio_amf_xml_element stack[GMIO_AMF_READ_DEPTH_MAX];
+    unsigned depth;
+    /* Depth within an element being skipped(unknown or unsupported) */
+    uint32_t skip_depth;
+    bool amf_closed;
+
+    /* Text contents of the current element */
+    bool text_on;
+    size_t text_len;
+    char text[GMIO_AMF_READ_TEXT_MAXLEN + 1];
+    char metadata_type[256];
+
+    /* Indexes and data of the current elements */
+    uint32_t object_count;
+    uint32_t material_count;
+    uint32_t constellation_count;
+    uint32_t metadata_count;
+    uint32_t element_metadata_count;
+    uint32_t mesh_count;
+    uint32_t vertex_count;
+    uint32_t volume_count;
+    uint32_t triangle_count;
+    uint32_t instance_count;
+    struct gmio_vec3d vertex;
+    uint32_t triangle[3];
+    struct gmio_amf_material material;
+    struct gmio_amf_instance instance;
+
+    /* Batches of elements to be handed over to the creator */
+    uint32_t batch_vertex_count;
+    struct gmio_vec3d batch_vertices[GMIO_AMF_READ_BATCH_SIZE];
+    uint32_t batch_triangle_count;
+    uint32_t batch_triangles[3 * GMIO_AMF_READ_BATCH_SIZE];
+};
+
+/* Helper to set error code of the reading context */
+GMIO_INLINE bool gmio_amf_rcontext_set_error(
+        struct gmio_amf_rcontext* context, int error)
+{
+    if (gmio_no_error(context->error))
+        context->error = error;
+    return false;
+}
+
+/* Checks CRC-32 of the uncompressed ZIP entry, \p trailer is what follows
+ * the compressed data(possibly a data descriptor) */
+static void gmio_amf_zip_check_crc32(
+        struct gmio_amf_rcontext* context,
+        const uint8_t* trailer,
+        size_t trailer_len)
+{
+    uint32_t expected_crc32 = context->zip_expected_crc32;
+    if (context->zip_use_data_descriptor) {
+        /* Data descriptor signature is optional */
+        if (trailer_len >= 4 && gmio_decode_uint32_le(trailer) == 0x08074b50) {
+            trailer += 4;
+            trailer_len -= 4;
+        }
+        /* Skip the check if data descriptor is not available */
+        if (trailer_len < 4)
+            return;
+        expected_crc32 = gmio_decode_uint32_le(trailer);
+    }
+    if (context->zip_crc32 != expected_crc32)
+        gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_ZIP_CRC32_MISMATCH);
+}
+
+/* Reads next bytes of input stream into \p ptr, returns the count of bytes
+ * read */
+static size_t gmio_amf_rcontext_read_input(
+        struct gmio_amf_rcontext* context, void* ptr, size_t len)
+{
+    const size_t len_read = gmio_stream_read_bytes(context->stream, ptr, len);
+    context->task_progress_current += len_read;
+    if (len_read != len && gmio_stream_error(context->stream) != 0)
+        gmio_amf_rcontext_set_error(context, GMIO_ERROR_STREAM);
+    return len_read;
+}
+
+/* Inflates next ZIP entry contents into \p ptr */
+static size_t gmio_amf_rcontext_inflate(
+        struct gmio_amf_rcontext* context, uint8_t* ptr, size_t len)
+{
+    struct z_stream_s* z_stream = &context->z_stream;
+    size_t len_inflated = 0;
+    if (context->z_end)
+        return 0;
+    gmio_zlib_assign_zstream_out(z_stream, ptr, len);
+    while (z_stream->avail_out == len && gmio_no_error(context->error)) {
+        int z_retcode = Z_OK;
+        if (z_stream->avail_in == 0) {
+            uint8_t* zin_ptr = (uint8_t*)context->zin_memblock.ptr;
+            const size_t zin_len =
+                    gmio_amf_rcontext_read_input(
+                        context, zin_ptr, context->zin_memblock.size);
+            if (zin_len == 0) { /* Truncated compressed data */
+                gmio_amf_rcontext_set_error(
+                            context, zlib_error_to_gmio_error(Z_BUF_ERROR));
+                break;
+            }
+            gmio_zlib_assign_zstream_in(z_stream, zin_ptr, zin_len);
+        }
+        z_retcode = inflate(z_stream, Z_NO_FLUSH);
+        if (z_retcode == Z_STREAM_END) {
+            context->z_end = true;
+            break;
+        }
+        if (z_retcode != Z_OK && z_retcode != Z_BUF_ERROR)
+            gmio_amf_rcontext_set_error(
+                        context, zlib_error_to_gmio_error(z_retcode));
+    }
+    len_inflated = len - z_stream->avail_out;
+    context->zip_crc32 =
+            gmio_zlib_crc32_update(context->zip_crc32, ptr, len_inflated);
+    if (context->z_end)
+        gmio_amf_zip_check_crc32(context, z_stream->next_in, z_stream->avail_in);
+    return len_inflated;
+}
+
+/* Reads next uncompressed ZIP entry contents into \p ptr */
+static size_t gmio_amf_rcontext_read_stored(
+        struct gmio_amf_rcontext* context, uint8_t* ptr, size_t len)
+{
+    const size_t len_to_read =
+            (size_t)GMIO_MIN(context->zip_stored_remaining, len);
+    const size_t len_read =
+            len_to_read != 0 ?
+                gmio_amf_rcontext_read_input(context, ptr, len_to_read) :
+                0;
+    if (len_read != len_to_read)
+        gmio_amf_rcontext_set_error(context, GMIO_ERROR_STREAM);
+    context->zip_stored_remaining -= len_read;
+    context->zip_crc32 =
+            gmio_zlib_crc32_update(context->zip_crc32, ptr, len_read);
+    if (len_to_read != 0 && context->zip_stored_remaining == 0)
+        gmio_amf_zip_check_crc32(context, NULL, 0);
+    return len_read;
+}
+
+/* Moves XML chars not parsed yet at buffer front then appends next XML
+ * contents. Returns false if no char could be appended */
+static bool gmio_amf_rcontext_fill(struct gmio_amf_rcontext* context)
+{
+    const size_t pending_len = context->xml_end - context->xml_at;
+    char* fill_ptr = context->xml_buff + pending_len;
+    const size_t fill_len = context->xml_capacity - pending_len;
+    size_t len = 0;
+
+    if (gmio_error(context->error) || context->xml_eof)
+        return false;
+    if (fill_len == 0)
+        return gmio_amf_rcontext_set_error(
+                    context, GMIO_AMF_ERROR_XML_TOKEN_TOO_LONG);
+    memmove(context->xml_buff, context->xml_at, pending_len);
+    context->xml_at = context->xml_buff;
+    context->xml_end = fill_ptr;
+
+    switch (context->source) {
+    case GMIO_AMF_XML_SOURCE_PLAIN:
+        len = gmio_amf_rcontext_read_input(context, fill_ptr, fill_len);
+        break;
+    case GMIO_AMF_XML_SOURCE_ZIP_DEFLATE:
+        len = gmio_amf_rcontext_inflate(context, (uint8_t*)fill_ptr, fill_len);
+        break;
+    case GMIO_AMF_XML_SOURCE_ZIP_STORED:
+        len = gmio_amf_rcontext_read_stored(context, (uint8_t*)fill_ptr, fill_len);
+        break;
+    }
+    context->xml_end += len;
+    context->xml_eof = len == 0;
+
+    if (gmio_no_error(context->error)) {
+        gmio_task_iface_handle_progress(
+                    context->task_iface,
+                    context->task_progress_current,
+                    context->task_progress_max);
+        if (gmio_task_iface_is_stop_requested(context->task_iface))
+            gmio_amf_rcontext_set_error(context, GMIO_ERROR_TASK_STOPPED);
+    }
+    return len != 0 && gmio_no_error(context->error);
+}
+
+/* Makes at least \p len chars available from xml_at */
+static bool gmio_amf_xml_require(struct gmio_amf_rcontext* context, size_t len)
+{
+    while ((size_t)(context->xml_end - context->xml_at) < len) {
+        if (!gmio_amf_rcontext_fill(context))
+            return false;
+    }
+    return true;
+}
+
+/* Returns the first char \p c from xml_at + \p offset, all chars from xml_at
+ * being kept in buffer. Returns NULL if not found */
+static const char* gmio_amf_xml_find(
+        struct gmio_amf_rcontext* context, size_t offset, char c)
+{
+    for (;;) {
+        const char* begin = context->xml_at + offset;
+        const char* found =
+                begin < context->xml_end ?
+                    (const char*)memchr(begin, c, context->xml_end - begin) :
+                    NULL;
+        if (found != NULL)
+            return found;
+        offset = GMIO_MAX(offset, (size_t)(context->xml_end - context->xml_at));
+        if (!gmio_amf_rcontext_fill(context))
+            return NULL;
+    }
+}
+
+/* Skips chars from xml_at until \p term followed by '>', \p term being not
+ * searched before xml_at + \p offset. Chars are discarded as they are skipped,
+ * so the skipped construct can be larger than the XML buffer */
+static bool gmio_amf_xml_skip_past(
+        struct gmio_amf_rcontext* context,
+        size_t offset,
+        const char* term,
+        size_t term_len)
+{
+    size_t search_offset = offset;
+    for (;;) {
+        const char* begin = context->xml_at + search_offset;
+        const char* found =
+                begin < context->xml_end ?
+                    (const char*)memchr(begin, '>', context->xml_end - begin) :
+                    NULL;
+        if (found != NULL) {
+            if ((size_t)(found - context->xml_at) >= offset + term_len
+                    && memcmp(found - term_len, term, term_len) == 0)
+            {
+                context->xml_at = (char*)found + 1;
+                return true;
+            }
+            search_offset = found + 1 - context->xml_at;
+        }
+        else {
+            /* Keep only the chars that may begin the terminator */
+            const size_t len = context->xml_end - context->xml_at;
+            const size_t keep_len = GMIO_MIN(len, term_len);
+            const size_t discard_len = len - keep_len;
+            context->xml_at += discard_len;
+            offset = offset > discard_len ? offset - discard_len : 0;
+            search_offset = keep_len;
+            if (!gmio_amf_rcontext_fill(context))
+                return false;
+        }
+    }
+}
+
+/* Appends \p len chars to the text contents of the current element */
+static void gmio_amf_text_append(
+        struct gmio_amf_rcontext* context, const char* str, size_t len)
+{
+    const size_t copy_len =
+            GMIO_MIN(len, GMIO_AMF_READ_TEXT_MAXLEN - context->text_len);
+    memcpy(context->text + context->text_len, str, copy_len);
+    context->text_len += copy_len;
+}
+
+/* Replaces in-place the predefined XML entities, returns the new length */
+static size_t gmio_amf_xml_unescape(char* str, size_t len)
+{
+    static const struct { const char* name; size_t len; char c; } entities[] = {
+        { "&lt;", 4, '<' }, { "&gt;", 4, '>' }, { "&amp;", 5, '&' },
+        { "&quot;", 6, '"' }, { "&apos;", 6, '\'' }
+    };
+    size_t i = 0;
+    size_t j = 0;
+    while (i < len) {
+        size_t ient = 0;
+        if (str[i] == '&') {
+            while (ient < GMIO_ARRAY_SIZE(entities)
+                   && (len - i < entities[ient].len
+                       || memcmp(str + i, entities[ient].name, entities[ient].len) != 0))
+            {
+                ++ient;
+            }
+        }
+        if (str[i] == '&' && ient < GMIO_ARRAY_SIZE(entities)) {
+            str[j++] = entities[ient].c;
+            i += entities[ient].len;
+        }
+        else {
+            str[j++] = str[i++];
+        }
+    }
+    return j;
+}
+
+/* Finds value of the attribute \p name within XML tag [\p begin, \p end[
+ * Returns false if no such attribute */
+static bool gmio_amf_xml_find_attr(
+        const char* begin,
+        const char* end,
+        const char* name,
+        const char** ptr_value,
+        size_t* ptr_value_len)
+{
+    const size_t name_len = strlen(name);
+    const char* c = begin;
+    while (c < end) {
+        const char* attr_name = NULL;
+        size_t attr_name_len = 0;
+        char quote = 0;
+        const char* value = NULL;
+        while (c < end && gmio_ascii_isspace(*c))
+            ++c;
+        attr_name = c;
+        while (c < end && *c != '=' && !gmio_ascii_isspace(*c))
+            ++c;
+        attr_name_len = c - attr_name;
+        while (c < end && gmio_ascii_isspace(*c))
+            ++c;
+        if (c >= end || *c != '=')
+            return false;
+        ++c;
+        while (c < end && gmio_ascii_isspace(*c))
+            ++c;
+        if (c >= end || (*c != '"' && *c != '\''))
+            return false;
+        quote = *c++;
+        value = c;
+        while (c < end && *c != quote)
+            ++c;
+        if (c >= end)
+            return false;
+        if (attr_name_len == name_len && memcmp(attr_name, name, name_len) == 0) {
+            *ptr_value = value;
+            *ptr_value_len = c - value;
+            return true;
+        }
+        ++c;
+    }
+    return false;
+}
+
+/* Parses unsigned 32b integer from [\p str, \p str + \p len[, leading and
+ * trailing spaces being ignored */
+static bool gmio_amf_parse_u32(const char* str, size_t len, uint32_t* value)
+{
+    const char* end = str + len;
+    uint64_t result = 0;
+    const char* digits = NULL;
+    while (str < end && gmio_ascii_isspace(*str))
+        ++str;
+    digits = str;
+    while (str < end && *str >= '0' && *str <= '9' && result <= 0xFFFFFFFF) {
+        result = result * 10 + (uint64_t)(*str - '0');
+        ++str;
+    }
+    while (str < end && gmio_ascii_isspace(*str))
+        ++str;
+    if (str == digits || str != end || result > 0xFFFFFFFF)
+        return false;
+    *value = (uint32_t)result;
+    return true;
+}
+
+/* Parses attribute \p name as unsigned 32b integer, \p value is left
+ * unchanged if there is no such attribute */
+static void gmio_amf_parse_attr_u32(
+        struct gmio_amf_rcontext* context,
+        const char* tag_begin,
+        const char* tag_end,
+        const char* name,
+        uint32_t* value)
+{
+    const char* str = NULL;
+    size_t len = 0;
+    if (gmio_amf_xml_find_attr(tag_begin, tag_end, name, &str, &len)
+            && !gmio_amf_parse_u32(str, len, value))
+    {
+        gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_XML_SYNTAX);
+    }
+}
+
+/* Parses the text contents of the current element as unsigned 32b integer */
+static uint32_t gmio_amf_text_to_u32(struct gmio_amf_rcontext* context)
+{
+    uint32_t value = 0;
+    if (!gmio_amf_parse_u32(context->text, context->text_len, &value))
+        gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_XML_SYNTAX);
+    return value;
+}
+
+/* Parses the text contents of the current element as double */
+static double gmio_amf_text_to_f64(struct gmio_amf_rcontext* context)
+{
+    char* end_ptr = NULL;
+    double value = 0.;
+    context->text[context->text_len] = '\0';
+    value = strtod(context->text, &end_ptr);
+    if (end_ptr == context->text)
+        gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_XML_SYNTAX);
+    return value;
+}
+
+/* Hands over the pending batch of vertices to the creator */
+static void gmio_amf_flush_vertices(struct gmio_amf_rcontext* context)
+{
+    const struct gmio_amf_document_creator* creator = context->creator;
+    if (context->batch_vertex_count == 0)
+        return;
+    if (creator->func_add_object_mesh_vertices != NULL) {
+        struct gmio_amf_object_mesh_element_index index;
+        index.object_index = context->object_count - 1;
+        index.mesh_index = context->mesh_count;
+        index.value = context->vertex_count - context->batch_vertex_count;
+        index.element_type = GMIO_AMF_MESH_ELEMENT_VERTEX;
+        creator->func_add_object_mesh_vertices(
+                    creator->cookie,
+                    &index,
+                    context->batch_vertices,
+                    context->batch_vertex_count);
+    }
+    context->batch_vertex_count = 0;
+}
+
+/* Hands over the pending batch of volume triangles to the creator */
+static void gmio_amf_flush_triangles(struct gmio_amf_rcontext* context)
+{
+    const struct gmio_amf_document_creator* creator = context->creator;
+    if (context->batch_triangle_count == 0)
+        return;
+    if (creator->func_add_object_mesh_volume_triangles != NULL) {
+        struct gmio_amf_object_mesh_element_index index;
+        index.object_index = context->object_count - 1;
+        index.mesh_index = context->mesh_count;
+        index.value = context->volume_count;
+        index.element_type = GMIO_AMF_MESH_ELEMENT_VOLUME;
+        creator->func_add_object_mesh_volume_triangles(
+                    creator->cookie,
+                    &index,
+                    context->triangle_count - context->batch_triangle_count,
+                    context->batch_triangles,
+                    context->batch_triangle_count);
+    }
+    context->batch_triangle_count = 0;
+}
+
+/* Returns the AMF unit corresponding to the text [\p str, \p str + \p len[ */
+static enum gmio_amf_unit gmio_amf_unit_from_str(const char* str, size_t len)
+{
+    static const struct { const char* str; enum gmio_amf_unit unit; } units[] = {
+        { "millimeter", GMIO_AMF_UNIT_MILLIMETER },
+        { "inch", GMIO_AMF_UNIT_INCH },
+        { "feet", GMIO_AMF_UNIT_FEET },
+        { "meter", GMIO_AMF_UNIT_METER },
+        { "micron", GMIO_AMF_UNIT_MICRON }
+    };
+    size_t i;
+    for (i = 0; i < GMIO_ARRAY_SIZE(units); ++i) {
+        if (strlen(units[i].str) == len && memcmp(units[i].str, str, len) == 0)
+            return units[i].unit;
+    }
+    return GMIO_AMF_UNIT_UNKNOWN;
+}
+
+/* Handles start tag of element of interest, [\p tag_begin, \p tag_end[ are
+ * the attributes */
+static void gmio_amf_on_element_start(
+        struct gmio_amf_rcontext* context,
+        enum gmio_amf_xml_element element,
+        const char* tag_begin,
+        const char* tag_end)
+{
+    const struct gmio_amf_document_creator* creator = context->creator;
+    switch (element) {
+    case GMIO_AMF_XML_AMF: {
+        const char* unit_str = NULL;
+        size_t unit_len = 0;
+        enum gmio_amf_unit unit = GMIO_AMF_UNIT_UNKNOWN;
+        if (gmio_amf_xml_find_attr(tag_begin, tag_end, "unit", &unit_str, &unit_len))
+            unit = gmio_amf_unit_from_str(unit_str, unit_len);
+        if (creator->func_begin_document != NULL)
+            creator->func_begin_document(creator->cookie, unit);
+        break;
+    }
+    case GMIO_AMF_XML_OBJECT: {
+        struct gmio_amf_object object = {0};
+        gmio_amf_parse_attr_u32(context, tag_begin, tag_end, "id", &object.id);
+        if (creator->func_add_document_element != NULL) {
+            creator->func_add_document_element(
+                        creator->cookie,
+                        GMIO_AMF_DOCUMENT_ELEMENT_OBJECT,
+                        context->object_count,
+                        &object);
+        }
+        ++context->object_count;
+        context->mesh_count = 0;
+        context->element_metadata_count = 0;
+        break;
+    }
+    case GMIO_AMF_XML_MESH:
+        context->vertex_count = 0;
+        context->volume_count = 0;
+        if (creator->func_begin_object_mesh != NULL) {
+            creator->func_begin_object_mesh(
+                        creator->cookie,
+                        context->object_count - 1,
+                        context->mesh_count);
+        }
+        break;
+    case GMIO_AMF_XML_VERTEX:
+        context->vertex.x = 0.;
+        context->vertex.y = 0.;
+        context->vertex.z = 0.;
+        break;
+    case GMIO_AMF_XML_VOLUME: {
+        struct gmio_amf_volume volume = {0};
+        const char* type_str = NULL;
+        size_t type_len = 0;
+        gmio_amf_flush_vertices(context);
+        gmio_amf_parse_attr_u32(
+                    context, tag_begin, tag_end, "materialid", &volume.materialid);
+        if (gmio_amf_xml_find_attr(tag_begin, tag_end, "type", &type_str, &type_len)
+                && type_len == 7
+                && memcmp(type_str, "support", 7) == 0)
+        {
+            volume.type = GMIO_AMF_VOLUME_TYPE_SUPPORT;
+        }
+        context->triangle_count = 0;
+        if (creator->func_add_object_mesh_volume != NULL) {
+            struct gmio_amf_object_mesh_element_index index;
+            index.object_index = context->object_count - 1;
+            index.mesh_index = context->mesh_count;
+            index.value = context->volume_count;
+            index.element_type = GMIO_AMF_MESH_ELEMENT_VOLUME;
+            creator->func_add_object_mesh_volume(
+                        creator->cookie, &index, &volume);
+        }
+        break;
+    }
+    case GMIO_AMF_XML_TRIANGLE:
+        context->triangle[0] = 0;
+        context->triangle[1] = 0;
+        context->triangle[2] = 0;
+        break;
+    case GMIO_AMF_XML_MATERIAL: {
+        const struct gmio_amf_material null_material = {0};
+        context->material = null_material;
+        gmio_amf_parse_attr_u32(
+                    context, tag_begin, tag_end, "id", &context->material.id);
+        context->element_metadata_count = 0;
+        break;
+    }
+    case GMIO_AMF_XML_CONSTELLATION: {
+        struct gmio_amf_constellation constellation = {0};
+        gmio_amf_parse_attr_u32(
+                    context, tag_begin, tag_end, "id", &constellation.id);
+        if (creator->func_add_document_element != NULL) {
+            creator->func_add_document_element(
+                        creator->cookie,
+                        GMIO_AMF_DOCUMENT_ELEMENT_CONSTELLATION,
+                        context->constellation_count,
+                        &constellation);
+        }
+        context->instance_count = 0;
+        context->element_metadata_count = 0;
+        break;
+    }
+    case GMIO_AMF_XML_INSTANCE: {
+        const struct gmio_amf_instance null_instance = {0};
+        context->instance = null_instance;
+        gmio_amf_parse_attr_u32(
+                    context, tag_begin, tag_end,
+                    "objectid", &context->instance.objectid);
+        break;
+    }
+    case GMIO_AMF_XML_METADATA: {
+        const char* type_str = NULL;
+        size_t type_len = 0;
+        gmio_amf_xml_find_attr(tag_begin, tag_end, "type", &type_str, &type_len);
+        type_len = GMIO_MIN(type_len, sizeof(context->metadata_type) - 1);
+        if (type_len != 0)
+            memcpy(context->metadata_type, type_str, type_len);
+        type_len = gmio_amf_xml_unescape(context->metadata_type, type_len);
+        context->metadata_type[type_len] = '\0';
+        context->text_on = true;
+        context->text_len = 0;
+        break;
+    }
+    case GMIO_AMF_XML_X:
+    case GMIO_AMF_XML_Y:
+    case GMIO_AMF_XML_Z:
+    case GMIO_AMF_XML_V1:
+    case GMIO_AMF_XML_V2:
+    case GMIO_AMF_XML_V3:
+    case GMIO_AMF_XML_R:
+    case GMIO_AMF_XML_G:
+    case GMIO_AMF_XML_B:
+    case GMIO_AMF_XML_A:
+    case GMIO_AMF_XML_DELTAX:
+    case GMIO_AMF_XML_DELTAY:
+    case GMIO_AMF_XML_DELTAZ:
+    case GMIO_AMF_XML_RX:
+    case GMIO_AMF_XML_RY:
+    case GMIO_AMF_XML_RZ:
+        context->text_on = true;
+        context->text_len = 0;
+        break;
+    case GMIO_AMF_XML_NONE:
+    case GMIO_AMF_XML_VERTICES:
+    case GMIO_AMF_XML_COORDINATES:
+    case GMIO_AMF_XML_COLOR:
+        break;
+    }
+}
+
+/* Hands over the <metadata> element just parsed to the creator */
+static void gmio_amf_add_metadata(
+        struct gmio_amf_rcontext* context, enum gmio_amf_xml_element parent)
+{
+    const struct gmio_amf_document_creator* creator = context->creator;
+    struct gmio_amf_metadata metadata;
+    context->text_len = gmio_amf_xml_unescape(context->text, context->text_len);
+    context->text[context->text_len] = '\0';
+    metadata.type = context->metadata_type;
+    metadata.data = context->text;
+    if (parent == GMIO_AMF_XML_AMF) {
+        if (creator->func_add_document_element != NULL) {
+            creator->func_add_document_element(
+                        creator->cookie,
+                        GMIO_AMF_DOCUMENT_ELEMENT_METADATA,
+                        context->metadata_count,
+                        &metadata);
+        }
+        ++context->metadata_count;
+    }
+    else {
+        enum gmio_amf_document_element element = GMIO_AMF_DOCUMENT_ELEMENT_OBJECT;
+        uint32_t element_index = context->object_count - 1;
+        if (parent == GMIO_AMF_XML_MATERIAL) {
+            element = GMIO_AMF_DOCUMENT_ELEMENT_MATERIAL;
+            element_index = context->material_count;
+        }
+        else if (parent == GMIO_AMF_XML_CONSTELLATION) {
+            element = GMIO_AMF_DOCUMENT_ELEMENT_CONSTELLATION;
+            element_index = context->constellation_count;
+        }
+        if (creator->func_add_document_element_metadata != NULL) {
+            creator->func_add_document_element_metadata(
+                        creator->cookie,
+                        element,
+                        element_index,
+                        context->element_metadata_count,
+                        &metadata);
+        }
+        ++context->element_metadata_count;
+    }
+}
+
+/* Handles end tag of element of interest */
+static void gmio_amf_on_element_end(
+        struct gmio_amf_rcontext* context,
+        enum gmio_amf_xml_element element,
+        enum gmio_amf_xml_element parent)
+{
+    const struct gmio_amf_document_creator* creator = context->creator;
+    switch (element) {
+    case GMIO_AMF_XML_X:
+        context->vertex.x = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_Y:
+        context->vertex.y = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_Z:
+        context->vertex.z = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_VERTEX:
+        context->batch_vertices[context->batch_vertex_count] = context->vertex;
+        ++context->batch_vertex_count;
+        ++context->vertex_count;
+        if (context->batch_vertex_count == GMIO_AMF_READ_BATCH_SIZE)
+            gmio_amf_flush_vertices(context);
+        break;
+    case GMIO_AMF_XML_VERTICES:
+        gmio_amf_flush_vertices(context);
+        break;
+    case GMIO_AMF_XML_V1:
+        context->triangle[0] = gmio_amf_text_to_u32(context);
+        break;
+    case GMIO_AMF_XML_V2:
+        context->triangle[1] = gmio_amf_text_to_u32(context);
+        break;
+    case GMIO_AMF_XML_V3:
+        context->triangle[2] = gmio_amf_text_to_u32(context);
+        break;
+    case GMIO_AMF_XML_TRIANGLE: {
+        uint32_t* batch_tri =
+                context->batch_triangles + 3 * context->batch_triangle_count;
+        batch_tri[0] = context->triangle[0];
+        batch_tri[1] = context->triangle[1];
+        batch_tri[2] = context->triangle[2];
+        ++context->batch_triangle_count;
+        ++context->triangle_count;
+        if (context->batch_triangle_count == GMIO_AMF_READ_BATCH_SIZE)
+            gmio_amf_flush_triangles(context);
+        break;
+    }
+    case GMIO_AMF_XML_VOLUME:
+        gmio_amf_flush_triangles(context);
+        ++context->volume_count;
+        break;
+    case GMIO_AMF_XML_MESH:
+        gmio_amf_flush_vertices(context);
+        ++context->mesh_count;
+        break;
+    case GMIO_AMF_XML_R:
+        context->material.color.r = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_G:
+        context->material.color.g = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_B:
+        context->material.color.b = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_A:
+        context->material.color.a = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_MATERIAL:
+        if (creator->func_add_document_element != NULL) {
+            creator->func_add_document_element(
+                        creator->cookie,
+                        GMIO_AMF_DOCUMENT_ELEMENT_MATERIAL,
+                        context->material_count,
+                        &context->material);
+        }
+        ++context->material_count;
+        break;
+    case GMIO_AMF_XML_DELTAX:
+        context->instance.delta.x = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_DELTAY:
+        context->instance.delta.y = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_DELTAZ:
+        context->instance.delta.z = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_RX:
+        context->instance.rot.x = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_RY:
+        context->instance.rot.y = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_RZ:
+        context->instance.rot.z = gmio_amf_text_to_f64(context);
+        break;
+    case GMIO_AMF_XML_INSTANCE:
+        if (creator->func_add_constellation_instance != NULL) {
+            creator->func_add_constellation_instance(
+                        creator->cookie,
+                        context->constellation_count,
+                        context->instance_count,
+                        &context->instance);
+        }
+        ++context->instance_count;
+        break;
+    case GMIO_AMF_XML_CONSTELLATION:
+        ++context->constellation_count;
+        break;
+    case GMIO_AMF_XML_METADATA:
+        gmio_amf_add_metadata(context, parent);
+        break;
+    case GMIO_AMF_XML_AMF:
+        context->amf_closed = true;
+        break;
+    case GMIO_AMF_XML_NONE:
+    case GMIO_AMF_XML_OBJECT:
+    case GMIO_AMF_XML_COORDINATES:
+    case GMIO_AMF_XML_COLOR:
+        break;
+    }
+    context->text_on = false;
+}
+
+/* Returns the XML element of interest named [\p name, \p name + \p len[
+ * within \p parent, GMIO_AMF_XML_NONE if none */
+static enum gmio_amf_xml_element gmio_amf_xml_element_find(
+        const char* name, size_t len, enum gmio_amf_xml_element parent)
+{
+    size_t i;
+    for (i = 0; i < GMIO_ARRAY_SIZE(gmio_amf_xml_element_defs); ++i) {
+        const struct gmio_amf_xml_element_def* def = &gmio_amf_xml_element_defs[i];
+        if (def->name_len == len && memcmp(def->name, name, len) == 0) {
+            if (def->element == GMIO_AMF_XML_METADATA) {
+                const bool valid_parent =
+                        parent == GMIO_AMF_XML_AMF
+                        || parent == GMIO_AMF_XML_OBJECT
+                        || parent == GMIO_AMF_XML_MATERIAL
+                        || parent == GMIO_AMF_XML_CONSTELLATION;
+                return valid_parent ? def->element : GMIO_AMF_XML_NONE;
+            }
+            return def->parent == parent ? def->element : GMIO_AMF_XML_NONE;
+        }
+    }
+    return GMIO_AMF_XML_NONE;
+}
+
+/* Returns the length of the XML name starting at \p name */
+static size_t gmio_amf_xml_name_len(const char* name, const char* end)
+{
+    const char* c = name;
+    while (c < end && *c != '>' && *c != '/' && !gmio_ascii_isspace(*c))
+        ++c;
+    return c - name;
+}
+
+/* Parses start tag at xml_at */
+static void gmio_amf_xml_parse_start_tag(struct gmio_amf_rcontext* context)
+{
+    const char* tag_end = gmio_amf_xml_find(context, 1, '>');
+    const char* name = context->xml_at + 1;
+    size_t name_len = 0;
+    bool empty_element = false;
+    if (tag_end == NULL) {
+        gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_XML_SYNTAX);
+        return;
+    }
+    name = context->xml_at + 1;
+    name_len = gmio_amf_xml_name_len(name, tag_end);
+    empty_element = tag_end[-1] == '/' && tag_end - 1 > name;
+    if (context->skip_depth > 0) {
+        if (!empty_element)
+            ++context->skip_depth;
+    }
+    else {
+        const enum gmio_amf_xml_element parent =
+                context->depth > 0 ?
+                    context->stack[context->depth - 1] :
+                    GMIO_AMF_XML_NONE;
+        const enum gmio_amf_xml_element element =
+                gmio_amf_xml_element_find(name, name_len, parent);
+        if (element == GMIO_AMF_XML_NONE
+                || context->depth == GMIO_AMF_READ_DEPTH_MAX)
+        {
+            if (!empty_element)
+                context->skip_depth = 1;
+        }
+        else {
+            const char* attrs_end = empty_element ? tag_end - 1 : tag_end;
+            context->stack[context->depth++] = element;
+            gmio_amf_on_element_start(
+                        context, element, name + name_len, attrs_end);
+            if (empty_element) {
+                --context->depth;
+                gmio_amf_on_element_end(context, element, parent);
+            }
+        }
+    }
+    context->xml_at = (char*)tag_end + 1;
+}
+
+/* Parses end tag at xml_at */
+static void gmio_amf_xml_parse_end_tag(struct gmio_amf_rcontext* context)
+{
+    const char* tag_end = gmio_amf_xml_find(context, 2, '>');
+    if (tag_end == NULL) {
+        gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_XML_SYNTAX);
+        return;
+    }
+    if (context->skip_depth > 0) {
+        --context->skip_depth;
+    }
+    else if (context->depth == 0) {
+        gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_XML_SYNTAX);
+    }
+    else {
+        const char* name = context->xml_at + 2;
+        const size_t name_len = gmio_amf_xml_name_len(name, tag_end);
+        const enum gmio_amf_xml_element element =
+                context->stack[context->depth - 1];
+        const enum gmio_amf_xml_element parent =
+                context->depth > 1 ?
+                    context->stack[context->depth - 2] :
+                    GMIO_AMF_XML_NONE;
+        if (gmio_amf_xml_element_find(name, name_len, parent) != element) {
+            gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_XML_SYNTAX);
+        }
+        else {
+            --context->depth;
+            gmio_amf_on_element_end(context, element, parent);
+        }
+    }
+    context->xml_at = (char*)tag_end + 1;
+}
+
+/* Parses CDATA section at xml_at */
+static void gmio_amf_xml_parse_cdata(struct gmio_amf_rcontext* context)
+{
+    static const size_t cdata_open_len = 9; /* <![CDATA[ */
+    size_t offset = cdata_open_len;
+    if (!context->text_on) {
+        gmio_amf_xml_skip_past(context, cdata_open_len, "]]", 2);
+        return;
+    }
+    /* Text is collected, CDATA section has to fit in XML buffer */
+    for (;;) {
+        const char* found = gmio_amf_xml_find(context, offset, '>');
+        if (found == NULL) {
+            gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_XML_SYNTAX);
+            return;
+        }
+        if ((size_t)(found - context->xml_at) >= cdata_open_len + 2
+                && found[-1] == ']' && found[-2] == ']')
+        {
+            const char* text = context->xml_at + cdata_open_len;
+            gmio_amf_text_append(context, text, found - 2 - text);
+            context->xml_at = (char*)found + 1;
+            return;
+        }
+        offset = found + 1 - context->xml_at;
+    }
+}
+
+/* Parses text contents until next '<' */
+static void gmio_amf_xml_parse_text(struct gmio_amf_rcontext* context)
+{
+    for (;;) {
+        const char* found =
+                (const char*)memchr(
+                    context->xml_at, '<', context->xml_end - context->xml_at);
+        const char* text_end = found != NULL ? found : context->xml_end;
+        if (context->text_on)
+            gmio_amf_text_append(context, context->xml_at, text_end - context->xml_at);
+        context->xml_at = (char*)text_end;
+        if (found != NULL || !gmio_amf_rcontext_fill(context))
+            return;
+    }
+}
+
+/* Parses the whole XML contents */
+static void gmio_amf_xml_parse(struct gmio_amf_rcontext* context)
+{
+    while (gmio_no_error(context->error) && !context->amf_closed) {
+        gmio_amf_xml_parse_text(context);
+        if (!gmio_amf_xml_require(context, 2))
+            break;
+        switch (context->xml_at[1]) {
+        case '?':
+            gmio_amf_xml_skip_past(context, 2, "?", 1);
+            break;
+        case '/':
+            gmio_amf_xml_parse_end_tag(context);
+            break;
+        case '!':
+            if (!gmio_amf_xml_require(context, 4))
+                break;
+            if (memcmp(context->xml_at, "<!--", 4) == 0)
+                gmio_amf_xml_skip_past(context, 4, "--", 2);
+            else if (gmio_amf_xml_require(context, 9)
+                     && memcmp(context->xml_at, "<![CDATA[", 9) == 0)
+                gmio_amf_xml_parse_cdata(context);
+            else /* DOCTYPE */
+                gmio_amf_xml_skip_past(context, 2, "", 0);
+            break;
+        default:
+            gmio_amf_xml_parse_start_tag(context);
+            break;
+        }
+    }
+    if (!context->amf_closed)
+        gmio_amf_rcontext_set_error(context, GMIO_AMF_ERROR_XML_SYNTAX);
+}
+
+/* Skips the extra field of ZIP local file header, retrieving the Zip64
+ * uncompressed size if any */
+static bool gmio_amf_zip_skip_extrafield(
+        struct gmio_amf_rcontext* context,
+        size_t extrafield_len,
+        uintmax_t* zip64_uncompressed_size)
+{
+    while (extrafield_len >= 4) {
+        uint8_t bytes[8];
+        uint16_t tag;
+        uint16_t data_len;
+        if (gmio_amf_rcontext_read_input(context, bytes, 4) != 4)
+            return gmio_amf_rcontext_set_error(context, GMIO_ERROR_STREAM);
+        tag = gmio_decode_uint16_le(bytes);
+        data_len = GMIO_MIN(gmio_decode_uint16_le(bytes + 2), extrafield_len - 4);
+        extrafield_len -= 4 + data_len;
+        if (tag == GMIO_ZIP_PKWARE_HEADERID_ZIP64_EXTENDED_INFO && data_len >= 8) {
+            if (gmio_amf_rcontext_read_input(context, bytes, 8) != 8)
+                return gmio_amf_rcontext_set_error(context, GMIO_ERROR_STREAM);
+#ifdef GMIO_HAVE_INT64_TYPE
+            *zip64_uncompressed_size = gmio_decode_uint64_le(bytes);
+#else
+            GMIO_UNUSED(zip64_uncompressed_size);
+#endif
+            data_len -= 8;
+        }
+        if (!gmio_stream_skip(context->stream, data_len, &context->zin_memblock))
+            return gmio_amf_rcontext_set_error(context, GMIO_ERROR_STREAM);
+    }
+    if (extrafield_len != 0
+            && !gmio_stream_skip(context->stream, extrafield_len, &context->zin_memblock))
+    {
+        return gmio_amf_rcontext_set_error(context, GMIO_ERROR_STREAM);
+    }
+    return true;
+}
+
+/* Reads ZIP local file header of the AMF entry and prepares decoding of its
+ * contents */
+static bool gmio_amf_zip_open_entry(struct gmio_amf_rcontext* context)
+{
+    struct gmio_zip_local_file_header zip_lfh = {0};
+    uintmax_t uncompressed_size = 0;
+    context->task_progress_current +=
+            gmio_zip_read_local_file_header(
+                context->stream, &zip_lfh, &context->error);
+    if (gmio_error(context->error))
+        return false;
+    if (zip_lfh.general_purpose_flags & GMIO_ZIP_GENERAL_PURPOSE_FLAG_FILE_ENCRYPTED)
+        return gmio_amf_rcontext_set_error(
+                    context, GMIO_AMF_ERROR_ZIP_UNSUPPORTED_ENTRY);
+    if (!gmio_stream_skip(
+                context->stream, zip_lfh.filename_len, &context->zin_memblock))
+    {
+        return gmio_amf_rcontext_set_error(context, GMIO_ERROR_STREAM);
+    }
+    uncompressed_size = zip_lfh.uncompressed_size;
+    if (!gmio_amf_zip_skip_extrafield(
+                context, zip_lfh.extrafield_len, &uncompressed_size))
+    {
+        return false;
+    }
+
+    context->zip_use_data_descriptor =
+            (zip_lfh.general_purpose_flags
+             & GMIO_ZIP_GENERAL_PURPOSE_FLAG_USE_DATA_DESCRIPTOR) != 0;
+    context->zip_expected_crc32 = zip_lfh.crc32;
+    context->zip_crc32 = gmio_zlib_crc32_initial();
+    if (zip_lfh.compress_method == GMIO_ZIP_COMPRESS_METHOD_DEFLATE) {
+        /* Raw deflate data, no zlib header */
+        const int z_retcode = inflateInit2(&context->z_stream, -MAX_WBITS);
+        if (z_retcode != Z_OK)
+            return gmio_amf_rcontext_set_error(
+                        context, zlib_error_to_gmio_error(z_retcode));
+        context->z_init = true;
+        context->source = GMIO_AMF_XML_SOURCE_ZIP_DEFLATE;
+    }
+    else if (zip_lfh.compress_method == GMIO_ZIP_COMPRESS_METHOD_NO_COMPRESSION
+             && !context->zip_use_data_descriptor)
+    {
+        context->zip_stored_remaining = uncompressed_size;
+        context->source = GMIO_AMF_XML_SOURCE_ZIP_STORED;
+    }
+    else {
+        return gmio_amf_rcontext_set_error(
+                    context, GMIO_AMF_ERROR_ZIP_UNSUPPORTED_ENTRY);
+    }
+    return true;
+}
+
+/* Input stream replaying the bytes consumed by the ZIP signature probe, for
+ * streams whose position cannot be restored */
+struct gmio_amf_probe_stream
+{
+    struct gmio_stream* stream;
+    uint8_t bytes[4];
+    size_t len;
+    size_t at;
+};
+
+static bool gmio_amf_probe_stream_at_end(void* cookie)
+{
+    struct gmio_amf_probe_stream* probe = (struct gmio_amf_probe_stream*)cookie;
+    return probe->at == probe->len && gmio_stream_at_end(probe->stream);
+}
+
+static int gmio_amf_probe_stream_error(void* cookie)
+{
+    struct gmio_amf_probe_stream* probe = (struct gmio_amf_probe_stream*)cookie;
+    return gmio_stream_error(probe->stream);
+}
+
+static size_t gmio_amf_probe_stream_read(
+        void* cookie, void* ptr, size_t size, size_t count)
+{
+    struct gmio_amf_probe_stream* probe = (struct gmio_amf_probe_stream*)cookie;
+    const size_t len = size * count;
+    const size_t replay_len = GMIO_MIN(len, probe->len - probe->at);
+    size_t len_read = 0;
+    if (size == 0)
+        return 0;
+    memcpy(ptr, probe->bytes + probe->at, replay_len);
+    probe->at += replay_len;
+    len_read =
+            replay_len
+            + gmio_stream_read_bytes(
+                probe->stream, (uint8_t*)ptr + replay_len, len - replay_len);
+    return len_read / size;
+}
+
+static gmio_streamsize_t gmio_amf_probe_stream_size(void* cookie)
+{
+    struct gmio_amf_probe_stream* probe = (struct gmio_amf_probe_stream*)cookie;
+    return gmio_stream_size(probe->stream);
+}
+
+/* Returns true if \p stream starts with ZIP local file header signature
+ *
+ * The stream position is restored if possible, otherwise the bytes read are
+ * kept in \p probe so they can be replayed */
+static bool gmio_amf_probe_zip_signature(
+        struct gmio_stream* stream, struct gmio_amf_probe_stream* probe)
+{
+    struct gmio_streampos begin_pos = {0};
+    const bool pos_saved = gmio_stream_get_pos(stream, &begin_pos) == 0;
+    const size_t len_read =
+            gmio_stream_read_bytes(stream, probe->bytes, sizeof(probe->bytes));
+    probe->stream = stream;
+    probe->at = 0;
+    probe->len = 0;
+    if (!pos_saved || gmio_stream_set_pos(stream, &begin_pos) != 0)
+        probe->len = len_read;
+    return len_read == sizeof(probe->bytes)
+            && gmio_decode_uint32_le(probe->bytes) == 0x04034b50;
+}
+
+/* Returns a stream reading probed bytes then the rest of the probed stream */
+static struct gmio_stream gmio_amf_probe_stream(
+        struct gmio_amf_probe_stream* probe)
+{
+    struct gmio_stream stream = {0};
+    stream.cookie = probe;
+    stream.func_at_end = gmio_amf_probe_stream_at_end;
+    stream.func_error = gmio_amf_probe_stream_error;
+    stream.func_read = gmio_amf_probe_stream_read;
+    stream.func_size = gmio_amf_probe_stream_size;
+    return stream;
+}
+
+int gmio_amf_read(
+        struct gmio_stream* stream,
+        const struct gmio_amf_document_creator* creator,
+        const struct gmio_amf_read_options* opts)
+{
+    static const struct gmio_amf_read_options default_read_opts = {0};
+    static const struct gmio_amf_document_creator null_creator = {0};
+    struct gmio_amf_rcontext context = {0};
+    struct gmio_amf_probe_stream probe = {0};
+    struct gmio_stream probe_stream = {0};
+    bool is_zip = false;
+    struct gmio_memblock_helper mblock_helper =
+            gmio_memblock_helper(opts != NULL ? &opts->stream_memblock : NULL);
+    const struct gmio_memblock* memblock = &mblock_helper.memblock;
+
+    opts = opts != NULL ? opts : &default_read_opts;
+    creator = creator != NULL ? creator : &null_creator;
+
+    /* Check validity of input parameters */
+    context.error = GMIO_ERROR_OK;
+    if (!gmio_check_istream(&context.error, stream))
+        goto label_end;
+    if (!gmio_check_memblock(&context.error, memblock))
+        goto label_end;
+    if (!opts->dont_check_lc_numeric && !gmio_check_lc_numeric(&context.error))
+        goto label_end;
+
+    /* Initialize reading context */
+    context.stream = stream;
+    context.creator = creator;
+    context.task_iface = &opts->task_iface;
+    context.task_progress_max = gmio_stream_size(stream);
+    context.xml_buff = (char*)memblock->ptr;
+    context.xml_capacity = memblock->size;
+    is_zip = gmio_amf_probe_zip_signature(stream, &probe);
+    if (probe.len != 0) {
+        probe_stream = gmio_amf_probe_stream(&probe);
+        context.stream = &probe_stream;
+    }
+    if (is_zip) {
+        /* First half of memblock for compressed data, second half for XML */
+        const size_t mblock_halfsize = memblock->size / 2;
+        context.zin_memblock =
+                gmio_memblock(memblock->ptr, mblock_halfsize, NULL);
+        context.xml_buff += mblock_halfsize;
+        context.xml_capacity = memblock->size - mblock_halfsize;
+        if (!gmio_amf_zip_open_entry(&context))
+            goto label_end;
+    }
+    else {
+        context.source = GMIO_AMF_XML_SOURCE_PLAIN;
+    }
+    context.xml_at = context.xml_buff;
+    context.xml_end = context.xml_buff;
+
+    gmio_amf_xml_parse(&context);
+    if (gmio_no_error(context.error) && creator->func_end_document != NULL)
+        creator->func_end_document(creator->cookie);
+
+label_end:
+    if (context.z_init)
+        inflateEnd(&context.z_stream);
+    gmio_memblock_helper_release(&mblock_helper);
+    return context.error;
+}
+
+int gmio_amf_read_file(
+        const char* filepath,
+        const struct gmio_amf_document_creator* creator,
+        const struct gmio_amf_read_options* opts)
+{
+    FILE* file = fopen(filepath, "rb");
+    if (file != NULL) {
+        struct gmio_stream stream = gmio_stream_stdio(file);
+        const int error = gmio_amf_read(&stream, creator, opts);
+        fclose(file);
+        return error;
+    }
+    return GMIO_ERROR_STDIO;
+}
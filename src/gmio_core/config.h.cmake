@@ -71,6 +71,15 @@
 #cmakedefine GMIO_HAVE_POSIX_FILENO
 #cmakedefine GMIO_HAVE_POSIX_FSTAT64
 #cmakedefine GMIO_HAVE_WIN__FSTAT64
+#cmakedefine GMIO_HAVE_POSIX_MMAP
+#cmakedefine GMIO_HAVE_POSIX_PWRITE
+
+/* Linux */
+#cmakedefine GMIO_HAVE_LINUX_IO_URING
+
+/* Threads */
+#cmakedefine GMIO_HAVE_PTHREAD
+#cmakedefine GMIO_HAVE_WIN32_THREADS
 
 /* Compiler byte-swap functions */
 #cmakedefine GMIO_HAVE_GCC_BUILTIN_BSWAP16
@@ -78,6 +87,10 @@
 
 #cmakedefine GMIO_HAVE_MSVC_BUILTIN_BSWAP
 
+/* SIMD instruction sets selectable at runtime */
+#cmakedefine GMIO_HAVE_GCC_TARGET_SSSE3
+#cmakedefine GMIO_HAVE_MSVC_CPUID_SSSE3
+
 /* Target architecture */
 #cmakedefine GMIO_HOST_IS_BIG_ENDIAN
 
@@ -97,11 +110,13 @@
 #define GMIO_STR2FLOAT_LIB_STD 0
 #define GMIO_STR2FLOAT_LIB_IRRLICHT 1
 #define GMIO_STR2FLOAT_LIB_DOUBLE_CONVERSION 2
+#define GMIO_STR2FLOAT_LIB_EISEL_LEMIRE 3
 #define GMIO_STR2FLOAT_LIB @GMIO_STR2FLOAT_LIBCODE@
 
 /* Select the float-to-string library to be used */
 #define GMIO_FLOAT2STR_LIB_STD 0
 #define GMIO_FLOAT2STR_LIB_DOUBLE_CONVERSION 2
+#define GMIO_FLOAT2STR_LIB_RYU 3
 #define GMIO_FLOAT2STR_LIB @GMIO_FLOAT2STR_LIBCODE@
 
 /* Header: gmio_core/internal/string_ascii_utils.h */
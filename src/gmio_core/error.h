@@ -123,7 +123,11 @@ enum gmio_error
 
     /*! The size of some ZIP file entry exceeds 32b limit and so requires Zip64
      *  format */
-    GMIO_ERROR_ZIP64_FORMAT_REQUIRED
+    GMIO_ERROR_ZIP64_FORMAT_REQUIRED,
+
+    /* Memory */
+    /*! A dynamic memory allocation failed(eg. \c malloc() returned \c NULL) */
+    GMIO_ERROR_MEMORY_ALLOC
 };
 
 /*! \c GMIO_CORE_ERROR_TAG
@@ -0,0 +1,47 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "cpu_features.h"
+
+#if defined(GMIO_HAVE_MSVC_CPUID_SSSE3) && defined(GMIO_ARCH_X86)
+#  include <intrin.h>
+#endif
+
+bool gmio_cpu_supports_ssse3()
+{
+#if defined(GMIO_HAVE_GCC_TARGET_SSSE3) && defined(GMIO_ARCH_X86)
+    return __builtin_cpu_supports("ssse3") != 0;
+#elif defined(GMIO_HAVE_MSVC_CPUID_SSSE3) && defined(GMIO_ARCH_X86)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0; /* ECX bit 9 */
+#else
+    return false;
+#endif
+}
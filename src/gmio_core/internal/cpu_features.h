@@ -0,0 +1,69 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include "../global.h"
+
+/* GMIO_ARCH_X86: defined when target architecture is x86 or x86_64 */
+#if defined(__i386__) || defined(__x86_64__) \
+    || defined(_M_IX86) || defined(_M_X64)
+#  define GMIO_ARCH_X86
+#endif
+
+/* GMIO_HAVE_SSE2: SSE2 intrinsics can be used unconditionally */
+#if defined(GMIO_ARCH_X86) \
+    && (defined(__SSE2__) || defined(_M_X64) \
+        || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define GMIO_HAVE_SSE2
+#endif
+
+/* GMIO_HAVE_SSSE3_DISPATCH: SSSE3 intrinsics can be used in functions marked
+ * with GMIO_TARGET_SSSE3, which must be called only if
+ * gmio_cpu_supports_ssse3() returns true */
+#if defined(GMIO_ARCH_X86) \
+    && (defined(GMIO_HAVE_GCC_TARGET_SSSE3) \
+        || defined(GMIO_HAVE_MSVC_CPUID_SSSE3))
+#  define GMIO_HAVE_SSSE3_DISPATCH
+#endif
+
+/* GMIO_TARGET_SSSE3: function attribute enabling SSSE3 code generation */
+#ifdef GMIO_HAVE_GCC_TARGET_SSSE3
+#  define GMIO_TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#  define GMIO_TARGET_SSSE3
+#endif
+
+/* GMIO_HAVE_NEON: ARM NEON intrinsics can be used unconditionally */
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define GMIO_HAVE_NEON
+#endif
+
+/*! Returns true if the running CPU supports the SSSE3 instruction set */
+bool gmio_cpu_supports_ssse3();
@@ -0,0 +1,140 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "eisel_lemire.h"
+
+/* Generated with the same method as in the fast_float library :
+ *     q < 0  : 2^b / 5^-q + 1, truncated to 128 bits
+ *     q >= 0 : 5^q, normalized then truncated to 128 bits */
+const uint64_t gmio_eisel_lemire_power_of_five_128[] = {
+    UINT64_C(0x86CCBB52EA94BAEA), UINT64_C(0x98E947129FC2B4E9), /* 5^-65 */
+    UINT64_C(0xA87FEA27A539E9A5), UINT64_C(0x3F2398D747B36224), /* 5^-64 */
+    UINT64_C(0xD29FE4B18E88640E), UINT64_C(0x8EEC7F0D19A03AAD), /* 5^-63 */
+    UINT64_C(0x83A3EEEEF9153E89), UINT64_C(0x1953CF68300424AC), /* 5^-62 */
+    UINT64_C(0xA48CEAAAB75A8E2B), UINT64_C(0x5FA8C3423C052DD7), /* 5^-61 */
+    UINT64_C(0xCDB02555653131B6), UINT64_C(0x3792F412CB06794D), /* 5^-60 */
+    UINT64_C(0x808E17555F3EBF11), UINT64_C(0xE2BBD88BBEE40BD0), /* 5^-59 */
+    UINT64_C(0xA0B19D2AB70E6ED6), UINT64_C(0x5B6ACEAEAE9D0EC4), /* 5^-58 */
+    UINT64_C(0xC8DE047564D20A8B), UINT64_C(0xF245825A5A445275), /* 5^-57 */
+    UINT64_C(0xFB158592BE068D2E), UINT64_C(0xEED6E2F0F0D56712), /* 5^-56 */
+    UINT64_C(0x9CED737BB6C4183D), UINT64_C(0x55464DD69685606B), /* 5^-55 */
+    UINT64_C(0xC428D05AA4751E4C), UINT64_C(0xAA97E14C3C26B886), /* 5^-54 */
+    UINT64_C(0xF53304714D9265DF), UINT64_C(0xD53DD99F4B3066A8), /* 5^-53 */
+    UINT64_C(0x993FE2C6D07B7FAB), UINT64_C(0xE546A8038EFE4029), /* 5^-52 */
+    UINT64_C(0xBF8FDB78849A5F96), UINT64_C(0xDE98520472BDD033), /* 5^-51 */
+    UINT64_C(0xEF73D256A5C0F77C), UINT64_C(0x963E66858F6D4440), /* 5^-50 */
+    UINT64_C(0x95A8637627989AAD), UINT64_C(0xDDE7001379A44AA8), /* 5^-49 */
+    UINT64_C(0xBB127C53B17EC159), UINT64_C(0x5560C018580D5D52), /* 5^-48 */
+    UINT64_C(0xE9D71B689DDE71AF), UINT64_C(0xAAB8F01E6E10B4A6), /* 5^-47 */
+    UINT64_C(0x9226712162AB070D), UINT64_C(0xCAB3961304CA70E8), /* 5^-46 */
+    UINT64_C(0xB6B00D69BB55C8D1), UINT64_C(0x3D607B97C5FD0D22), /* 5^-45 */
+    UINT64_C(0xE45C10C42A2B3B05), UINT64_C(0x8CB89A7DB77C506A), /* 5^-44 */
+    UINT64_C(0x8EB98A7A9A5B04E3), UINT64_C(0x77F3608E92ADB242), /* 5^-43 */
+    UINT64_C(0xB267ED1940F1C61C), UINT64_C(0x55F038B237591ED3), /* 5^-42 */
+    UINT64_C(0xDF01E85F912E37A3), UINT64_C(0x6B6C46DEC52F6688), /* 5^-41 */
+    UINT64_C(0x8B61313BBABCE2C6), UINT64_C(0x2323AC4B3B3DA015), /* 5^-40 */
+    UINT64_C(0xAE397D8AA96C1B77), UINT64_C(0xABEC975E0A0D081A), /* 5^-39 */
+    UINT64_C(0xD9C7DCED53C72255), UINT64_C(0x96E7BD358C904A21), /* 5^-38 */
+    UINT64_C(0x881CEA14545C7575), UINT64_C(0x7E50D64177DA2E54), /* 5^-37 */
+    UINT64_C(0xAA242499697392D2), UINT64_C(0xDDE50BD1D5D0B9E9), /* 5^-36 */
+    UINT64_C(0xD4AD2DBFC3D07787), UINT64_C(0x955E4EC64B44E864), /* 5^-35 */
+    UINT64_C(0x84EC3C97DA624AB4), UINT64_C(0xBD5AF13BEF0B113E), /* 5^-34 */
+    UINT64_C(0xA6274BBDD0FADD61), UINT64_C(0xECB1AD8AEACDD58E), /* 5^-33 */
+    UINT64_C(0xCFB11EAD453994BA), UINT64_C(0x67DE18EDA5814AF2), /* 5^-32 */
+    UINT64_C(0x81CEB32C4B43FCF4), UINT64_C(0x80EACF948770CED7), /* 5^-31 */
+    UINT64_C(0xA2425FF75E14FC31), UINT64_C(0xA1258379A94D028D), /* 5^-30 */
+    UINT64_C(0xCAD2F7F5359A3B3E), UINT64_C(0x096EE45813A04330), /* 5^-29 */
+    UINT64_C(0xFD87B5F28300CA0D), UINT64_C(0x8BCA9D6E188853FC), /* 5^-28 */
+    UINT64_C(0x9E74D1B791E07E48), UINT64_C(0x775EA264CF55347E), /* 5^-27 */
+    UINT64_C(0xC612062576589DDA), UINT64_C(0x95364AFE032A819E), /* 5^-26 */
+    UINT64_C(0xF79687AED3EEC551), UINT64_C(0x3A83DDBD83F52205), /* 5^-25 */
+    UINT64_C(0x9ABE14CD44753B52), UINT64_C(0xC4926A9672793543), /* 5^-24 */
+    UINT64_C(0xC16D9A0095928A27), UINT64_C(0x75B7053C0F178294), /* 5^-23 */
+    UINT64_C(0xF1C90080BAF72CB1), UINT64_C(0x5324C68B12DD6339), /* 5^-22 */
+    UINT64_C(0x971DA05074DA7BEE), UINT64_C(0xD3F6FC16EBCA5E04), /* 5^-21 */
+    UINT64_C(0xBCE5086492111AEA), UINT64_C(0x88F4BB1CA6BCF585), /* 5^-20 */
+    UINT64_C(0xEC1E4A7DB69561A5), UINT64_C(0x2B31E9E3D06C32E6), /* 5^-19 */
+    UINT64_C(0x9392EE8E921D5D07), UINT64_C(0x3AFF322E62439FD0), /* 5^-18 */
+    UINT64_C(0xB877AA3236A4B449), UINT64_C(0x09BEFEB9FAD487C3), /* 5^-17 */
+    UINT64_C(0xE69594BEC44DE15B), UINT64_C(0x4C2EBE687989A9B4), /* 5^-16 */
+    UINT64_C(0x901D7CF73AB0ACD9), UINT64_C(0x0F9D37014BF60A11), /* 5^-15 */
+    UINT64_C(0xB424DC35095CD80F), UINT64_C(0x538484C19EF38C95), /* 5^-14 */
+    UINT64_C(0xE12E13424BB40E13), UINT64_C(0x2865A5F206B06FBA), /* 5^-13 */
+    UINT64_C(0x8CBCCC096F5088CB), UINT64_C(0xF93F87B7442E45D4), /* 5^-12 */
+    UINT64_C(0xAFEBFF0BCB24AAFE), UINT64_C(0xF78F69A51539D749), /* 5^-11 */
+    UINT64_C(0xDBE6FECEBDEDD5BE), UINT64_C(0xB573440E5A884D1C), /* 5^-10 */
+    UINT64_C(0x89705F4136B4A597), UINT64_C(0x31680A88F8953031), /* 5^-9 */
+    UINT64_C(0xABCC77118461CEFC), UINT64_C(0xFDC20D2B36BA7C3E), /* 5^-8 */
+    UINT64_C(0xD6BF94D5E57A42BC), UINT64_C(0x3D32907604691B4D), /* 5^-7 */
+    UINT64_C(0x8637BD05AF6C69B5), UINT64_C(0xA63F9A49C2C1B110), /* 5^-6 */
+    UINT64_C(0xA7C5AC471B478423), UINT64_C(0x0FCF80DC33721D54), /* 5^-5 */
+    UINT64_C(0xD1B71758E219652B), UINT64_C(0xD3C36113404EA4A9), /* 5^-4 */
+    UINT64_C(0x83126E978D4FDF3B), UINT64_C(0x645A1CAC083126EA), /* 5^-3 */
+    UINT64_C(0xA3D70A3D70A3D70A), UINT64_C(0x3D70A3D70A3D70A4), /* 5^-2 */
+    UINT64_C(0xCCCCCCCCCCCCCCCC), UINT64_C(0xCCCCCCCCCCCCCCCD), /* 5^-1 */
+    UINT64_C(0x8000000000000000), UINT64_C(0x0000000000000000), /* 5^0 */
+    UINT64_C(0xA000000000000000), UINT64_C(0x0000000000000000), /* 5^1 */
+    UINT64_C(0xC800000000000000), UINT64_C(0x0000000000000000), /* 5^2 */
+    UINT64_C(0xFA00000000000000), UINT64_C(0x0000000000000000), /* 5^3 */
+    UINT64_C(0x9C40000000000000), UINT64_C(0x0000000000000000), /* 5^4 */
+    UINT64_C(0xC350000000000000), UINT64_C(0x0000000000000000), /* 5^5 */
+    UINT64_C(0xF424000000000000), UINT64_C(0x0000000000000000), /* 5^6 */
+    UINT64_C(0x9896800000000000), UINT64_C(0x0000000000000000), /* 5^7 */
+    UINT64_C(0xBEBC200000000000), UINT64_C(0x0000000000000000), /* 5^8 */
+    UINT64_C(0xEE6B280000000000), UINT64_C(0x0000000000000000), /* 5^9 */
+    UINT64_C(0x9502F90000000000), UINT64_C(0x0000000000000000), /* 5^10 */
+    UINT64_C(0xBA43B74000000000), UINT64_C(0x0000000000000000), /* 5^11 */
+    UINT64_C(0xE8D4A51000000000), UINT64_C(0x0000000000000000), /* 5^12 */
+    UINT64_C(0x9184E72A00000000), UINT64_C(0x0000000000000000), /* 5^13 */
+    UINT64_C(0xB5E620F480000000), UINT64_C(0x0000000000000000), /* 5^14 */
+    UINT64_C(0xE35FA931A0000000), UINT64_C(0x0000000000000000), /* 5^15 */
+    UINT64_C(0x8E1BC9BF04000000), UINT64_C(0x0000000000000000), /* 5^16 */
+    UINT64_C(0xB1A2BC2EC5000000), UINT64_C(0x0000000000000000), /* 5^17 */
+    UINT64_C(0xDE0B6B3A76400000), UINT64_C(0x0000000000000000), /* 5^18 */
+    UINT64_C(0x8AC7230489E80000), UINT64_C(0x0000000000000000), /* 5^19 */
+    UINT64_C(0xAD78EBC5AC620000), UINT64_C(0x0000000000000000), /* 5^20 */
+    UINT64_C(0xD8D726B7177A8000), UINT64_C(0x0000000000000000), /* 5^21 */
+    UINT64_C(0x878678326EAC9000), UINT64_C(0x0000000000000000), /* 5^22 */
+    UINT64_C(0xA968163F0A57B400), UINT64_C(0x0000000000000000), /* 5^23 */
+    UINT64_C(0xD3C21BCECCEDA100), UINT64_C(0x0000000000000000), /* 5^24 */
+    UINT64_C(0x84595161401484A0), UINT64_C(0x0000000000000000), /* 5^25 */
+    UINT64_C(0xA56FA5B99019A5C8), UINT64_C(0x0000000000000000), /* 5^26 */
+    UINT64_C(0xCECB8F27F4200F3A), UINT64_C(0x0000000000000000), /* 5^27 */
+    UINT64_C(0x813F3978F8940984), UINT64_C(0x4000000000000000), /* 5^28 */
+    UINT64_C(0xA18F07D736B90BE5), UINT64_C(0x5000000000000000), /* 5^29 */
+    UINT64_C(0xC9F2C9CD04674EDE), UINT64_C(0xA400000000000000), /* 5^30 */
+    UINT64_C(0xFC6F7C4045812296), UINT64_C(0x4D00000000000000), /* 5^31 */
+    UINT64_C(0x9DC5ADA82B70B59D), UINT64_C(0xF020000000000000), /* 5^32 */
+    UINT64_C(0xC5371912364CE305), UINT64_C(0x6C28000000000000), /* 5^33 */
+    UINT64_C(0xF684DF56C3E01BC6), UINT64_C(0xC732000000000000), /* 5^34 */
+    UINT64_C(0x9A130B963A6C115C), UINT64_C(0x3C7F400000000000), /* 5^35 */
+    UINT64_C(0xC097CE7BC90715B3), UINT64_C(0x4B9F100000000000), /* 5^36 */
+    UINT64_C(0xF0BDC21ABB48DB20), UINT64_C(0x1E86D40000000000), /* 5^37 */
+    UINT64_C(0x96769950B50D88F4), UINT64_C(0x1314448000000000), /* 5^38 */
+};
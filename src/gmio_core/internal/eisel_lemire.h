@@ -0,0 +1,622 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+/* Correctly rounded conversion of decimal strings to float32, based on the
+ * Eisel-Lemire algorithm :
+ *     Daniel Lemire, "Number Parsing at a Gigabyte per Second",
+ *     Software: Practice and Experience 51 (8), 2021
+ *     Noble Mushtak, Daniel Lemire, "Fast Number Parsing Without Fallback",
+ *     Software: Practice and Experience 53 (6), 2023
+ *
+ * Up to 19 significant digits are gathered in a 64-bit integer w(digits after
+ * the decimal point are gathered 8 at a time with SWAR), then w * 10^q is
+ * computed with a 128-bit approximation of 5^q, which is always accurate
+ * enough to get the nearest float32.
+ * Beyond 19 significant digits, w and w+1 are both converted : if results
+ * differ the C library strtof() is called on a shortened copy of the number
+ * (see struct gmio_eisel_lemire_short_number).
+ */
+
+#pragma once
+
+#include "../global.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* Decimal number parsed by gmio_eisel_lemire_parse() */
+struct gmio_eisel_lemire_decimal
+{
+    /* First 19 significant digits */
+    uint64_t mantissa;
+    /* Power of ten applying to mantissa */
+    int64_t exponent;
+    /* Is there a minus sign ? */
+    bool negative;
+    /* More than 19 significant digits, mantissa is truncated */
+    bool too_many_digits;
+};
+
+/* Parses the decimal number at the beginning of [begin, end)
+ *
+ * Accepted syntax is : [+-]digits[.digits][(e|E)[+-]digits], where one of the
+ * digit sequences before or after the decimal point can be empty.
+ *
+ * Returns the position after the number, or \p begin if there is no number */
+GMIO_INLINE const char* gmio_eisel_lemire_parse(
+        const char* begin,
+        const char* end,
+        struct gmio_eisel_lemire_decimal* decimal);
+
+/* Returns the float32 nearest to <tt>w * 10^q</tt> (ties to even) */
+GMIO_INLINE float gmio_eisel_lemire_to_float32(
+        uint64_t w, int64_t q, bool negative);
+
+/* Returns the float32 nearest to the number in [begin, end) parsed into
+ * \p decimal */
+GMIO_INLINE float gmio_eisel_lemire_decimal_to_float32(
+        const struct gmio_eisel_lemire_decimal* decimal,
+        const char* begin,
+        const char* end);
+
+/* Significant digits kept by struct gmio_eisel_lemire_short_number
+ *
+ * Any float32 rounding boundary(halfway between two floats) has at most 113
+ * significant digits, so truncating beyond this count and appending a sticky
+ * non-zero digit cannot change the rounded result */
+enum { GMIO_EISEL_LEMIRE_SHORT_NUMBER_MAX_DIGITS = 120 };
+
+/* Decimal number rewritten as <tt>[-]0.digits[1]e[-]exp</tt>, fed one char
+ * at a time
+ *
+ * Accepted syntax is the same as gmio_eisel_lemire_parse(), feeding stops
+ * having effect at the first char not part of the number. The mantissa keeps
+ * at most GMIO_EISEL_LEMIRE_SHORT_NUMBER_MAX_DIGITS significant digits, so the
+ * resulting string has bounded length whatever the length of the input */
+struct gmio_eisel_lemire_short_number
+{
+    char str[GMIO_EISEL_LEMIRE_SHORT_NUMBER_MAX_DIGITS + 40];
+    /* Significant digits are stored at str + 3 */
+    size_t digit_count;
+    /* Power of ten applying to 0.digits, explicit exponent excluded */
+    int64_t digits_exponent;
+    /* Explicit exponent, after 'e' */
+    int64_t exp_number;
+    int state;
+    bool negative;
+    bool exp_negative;
+    bool has_digit;
+    /* Some non-zero digit was dropped */
+    bool sticky;
+};
+
+GMIO_INLINE void gmio_eisel_lemire_short_number_init(
+        struct gmio_eisel_lemire_short_number* num);
+
+/* Feeds next char \p c, returns false if \p c is not part of the number */
+GMIO_INLINE bool gmio_eisel_lemire_short_number_push(
+        struct gmio_eisel_lemire_short_number* num, char c);
+
+/* Returns the shortened number as a C string, or NULL if no number was fed */
+GMIO_INLINE const char* gmio_eisel_lemire_short_number_str(
+        struct gmio_eisel_lemire_short_number* num);
+
+/* Converts C string \p str to float, same semantics as strtof()
+ *
+ * Leading spaces are not skipped. If \p end_ptr is not \c NULL it receives the
+ * position after the number, or \p str if there is no number */
+GMIO_INLINE float gmio_eisel_lemire_strtof(const char* str, const char** end_ptr);
+
+
+
+/*
+ * -- Implementation
+ */
+
+#include "byte_swap.h"
+#include "c99_stdlib_compat.h"
+#include "string_ascii_utils.h"
+
+#include <float.h>
+#if defined(_MSC_VER) && defined(_M_X64)
+#  include <intrin.h>
+#endif
+
+/* 128-bit truncated approximations of 5^q, q in [-65, 38] : high 64 bits then
+ * low 64 bits */
+extern const uint64_t gmio_eisel_lemire_power_of_five_128[];
+
+enum {
+    GMIO_EISEL_LEMIRE_SMALLEST_POWER_OF_TEN = -65,
+    GMIO_EISEL_LEMIRE_LARGEST_POWER_OF_TEN = 38
+};
+
+/* Returns 8 chars starting at \p str, first char in the least significant
+ * byte */
+GMIO_INLINE uint64_t gmio_eisel_lemire_read8(const char* str)
+{
+    uint64_t val;
+    memcpy(&val, str, sizeof(uint64_t));
+#ifdef GMIO_HOST_IS_BIG_ENDIAN
+    val = ((uint64_t)gmio_uint32_bswap((uint32_t)val) << 32)
+            | gmio_uint32_bswap((uint32_t)(val >> 32));
+#endif
+    return val;
+}
+
+/* Are the 8 chars in \p val all decimal digits ? */
+GMIO_INLINE bool gmio_eisel_lemire_is_eight_digits(uint64_t val)
+{
+    return ((val & UINT64_C(0xF0F0F0F0F0F0F0F0))
+            | (((val + UINT64_C(0x0606060606060606))
+                & UINT64_C(0xF0F0F0F0F0F0F0F0)) >> 4))
+            == UINT64_C(0x3333333333333333);
+}
+
+/* Returns the value of the 8 decimal digits in \p val */
+GMIO_INLINE uint32_t gmio_eisel_lemire_parse_eight_digits(uint64_t val)
+{
+    const uint64_t mask = UINT64_C(0x000000FF000000FF);
+    const uint64_t mul1 = UINT64_C(0x000F424000000064); /* 100 + (1000000 << 32) */
+    const uint64_t mul2 = UINT64_C(0x0000271000000001); /* 1 + (10000 << 32) */
+    val -= UINT64_C(0x3030303030303030);
+    val = (val * 10) + (val >> 8); /* val = (val * 2561) >> 8; */
+    val = (((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)val;
+}
+
+/* Returns the count of leading zero bits in \p val, which must not be 0 */
+GMIO_INLINE int gmio_eisel_lemire_clz64(uint64_t val)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(val);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, val);
+    return 63 - (int)index;
+#else
+    int count = 0;
+    while ((val & (UINT64_C(1) << 63)) == 0) {
+        val <<= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/* Computes the 128-bit product of \p a and \p b */
+GMIO_INLINE void gmio_eisel_lemire_mul128(
+        uint64_t a, uint64_t b, uint64_t* high, uint64_t* low)
+{
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 gmio_uint128_t;
+    const gmio_uint128_t r = (gmio_uint128_t)a * b;
+    *high = (uint64_t)(r >> 64);
+    *low = (uint64_t)r;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *low = _umul128(a, b, high);
+#else
+    const uint64_t a_lo = (uint32_t)a;
+    const uint64_t a_hi = a >> 32;
+    const uint64_t b_lo = (uint32_t)b;
+    const uint64_t b_hi = b >> 32;
+    const uint64_t lo_lo = a_lo * b_lo;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi;
+    const uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    *high = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+    *low = (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+const char* gmio_eisel_lemire_parse(
+        const char* begin,
+        const char* end,
+        struct gmio_eisel_lemire_decimal* decimal)
+{
+    const char* it = begin;
+    const char* int_begin;
+    const char* int_end;
+    const char* frac_begin = NULL;
+    const char* frac_end = NULL;
+    uint64_t w = 0;
+    int64_t exp_number = 0; /* Explicit exponent, after 'e' */
+    int64_t exponent = 0;
+    size_t digit_count;
+
+    decimal->mantissa = 0;
+    decimal->exponent = 0;
+    decimal->negative = it != end && *it == '-';
+    decimal->too_many_digits = false;
+    if (it != end && (*it == '-' || *it == '+'))
+        ++it;
+
+    /* Integer part */
+    int_begin = it;
+    while (it != end && gmio_ascii_isdigit(*it)) {
+        w = 10 * w + (uint64_t)(*it - '0');
+        ++it;
+    }
+    int_end = it;
+    digit_count = int_end - int_begin;
+
+    /* Fractional part */
+    if (it != end && *it == '.') {
+        ++it;
+        frac_begin = it;
+        while (end - it >= 8
+               && gmio_eisel_lemire_is_eight_digits(gmio_eisel_lemire_read8(it)))
+        {
+            w = 100000000 * w
+                    + gmio_eisel_lemire_parse_eight_digits(
+                        gmio_eisel_lemire_read8(it));
+            it += 8;
+        }
+        while (it != end && gmio_ascii_isdigit(*it)) {
+            w = 10 * w + (uint64_t)(*it - '0');
+            ++it;
+        }
+        frac_end = it;
+        exponent = frac_begin - frac_end;
+        digit_count += frac_end - frac_begin;
+    }
+    if (digit_count == 0)
+        return begin;
+
+    /* Exponent part */
+    if (it != end && (*it == 'e' || *it == 'E')) {
+        const char* exp_begin = it;
+        bool exp_negative = false;
+        ++it;
+        if (it != end && (*it == '-' || *it == '+')) {
+            exp_negative = *it == '-';
+            ++it;
+        }
+        if (it == end || !gmio_ascii_isdigit(*it)) {
+            it = exp_begin; /* Not an exponent, leave 'e' unparsed */
+        }
+        else {
+            while (it != end && gmio_ascii_isdigit(*it)) {
+                if (exp_number < 0x10000)
+                    exp_number = 10 * exp_number + (*it - '0');
+                ++it;
+            }
+            if (exp_negative)
+                exp_number = -exp_number;
+            exponent += exp_number;
+        }
+    }
+
+    /* w may have overflowed, then keep only the 19 first significant digits */
+    if (digit_count > 19) {
+        const char* start = int_begin;
+        while (start != end && (*start == '0' || *start == '.')) {
+            if (*start == '0')
+                --digit_count;
+            ++start;
+        }
+        if (digit_count > 19) {
+            static const uint64_t min_19_digit_integer =
+                    UINT64_C(1000000000000000000);
+            const char* digit = int_begin;
+            decimal->too_many_digits = true;
+            w = 0;
+            while (w < min_19_digit_integer && digit != int_end) {
+                w = 10 * w + (uint64_t)(*digit - '0');
+                ++digit;
+            }
+            if (w >= min_19_digit_integer) { /* Integer part is big enough */
+                exponent = (int_end - digit) + exp_number;
+            }
+            else {
+                digit = frac_begin;
+                while (w < min_19_digit_integer && digit != frac_end) {
+                    w = 10 * w + (uint64_t)(*digit - '0');
+                    ++digit;
+                }
+                exponent = (frac_begin - digit) + exp_number;
+            }
+        }
+    }
+
+    decimal->mantissa = w;
+    decimal->exponent = exponent;
+    return it;
+}
+
+float gmio_eisel_lemire_to_float32(uint64_t w, int64_t q, bool negative)
+{
+    /* Parameters of the float32 binary format */
+    enum {
+        mantissa_explicit_bits = 23,
+        minimum_exponent = -127,
+        infinite_power = 0xFF,
+        min_exponent_round_to_even = -17,
+        max_exponent_round_to_even = 10
+    };
+    uint64_t mantissa;
+    int32_t power2;
+    uint32_t bits;
+    float value;
+
+    if (w == 0 || q < GMIO_EISEL_LEMIRE_SMALLEST_POWER_OF_TEN) {
+        mantissa = 0;
+        power2 = 0;
+    }
+    else if (q > GMIO_EISEL_LEMIRE_LARGEST_POWER_OF_TEN) {
+        mantissa = 0;
+        power2 = infinite_power;
+    }
+    else {
+        /* Product of normalized w with 128-bit approximation of 5^q */
+        const uint64_t* pow5 =
+                &gmio_eisel_lemire_power_of_five_128[
+                    2 * (q - GMIO_EISEL_LEMIRE_SMALLEST_POWER_OF_TEN)];
+        const uint64_t precision_mask =
+                UINT64_C(0xFFFFFFFFFFFFFFFF) >> (mantissa_explicit_bits + 3);
+        const int lz = gmio_eisel_lemire_clz64(w);
+        uint64_t high;
+        uint64_t low;
+        int upperbit;
+        int shift;
+        w <<= lz;
+        gmio_eisel_lemire_mul128(w, pow5[0], &high, &low);
+        if ((high & precision_mask) == precision_mask) {
+            uint64_t high2;
+            uint64_t low2;
+            gmio_eisel_lemire_mul128(w, pow5[1], &high2, &low2);
+            low += high2;
+            if (high2 > low)
+                ++high;
+        }
+
+        upperbit = (int)(high >> 63);
+        shift = upperbit + 64 - mantissa_explicit_bits - 3;
+        mantissa = high >> shift;
+        /* power(q) == floor(q * log2(10)) + 63 */
+        power2 = (int32_t)(((((152170 + 65536) * q) >> 16) + 63)
+                           + upperbit - lz - minimum_exponent);
+
+        if (power2 <= 0) { /* Subnormal */
+            if (-power2 + 1 >= 64) {
+                mantissa = 0;
+                power2 = 0;
+            }
+            else {
+                mantissa >>= -power2 + 1;
+                mantissa += (mantissa & 1);
+                mantissa >>= 1;
+                power2 =
+                        mantissa < (UINT64_C(1) << mantissa_explicit_bits) ?
+                            0 : 1;
+            }
+        }
+        else {
+            /* Exactly halfway between two floats : round to even */
+            if (low <= 1
+                    && q >= min_exponent_round_to_even
+                    && q <= max_exponent_round_to_even
+                    && (mantissa & 3) == 1
+                    && (mantissa << shift) == high)
+            {
+                mantissa &= ~UINT64_C(1);
+            }
+            mantissa += (mantissa & 1);
+            mantissa >>= 1;
+            if (mantissa >= (UINT64_C(2) << mantissa_explicit_bits)) {
+                mantissa = UINT64_C(1) << mantissa_explicit_bits;
+                ++power2;
+            }
+            mantissa &= ~(UINT64_C(1) << mantissa_explicit_bits);
+            if (power2 >= infinite_power) {
+                mantissa = 0;
+                power2 = infinite_power;
+            }
+        }
+    }
+
+    bits = (uint32_t)mantissa
+            | ((uint32_t)power2 << mantissa_explicit_bits)
+            | (negative ? UINT32_C(0x80000000) : 0);
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+float gmio_eisel_lemire_decimal_to_float32(
+        const struct gmio_eisel_lemire_decimal* decimal,
+        const char* begin,
+        const char* end)
+{
+    const float value =
+            gmio_eisel_lemire_to_float32(
+                decimal->mantissa, decimal->exponent, decimal->negative);
+    const float value_up =
+            decimal->too_many_digits ?
+                gmio_eisel_lemire_to_float32(
+                    decimal->mantissa + 1, decimal->exponent, decimal->negative) :
+                value;
+    if (memcmp(&value, &value_up, sizeof(float)) != 0) {
+        /* Truncated digits matter, rely on the C library */
+        struct gmio_eisel_lemire_short_number num;
+        const char* str;
+        gmio_eisel_lemire_short_number_init(&num);
+        while (begin != end && gmio_eisel_lemire_short_number_push(&num, *begin))
+            ++begin;
+        str = gmio_eisel_lemire_short_number_str(&num);
+        if (str != NULL)
+            return gmio_strtof(str, NULL);
+    }
+    return value;
+}
+
+enum gmio_eisel_lemire_short_number_state {
+    GMIO_EISEL_LEMIRE_SHORT_NUMBER_START,
+    GMIO_EISEL_LEMIRE_SHORT_NUMBER_INT,
+    GMIO_EISEL_LEMIRE_SHORT_NUMBER_FRAC,
+    GMIO_EISEL_LEMIRE_SHORT_NUMBER_EXP_START,
+    GMIO_EISEL_LEMIRE_SHORT_NUMBER_EXP_SIGN,
+    GMIO_EISEL_LEMIRE_SHORT_NUMBER_EXP,
+    GMIO_EISEL_LEMIRE_SHORT_NUMBER_END
+};
+
+void gmio_eisel_lemire_short_number_init(
+        struct gmio_eisel_lemire_short_number* num)
+{
+    num->digit_count = 0;
+    num->digits_exponent = 0;
+    num->exp_number = 0;
+    num->state = GMIO_EISEL_LEMIRE_SHORT_NUMBER_START;
+    num->negative = false;
+    num->exp_negative = false;
+    num->has_digit = false;
+    num->sticky = false;
+}
+
+/* Handles mantissa digit \p c */
+GMIO_INLINE void gmio_eisel_lemire_short_number_push_digit(
+        struct gmio_eisel_lemire_short_number* num, char c)
+{
+    const bool in_int = num->state == GMIO_EISEL_LEMIRE_SHORT_NUMBER_INT;
+    num->has_digit = true;
+    if (num->digit_count == 0 && c == '0') {
+        /* Leading zero */
+        if (!in_int)
+            --num->digits_exponent;
+    }
+    else {
+        if (num->digit_count < GMIO_EISEL_LEMIRE_SHORT_NUMBER_MAX_DIGITS)
+            num->str[3 + num->digit_count++] = c;
+        else if (c != '0')
+            num->sticky = true;
+        if (in_int)
+            ++num->digits_exponent;
+    }
+}
+
+bool gmio_eisel_lemire_short_number_push(
+        struct gmio_eisel_lemire_short_number* num, char c)
+{
+    const bool is_digit = gmio_ascii_isdigit(c);
+    const bool is_sign = c == '-' || c == '+';
+    const bool is_exp = c == 'e' || c == 'E';
+    switch (num->state) {
+    case GMIO_EISEL_LEMIRE_SHORT_NUMBER_START:
+        num->state = GMIO_EISEL_LEMIRE_SHORT_NUMBER_INT;
+        if (is_sign) {
+            num->negative = c == '-';
+            break;
+        }
+        return gmio_eisel_lemire_short_number_push(num, c);
+    case GMIO_EISEL_LEMIRE_SHORT_NUMBER_INT:
+    case GMIO_EISEL_LEMIRE_SHORT_NUMBER_FRAC:
+        if (is_digit) {
+            gmio_eisel_lemire_short_number_push_digit(num, c);
+        }
+        else if (c == '.'
+                 && num->state == GMIO_EISEL_LEMIRE_SHORT_NUMBER_INT)
+        {
+            num->state = GMIO_EISEL_LEMIRE_SHORT_NUMBER_FRAC;
+        }
+        else if (is_exp && num->has_digit) {
+            num->state = GMIO_EISEL_LEMIRE_SHORT_NUMBER_EXP_START;
+        }
+        else {
+            num->state = GMIO_EISEL_LEMIRE_SHORT_NUMBER_END;
+            return false;
+        }
+        break;
+    case GMIO_EISEL_LEMIRE_SHORT_NUMBER_EXP_START:
+        if (is_sign) {
+            num->exp_negative = c == '-';
+            num->state = GMIO_EISEL_LEMIRE_SHORT_NUMBER_EXP_SIGN;
+            break;
+        }
+        /* Fallthrough */
+    case GMIO_EISEL_LEMIRE_SHORT_NUMBER_EXP_SIGN:
+    case GMIO_EISEL_LEMIRE_SHORT_NUMBER_EXP:
+        if (!is_digit) {
+            num->state = GMIO_EISEL_LEMIRE_SHORT_NUMBER_END;
+            return false;
+        }
+        num->state = GMIO_EISEL_LEMIRE_SHORT_NUMBER_EXP;
+        if (num->exp_number < 0x10000)
+            num->exp_number = 10 * num->exp_number + (c - '0');
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+const char* gmio_eisel_lemire_short_number_str(
+        struct gmio_eisel_lemire_short_number* num)
+{
+    char* it = num->str + 3 + num->digit_count;
+    char exp_digits[24];
+    size_t exp_len = 0;
+    uint64_t exp_abs;
+    const int64_t exp =
+            num->digits_exponent
+            + (num->exp_negative ? -num->exp_number : num->exp_number);
+
+    if (!num->has_digit)
+        return NULL;
+
+    num->str[0] = num->negative ? '-' : '+';
+    num->str[1] = '0';
+    num->str[2] = '.';
+    if (num->digit_count == 0)
+        *it++ = '0';
+    if (num->sticky)
+        *it++ = '1';
+    *it++ = 'e';
+    if (exp < 0)
+        *it++ = '-';
+    exp_abs = exp < 0 ? (uint64_t)-exp : (uint64_t)exp;
+    do {
+        exp_digits[exp_len++] = (char)('0' + exp_abs % 10);
+        exp_abs /= 10;
+    } while (exp_abs != 0);
+    while (exp_len != 0)
+        *it++ = exp_digits[--exp_len];
+    *it = '\0';
+    return num->str;
+}
+
+float gmio_eisel_lemire_strtof(const char* str, const char** end_ptr)
+{
+    struct gmio_eisel_lemire_decimal decimal = {0};
+    const char* end = str + strlen(str);
+    const char* number_end = gmio_eisel_lemire_parse(str, end, &decimal);
+    if (end_ptr != NULL)
+        *end_ptr = number_end;
+    if (number_end == str)
+        return 0.f;
+    return gmio_eisel_lemire_decimal_to_float32(&decimal, str, number_end);
+}
@@ -38,6 +38,8 @@
 #  include "c99_stdio_compat.h"
 #elif GMIO_FLOAT2STR_LIB == GMIO_FLOAT2STR_LIB_DOUBLE_CONVERSION
 #  include "google_doubleconversion.h"
+#elif GMIO_FLOAT2STR_LIB == GMIO_FLOAT2STR_LIB_RYU
+#  include "ryu.h"
 #endif
 
 #include <string.h>
@@ -180,6 +182,13 @@ void gmio_ostringstream_write_f64(
                 buff->capacity - buff->len,
                 nformat->text_format,
                 nformat->precision);
+#elif GMIO_FLOAT2STR_LIB == GMIO_FLOAT2STR_LIB_RYU
+    written_count = gmio_double2str_ryu(
+                value,
+                buff->ptr + buff->len,
+                buff->capacity - buff->len,
+                nformat->text_format,
+                nformat->precision);
 #endif
     buff->len += written_count;
 }
@@ -0,0 +1,767 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "ryu.h"
+
+#include "c99_stdio_compat.h"
+#include "convert.h"
+#include "float_format_utils.h"
+
+#include <float.h>
+#include <string.h>
+
+enum {
+    GMIO_RYU_FLOAT_MANTISSA_BITS = 23,
+    GMIO_RYU_FLOAT_BIAS = 127,
+    GMIO_RYU_FLOAT_POW5_INV_BITCOUNT = 59,
+    GMIO_RYU_FLOAT_POW5_BITCOUNT = 61,
+    /* Max significant digits needed to read back any float32 */
+    GMIO_RYU_FLOAT_MAX_DIGITS = 9,
+    /* Max precision handled without snprintf() */
+    GMIO_RYU_PREC_MAX = 17,
+    /* Max length of texts produced without snprintf() */
+    GMIO_RYU_STR_MAX_LEN = 64
+};
+
+/* floor(2^(pow5bits(i) - 1 + 59) / 5^i) + 1 */
+static const uint64_t gmio_ryu_float_pow5_inv_split[] = {
+    UINT64_C(576460752303423489), UINT64_C(461168601842738791),
+    UINT64_C(368934881474191033), UINT64_C(295147905179352826),
+    UINT64_C(472236648286964522), UINT64_C(377789318629571618),
+    UINT64_C(302231454903657294), UINT64_C(483570327845851670),
+    UINT64_C(386856262276681336), UINT64_C(309485009821345069),
+    UINT64_C(495176015714152110), UINT64_C(396140812571321688),
+    UINT64_C(316912650057057351), UINT64_C(507060240091291761),
+    UINT64_C(405648192073033409), UINT64_C(324518553658426727),
+    UINT64_C(519229685853482763), UINT64_C(415383748682786211),
+    UINT64_C(332306998946228969), UINT64_C(531691198313966350),
+    UINT64_C(425352958651173080), UINT64_C(340282366920938464),
+    UINT64_C(544451787073501542), UINT64_C(435561429658801234),
+    UINT64_C(348449143727040987), UINT64_C(557518629963265579),
+    UINT64_C(446014903970612463), UINT64_C(356811923176489971),
+    UINT64_C(570899077082383953), UINT64_C(456719261665907162),
+    UINT64_C(365375409332725730),
+};
+
+/* 61 most significant bits of 5^i */
+static const uint64_t gmio_ryu_float_pow5_split[] = {
+    UINT64_C(1152921504606846976), UINT64_C(1441151880758558720),
+    UINT64_C(1801439850948198400), UINT64_C(2251799813685248000),
+    UINT64_C(1407374883553280000), UINT64_C(1759218604441600000),
+    UINT64_C(2199023255552000000), UINT64_C(1374389534720000000),
+    UINT64_C(1717986918400000000), UINT64_C(2147483648000000000),
+    UINT64_C(1342177280000000000), UINT64_C(1677721600000000000),
+    UINT64_C(2097152000000000000), UINT64_C(1310720000000000000),
+    UINT64_C(1638400000000000000), UINT64_C(2048000000000000000),
+    UINT64_C(1280000000000000000), UINT64_C(1600000000000000000),
+    UINT64_C(2000000000000000000), UINT64_C(1250000000000000000),
+    UINT64_C(1562500000000000000), UINT64_C(1953125000000000000),
+    UINT64_C(1220703125000000000), UINT64_C(1525878906250000000),
+    UINT64_C(1907348632812500000), UINT64_C(1192092895507812500),
+    UINT64_C(1490116119384765625), UINT64_C(1862645149230957031),
+    UINT64_C(1164153218269348144), UINT64_C(1455191522836685180),
+    UINT64_C(1818989403545856475), UINT64_C(2273736754432320594),
+    UINT64_C(1421085471520200371), UINT64_C(1776356839400250464),
+    UINT64_C(2220446049250313080), UINT64_C(1387778780781445675),
+    UINT64_C(1734723475976807094), UINT64_C(2168404344971008868),
+    UINT64_C(1355252715606880542), UINT64_C(1694065894508600678),
+    UINT64_C(2117582368135750847), UINT64_C(1323488980084844279),
+    UINT64_C(1654361225106055349), UINT64_C(2067951531382569187),
+    UINT64_C(1292469707114105741), UINT64_C(1615587133892632177),
+    UINT64_C(2019483917365790221), UINT64_C(1262177448353618888),
+};
+
+/* Powers of 5 and 10 that fit in 64 bits */
+static const uint64_t gmio_ryu_pow5[] = {
+    UINT64_C(1), UINT64_C(5),
+    UINT64_C(25), UINT64_C(125),
+    UINT64_C(625), UINT64_C(3125),
+    UINT64_C(15625), UINT64_C(78125),
+    UINT64_C(390625), UINT64_C(1953125),
+    UINT64_C(9765625), UINT64_C(48828125),
+    UINT64_C(244140625), UINT64_C(1220703125),
+    UINT64_C(6103515625), UINT64_C(30517578125),
+    UINT64_C(152587890625), UINT64_C(762939453125),
+    UINT64_C(3814697265625), UINT64_C(19073486328125),
+    UINT64_C(95367431640625), UINT64_C(476837158203125),
+    UINT64_C(2384185791015625), UINT64_C(11920928955078125),
+    UINT64_C(59604644775390625), UINT64_C(298023223876953125),
+    UINT64_C(1490116119384765625), UINT64_C(7450580596923828125),
+};
+static const uint64_t gmio_ryu_pow10[] = {
+    UINT64_C(1), UINT64_C(10),
+    UINT64_C(100), UINT64_C(1000),
+    UINT64_C(10000), UINT64_C(100000),
+    UINT64_C(1000000), UINT64_C(10000000),
+    UINT64_C(100000000), UINT64_C(1000000000),
+    UINT64_C(10000000000), UINT64_C(100000000000),
+    UINT64_C(1000000000000), UINT64_C(10000000000000),
+    UINT64_C(100000000000000), UINT64_C(1000000000000000),
+    UINT64_C(10000000000000000), UINT64_C(100000000000000000),
+    UINT64_C(1000000000000000000), UINT64_C(10000000000000000000),
+};
+
+static const char gmio_ryu_digit_table[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+/* Returns ceil(log2(5^e)) for e > 0, 1 for e == 0 */
+GMIO_INLINE int32_t gmio_ryu_pow5bits(int32_t e)
+{
+    return (int32_t)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+/* Returns floor(log10(2^e)), e >= 0 */
+GMIO_INLINE uint32_t gmio_ryu_log10_pow2(int32_t e)
+{
+    return ((uint32_t)e * 78913) >> 18;
+}
+
+/* Returns floor(log10(5^e)), e >= 0 */
+GMIO_INLINE uint32_t gmio_ryu_log10_pow5(int32_t e)
+{
+    return ((uint32_t)e * 732923) >> 20;
+}
+
+GMIO_INLINE bool gmio_ryu_is_multiple_of_pow5(uint32_t value, uint32_t p)
+{
+    uint32_t count = 0;
+    while (value % 5 == 0 && count < p) {
+        value /= 5;
+        ++count;
+    }
+    return count >= p;
+}
+
+GMIO_INLINE bool gmio_ryu_is_multiple_of_pow2(uint32_t value, uint32_t p)
+{
+    return (value & ((UINT32_C(1) << p) - 1)) == 0;
+}
+
+/* Returns (m * factor) >> shift, shift being in [33, 95] */
+GMIO_INLINE uint32_t gmio_ryu_mul_shift(
+        uint32_t m, uint64_t factor, int32_t shift)
+{
+    const uint64_t bits0 = (uint64_t)m * (uint32_t)factor;
+    const uint64_t bits1 = (uint64_t)m * (uint32_t)(factor >> 32);
+    const uint64_t sum = (bits0 >> 32) + bits1;
+    return (uint32_t)(sum >> (shift - 32));
+}
+
+struct gmio_ryu_decimal32 gmio_ryu_f2d(float value)
+{
+    const uint32_t bits = gmio_convert_uint32(value);
+    const uint32_t ieee_mantissa =
+            bits & ((UINT32_C(1) << GMIO_RYU_FLOAT_MANTISSA_BITS) - 1);
+    const uint32_t ieee_exponent = (bits >> GMIO_RYU_FLOAT_MANTISSA_BITS) & 0xFF;
+    struct gmio_ryu_decimal32 decimal = {0};
+    int32_t e2;
+    uint32_t m2;
+    bool accept_bounds;
+    uint32_t mv, mp, mm, mm_shift;
+    uint32_t vr, vp, vm;
+    int32_t e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    uint32_t last_removed_digit = 0;
+    int32_t removed = 0;
+
+    if (ieee_mantissa == 0 && ieee_exponent == 0)
+        return decimal;
+
+    /* Step 1: decode value as m2 * 2^e2, with two extra bits for the
+     * boundaries */
+    if (ieee_exponent == 0) {
+        e2 = 1 - GMIO_RYU_FLOAT_BIAS - GMIO_RYU_FLOAT_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    }
+    else {
+        e2 = (int32_t)ieee_exponent
+                - GMIO_RYU_FLOAT_BIAS - GMIO_RYU_FLOAT_MANTISSA_BITS - 2;
+        m2 = (UINT32_C(1) << GMIO_RYU_FLOAT_MANTISSA_BITS) | ieee_mantissa;
+    }
+    accept_bounds = (m2 & 1) == 0;
+
+    /* Step 2: interval of values that read back to the float */
+    mv = 4 * m2;
+    mp = 4 * m2 + 2;
+    mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    mm = 4 * m2 - 1 - mm_shift;
+
+    /* Step 3: convert the interval bounds to a decimal power base */
+    if (e2 >= 0) {
+        const uint32_t q = gmio_ryu_log10_pow2(e2);
+        const int32_t k =
+                GMIO_RYU_FLOAT_POW5_INV_BITCOUNT
+                + gmio_ryu_pow5bits((int32_t)q) - 1;
+        const int32_t i = -e2 + (int32_t)q + k;
+        const uint64_t factor = gmio_ryu_float_pow5_inv_split[q];
+        e10 = (int32_t)q;
+        vr = gmio_ryu_mul_shift(mv, factor, i);
+        vp = gmio_ryu_mul_shift(mp, factor, i);
+        vm = gmio_ryu_mul_shift(mm, factor, i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            /* One removed digit is needed even if the loop below doesn't
+             * run */
+            const int32_t l =
+                    GMIO_RYU_FLOAT_POW5_INV_BITCOUNT
+                    + gmio_ryu_pow5bits((int32_t)(q - 1)) - 1;
+            last_removed_digit =
+                    gmio_ryu_mul_shift(
+                        mv,
+                        gmio_ryu_float_pow5_inv_split[q - 1],
+                        -e2 + (int32_t)q - 1 + l) % 10;
+        }
+        if (q <= 9) {
+            /* Only one of mp, mv and mm can be a multiple of 5, if any */
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = gmio_ryu_is_multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = gmio_ryu_is_multiple_of_pow5(mm, q);
+            else
+                vp -= gmio_ryu_is_multiple_of_pow5(mp, q);
+        }
+    }
+    else {
+        const uint32_t q = gmio_ryu_log10_pow5(-e2);
+        const int32_t i = -e2 - (int32_t)q;
+        const int32_t k = gmio_ryu_pow5bits(i) - GMIO_RYU_FLOAT_POW5_BITCOUNT;
+        const int32_t j = (int32_t)q - k;
+        const uint64_t factor = gmio_ryu_float_pow5_split[i];
+        e10 = (int32_t)q + e2;
+        vr = gmio_ryu_mul_shift(mv, factor, j);
+        vp = gmio_ryu_mul_shift(mp, factor, j);
+        vm = gmio_ryu_mul_shift(mm, factor, j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            const int32_t l =
+                    (int32_t)q - 1
+                    - (gmio_ryu_pow5bits(i + 1) - GMIO_RYU_FLOAT_POW5_BITCOUNT);
+            last_removed_digit =
+                    gmio_ryu_mul_shift(
+                        mv, gmio_ryu_float_pow5_split[i + 1], l) % 10;
+        }
+        if (q <= 1) {
+            /* mv = 4 * m2 always has at least two trailing 0 bits */
+            vr_is_trailing_zeros = true;
+            if (accept_bounds)
+                vm_is_trailing_zeros = mm_shift == 1;
+            else
+                --vp; /* mp = mv + 2 always has a trailing 0 bit */
+        }
+        else if (q < 31) {
+            vr_is_trailing_zeros = gmio_ryu_is_multiple_of_pow2(mv, q - 1);
+        }
+    }
+
+    /* Step 4: find the shortest decimal in the interval */
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        /* General case, rare */
+        while (vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_is_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4; /* Round to even */
+        decimal.digits =
+                vr
+                + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros))
+                   || last_removed_digit >= 5);
+    }
+    else {
+        /* Common case */
+        while (vp / 10 > vm / 10) {
+            last_removed_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        decimal.digits = vr + (vr == vm || last_removed_digit >= 5);
+    }
+    decimal.exponent = e10 + removed;
+    return decimal;
+}
+
+/*
+ * Fixed-precision conversion
+ */
+
+/* Returns the count of decimal digits of \p value */
+GMIO_INLINE unsigned gmio_ryu_digit_count(uint64_t value)
+{
+    unsigned count = 1;
+    while (count < 20 && value >= gmio_ryu_pow10[count])
+        ++count;
+    return count;
+}
+
+/* Returns the count of significant bits of \p value */
+GMIO_INLINE int32_t gmio_ryu_bit_count(uint32_t value)
+{
+    int32_t count = 0;
+    while (value != 0) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+/* Rounds quotient \p num / \p den to nearest, ties to even */
+GMIO_INLINE uint64_t gmio_ryu_div_round(uint64_t num, uint64_t den)
+{
+    const uint64_t quo = num / den;
+    const uint64_t rem = num - quo * den;
+    const uint64_t rem_complement = den - rem;
+    if (rem > rem_complement || (rem == rem_complement && (quo & 1) != 0))
+        return quo + 1;
+    return quo;
+}
+
+/* Rounds 128-bit (hi, lo) / 2^shift to nearest, ties to even
+ *
+ * Returns false if the result doesn't fit in 64 bits */
+static bool gmio_ryu_shift_round(
+        uint64_t hi, uint64_t lo, uint32_t shift, uint64_t* result)
+{
+    uint64_t quo, rem_hi, rem_lo, half_hi, half_lo;
+    if (shift == 0) {
+        *result = lo;
+        return hi == 0;
+    }
+    if (shift > 128) { /* (hi, lo) < 2^(shift - 1) */
+        *result = 0;
+        return true;
+    }
+    if (shift < 64) {
+        if ((hi >> shift) != 0)
+            return false;
+        quo = (lo >> shift) | (hi << (64 - shift));
+        rem_hi = 0;
+        rem_lo = lo & ((UINT64_C(1) << shift) - 1);
+        half_hi = 0;
+        half_lo = UINT64_C(1) << (shift - 1);
+    }
+    else if (shift < 128) {
+        quo = hi >> (shift - 64);
+        rem_hi = shift != 64 ? hi & ((UINT64_C(1) << (shift - 64)) - 1) : 0;
+        rem_lo = lo;
+        half_hi = shift != 64 ? UINT64_C(1) << (shift - 65) : 0;
+        half_lo = shift != 64 ? 0 : UINT64_C(1) << 63;
+    }
+    else {
+        quo = 0;
+        rem_hi = hi;
+        rem_lo = lo;
+        half_hi = UINT64_C(1) << 63;
+        half_lo = 0;
+    }
+    if (rem_hi > half_hi || (rem_hi == half_hi && rem_lo > half_lo))
+        ++quo;
+    else if (rem_hi == half_hi && rem_lo == half_lo)
+        quo += quo & 1;
+    *result = quo;
+    return true;
+}
+
+/* Computes round(m * 2^e2 * 10^s), ties to even
+ *
+ * Returns false if the computation can't be done with 64-bit integers */
+static bool gmio_ryu_scale_round(
+        uint32_t m, int32_t e2, int32_t s, uint64_t* result)
+{
+    if (s >= 0) {
+        /* m * 5^s * 2^(e2 + s) */
+        const int32_t e = e2 + s;
+        uint64_t pow5, lo, hi, mid;
+        if (s >= (int32_t)(GMIO_ARRAY_SIZE(gmio_ryu_pow5)))
+            return false;
+        pow5 = gmio_ryu_pow5[s];
+        lo = (uint64_t)m * (uint32_t)pow5;
+        mid = (lo >> 32) + (uint64_t)m * (uint32_t)(pow5 >> 32);
+        lo = (mid << 32) | (uint32_t)lo;
+        hi = mid >> 32;
+        if (e >= 0) {
+            if (hi != 0 || e >= 64 || (e != 0 && (lo >> (64 - e)) != 0))
+                return false;
+            *result = lo << e;
+            return true;
+        }
+        return gmio_ryu_shift_round(hi, lo, (uint32_t)(-e), result);
+    }
+    else {
+        /* m * 2^e2 / 10^-s */
+        uint64_t num, den;
+        if (-s >= (int32_t)(GMIO_ARRAY_SIZE(gmio_ryu_pow10)))
+            return false;
+        den = gmio_ryu_pow10[-s];
+        if (e2 >= 0) {
+            if (e2 >= 40) /* m < 2^24 */
+                return false;
+            num = (uint64_t)m << e2;
+        }
+        else {
+            if (e2 <= -64 || (den >> (64 + e2)) != 0)
+                return false;
+            num = m;
+            den <<= -e2;
+        }
+        *result = gmio_ryu_div_round(num, den);
+        return true;
+    }
+}
+
+/* Computes the \p digit_count significant digits of m * 2^e2 rounded to
+ * nearest(ties to even), and the decimal exponent of the first one */
+static bool gmio_ryu_scale_round_significant(
+        uint32_t m,
+        int32_t e2,
+        unsigned digit_count,
+        uint64_t* digits,
+        int32_t* exponent)
+{
+    const uint64_t digits_end = gmio_ryu_pow10[digit_count];
+    int32_t log2 = e2 + gmio_ryu_bit_count(m) - 1;
+    int32_t log10;
+    if (m == 0) {
+        *digits = 0;
+        *exponent = 0;
+        return true;
+    }
+    /* Estimate floor(log10(value)), it can be one less than the exact one */
+    if (log2 >= 0)
+        log10 = (int32_t)(((uint32_t)log2 * 78913) >> 18);
+    else
+        log10 = -(int32_t)(((uint32_t)(-log2) * 78913) >> 18) - 1;
+    if (!gmio_ryu_scale_round(m, e2, (int32_t)digit_count - 1 - log10, digits))
+        return false;
+    if (*digits >= digits_end) {
+        ++log10;
+        if (!gmio_ryu_scale_round(
+                    m, e2, (int32_t)digit_count - 1 - log10, digits))
+        {
+            return false;
+        }
+    }
+    if (*digits >= digits_end) { /* Rounding up to a power of 10 */
+        *digits /= 10;
+        ++log10;
+    }
+    *exponent = log10;
+    return true;
+}
+
+/* Writes the \p count lowest decimal digits of \p value */
+GMIO_INLINE char* gmio_ryu_write_digits(char* buff, uint64_t value, unsigned count)
+{
+    char* it = buff + count;
+    while (it - buff >= 2) {
+        const unsigned pos = (unsigned)(value % 100) * 2;
+        value /= 100;
+        it -= 2;
+        it[0] = gmio_ryu_digit_table[pos];
+        it[1] = gmio_ryu_digit_table[pos + 1];
+    }
+    if (it != buff)
+        *buff = (char)('0' + value % 10);
+    return buff + count;
+}
+
+/* Writes decimal digits * 10^-decimal_count in fixed-point notation */
+static char* gmio_ryu_write_fixed(
+        char* buff, uint64_t digits, unsigned decimal_count)
+{
+    uint64_t int_part = 0;
+    uint64_t frac_part = digits;
+    if (decimal_count < GMIO_ARRAY_SIZE(gmio_ryu_pow10)) {
+        int_part = digits / gmio_ryu_pow10[decimal_count];
+        frac_part = digits - int_part * gmio_ryu_pow10[decimal_count];
+    }
+    buff = gmio_ryu_write_digits(buff, int_part, gmio_ryu_digit_count(int_part));
+    if (decimal_count != 0) {
+        *buff++ = '.';
+        buff = gmio_ryu_write_digits(buff, frac_part, decimal_count);
+    }
+    return buff;
+}
+
+/* Writes d.ddd * 10^exponent in scientific notation, where \p digits holds
+ * 1 + \p decimal_count decimal digits */
+static char* gmio_ryu_write_scientific(
+        char* buff,
+        uint64_t digits,
+        unsigned decimal_count,
+        int32_t exponent,
+        char exp_char)
+{
+    buff = gmio_ryu_write_fixed(buff, digits, decimal_count);
+    *buff++ = exp_char;
+    if (exponent < 0) {
+        *buff++ = '-';
+        exponent = -exponent;
+    }
+    else {
+        *buff++ = '+';
+    }
+    if (exponent >= 100)
+        return gmio_ryu_write_digits(buff, (uint64_t)exponent, 3);
+    return gmio_ryu_write_digits(buff, (uint64_t)exponent, 2);
+}
+
+/* Writes \p digits * 10^exponent(\p digit_count digits) as printf() "%g"
+ * does with precision \p prec, trailing zeros being removed */
+static char* gmio_ryu_write_general(
+        char* buff,
+        uint64_t digits,
+        unsigned digit_count,
+        int32_t exponent,
+        unsigned prec,
+        char exp_char)
+{
+    while (digit_count > 1 && digits % 10 == 0) {
+        digits /= 10;
+        --digit_count;
+    }
+    if ((int32_t)prec > exponent && exponent >= -4) {
+        const int32_t decimal_count = (int32_t)digit_count - 1 - exponent;
+        if (decimal_count < 0) {
+            buff = gmio_ryu_write_digits(buff, digits, digit_count);
+            memset(buff, '0', (size_t)(-decimal_count));
+            return buff - decimal_count;
+        }
+        return gmio_ryu_write_fixed(buff, digits, (unsigned)decimal_count);
+    }
+    return gmio_ryu_write_scientific(
+                buff, digits, digit_count - 1, exponent, exp_char);
+}
+
+/* Writes value(2^e2 * m) with printf() format "%.<prec><spec>"
+ *
+ * Returns the end of the written text or NULL if snprintf() must be used */
+static char* gmio_ryu_write_prec(
+        char* buff,
+        uint32_t m,
+        int32_t e2,
+        enum gmio_float_text_format textformat,
+        unsigned prec,
+        char exp_char)
+{
+    uint64_t digits;
+    int32_t exponent;
+    switch (textformat) {
+    case GMIO_FLOAT_TEXT_FORMAT_DECIMAL_LOWERCASE:
+    case GMIO_FLOAT_TEXT_FORMAT_DECIMAL_UPPERCASE:
+        if (!gmio_ryu_scale_round(m, e2, (int32_t)prec, &digits))
+            return NULL;
+        return gmio_ryu_write_fixed(buff, digits, prec);
+    case GMIO_FLOAT_TEXT_FORMAT_SCIENTIFIC_LOWERCASE:
+    case GMIO_FLOAT_TEXT_FORMAT_SCIENTIFIC_UPPERCASE:
+        if (!gmio_ryu_scale_round_significant(
+                    m, e2, prec + 1, &digits, &exponent))
+        {
+            return NULL;
+        }
+        return gmio_ryu_write_scientific(
+                    buff, digits, prec, exponent, exp_char);
+    case GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE:
+    case GMIO_FLOAT_TEXT_FORMAT_SHORTEST_UPPERCASE:
+        prec = prec != 0 ? prec : 1;
+        if (!gmio_ryu_scale_round_significant(
+                    m, e2, prec, &digits, &exponent))
+        {
+            return NULL;
+        }
+        return gmio_ryu_write_general(
+                    buff, digits, prec, exponent, prec, exp_char);
+    }
+    return NULL;
+}
+
+GMIO_INLINE bool gmio_ryu_is_shortest_format(
+        enum gmio_float_text_format textformat)
+{
+    return textformat == GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE
+            || textformat == GMIO_FLOAT_TEXT_FORMAT_SHORTEST_UPPERCASE;
+}
+
+GMIO_INLINE char gmio_ryu_exp_char(enum gmio_float_text_format textformat)
+{
+    const bool is_lowercase =
+            textformat == GMIO_FLOAT_TEXT_FORMAT_DECIMAL_LOWERCASE
+            || textformat == GMIO_FLOAT_TEXT_FORMAT_SCIENTIFIC_LOWERCASE
+            || textformat == GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE;
+    return is_lowercase ? 'e' : 'E';
+}
+
+/* Writes finite float \p value into \p buff, shortest text if \p shortest
+ * is true
+ *
+ * Returns the end of the written text or NULL if snprintf() must be used */
+static char* gmio_ryu_write_float(
+        char* buff,
+        float value,
+        enum gmio_float_text_format textformat,
+        unsigned prec,
+        bool shortest)
+{
+    const uint32_t bits = gmio_convert_uint32(value);
+    const uint32_t ieee_mantissa =
+            bits & ((UINT32_C(1) << GMIO_RYU_FLOAT_MANTISSA_BITS) - 1);
+    const uint32_t ieee_exponent = (bits >> GMIO_RYU_FLOAT_MANTISSA_BITS) & 0xFF;
+    const char exp_char = gmio_ryu_exp_char(textformat);
+    uint32_t m;
+    int32_t e2;
+
+    if ((bits >> 31) != 0)
+        *buff++ = '-';
+    if (shortest) {
+        const unsigned prec_max = prec != 0 ? prec : GMIO_RYU_FLOAT_MAX_DIGITS;
+        const struct gmio_ryu_decimal32 decimal = gmio_ryu_f2d(value);
+        const unsigned digit_count = gmio_ryu_digit_count(decimal.digits);
+        if (digit_count <= prec_max) {
+            return gmio_ryu_write_general(
+                        buff,
+                        decimal.digits,
+                        digit_count,
+                        decimal.exponent + (int32_t)digit_count - 1,
+                        prec_max,
+                        exp_char);
+        }
+    }
+
+    /* Decode value as m * 2^e2 */
+    if (ieee_exponent == 0) {
+        m = ieee_mantissa;
+        e2 = 1 - GMIO_RYU_FLOAT_BIAS - GMIO_RYU_FLOAT_MANTISSA_BITS;
+    }
+    else {
+        m = (UINT32_C(1) << GMIO_RYU_FLOAT_MANTISSA_BITS) | ieee_mantissa;
+        e2 = (int32_t)ieee_exponent
+                - GMIO_RYU_FLOAT_BIAS - GMIO_RYU_FLOAT_MANTISSA_BITS;
+    }
+    return gmio_ryu_write_prec(buff, m, e2, textformat, prec, exp_char);
+}
+
+/* Copies text [str, str_end) into \p buff, truncated to \p bufflen */
+GMIO_INLINE int gmio_ryu_copy_str(
+        char* buff, size_t bufflen, const char* str, const char* str_end)
+{
+    const size_t len = str_end - str;
+    const size_t copy_len = len < bufflen ? len : bufflen;
+    memcpy(buff, str, copy_len);
+    return (int)copy_len;
+}
+
+/* Writes \p value with snprintf(), the count of chars written(excluding the
+ * terminating null char) is returned */
+static int gmio_ryu_snprintf(
+        double value,
+        char* buff,
+        size_t bufflen,
+        enum gmio_float_text_format textformat,
+        uint8_t prec)
+{
+    const struct gmio_string_16 format =
+            gmio_to_stdio_float_format(textformat, prec);
+    const int len = gmio_snprintf(buff, bufflen, format.array, value);
+    if (len < 0 || bufflen == 0)
+        return 0;
+    return (size_t)len < bufflen ? len : (int)(bufflen - 1);
+}
+
+int gmio_float2str_ryu(
+        float value,
+        char* buff,
+        size_t bufflen,
+        enum gmio_float_text_format textformat,
+        uint8_t prec)
+{
+    const uint32_t ieee_exponent =
+            (gmio_convert_uint32(value) >> GMIO_RYU_FLOAT_MANTISSA_BITS) & 0xFF;
+    if (ieee_exponent != 0xFF && prec <= GMIO_RYU_PREC_MAX) {
+        char str[GMIO_RYU_STR_MAX_LEN];
+        const char* str_end =
+                gmio_ryu_write_float(
+                    str,
+                    value,
+                    textformat,
+                    prec,
+                    gmio_ryu_is_shortest_format(textformat));
+        if (str_end != NULL)
+            return gmio_ryu_copy_str(buff, bufflen, str, str_end);
+    }
+    return gmio_ryu_snprintf(value, buff, bufflen, textformat, prec);
+}
+
+int gmio_double2str_ryu(
+        double value,
+        char* buff,
+        size_t bufflen,
+        enum gmio_float_text_format textformat,
+        uint8_t prec)
+{
+    if (value >= -FLT_MAX && value <= FLT_MAX && prec <= GMIO_RYU_PREC_MAX) {
+        const float fvalue = (float)value;
+        if (!(fvalue < value) && !(fvalue > value)) {
+            const bool shortest =
+                    gmio_ryu_is_shortest_format(textformat)
+                    && prec <= GMIO_RYU_FLOAT_MAX_DIGITS;
+            char str[GMIO_RYU_STR_MAX_LEN];
+            const char* str_end =
+                    gmio_ryu_write_float(
+                        str, fvalue, textformat, prec, shortest);
+            if (str_end != NULL)
+                return gmio_ryu_copy_str(buff, bufflen, str, str_end);
+        }
+    }
+    return gmio_ryu_snprintf(value, buff, bufflen, textformat, prec);
+}
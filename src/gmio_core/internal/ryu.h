@@ -0,0 +1,88 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+/* Float-to-string conversion of float32 values, based on the Ryu algorithm :
+ *     Ulf Adams, "Ryu: Fast Float-to-String Conversion", PLDI 2018
+ *
+ * The shortest decimal that reads back to the same float32 is computed with
+ * 64-bit multiplications by truncated powers of 5, no bignum is involved.
+ * Fixed-precision conversions("%.<prec>f", "%.<prec>e", "%.<prec>g") are
+ * exact and give the same text as the C library printf(), they are computed
+ * with integer arithmetic as long as intermediate values fit in 64 bits and
+ * are delegated to snprintf() otherwise(eg. very large or tiny values).
+ */
+
+#pragma once
+
+#include "../global.h"
+#include "../text_format.h"
+
+#include <stddef.h>
+
+/* Decimal value digits * 10^exponent */
+struct gmio_ryu_decimal32
+{
+    uint32_t digits;
+    int32_t exponent;
+};
+
+/* Returns the shortest decimal that reads back to |value|
+ *
+ * \p value must be finite, the sign is ignored. When several decimals of the
+ * shortest length are possible, the closest to \p value is returned */
+struct gmio_ryu_decimal32 gmio_ryu_f2d(float value);
+
+/* Writes the text representation of float \p value into \p buff
+ *
+ * DECIMAL and SCIENTIFIC formats give the same text as printf() with
+ * "%.<prec>f" and "%.<prec>e". SHORTEST formats give the shortest text that
+ * reads back to \p value, unless it requires more than \p prec significant
+ * digits(\p prec == 0 means no limit) : then the text is the one of printf()
+ * with "%.<prec>g".
+ *
+ * No null terminating char is written. Returns the count of chars written,
+ * which is at most \p bufflen */
+int gmio_float2str_ryu(
+        float value,
+        char* buff,
+        size_t bufflen,
+        enum gmio_float_text_format textformat,
+        uint8_t prec);
+
+/* Writes the text representation of double \p value into \p buff
+ *
+ * Values exactly representable as float32 go through gmio_float2str_ryu(),
+ * SHORTEST formats with \p prec > 9 being converted as "%.<prec>g" to keep
+ * the full double precision. Other values are converted with snprintf() */
+int gmio_double2str_ryu(
+        double value,
+        char* buff,
+        size_t bufflen,
+        enum gmio_float_text_format textformat,
+        uint8_t prec);
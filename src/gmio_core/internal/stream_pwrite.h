@@ -0,0 +1,64 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include "../stream.h"
+
+/* Positioned writes allow several threads to write distinct parts of a
+ * stream at the same time. They are supported only by streams created with
+ * gmio_stream_stdio() over a seekable file, on platforms providing pwrite() */
+
+/*! Prepares positioned writes on \p stream: pending data is flushed and the
+ *  current position is stored in \p base_offset
+ *
+ *  \return \c false if \p stream does not support positioned writes */
+bool gmio_stream_pwrite_begin(
+        struct gmio_stream* stream, gmio_streamoffset_t* base_offset);
+
+/*! Writes \p size bytes from \p ptr at \p base_offset + \p offset in \p stream,
+ *  without changing the current position
+ *
+ *  Can be called concurrently from several threads, for disjoint parts of
+ *  the stream.
+ *
+ *  \return The count of bytes successfully written */
+size_t gmio_stream_pwrite(
+        const struct gmio_stream* stream,
+        const void* ptr,
+        size_t size,
+        gmio_streamoffset_t base_offset,
+        gmio_streamoffset_t offset);
+
+/*! Ends positioned writes : the current position of \p stream is moved to
+ *  \p end_offset
+ *
+ *  \return \c false on error */
+bool gmio_stream_pwrite_end(
+        struct gmio_stream* stream, gmio_streamoffset_t end_offset);
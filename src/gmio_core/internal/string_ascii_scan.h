@@ -0,0 +1,151 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include "../global.h"
+#include "cpu_features.h"
+#include "string_ascii_utils.h"
+
+#include <stddef.h>
+
+/*! Returns the first char in [\p begin, \p end) that is not a space(as of
+ *  gmio_ascii_isspace()), \p end if there is none
+ *
+ *  Chars are classified by chunks of 16 bytes when SIMD is available */
+GMIO_INLINE const char* gmio_ascii_find_nonspace(
+        const char* begin, const char* end);
+
+/*! Returns the first space char(as of gmio_ascii_isspace()) in
+ *  [\p begin, \p end), \p end if there is none
+ *
+ *  Chars are classified by chunks of 16 bytes when SIMD is available */
+GMIO_INLINE const char* gmio_ascii_find_space(
+        const char* begin, const char* end);
+
+
+
+/*
+ * -- Implementation
+ */
+
+/* SIMD classification is done with SSE2 compares, available on any x86_64
+ * CPU. pcmpistri(SSE4.2) has higher latency for this simple char set, and
+ * 32-byte AVX2 chunks would rarely pay off as STL ascii words and space runs
+ * are mostly shorter than 16 chars */
+#if defined(GMIO_HAVE_SSE2)
+#  include <emmintrin.h>
+#  define GMIO_ASCII_SCAN_SSE2
+#elif defined(GMIO_HAVE_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#  define GMIO_ASCII_SCAN_NEON
+#endif
+
+#ifdef GMIO_ASCII_SCAN_SSE2
+/* Returns a 16b mask where bit i is set if chunk[i] is a space char */
+GMIO_INLINE unsigned gmio_ascii_space_mask_sse2(const char* chunk)
+{
+    const __m128i vec = _mm_loadu_si128((const __m128i*)chunk);
+    /* c == 0x20 || (uint8_t)(c - 0x09) <= 4 */
+    const __m128i is_spc = _mm_cmpeq_epi8(vec, _mm_set1_epi8(0x20));
+    const __m128i vec_sub = _mm_sub_epi8(vec, _mm_set1_epi8(0x09));
+    const __m128i is_ctl =
+            _mm_cmpeq_epi8(_mm_min_epu8(vec_sub, _mm_set1_epi8(4)), vec_sub);
+    return (unsigned)_mm_movemask_epi8(_mm_or_si128(is_spc, is_ctl));
+}
+
+/* Returns the index of the lowest bit set in non-null \p mask */
+GMIO_INLINE unsigned gmio_ascii_scan_ctz(unsigned mask)
+{
+#  if defined(__GNUC__)
+    return (unsigned)__builtin_ctz(mask);
+#  else
+    unsigned i = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++i;
+    }
+    return i;
+#  endif
+}
+#endif /* GMIO_ASCII_SCAN_SSE2 */
+
+#ifdef GMIO_ASCII_SCAN_NEON
+/* Returns a vector where byte i is 0xFF if chunk[i] is a space char */
+GMIO_INLINE uint8x16_t gmio_ascii_space_vec_neon(const char* chunk)
+{
+    const uint8x16_t vec = vld1q_u8((const uint8_t*)chunk);
+    const uint8x16_t is_spc = vceqq_u8(vec, vdupq_n_u8(0x20));
+    const uint8x16_t is_ctl =
+            vcleq_u8(vsubq_u8(vec, vdupq_n_u8(0x09)), vdupq_n_u8(4));
+    return vorrq_u8(is_spc, is_ctl);
+}
+#endif /* GMIO_ASCII_SCAN_NEON */
+
+const char* gmio_ascii_find_nonspace(const char* begin, const char* end)
+{
+#if defined(GMIO_ASCII_SCAN_SSE2)
+    while (end - begin >= 16) {
+        const unsigned mask = gmio_ascii_space_mask_sse2(begin) ^ 0xFFFF;
+        if (mask != 0)
+            return begin + gmio_ascii_scan_ctz(mask);
+        begin += 16;
+    }
+#elif defined(GMIO_ASCII_SCAN_NEON)
+    while (end - begin >= 16) {
+        if (vminvq_u8(gmio_ascii_space_vec_neon(begin)) == 0)
+            break; /* Non-space char is in this chunk */
+        begin += 16;
+    }
+#endif
+    while (begin < end && gmio_ascii_isspace(*begin))
+        ++begin;
+    return begin;
+}
+
+const char* gmio_ascii_find_space(const char* begin, const char* end)
+{
+#if defined(GMIO_ASCII_SCAN_SSE2)
+    while (end - begin >= 16) {
+        const unsigned mask = gmio_ascii_space_mask_sse2(begin);
+        if (mask != 0)
+            return begin + gmio_ascii_scan_ctz(mask);
+        begin += 16;
+    }
+#elif defined(GMIO_ASCII_SCAN_NEON)
+    while (end - begin >= 16) {
+        if (vmaxvq_u8(gmio_ascii_space_vec_neon(begin)) != 0)
+            break; /* Space char is in this chunk */
+        begin += 16;
+    }
+#endif
+    while (begin < end && !gmio_ascii_isspace(*begin))
+        ++begin;
+    return begin;
+}
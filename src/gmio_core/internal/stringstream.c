@@ -31,6 +31,8 @@
 
 #include "helper_stream.h"
 
+#include <string.h>
+
 struct gmio_stringstream gmio_stringstream(
         const struct gmio_stream stream, const struct gmio_string strbuff)
 {
@@ -77,12 +79,24 @@ enum gmio_eat_word_error gmio_stringstream_eat_word(
     }
 
     do {
-        *str_ptr_at = *stream_curr_char;
-        stream_curr_char = gmio_stringstream_next_char(sstream);
-        ++str_ptr_at;
-    } while (stream_curr_char != NULL
-             && !gmio_ascii_isspace(*stream_curr_char)
-             && str_ptr_at < str_ptr_end);
+        /* Copy the part of the word available in strbuff */
+        const char* word_end =
+                gmio_ascii_find_space(stream_curr_char, sstream->strbuff_end);
+        const size_t str_remaining_len = str_ptr_end - str_ptr_at;
+        size_t word_len = word_end - stream_curr_char;
+        if (word_len > str_remaining_len) {
+            word_len = str_remaining_len;
+            word_end = stream_curr_char + word_len;
+        }
+        memcpy(str_ptr_at, stream_curr_char, word_len);
+        str_ptr_at += word_len;
+        sstream->strbuff_at = word_end;
+        /* Word continues in next chunk ? */
+        stream_curr_char =
+                word_end < sstream->strbuff_end ?
+                    NULL :
+                    gmio_stringstream_next_chunk(sstream);
+    } while (stream_curr_char != NULL && str_ptr_at < str_ptr_end);
 
     if (str_ptr_at < str_ptr_end) {
         *str_ptr_at = 0; /* End string with null byte */
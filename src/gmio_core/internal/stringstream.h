@@ -82,6 +82,12 @@ GMIO_INLINE const char* gmio_stringstream_current_char(
 GMIO_INLINE const char* gmio_stringstream_next_char(
         struct gmio_stringstream* sstream);
 
+/*! Reads next contents chunk into strbuff and moves on its first char
+ *
+ *  Returns \c NULL if end of stream is reached */
+GMIO_INLINE const char* gmio_stringstream_next_chunk(
+        struct gmio_stringstream* sstream);
+
 /*! Moves on next char in stream */
 GMIO_INLINE struct gmio_stringstream* gmio_stringstream_move_next_char(
         struct gmio_stringstream* sstream);
@@ -140,12 +146,16 @@ GMIO_INLINE float gmio_to_float32(const char* str);
  */
 
 #include "c99_stdlib_compat.h"
+#include "string_ascii_scan.h"
 #include "string_ascii_utils.h"
 #if GMIO_STR2FLOAT_LIB == GMIO_STR2FLOAT_LIB_IRRLICHT
 #  include "fast_atof.h"
 #  include "stringstream_fast_atof.h"
 #elif GMIO_STR2FLOAT_LIB == GMIO_STR2FLOAT_LIB_DOUBLE_CONVERSION
 #  include "google_doubleconversion.h"
+#elif GMIO_STR2FLOAT_LIB == GMIO_STR2FLOAT_LIB_EISEL_LEMIRE
+#  include "eisel_lemire.h"
+#  include "stringstream_eisel_lemire.h"
 #endif
 
 #include <errno.h>
@@ -163,8 +173,11 @@ const char *gmio_stringstream_next_char(struct gmio_stringstream *sstream)
     ++(sstream->strbuff_at);
     if (sstream->strbuff_at < sstream->strbuff_end)
         return sstream->strbuff_at;
+    return gmio_stringstream_next_chunk(sstream);
+}
 
-    /* Read next chunk of data */
+const char* gmio_stringstream_next_chunk(struct gmio_stringstream* sstream)
+{
     sstream->strbuff_at = sstream->strbuff.ptr;
     sstream->strbuff.len =
             sstream->func_stream_read(
@@ -186,9 +199,15 @@ struct gmio_stringstream* gmio_stringstream_move_next_char(
 const char* gmio_stringstream_skip_ascii_spaces(struct gmio_stringstream* sstream)
 {
     const char* curr_char = gmio_stringstream_current_char(sstream);
-    while (curr_char != NULL && gmio_ascii_isspace(*curr_char))
-        curr_char = gmio_stringstream_next_char(sstream);
-    return curr_char;
+    while (curr_char != NULL) {
+        /* Scan whole strbuff, then read next chunk if only spaces found */
+        curr_char = gmio_ascii_find_nonspace(curr_char, sstream->strbuff_end);
+        sstream->strbuff_at = curr_char;
+        if (curr_char < sstream->strbuff_end)
+            return curr_char;
+        curr_char = gmio_stringstream_next_chunk(sstream);
+    }
+    return NULL;
 }
 
 void gmio_stringstream_copy_ascii_spaces(
@@ -223,6 +242,10 @@ int gmio_get_float32(const char* str, float* value_ptr)
         ++len;
     *value_ptr = gmio_str2float_googledoubleconversion(str, len);
     return 0;
+#elif GMIO_STR2FLOAT_LIB == GMIO_STR2FLOAT_LIB_EISEL_LEMIRE
+    const char* end_ptr = NULL;
+    *value_ptr = gmio_eisel_lemire_strtof(str, &end_ptr);
+    return end_ptr == str ? -1 : 0;
 #endif
 }
 
@@ -234,6 +257,8 @@ float gmio_to_float32(const char* str)
     return fast_atof(str);
 #elif GMIO_STR2FLOAT_LIB == GMIO_STR2FLOAT_LIB_DOUBLE_CONVERSION
     return gmio_str2float_googledoubleconversion(str, strlen(str));
+#elif GMIO_STR2FLOAT_LIB == GMIO_STR2FLOAT_LIB_EISEL_LEMIRE
+    return gmio_eisel_lemire_strtof(str, NULL);
 #endif
 }
 
@@ -251,5 +276,7 @@ float gmio_stringstream_parse_float32(struct gmio_stringstream* sstream)
     struct gmio_string strnum = gmio_string(num, 0, sizeof(num));
     gmio_stringstream_eat_word(sstream, &strnum);
     return gmio_str2float_googledoubleconversion(num, strnum.len);
+#elif GMIO_STR2FLOAT_LIB == GMIO_STR2FLOAT_LIB_EISEL_LEMIRE
+    return gmio_stringstream_eisel_lemire(sstream);
 #endif
 }
@@ -0,0 +1,86 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include "eisel_lemire.h"
+#include "stringstream.h"
+
+/* Returns true if \p c can be part of a number parsed with
+ * gmio_eisel_lemire_parse() */
+GMIO_INLINE bool gmio_eisel_lemire_is_number_char(char c)
+{
+    return gmio_ascii_isdigit(c)
+            || c == '.'
+            || c == 'e'
+            || c == 'E'
+            || c == '+'
+            || c == '-';
+}
+
+/* Parses float from stringstream \p sstream with the Eisel-Lemire algorithm
+ *
+ * The number is parsed in place when it lies entirely in the current strbuff,
+ * otherwise(it spans two chunks) its chars are first fed to a
+ * gmio_eisel_lemire_short_number with the stringstream iterator */
+GMIO_INLINE float gmio_stringstream_eisel_lemire(
+        struct gmio_stringstream* sstream)
+{
+    struct gmio_eisel_lemire_decimal decimal;
+    const char* begin = gmio_stringstream_current_char(sstream);
+    const char* end = sstream->strbuff_end;
+    const char* number_end = NULL;
+    struct gmio_eisel_lemire_short_number num;
+    const char* num_str = NULL;
+
+    if (begin == NULL)
+        return 0.f;
+
+    /* Fast path: the number is followed by some other char in strbuff */
+    number_end = gmio_eisel_lemire_parse(begin, end, &decimal);
+    if (number_end != begin
+            && number_end < end
+            && !gmio_eisel_lemire_is_number_char(*number_end))
+    {
+        sstream->strbuff_at = number_end;
+        return gmio_eisel_lemire_decimal_to_float32(
+                    &decimal, begin, number_end);
+    }
+
+    /* Slow path: number may continue in next chunk(or is invalid) */
+    gmio_eisel_lemire_short_number_init(&num);
+    while (begin != NULL && gmio_eisel_lemire_is_number_char(*begin)) {
+        gmio_eisel_lemire_short_number_push(&num, *begin);
+        begin = gmio_stringstream_next_char(sstream);
+    }
+    num_str = gmio_eisel_lemire_short_number_str(&num);
+    if (num_str == NULL)
+        return 0.f;
+    return gmio_eisel_lemire_strtof(num_str, NULL);
+}
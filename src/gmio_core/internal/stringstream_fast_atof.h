@@ -30,10 +30,10 @@ GMIO_INLINE int32_t gmio_stringstream_strtol10(
         struct gmio_stringstream* sstream)
 {
     const char* in = gmio_stringstream_current_char(sstream);
-    const bool inv = (*in == '-');
+    const bool inv = in != NULL && *in == '-';
     int value = 0;
 
-    if (inv || *in == '+')
+    if (inv || (in != NULL && *in == '+'))
         in = gmio_stringstream_next_char(sstream);
     value = gmio_stringstream_strtoul10(sstream);
     if (inv)
@@ -84,16 +84,16 @@ GMIO_INLINE struct gmio_stringstream_strtof10_result
 GMIO_INLINE float gmio_stringstream_fast_atof(struct gmio_stringstream* sstream)
 {
     const char* in = gmio_stringstream_current_char(sstream);
-    const bool negative = ('-' == *in);
+    const bool negative = in != NULL && '-' == *in;
     float value = 0.f;
 
     /* Please run the regression test when making any modifications to this
      * function. */
-    if (negative || ('+' == *in))
+    if (negative || (in != NULL && '+' == *in))
         in = gmio_stringstream_next_char(sstream);
     value = gmio_stringstream_strtof10(sstream).val;
     in = gmio_stringstream_current_char(sstream);
-    if (is_local_decimal_point(*in)) {
+    if (in != NULL && is_local_decimal_point(*in)) {
         const struct gmio_stringstream_strtof10_result decimal =
                 gmio_stringstream_strtof10(
                     gmio_stringstream_move_next_char(sstream));
@@ -0,0 +1,278 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "thread.h"
+
+#include <stdlib.h>
+
+#if defined(GMIO_HAVE_PTHREAD)
+#  include <pthread.h>
+#elif defined(GMIO_HAVE_WIN32_THREADS)
+#  include <windows.h>
+#endif
+
+#ifdef GMIO_HAVE_THREADS
+
+struct gmio_thread
+{
+#  if defined(GMIO_HAVE_PTHREAD)
+    pthread_t handle;
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+    HANDLE handle;
+#  endif
+    gmio_thread_func_t func;
+    void* arg;
+};
+
+struct gmio_mutex
+{
+#  if defined(GMIO_HAVE_PTHREAD)
+    pthread_mutex_t handle;
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+    CRITICAL_SECTION handle;
+#  endif
+};
+
+struct gmio_cond
+{
+#  if defined(GMIO_HAVE_PTHREAD)
+    pthread_cond_t handle;
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+    CONDITION_VARIABLE handle;
+#  endif
+};
+
+#  if defined(GMIO_HAVE_PTHREAD)
+static void* gmio_thread_start(void* thread)
+{
+    const struct gmio_thread* th = (const struct gmio_thread*)thread;
+    th->func(th->arg);
+    return NULL;
+}
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+static DWORD WINAPI gmio_thread_start(LPVOID thread)
+{
+    const struct gmio_thread* th = (const struct gmio_thread*)thread;
+    th->func(th->arg);
+    return 0;
+}
+#  endif
+
+struct gmio_thread* gmio_thread_create(gmio_thread_func_t func, void* arg)
+{
+    struct gmio_thread* thread = malloc(sizeof(struct gmio_thread));
+    if (thread != NULL) {
+        thread->func = func;
+        thread->arg = arg;
+#  if defined(GMIO_HAVE_PTHREAD)
+        if (pthread_create(&thread->handle, NULL, gmio_thread_start, thread)
+                != 0)
+        {
+            free(thread);
+            thread = NULL;
+        }
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+        thread->handle =
+                CreateThread(NULL, 0, gmio_thread_start, thread, 0, NULL);
+        if (thread->handle == NULL) {
+            free(thread);
+            thread = NULL;
+        }
+#  endif
+    }
+    return thread;
+}
+
+void gmio_thread_join(struct gmio_thread* thread)
+{
+    if (thread != NULL) {
+#  if defined(GMIO_HAVE_PTHREAD)
+        pthread_join(thread->handle, NULL);
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+        WaitForSingleObject(thread->handle, INFINITE);
+        CloseHandle(thread->handle);
+#  endif
+        free(thread);
+    }
+}
+
+struct gmio_mutex* gmio_mutex_create()
+{
+    struct gmio_mutex* mutex = malloc(sizeof(struct gmio_mutex));
+    if (mutex != NULL) {
+#  if defined(GMIO_HAVE_PTHREAD)
+        if (pthread_mutex_init(&mutex->handle, NULL) != 0) {
+            free(mutex);
+            mutex = NULL;
+        }
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+        InitializeCriticalSection(&mutex->handle);
+#  endif
+    }
+    return mutex;
+}
+
+void gmio_mutex_destroy(struct gmio_mutex* mutex)
+{
+    if (mutex != NULL) {
+#  if defined(GMIO_HAVE_PTHREAD)
+        pthread_mutex_destroy(&mutex->handle);
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+        DeleteCriticalSection(&mutex->handle);
+#  endif
+        free(mutex);
+    }
+}
+
+void gmio_mutex_lock(struct gmio_mutex* mutex)
+{
+    if (mutex != NULL) {
+#  if defined(GMIO_HAVE_PTHREAD)
+        pthread_mutex_lock(&mutex->handle);
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+        EnterCriticalSection(&mutex->handle);
+#  endif
+    }
+}
+
+void gmio_mutex_unlock(struct gmio_mutex* mutex)
+{
+    if (mutex != NULL) {
+#  if defined(GMIO_HAVE_PTHREAD)
+        pthread_mutex_unlock(&mutex->handle);
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+        LeaveCriticalSection(&mutex->handle);
+#  endif
+    }
+}
+
+struct gmio_cond* gmio_cond_create()
+{
+    struct gmio_cond* cond = malloc(sizeof(struct gmio_cond));
+    if (cond != NULL) {
+#  if defined(GMIO_HAVE_PTHREAD)
+        if (pthread_cond_init(&cond->handle, NULL) != 0) {
+            free(cond);
+            cond = NULL;
+        }
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+        InitializeConditionVariable(&cond->handle);
+#  endif
+    }
+    return cond;
+}
+
+void gmio_cond_destroy(struct gmio_cond* cond)
+{
+    if (cond != NULL) {
+#  if defined(GMIO_HAVE_PTHREAD)
+        pthread_cond_destroy(&cond->handle);
+#  endif
+        free(cond);
+    }
+}
+
+void gmio_cond_wait(struct gmio_cond* cond, struct gmio_mutex* mutex)
+{
+    if (cond != NULL && mutex != NULL) {
+#  if defined(GMIO_HAVE_PTHREAD)
+        pthread_cond_wait(&cond->handle, &mutex->handle);
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+        SleepConditionVariableCS(&cond->handle, &mutex->handle, INFINITE);
+#  endif
+    }
+}
+
+void gmio_cond_broadcast(struct gmio_cond* cond)
+{
+    if (cond != NULL) {
+#  if defined(GMIO_HAVE_PTHREAD)
+        pthread_cond_broadcast(&cond->handle);
+#  elif defined(GMIO_HAVE_WIN32_THREADS)
+        WakeAllConditionVariable(&cond->handle);
+#  endif
+    }
+}
+
+#else /* !GMIO_HAVE_THREADS */
+
+struct gmio_thread* gmio_thread_create(gmio_thread_func_t func, void* arg)
+{
+    GMIO_UNUSED(func);
+    GMIO_UNUSED(arg);
+    return NULL;
+}
+
+void gmio_thread_join(struct gmio_thread* thread)
+{
+    GMIO_UNUSED(thread);
+}
+
+struct gmio_mutex* gmio_mutex_create()
+{
+    return NULL;
+}
+
+void gmio_mutex_destroy(struct gmio_mutex* mutex)
+{
+    GMIO_UNUSED(mutex);
+}
+
+void gmio_mutex_lock(struct gmio_mutex* mutex)
+{
+    GMIO_UNUSED(mutex);
+}
+
+void gmio_mutex_unlock(struct gmio_mutex* mutex)
+{
+    GMIO_UNUSED(mutex);
+}
+
+struct gmio_cond* gmio_cond_create()
+{
+    return NULL;
+}
+
+void gmio_cond_destroy(struct gmio_cond* cond)
+{
+    GMIO_UNUSED(cond);
+}
+
+void gmio_cond_wait(struct gmio_cond* cond, struct gmio_mutex* mutex)
+{
+    GMIO_UNUSED(cond);
+    GMIO_UNUSED(mutex);
+}
+
+void gmio_cond_broadcast(struct gmio_cond* cond)
+{
+    GMIO_UNUSED(cond);
+}
+
+#endif /* GMIO_HAVE_THREADS */
@@ -0,0 +1,91 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include "../global.h"
+
+#if defined(GMIO_HAVE_PTHREAD) || defined(GMIO_HAVE_WIN32_THREADS)
+/*! Defined when gmio_thread_create() and gmio_mutex_create() are functional */
+#  define GMIO_HAVE_THREADS
+#endif
+
+/*! Opaque thread object */
+struct gmio_thread;
+
+/*! Opaque mutual exclusion object */
+struct gmio_mutex;
+
+/*! Opaque condition variable object */
+struct gmio_cond;
+
+/*! Function executed by a thread */
+typedef void (*gmio_thread_func_t)(void* arg);
+
+/*! Starts a new thread executing <tt>func(arg)</tt>
+ *
+ *  Returns \c NULL on failure or if threads are not supported(see
+ *  \c GMIO_HAVE_THREADS), in which case the caller must run \p func itself.
+ */
+struct gmio_thread* gmio_thread_create(gmio_thread_func_t func, void* arg);
+
+/*! Waits for \p thread to finish then releases it. \p thread may be \c NULL */
+void gmio_thread_join(struct gmio_thread* thread);
+
+/*! Returns a new mutex, \c NULL on failure or if threads are not supported */
+struct gmio_mutex* gmio_mutex_create();
+
+/*! Releases \p mutex, which may be \c NULL */
+void gmio_mutex_destroy(struct gmio_mutex* mutex);
+
+/*! Locks \p mutex, does nothing if \p mutex is \c NULL */
+void gmio_mutex_lock(struct gmio_mutex* mutex);
+
+/*! Unlocks \p mutex, does nothing if \p mutex is \c NULL */
+void gmio_mutex_unlock(struct gmio_mutex* mutex);
+
+/*! Returns a new condition variable, \c NULL on failure or if threads are not
+ *  supported
+ *
+ *  On Windows, requires Vista or later */
+struct gmio_cond* gmio_cond_create();
+
+/*! Releases \p cond, which may be \c NULL */
+void gmio_cond_destroy(struct gmio_cond* cond);
+
+/*! Atomically unlocks \p mutex and waits for \p cond to be signaled, then
+ *  locks \p mutex again
+ *
+ *  As spurious wakeups may occur, the waited condition must always be checked
+ *  again in a loop. Does nothing if \p cond is \c NULL */
+void gmio_cond_wait(struct gmio_cond* cond, struct gmio_mutex* mutex);
+
+/*! Wakes up all threads waiting for \p cond, does nothing if \p cond is
+ *  \c NULL */
+void gmio_cond_broadcast(struct gmio_cond* cond);
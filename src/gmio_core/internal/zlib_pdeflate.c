@@ -0,0 +1,346 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "zlib_pdeflate.h"
+
+#include "helper_stream.h"
+#include "min_max.h"
+#include "thread.h"
+#include "zlib_utils.h"
+#include "../error.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+/* Size of the deflate window, ie the maximum dictionary length */
+enum { GMIO_ZLIB_PDEFLATE_DICT_SIZE = 32 * 1024 };
+
+/* Compression job of one input block */
+struct gmio_zlib_pdeflate_job
+{
+    uint8_t* in;
+    size_t in_len;
+    uint8_t* dict;
+    size_t dict_len;
+    uint8_t* out;
+    size_t out_len;
+    uint32_t crc32;
+    bool finish;
+    int error;
+    bool done; /* Accessed only with mutex locked */
+};
+
+struct gmio_zlib_pdeflate
+{
+    struct gmio_zlib_compress_options z_opts;
+    size_t out_capacity;
+    struct gmio_thread** threads;
+    unsigned thread_count;
+    struct gmio_mutex* mutex;
+    struct gmio_cond* cond; /* Signaled when any member below mutex changes */
+    struct gmio_zlib_pdeflate_job* jobs;
+    unsigned job_count;
+
+    /* Accessed only by the calling thread */
+    struct z_stream_s z_stream; /* To run jobs while waiting for output */
+    uintmax_t write_seq; /* Sequence number of the next job to be written */
+    size_t fill_len; /* Length of input in the job being filled */
+    uint32_t crc32;
+    int error;
+
+    /* Accessed only with mutex locked. Jobs [run_seq, queued_seq) are waiting
+     * to be run, job queued_seq is the one being filled */
+    uintmax_t run_seq;
+    uintmax_t queued_seq;
+    bool quit;
+};
+
+/* Initializes \p z_stream for raw deflate with the options of \p pdeflate */
+static int gmio_zlib_pdeflate_init_zstream(
+        const struct gmio_zlib_pdeflate* pdeflate, struct z_stream_s* z_stream)
+{
+    memset(z_stream, 0, sizeof(struct z_stream_s));
+    z_stream->zalloc = pdeflate->z_opts.func_alloc;
+    z_stream->zfree = pdeflate->z_opts.func_free;
+    z_stream->opaque = pdeflate->z_opts.opaque;
+    return gmio_zlib_compress_init(z_stream, &pdeflate->z_opts);
+}
+
+/* Deflates the input block of \p job */
+static void gmio_zlib_pdeflate_job_run(
+        const struct gmio_zlib_pdeflate* pdeflate,
+        struct z_stream_s* z_stream,
+        struct gmio_zlib_pdeflate_job* job)
+{
+    const int z_flush = job->finish ? Z_FINISH : Z_SYNC_FLUSH;
+    int z_retcode = deflateReset(z_stream);
+    if (z_retcode == Z_OK && job->dict_len > 0)
+        z_retcode = deflateSetDictionary(z_stream, job->dict, (uInt)job->dict_len);
+    if (z_retcode == Z_OK) {
+        gmio_zlib_assign_zstream_in(z_stream, job->in, job->in_len);
+        gmio_zlib_assign_zstream_out(z_stream, job->out, pdeflate->out_capacity);
+        z_retcode = deflate(z_stream, z_flush);
+    }
+    job->crc32 = gmio_zlib_crc32(job->in, job->in_len);
+    job->out_len = pdeflate->out_capacity - z_stream->avail_out;
+    job->error = GMIO_ERROR_OK;
+    if (z_retcode != Z_OK && z_retcode != Z_STREAM_END)
+        job->error = zlib_error_to_gmio_error(z_retcode);
+    else if (z_stream->avail_in != 0)
+        job->error = GMIO_ERROR_ZLIB_DEFLATE_NOT_ALL_INPUT_USED;
+    else if (job->finish && z_retcode != Z_STREAM_END)
+        job->error = GMIO_ERROR_ZLIB_DEFLATE_STREAM_INCOMPLETE;
+}
+
+/* Takes the next queued job and runs it, mutex being locked on entry and exit
+ *
+ * Returns false if there is no queued job */
+static bool gmio_zlib_pdeflate_run_next(
+        struct gmio_zlib_pdeflate* pdeflate, struct z_stream_s* z_stream)
+{
+    struct gmio_zlib_pdeflate_job* job = NULL;
+    if (pdeflate->run_seq == pdeflate->queued_seq)
+        return false;
+    job = &pdeflate->jobs[pdeflate->run_seq % pdeflate->job_count];
+    ++pdeflate->run_seq;
+    gmio_mutex_unlock(pdeflate->mutex);
+    gmio_zlib_pdeflate_job_run(pdeflate, z_stream, job);
+    gmio_mutex_lock(pdeflate->mutex);
+    job->done = true;
+    gmio_cond_broadcast(pdeflate->cond);
+    return true;
+}
+
+/* Function of the compression threads */
+static void gmio_zlib_pdeflate_thread_run(void* arg)
+{
+    struct gmio_zlib_pdeflate* pdeflate = (struct gmio_zlib_pdeflate*)arg;
+    struct z_stream_s z_stream;
+    if (gmio_error(gmio_zlib_pdeflate_init_zstream(pdeflate, &z_stream)))
+        return; /* Jobs are left to the other threads */
+    gmio_mutex_lock(pdeflate->mutex);
+    while (!pdeflate->quit) {
+        if (!gmio_zlib_pdeflate_run_next(pdeflate, &z_stream))
+            gmio_cond_wait(pdeflate->cond, pdeflate->mutex);
+    }
+    gmio_mutex_unlock(pdeflate->mutex);
+    deflateEnd(&z_stream);
+}
+
+/* Waits for the oldest job to complete then writes its output to \p stream
+ *
+ * Returns the count of bytes written */
+static size_t gmio_zlib_pdeflate_write_next(
+        struct gmio_zlib_pdeflate* pdeflate, struct gmio_stream* stream)
+{
+    struct gmio_zlib_pdeflate_job* job =
+            &pdeflate->jobs[pdeflate->write_seq % pdeflate->job_count];
+    size_t written_len = 0;
+    gmio_mutex_lock(pdeflate->mutex);
+    while (!job->done) {
+        if (!gmio_zlib_pdeflate_run_next(pdeflate, &pdeflate->z_stream))
+            gmio_cond_wait(pdeflate->cond, pdeflate->mutex);
+    }
+    gmio_mutex_unlock(pdeflate->mutex);
+    ++pdeflate->write_seq;
+
+    if (gmio_no_error(pdeflate->error))
+        pdeflate->error = job->error;
+    if (gmio_no_error(pdeflate->error)) {
+        written_len = gmio_stream_write_bytes(stream, job->out, job->out_len);
+        if (written_len != job->out_len || gmio_stream_error(stream) != 0)
+            pdeflate->error = GMIO_ERROR_STREAM;
+        pdeflate->crc32 =
+                gmio_zlib_crc32_combine(pdeflate->crc32, job->crc32, job->in_len);
+    }
+    return written_len;
+}
+
+/* Queues the job being filled, its dictionary is the tail of the previous
+ * input block */
+static void gmio_zlib_pdeflate_queue(
+        struct gmio_zlib_pdeflate* pdeflate, bool finish)
+{
+    const uintmax_t seq = pdeflate->queued_seq;
+    struct gmio_zlib_pdeflate_job* job = &pdeflate->jobs[seq % pdeflate->job_count];
+    job->in_len = pdeflate->fill_len;
+    job->dict_len = 0;
+    if (seq > 0) {
+        const struct gmio_zlib_pdeflate_job* prev_job =
+                &pdeflate->jobs[(seq - 1) % pdeflate->job_count];
+        job->dict_len =
+                GMIO_MIN(prev_job->in_len, (size_t)GMIO_ZLIB_PDEFLATE_DICT_SIZE);
+        memcpy(job->dict,
+               prev_job->in + prev_job->in_len - job->dict_len,
+               job->dict_len);
+    }
+    job->finish = finish;
+    gmio_mutex_lock(pdeflate->mutex);
+    job->done = false;
+    ++pdeflate->queued_seq;
+    gmio_cond_broadcast(pdeflate->cond);
+    gmio_mutex_unlock(pdeflate->mutex);
+    pdeflate->fill_len = 0;
+}
+
+size_t gmio_zlib_pdeflate_write(
+        struct gmio_zlib_pdeflate* pdeflate,
+        struct gmio_stream* stream,
+        const uint8_t* ptr,
+        size_t len,
+        bool finish,
+        int* error)
+{
+    size_t written_len = 0;
+    while (len > 0 && gmio_no_error(pdeflate->error)) {
+        /* queued_seq is written only by the calling thread */
+        const uintmax_t fill_seq = pdeflate->queued_seq;
+        struct gmio_zlib_pdeflate_job* job =
+                &pdeflate->jobs[fill_seq % pdeflate->job_count];
+        size_t copy_len = 0;
+        /* Job slot reused, its previous output has to be written first */
+        while (pdeflate->write_seq + pdeflate->job_count <= fill_seq
+               && gmio_no_error(pdeflate->error))
+        {
+            written_len += gmio_zlib_pdeflate_write_next(pdeflate, stream);
+        }
+        copy_len =
+                GMIO_MIN(len, GMIO_ZLIB_PDEFLATE_BLOCK_SIZE - pdeflate->fill_len);
+        memcpy(job->in + pdeflate->fill_len, ptr, copy_len);
+        pdeflate->fill_len += copy_len;
+        ptr += copy_len;
+        len -= copy_len;
+        if (pdeflate->fill_len == GMIO_ZLIB_PDEFLATE_BLOCK_SIZE)
+            gmio_zlib_pdeflate_queue(pdeflate, false);
+    }
+    if (finish && gmio_no_error(pdeflate->error)) {
+        while (pdeflate->write_seq + pdeflate->job_count <= pdeflate->queued_seq
+               && gmio_no_error(pdeflate->error))
+        {
+            written_len += gmio_zlib_pdeflate_write_next(pdeflate, stream);
+        }
+        gmio_zlib_pdeflate_queue(pdeflate, true);
+        while (pdeflate->write_seq < pdeflate->queued_seq
+               && gmio_no_error(pdeflate->error))
+        {
+            written_len += gmio_zlib_pdeflate_write_next(pdeflate, stream);
+        }
+    }
+    if (gmio_error(pdeflate->error))
+        *error = pdeflate->error;
+    return written_len;
+}
+
+uint32_t gmio_zlib_pdeflate_crc32(const struct gmio_zlib_pdeflate* pdeflate)
+{
+    return pdeflate->crc32;
+}
+
+struct gmio_zlib_pdeflate* gmio_zlib_pdeflate_create(
+        const struct gmio_zlib_compress_options* z_opts, unsigned thread_count)
+{
+    struct gmio_zlib_pdeflate* pdeflate = NULL;
+    unsigned i;
+#ifndef GMIO_HAVE_THREADS
+    thread_count = 1; /* Caller falls back to sequential deflate */
+#endif
+    if (thread_count < 2)
+        return NULL;
+    pdeflate = calloc(1, sizeof(struct gmio_zlib_pdeflate));
+    if (pdeflate == NULL)
+        return NULL;
+    pdeflate->z_opts = *z_opts;
+    pdeflate->crc32 = gmio_zlib_crc32_initial();
+    if (gmio_error(gmio_zlib_pdeflate_init_zstream(pdeflate, &pdeflate->z_stream))) {
+        free(pdeflate);
+        return NULL;
+    }
+    /* Margin for the sync flush marker, not included by deflateBound() */
+    pdeflate->out_capacity =
+            deflateBound(&pdeflate->z_stream, GMIO_ZLIB_PDEFLATE_BLOCK_SIZE) + 64;
+
+    /* Two jobs per thread so threads don't starve while output is written */
+    pdeflate->job_count = 2 * thread_count;
+    pdeflate->jobs =
+            calloc(pdeflate->job_count, sizeof(struct gmio_zlib_pdeflate_job));
+    pdeflate->threads = calloc(thread_count - 1, sizeof(struct gmio_thread*));
+    pdeflate->mutex = gmio_mutex_create();
+    pdeflate->cond = gmio_cond_create();
+    if (pdeflate->jobs == NULL || pdeflate->threads == NULL
+            || pdeflate->mutex == NULL || pdeflate->cond == NULL)
+    {
+        gmio_zlib_pdeflate_destroy(pdeflate);
+        return NULL;
+    }
+    for (i = 0; i < pdeflate->job_count; ++i) {
+        struct gmio_zlib_pdeflate_job* job = &pdeflate->jobs[i];
+        job->in = malloc(GMIO_ZLIB_PDEFLATE_BLOCK_SIZE);
+        job->dict = malloc(GMIO_ZLIB_PDEFLATE_DICT_SIZE);
+        job->out = malloc(pdeflate->out_capacity);
+        job->done = true;
+        if (job->in == NULL || job->dict == NULL || job->out == NULL) {
+            gmio_zlib_pdeflate_destroy(pdeflate);
+            return NULL;
+        }
+    }
+    /* Jobs are run by the calling thread if no thread could be started */
+    for (i = 0; i + 1 < thread_count; ++i) {
+        pdeflate->threads[i] =
+                gmio_thread_create(gmio_zlib_pdeflate_thread_run, pdeflate);
+        if (pdeflate->threads[i] == NULL)
+            break;
+        ++pdeflate->thread_count;
+    }
+    return pdeflate;
+}
+
+void gmio_zlib_pdeflate_destroy(struct gmio_zlib_pdeflate* pdeflate)
+{
+    unsigned i;
+    if (pdeflate == NULL)
+        return;
+    gmio_mutex_lock(pdeflate->mutex);
+    pdeflate->quit = true;
+    gmio_cond_broadcast(pdeflate->cond);
+    gmio_mutex_unlock(pdeflate->mutex);
+    for (i = 0; i < pdeflate->thread_count; ++i)
+        gmio_thread_join(pdeflate->threads[i]);
+    for (i = 0; pdeflate->jobs != NULL && i < pdeflate->job_count; ++i) {
+        free(pdeflate->jobs[i].in);
+        free(pdeflate->jobs[i].dict);
+        free(pdeflate->jobs[i].out);
+    }
+    deflateEnd(&pdeflate->z_stream);
+    gmio_cond_destroy(pdeflate->cond);
+    gmio_mutex_destroy(pdeflate->mutex);
+    free(pdeflate->threads);
+    free(pdeflate->jobs);
+    free(pdeflate);
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include "../global.h"
+#include "../stream.h"
+#include "../zlib_compress.h"
+
+/*! Opaque object compressing a raw deflate stream with several threads
+ *
+ *  Input data is split into independent blocks of
+ *  \c GMIO_ZLIB_PDEFLATE_BLOCK_SIZE bytes, each block being deflated in its
+ *  own job with a dictionary primed from the last 32KB of the previous block.
+ *  Blocks are terminated with \c Z_SYNC_FLUSH(the last one with \c Z_FINISH)
+ *  so their compressed outputs, written in order, form a single valid deflate
+ *  stream. CRC-32 of the blocks are merged with gmio_zlib_crc32_combine().
+ */
+struct gmio_zlib_pdeflate;
+
+enum { GMIO_ZLIB_PDEFLATE_BLOCK_SIZE = 128 * 1024 /* 128KB */ };
+
+/*! Returns a new parallel deflate object with <tt>thread_count - 1</tt>
+ *  compression threads, the calling thread taking jobs too when it has to wait
+ *  for an output block
+ *
+ *  \p z_opts must be valid(see gmio_check_zlib_compress_options()),
+ *  gmio_zlib_compress_options::func_alloc and
+ *  gmio_zlib_compress_options::func_free must be thread-safe.
+ *
+ *  Returns \c NULL on failure or if threads are not supported, in which case
+ *  the caller must fall back to sequential deflate.
+ */
+struct gmio_zlib_pdeflate* gmio_zlib_pdeflate_create(
+        const struct gmio_zlib_compress_options* z_opts, unsigned thread_count);
+
+/*! Deflates \p len bytes from \p ptr, completed blocks being written in order
+ *  to \p stream
+ *
+ *  If \p finish is \c true then the deflate stream is terminated and written
+ *  entirely before returning.
+ *
+ *  Returns the count of compressed bytes written to \p stream. On failure
+ *  \p error is set and next calls are no-op.
+ */
+size_t gmio_zlib_pdeflate_write(
+        struct gmio_zlib_pdeflate* pdeflate,
+        struct gmio_stream* stream,
+        const uint8_t* ptr,
+        size_t len,
+        bool finish,
+        int* error);
+
+/*! Returns the CRC-32 of the input data whose compressed output was written
+ *  so far */
+uint32_t gmio_zlib_pdeflate_crc32(const struct gmio_zlib_pdeflate* pdeflate);
+
+/*! Stops the compression threads and releases \p pdeflate, which may be
+ *  \c NULL */
+void gmio_zlib_pdeflate_destroy(struct gmio_zlib_pdeflate* pdeflate);
@@ -163,6 +163,11 @@ uint32_t gmio_zlib_crc32_initial()
     return crc32(0, NULL, 0);
 }
 
+uint32_t gmio_zlib_crc32_combine(uint32_t crc1, uint32_t crc2, uintmax_t len2)
+{
+    return crc32_combine(crc1, crc2, (z_off_t)len2);
+}
+
 void gmio_zlib_assign_zstream_in(
         struct z_stream_s *zstream, const uint8_t *next_in, size_t avail_in)
 {
@@ -63,6 +63,10 @@ uint32_t gmio_zlib_crc32_initial();
 uint32_t gmio_zlib_crc32_update(
         uint32_t crc, const uint8_t* buff, size_t buff_len);
 
+/*! Combines CRC-32 \p crc1 of a first block and \p crc2 of a second block of
+ *  \p len2 bytes into the CRC-32 of the two blocks concatenated */
+uint32_t gmio_zlib_crc32_combine(uint32_t crc1, uint32_t crc2, uintmax_t len2);
+
 /*! Type-safe assigns z_stream_s::next_in and z_stream_s::avail_in */
 void gmio_zlib_assign_zstream_in(
         struct z_stream_s* zstream, const uint8_t* next_in, size_t avail_in);
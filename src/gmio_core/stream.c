@@ -27,7 +27,16 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ****************************************************************************/
 
+/* For pwrite() and fseeko() */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#  define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "stream.h"
+#include "internal/min_max.h"
+#include "internal/stream_mmap.h"
+#include "internal/stream_pwrite.h"
+#include "internal/stream_skip.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -59,6 +68,21 @@ GMIO_INLINE int gmio_fstat(int fd, gmio_stat_t* buf)
 
 #endif /* GMIO_HAVE_SYS_TYPES_H && GMIO_HAVE_SYS_STAT_H */
 
+#if defined(GMIO_HAVE_POSIX_MMAP) \
+    && defined(GMIO_HAVE_SYS_TYPES_H) \
+    && defined(GMIO_HAVE_SYS_STAT_H)
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  define GMIO_STREAM_MMAP_SUPPORTED
+#endif
+
+#if defined(GMIO_HAVE_POSIX_PWRITE) && defined(GMIO_HAVE_POSIX_FILENO)
+#  include <errno.h>
+#  include <unistd.h>
+#  define GMIO_STREAM_PWRITE_SUPPORTED
+#endif
+
 struct gmio_stream gmio_stream_null()
 {
     struct gmio_stream null_stream = {0};
@@ -171,3 +195,302 @@ struct gmio_stream gmio_stream_stdio(FILE* file)
     stream.func_set_pos = gmio_stream_stdio_set_pos;
     return stream;
 }
+
+bool gmio_stream_pwrite_begin(
+        struct gmio_stream* stream, gmio_streamoffset_t* base_offset)
+{
+#ifdef GMIO_STREAM_PWRITE_SUPPORTED
+    if (stream != NULL && stream->func_write == gmio_stream_stdio_write) {
+        FILE* file = (FILE*)stream->cookie;
+        if (fflush(file) == 0) {
+            const off_t pos = lseek(fileno(file), 0, SEEK_CUR);
+            if (pos >= 0) {
+                *base_offset = pos;
+                return true;
+            }
+        }
+    }
+#else
+    GMIO_UNUSED(stream);
+    GMIO_UNUSED(base_offset);
+#endif
+    return false;
+}
+
+size_t gmio_stream_pwrite(
+        const struct gmio_stream* stream,
+        const void* ptr,
+        size_t size,
+        gmio_streamoffset_t base_offset,
+        gmio_streamoffset_t offset)
+{
+#ifdef GMIO_STREAM_PWRITE_SUPPORTED
+    const int fd = fileno((FILE*)stream->cookie);
+    const uint8_t* bytes = (const uint8_t*)ptr;
+    size_t pos = 0;
+    while (pos < size) {
+        const ssize_t written_count =
+                pwrite(fd,
+                       bytes + pos,
+                       size - pos,
+                       (off_t)(base_offset + offset + pos));
+        if (written_count > 0)
+            pos += written_count;
+        else if (written_count == 0 || errno != EINTR)
+            break;
+    }
+    return pos;
+#else
+    GMIO_UNUSED(stream);
+    GMIO_UNUSED(ptr);
+    GMIO_UNUSED(size);
+    GMIO_UNUSED(base_offset);
+    GMIO_UNUSED(offset);
+    return 0;
+#endif
+}
+
+bool gmio_stream_pwrite_end(
+        struct gmio_stream* stream, gmio_streamoffset_t end_offset)
+{
+#ifdef GMIO_STREAM_PWRITE_SUPPORTED
+    return fseeko((FILE*)stream->cookie, (off_t)end_offset, SEEK_SET) == 0;
+#else
+    GMIO_UNUSED(stream);
+    GMIO_UNUSED(end_offset);
+    return false;
+#endif
+}
+
+/* Data of a stream created with gmio_stream_mmap() */
+struct gmio_stream_mmap_cookie
+{
+    const uint8_t* ptr;  /* Beginning of the mapping */
+    size_t size;         /* Size of the mapping(ie file size) */
+    size_t pos;          /* Current position */
+    bool at_end;         /* End-of-stream indicator, same semantics as feof() */
+};
+
+#ifdef GMIO_STREAM_MMAP_SUPPORTED
+static bool gmio_stream_mmap_at_end(void* cookie)
+{
+    return ((const struct gmio_stream_mmap_cookie*)cookie)->at_end;
+}
+
+static int gmio_stream_mmap_error(void* cookie)
+{
+    GMIO_UNUSED(cookie);
+    return 0;
+}
+
+static size_t gmio_stream_mmap_read(
+        void* cookie, void* ptr, size_t item_size, size_t item_count)
+{
+    struct gmio_stream_mmap_cookie* mmcookie =
+            (struct gmio_stream_mmap_cookie*)cookie;
+    const size_t remaining_size = mmcookie->size - mmcookie->pos;
+    const size_t read_count =
+            item_size != 0 ?
+                (item_count <= remaining_size / item_size ?
+                     item_count :
+                     remaining_size / item_size) :
+                0;
+    const size_t read_size = read_count * item_size;
+    if (read_size > 0)
+        memcpy(ptr, mmcookie->ptr + mmcookie->pos, read_size);
+    mmcookie->pos += read_size;
+    if (read_count < item_count)
+        mmcookie->at_end = true;
+    return read_count;
+}
+
+static gmio_streamsize_t gmio_stream_mmap_size(void* cookie)
+{
+    return ((const struct gmio_stream_mmap_cookie*)cookie)->size;
+}
+
+static int gmio_stream_mmap_get_pos(void* cookie, struct gmio_streampos* pos)
+{
+    const struct gmio_stream_mmap_cookie* mmcookie =
+            (const struct gmio_stream_mmap_cookie*)cookie;
+    memcpy(pos->cookie, &mmcookie->pos, sizeof(size_t));
+    return 0;
+}
+
+static int gmio_stream_mmap_set_pos(
+        void* cookie, const struct gmio_streampos* pos)
+{
+    struct gmio_stream_mmap_cookie* mmcookie =
+            (struct gmio_stream_mmap_cookie*)cookie;
+    size_t new_pos;
+    memcpy(&new_pos, pos->cookie, sizeof(size_t));
+    if (new_pos > mmcookie->size)
+        return -1;
+    mmcookie->pos = new_pos;
+    mmcookie->at_end = false;
+    return 0;
+}
+#endif /* GMIO_STREAM_MMAP_SUPPORTED */
+
+struct gmio_stream gmio_stream_mmap(const char* filepath)
+{
+    struct gmio_stream stream = gmio_stream_null();
+#ifdef GMIO_STREAM_MMAP_SUPPORTED
+    struct gmio_stream_mmap_cookie* cookie = NULL;
+    gmio_stat_t buf;
+    const int fd = open(filepath, O_RDONLY);
+    if (fd == -1)
+        return stream;
+    if (gmio_fstat(fd, &buf) != 0 || (uintmax_t)buf.st_size > (size_t)-1)
+        goto label_end;
+
+    cookie = calloc(1, sizeof(struct gmio_stream_mmap_cookie));
+    if (cookie == NULL)
+        goto label_end;
+    cookie->size = (size_t)buf.st_size;
+    /* Zero-length mapping is not allowed, empty files are just not mapped */
+    if (cookie->size > 0) {
+        void* ptr = mmap(NULL, cookie->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            free(cookie);
+            goto label_end;
+        }
+        cookie->ptr = (const uint8_t*)ptr;
+    }
+
+    stream.cookie = cookie;
+    stream.func_at_end = gmio_stream_mmap_at_end;
+    stream.func_error = gmio_stream_mmap_error;
+    stream.func_read = gmio_stream_mmap_read;
+    stream.func_size = gmio_stream_mmap_size;
+    stream.func_get_pos = gmio_stream_mmap_get_pos;
+    stream.func_set_pos = gmio_stream_mmap_set_pos;
+
+label_end:
+    /* The mapping remains valid after the file descriptor is closed */
+    close(fd);
+#else
+    GMIO_UNUSED(filepath);
+#endif
+    return stream;
+}
+
+void gmio_stream_mmap_close(struct gmio_stream* stream)
+{
+    if (stream != NULL && stream->cookie != NULL) {
+        struct gmio_stream_mmap_cookie* cookie =
+                (struct gmio_stream_mmap_cookie*)stream->cookie;
+#ifdef GMIO_STREAM_MMAP_SUPPORTED
+        if (cookie->ptr != NULL)
+            munmap((void*)cookie->ptr, cookie->size);
+#endif
+        free(cookie);
+        *stream = gmio_stream_null();
+    }
+}
+
+/* Returns the cookie of \p stream if it was created with gmio_stream_mmap() */
+static const struct gmio_stream_mmap_cookie* gmio_stream_mmap_cookie(
+        const struct gmio_stream* stream)
+{
+#ifdef GMIO_STREAM_MMAP_SUPPORTED
+    if (stream != NULL
+            && stream->cookie != NULL
+            && stream->func_read == gmio_stream_mmap_read)
+    {
+        return (const struct gmio_stream_mmap_cookie*)stream->cookie;
+    }
+#else
+    GMIO_UNUSED(stream);
+#endif
+    return NULL;
+}
+
+const void* gmio_stream_mmap_data(const struct gmio_stream* stream)
+{
+    const struct gmio_stream_mmap_cookie* cookie =
+            gmio_stream_mmap_cookie(stream);
+    return cookie != NULL ? cookie->ptr : NULL;
+}
+
+const char* gmio_stream_mmap_current(
+        const struct gmio_stream* stream, size_t* remaining_size)
+{
+    const struct gmio_stream_mmap_cookie* cookie =
+            gmio_stream_mmap_cookie(stream);
+    if (cookie != NULL && cookie->ptr != NULL) {
+        *remaining_size = cookie->size - cookie->pos;
+        return (const char*)cookie->ptr + cookie->pos;
+    }
+    return NULL;
+}
+
+void gmio_stream_mmap_skip(struct gmio_stream* stream, size_t size)
+{
+    if (gmio_stream_mmap_cookie(stream) != NULL) {
+        struct gmio_stream_mmap_cookie* cookie =
+                (struct gmio_stream_mmap_cookie*)stream->cookie;
+        const size_t remaining_size = cookie->size - cookie->pos;
+        cookie->pos += GMIO_MIN(size, remaining_size);
+        if (size > remaining_size)
+            cookie->at_end = true;
+    }
+}
+
+bool gmio_stream_skip(
+        struct gmio_stream* stream,
+        gmio_streamoffset_t offset,
+        struct gmio_memblock* mblock)
+{
+    size_t remaining_size = 0;
+    if (offset <= 0)
+        return offset == 0;
+
+    /* Memory-mapped stream */
+    if (gmio_stream_mmap_current(stream, &remaining_size) != NULL) {
+        if ((gmio_streamsize_t)remaining_size < offset)
+            return false;
+        gmio_stream_mmap_skip(stream, (size_t)offset);
+        return true;
+    }
+
+    /* Stream over FILE* */
+    if (stream->func_read == gmio_stream_stdio_read) {
+        FILE* file = (FILE*)stream->cookie;
+        const gmio_streamsize_t size = gmio_stream_stdio_size(file);
+#if defined(_WIN32)
+        const long long pos = _ftelli64(file);
+#elif defined(_POSIX_C_SOURCE)
+        const off_t pos = ftello(file);
+#else
+        const long pos = ftell(file);
+#endif
+        if (pos >= 0 && size >= 0) {
+            if (size - pos < offset)
+                return false;
+#if defined(_WIN32)
+            return _fseeki64(file, offset, SEEK_CUR) == 0;
+#elif defined(_POSIX_C_SOURCE)
+            return fseeko(file, (off_t)offset, SEEK_CUR) == 0;
+#else
+            if (offset <= 0x7FFFFFFF)
+                return fseek(file, (long)offset, SEEK_CUR) == 0;
+#endif
+        }
+    }
+
+    /* Generic case: read and discard */
+    if (mblock == NULL || mblock->ptr == NULL || mblock->size == 0)
+        return false;
+    while (offset > 0) {
+        const size_t read_size =
+                (size_t)GMIO_MIN((gmio_streamoffset_t)mblock->size, offset);
+        if (stream->func_read(stream->cookie, mblock->ptr, 1, read_size)
+                != read_size)
+        {
+            return false;
+        }
+        offset -= read_size;
+    }
+    return true;
+}
@@ -157,6 +157,153 @@ GMIO_API struct gmio_stream gmio_stream_null();
 /*! Returns a stream for standard FILE* (cookie will hold \p file) */
 GMIO_API struct gmio_stream gmio_stream_stdio(FILE* file);
 
+/*! Returns a read-only stream over the file at \p filepath, which is mapped
+ *  in memory
+ *
+ *  The whole file is mapped at once, gmio_stream::func_read() is then served
+ *  by copying from the mapping (no intermediate <tt><stdio.h></tt> buffer).
+ *  gmio_stream::func_size(), gmio_stream::func_get_pos() and
+ *  gmio_stream::func_set_pos() have O(1) cost.
+ *
+ *  The returned stream must be released with gmio_stream_mmap_close()
+ *
+ *  \return A null stream(ie gmio_stream::cookie is \c NULL) if the file
+ *          could not be mapped, or if memory-mapping is not supported on the
+ *          target platform. The caller can check \c errno to get the real
+ *          error number.
+ *
+ *  \sa gmio_stream_mmap_data()
+ */
+GMIO_API struct gmio_stream gmio_stream_mmap(const char* filepath);
+
+/*! Releases the resources of a stream created with gmio_stream_mmap()
+ *
+ *  The file is unmapped and \p stream is reset to a null stream */
+GMIO_API void gmio_stream_mmap_close(struct gmio_stream* stream);
+
+/*! Returns the pointer to the beginning of the memory-mapped file of a stream
+ *  created with gmio_stream_mmap()
+ *
+ *  The size of the mapping is given by gmio_stream::func_size()
+ *
+ *  \return \c NULL if \p stream was not created with gmio_stream_mmap(), or
+ *          if the file is empty
+ */
+GMIO_API const void* gmio_stream_mmap_data(const struct gmio_stream* stream);
+
+/*! Returns a read-only stream that prefetches data of \p stream in a
+ *  background thread
+ *
+ *  The background thread reads \p stream by chunks of \p buffer_size bytes
+ *  into a ring of \p buffer_count buffers, while the caller consumes the
+ *  previously read chunks. This way I/O latency of \p stream(eg. network
+ *  filesystem, spinning disk) is mostly hidden behind the processing of data.
+ *
+ *  \p buffer_size defaults to 128KB if \c 0 and \p buffer_count is at least
+ *  \c 2 (double-buffering).
+ *
+ *  \p stream is copied and is then used by the background thread : it must
+ *  not be accessed by the caller until gmio_stream_readahead_close(), after
+ *  which its current position is unspecified.\n
+ *  gmio_stream::func_size() returns the size of \p stream at creation time.
+ *  gmio_stream::func_get_pos() and gmio_stream::func_set_pos() are available
+ *  only if \p stream provides them. Restoring a position still held in the
+ *  buffers is cheap, otherwise \p stream is rewound to its position at
+ *  creation time then read up to the requested position.
+ *
+ *  The returned stream must be released with gmio_stream_readahead_close()
+ *
+ *  \return A null stream(ie gmio_stream::cookie is \c NULL) if resources
+ *           could not be allocated or if threads are not supported on the
+ *           target platform
+ */
+GMIO_API struct gmio_stream gmio_stream_readahead(
+        const struct gmio_stream* stream,
+        size_t buffer_size,
+        unsigned buffer_count);
+
+/*! Releases the resources of a stream created with gmio_stream_readahead()
+ *
+ *  The background thread is stopped and \p stream is reset to a null stream.
+ *  The underlying stream is not closed */
+GMIO_API void gmio_stream_readahead_close(struct gmio_stream* stream);
+
+/*! Returns a write-only stream that writes data to \p stream in a background
+ *  thread
+ *
+ *  Data written to the returned stream is copied into a buffer of
+ *  \p buffer_size bytes. Once full, the buffer is queued to the background
+ *  thread that writes it to \p stream, while the caller goes on with the next
+ *  free buffer of the ring. Memory usage is bounded : if all the
+ *  \p buffer_count buffers are queued then the caller waits for the first one
+ *  to be written. This way output I/O (eg. network filesystem) overlaps with
+ *  the encoding of data.
+ *
+ *  \p buffer_size defaults to 128KB if \c 0 and \p buffer_count is at least
+ *  \c 2 (double-buffering).
+ *
+ *  \p stream is copied and is then used by the background thread : it must
+ *  not be accessed by the caller until gmio_stream_writebehind_close().\n
+ *  As data is actually written later on, an error occurring in the background
+ *  thread is reported by the next call to gmio_stream::func_write() (that
+ *  returns \c 0), by gmio_stream::func_error() and by
+ *  gmio_stream_writebehind_close(). Data written after an error is discarded.\n
+ *  gmio_stream::func_get_pos() and gmio_stream::func_set_pos() are available
+ *  only if \p stream provides them, they first wait for all pending data to
+ *  be written.
+ *
+ *  The returned stream must be released with gmio_stream_writebehind_close()
+ *
+ *  \return A null stream(ie gmio_stream::cookie is \c NULL) if resources
+ *           could not be allocated or if threads are not supported on the
+ *           target platform
+ */
+GMIO_API struct gmio_stream gmio_stream_writebehind(
+        const struct gmio_stream* stream,
+        size_t buffer_size,
+        unsigned buffer_count);
+
+/*! Writes any pending data then releases the resources of a stream created
+ *  with gmio_stream_writebehind()
+ *
+ *  The background thread is stopped and \p stream is reset to a null stream.
+ *  The underlying stream is not closed(nor flushed)
+ *
+ *  \retval 0 if all data was successfully written
+ *  \retval !=0 if any write to the underlying stream failed
+ */
+GMIO_API int gmio_stream_writebehind_close(struct gmio_stream* stream);
+
+/*! Returns a read-only stream over the file descriptor \p fd, read with
+ *  Linux io_uring
+ *
+ *  Several reads of 128KB are kept in flight ahead of the current position
+ *  and are submitted with a single system call. Buffers are registered to the
+ *  kernel when allowed(see \c RLIMIT_MEMLOCK), so data is read without extra
+ *  page pinning per request.\n
+ *  Reading starts at the current offset of \p fd, which is not modified
+ *  afterwards(reads are positioned).
+ *  gmio_stream::func_size() returns the size of the file at creation time.
+ *  Restoring a position held in the current buffer is cheap, otherwise all
+ *  in-flight reads are awaited then requested again from the new position.
+ *
+ *  Available only if gmio was built with the \c GMIO_USE_LINUX_IO_URING
+ *  option and the host kernel supports io_uring(Linux >= 5.1).
+ *
+ *  The returned stream must be released with gmio_stream_uring_close(), \p fd
+ *  must stay open until then.
+ *
+ *  \return A null stream(ie gmio_stream::cookie is \c NULL) if resources
+ *          could not be allocated or if io_uring is not available
+ */
+GMIO_API struct gmio_stream gmio_stream_uring(int fd);
+
+/*! Releases the resources of a stream created with gmio_stream_uring()
+ *
+ *  Pending reads are awaited and \p stream is reset to a null stream.
+ *  The file descriptor is not closed */
+GMIO_API void gmio_stream_uring_close(struct gmio_stream* stream);
+
 GMIO_C_LINKAGE_END
 
 /*! @} */
@@ -0,0 +1,380 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "stream.h"
+#include "internal/helper_stream.h"
+#include "internal/min_max.h"
+#include "internal/thread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum { GMIO_STREAM_READAHEAD_DEFAULT_BUFFER_SIZE = 128 * 1024 /* 128KB */ };
+
+/* Buffer of the ring filled by the read-ahead thread */
+struct gmio_stream_readahead_buffer
+{
+    uint8_t* ptr;
+    size_t len; /* Count of bytes held */
+    gmio_streamoffset_t offset; /* Offset of the first byte, from origin */
+    struct gmio_streampos source_end_pos; /* Source position after last byte */
+    bool valid; /* Members above describe the actual contents */
+};
+
+/* Data of a stream created with gmio_stream_readahead()
+ *
+ * Buffers [head, head + filled_count) of the ring hold prefetched data, the
+ * others are free to be filled by the read-ahead thread. Free buffers keep
+ * their contents until they are filled again, so they can still serve
+ * gmio_stream::func_set_pos() */
+struct gmio_stream_readahead_cookie
+{
+    struct gmio_stream source;
+    struct gmio_thread* thread;
+    struct gmio_mutex* mutex;
+    struct gmio_cond* cond; /* Signaled when any member below mutex changes */
+    struct gmio_stream_readahead_buffer* buffers;
+    unsigned buffer_count;
+    size_t buffer_size;
+    gmio_streamsize_t source_size;
+    struct gmio_streampos source_origin_pos; /* Source position at offset 0 */
+    bool has_pos; /* Source supports get/set position */
+
+    /* Accessed only by the reading thread */
+    bool has_head; /* Buffer at head is being consumed */
+    size_t head_len;
+    size_t head_cursor;
+    bool at_end; /* End-of-stream indicator, same semantics as feof() */
+
+    /* Accessed only with mutex locked */
+    unsigned head;
+    unsigned filled_count;
+    gmio_streamoffset_t fill_offset; /* Offset of the next buffer to fill */
+    bool filling; /* Read-ahead thread is reading from source */
+    bool source_end; /* Nothing more to prefetch */
+    bool source_error;
+    bool quit;
+};
+
+/* Function of the read-ahead thread */
+static void gmio_stream_readahead_run(void* arg)
+{
+    struct gmio_stream_readahead_cookie* rac =
+            (struct gmio_stream_readahead_cookie*)arg;
+    gmio_mutex_lock(rac->mutex);
+    while (!rac->quit) {
+        struct gmio_stream_readahead_buffer* buffer = NULL;
+        size_t len;
+        bool end;
+        bool error;
+        if (rac->source_end || rac->filled_count == rac->buffer_count) {
+            gmio_cond_wait(rac->cond, rac->mutex);
+            continue;
+        }
+
+        /* Fill the next free buffer, outside of the lock */
+        buffer =
+                &rac->buffers[(rac->head + rac->filled_count)
+                              % rac->buffer_count];
+        buffer->valid = false;
+        buffer->offset = rac->fill_offset;
+        rac->filling = true;
+        gmio_mutex_unlock(rac->mutex);
+        len = gmio_stream_read(&rac->source, buffer->ptr, 1, rac->buffer_size);
+        end = len < rac->buffer_size;
+        error = end && gmio_stream_error(&rac->source) != 0;
+        if (rac->has_pos)
+            gmio_stream_get_pos(&rac->source, &buffer->source_end_pos);
+
+        gmio_mutex_lock(rac->mutex);
+        rac->filling = false;
+        buffer->len = len;
+        if (len > 0) {
+            buffer->valid = true;
+            ++rac->filled_count;
+            rac->fill_offset += len;
+        }
+        rac->source_end = end;
+        rac->source_error = error;
+        gmio_cond_broadcast(rac->cond);
+    }
+    gmio_mutex_unlock(rac->mutex);
+}
+
+static bool gmio_stream_readahead_at_end(void* cookie)
+{
+    return ((const struct gmio_stream_readahead_cookie*)cookie)->at_end;
+}
+
+static int gmio_stream_readahead_error(void* cookie)
+{
+    struct gmio_stream_readahead_cookie* rac =
+            (struct gmio_stream_readahead_cookie*)cookie;
+    bool error;
+    gmio_mutex_lock(rac->mutex);
+    error = rac->source_error;
+    gmio_mutex_unlock(rac->mutex);
+    return error ? 1 : 0;
+}
+
+static size_t gmio_stream_readahead_read(
+        void* cookie, void* ptr, size_t item_size, size_t item_count)
+{
+    struct gmio_stream_readahead_cookie* rac =
+            (struct gmio_stream_readahead_cookie*)cookie;
+    const size_t size = item_size * item_count;
+    uint8_t* bytes = (uint8_t*)ptr;
+    size_t pos = 0;
+
+    while (pos < size) {
+        /* Copy from the buffer being consumed, no lock needed */
+        if (rac->has_head && rac->head_cursor < rac->head_len) {
+            const uint8_t* head_ptr = rac->buffers[rac->head].ptr;
+            const size_t copy_size =
+                    GMIO_MIN(rac->head_len - rac->head_cursor, size - pos);
+            memcpy(bytes + pos, head_ptr + rac->head_cursor, copy_size);
+            rac->head_cursor += copy_size;
+            pos += copy_size;
+            continue;
+        }
+
+        /* Release the consumed buffer and wait for the next one */
+        gmio_mutex_lock(rac->mutex);
+        if (rac->has_head) {
+            rac->head = (rac->head + 1) % rac->buffer_count;
+            --rac->filled_count;
+            rac->has_head = false;
+            gmio_cond_broadcast(rac->cond);
+        }
+        while (rac->filled_count == 0 && !rac->source_end)
+            gmio_cond_wait(rac->cond, rac->mutex);
+        if (rac->filled_count > 0) {
+            rac->has_head = true;
+            rac->head_len = rac->buffers[rac->head].len;
+            rac->head_cursor = 0;
+        }
+        gmio_mutex_unlock(rac->mutex);
+        if (!rac->has_head) {
+            rac->at_end = true;
+            break;
+        }
+    }
+    return item_size != 0 ? pos / item_size : 0;
+}
+
+static gmio_streamsize_t gmio_stream_readahead_size(void* cookie)
+{
+    return ((const struct gmio_stream_readahead_cookie*)cookie)->source_size;
+}
+
+static int gmio_stream_readahead_get_pos(
+        void* cookie, struct gmio_streampos* pos)
+{
+    struct gmio_stream_readahead_cookie* rac =
+            (struct gmio_stream_readahead_cookie*)cookie;
+    gmio_streamoffset_t offset;
+    gmio_mutex_lock(rac->mutex);
+    if (rac->has_head)
+        offset = rac->buffers[rac->head].offset + rac->head_cursor;
+    else if (rac->filled_count > 0)
+        offset = rac->buffers[rac->head].offset;
+    else
+        offset = rac->fill_offset;
+    gmio_mutex_unlock(rac->mutex);
+    memcpy(pos->cookie, &offset, sizeof(gmio_streamoffset_t));
+    return 0;
+}
+
+/* Moves the source to \p offset, the read-ahead thread must be idle(mutex
+ * locked and no buffer being filled)
+ *
+ * If a buffer still holds data at \p offset then it becomes the head, the
+ * source being moved after its last byte. Otherwise the source is rewound to
+ * its origin then read up to \p offset */
+static int gmio_stream_readahead_seek_source(
+        struct gmio_stream_readahead_cookie* rac, gmio_streamoffset_t offset)
+{
+    unsigned i;
+    for (i = 0; i < rac->buffer_count; ++i) {
+        struct gmio_stream_readahead_buffer* buffer = &rac->buffers[i];
+        if (buffer->valid
+                && buffer->offset <= offset
+                && offset <= buffer->offset + (gmio_streamoffset_t)buffer->len
+                && gmio_stream_set_pos(
+                    &rac->source, &buffer->source_end_pos) == 0)
+        {
+            rac->head = i;
+            rac->filled_count = 1;
+            rac->fill_offset = buffer->offset + buffer->len;
+            rac->has_head = true;
+            rac->head_len = buffer->len;
+            rac->head_cursor = (size_t)(offset - buffer->offset);
+            return 0;
+        }
+    }
+
+    rac->head = 0;
+    rac->filled_count = 0;
+    rac->fill_offset = 0;
+    rac->has_head = false;
+    rac->buffers[0].valid = false;
+    if (gmio_stream_set_pos(&rac->source, &rac->source_origin_pos) != 0)
+        return -1;
+    while (rac->fill_offset < offset) {
+        const size_t skip_size =
+                (size_t)GMIO_MIN(offset - rac->fill_offset,
+                                 (gmio_streamoffset_t)rac->buffer_size);
+        const size_t len =
+                gmio_stream_read(&rac->source, rac->buffers[0].ptr, 1, skip_size);
+        rac->fill_offset += len;
+        if (len < skip_size)
+            return -1;
+    }
+    return 0;
+}
+
+static int gmio_stream_readahead_set_pos(
+        void* cookie, const struct gmio_streampos* pos)
+{
+    struct gmio_stream_readahead_cookie* rac =
+            (struct gmio_stream_readahead_cookie*)cookie;
+    gmio_streamoffset_t offset;
+    int res;
+    memcpy(&offset, pos->cookie, sizeof(gmio_streamoffset_t));
+
+    /* Fast path: offset is within the buffer being consumed */
+    if (rac->has_head) {
+        const gmio_streamoffset_t head_offset = rac->buffers[rac->head].offset;
+        if (head_offset <= offset
+                && offset <= head_offset + (gmio_streamoffset_t)rac->head_len)
+        {
+            rac->head_cursor = (size_t)(offset - head_offset);
+            rac->at_end = false;
+            return 0;
+        }
+    }
+
+    /* Wait for the read-ahead thread to be idle, keeping mutex locked prevents
+     * it from accessing the source */
+    gmio_mutex_lock(rac->mutex);
+    while (rac->filling)
+        gmio_cond_wait(rac->cond, rac->mutex);
+    res = gmio_stream_readahead_seek_source(rac, offset);
+    rac->at_end = false;
+    rac->source_end = res != 0;
+    rac->source_error = false;
+    gmio_cond_broadcast(rac->cond);
+    gmio_mutex_unlock(rac->mutex);
+    return res;
+}
+
+static void gmio_stream_readahead_free(struct gmio_stream_readahead_cookie* rac)
+{
+    unsigned i;
+    if (rac->buffers != NULL) {
+        for (i = 0; i < rac->buffer_count; ++i)
+            free(rac->buffers[i].ptr);
+    }
+    free(rac->buffers);
+    gmio_cond_destroy(rac->cond);
+    gmio_mutex_destroy(rac->mutex);
+    free(rac);
+}
+
+struct gmio_stream gmio_stream_readahead(
+        const struct gmio_stream* stream,
+        size_t buffer_size,
+        unsigned buffer_count)
+{
+    struct gmio_stream rastream = gmio_stream_null();
+    struct gmio_stream_readahead_cookie* rac = NULL;
+    bool ok = false;
+    unsigned i;
+
+    if (stream == NULL || stream->func_read == NULL)
+        return rastream;
+    rac = calloc(1, sizeof(struct gmio_stream_readahead_cookie));
+    if (rac == NULL)
+        return rastream;
+
+    rac->source = *stream;
+    rac->buffer_size =
+            buffer_size != 0 ?
+                buffer_size : GMIO_STREAM_READAHEAD_DEFAULT_BUFFER_SIZE;
+    rac->buffer_count = GMIO_MAX(buffer_count, 2);
+    rac->source_size = gmio_stream_size(&rac->source);
+    rac->has_pos =
+            stream->func_get_pos != NULL
+            && stream->func_set_pos != NULL
+            && gmio_stream_get_pos(&rac->source, &rac->source_origin_pos) == 0;
+    rac->mutex = gmio_mutex_create();
+    rac->cond = gmio_cond_create();
+    rac->buffers =
+            calloc(rac->buffer_count, sizeof(struct gmio_stream_readahead_buffer));
+    ok = rac->mutex != NULL && rac->cond != NULL && rac->buffers != NULL;
+    for (i = 0; ok && i < rac->buffer_count; ++i) {
+        rac->buffers[i].ptr = malloc(rac->buffer_size);
+        ok = rac->buffers[i].ptr != NULL;
+    }
+    if (ok) {
+        rac->thread = gmio_thread_create(gmio_stream_readahead_run, rac);
+        ok = rac->thread != NULL;
+    }
+    if (!ok) {
+        gmio_stream_readahead_free(rac);
+        return rastream;
+    }
+
+    rastream.cookie = rac;
+    rastream.func_at_end = gmio_stream_readahead_at_end;
+    rastream.func_error = gmio_stream_readahead_error;
+    rastream.func_read = gmio_stream_readahead_read;
+    if (stream->func_size != NULL)
+        rastream.func_size = gmio_stream_readahead_size;
+    if (rac->has_pos) {
+        rastream.func_get_pos = gmio_stream_readahead_get_pos;
+        rastream.func_set_pos = gmio_stream_readahead_set_pos;
+    }
+    return rastream;
+}
+
+void gmio_stream_readahead_close(struct gmio_stream* stream)
+{
+    if (stream != NULL && stream->cookie != NULL) {
+        struct gmio_stream_readahead_cookie* rac =
+                (struct gmio_stream_readahead_cookie*)stream->cookie;
+        gmio_mutex_lock(rac->mutex);
+        rac->quit = true;
+        gmio_cond_broadcast(rac->cond);
+        gmio_mutex_unlock(rac->mutex);
+        gmio_thread_join(rac->thread);
+        gmio_stream_readahead_free(rac);
+        *stream = gmio_stream_null();
+    }
+}
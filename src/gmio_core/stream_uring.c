@@ -0,0 +1,526 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+/* For syscall() and MAP_POPULATE */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#  define _GNU_SOURCE
+#endif
+
+#include "stream.h"
+#include "internal/min_max.h"
+
+#ifdef GMIO_HAVE_LINUX_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+enum {
+    /* Count of reads kept in flight */
+    GMIO_STREAM_URING_DEPTH = 8,
+    GMIO_STREAM_URING_BUFFER_SIZE = 128 * 1024 /* 128KB */
+};
+
+/* Rings shared with the kernel, mapped in memory */
+struct gmio_uring
+{
+    int fd;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    void* sq_ptr;
+    size_t sq_size;
+    void* cq_ptr; /* Same as sq_ptr with IORING_FEAT_SINGLE_MMAP */
+    size_t cq_size;
+    size_t sqes_size;
+    unsigned to_submit; /* Count of SQEs queued but not yet submitted */
+};
+
+enum gmio_stream_uring_slot_state
+{
+    GMIO_STREAM_URING_SLOT_FREE = 0,
+    GMIO_STREAM_URING_SLOT_INFLIGHT,
+    GMIO_STREAM_URING_SLOT_DONE
+};
+
+/* Read request on a buffer of the memblock */
+struct gmio_stream_uring_slot
+{
+    enum gmio_stream_uring_slot_state state;
+    gmio_streamoffset_t offset; /* File offset of the first byte */
+    size_t request_len;
+    size_t len; /* Count of bytes read so far */
+    bool error;
+};
+
+/* Data of a stream created with gmio_stream_uring()
+ *
+ * Slots [head, head + queued_count) of the ring are in flight or hold data,
+ * with increasing file offsets. Other slots are free */
+struct gmio_stream_uring_cookie
+{
+    int fd;
+    struct gmio_uring ring;
+    struct gmio_memblock memblock; /* Buffers of the slots, contiguous */
+    struct iovec iovecs[GMIO_STREAM_URING_DEPTH]; /* Buffer of each slot */
+    struct iovec request_iovecs[GMIO_STREAM_URING_DEPTH]; /* For READV */
+    bool registered_buffers;
+    struct gmio_stream_uring_slot slots[GMIO_STREAM_URING_DEPTH];
+    unsigned head;
+    unsigned queued_count;
+    size_t head_cursor;
+    gmio_streamoffset_t submit_offset; /* File offset of the next request */
+    gmio_streamsize_t size;
+    bool source_end; /* Nothing more to request */
+    bool at_end; /* End-of-stream indicator, same semantics as feof() */
+    bool error;
+};
+
+static int gmio_uring_setup(unsigned entries, struct io_uring_params* p)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int gmio_uring_enter(
+        int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return (int)syscall(
+                __NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int gmio_uring_register(
+        int fd, unsigned opcode, const void* arg, unsigned nr_args)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+/* Releases the resources of \p ring, which is then reset(so releasing it
+ * again is harmless) */
+static void gmio_uring_release(struct gmio_uring* ring)
+{
+    if (ring->sqes != NULL && ring->sqes != MAP_FAILED)
+        munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ptr != NULL
+            && ring->cq_ptr != MAP_FAILED
+            && ring->cq_ptr != ring->sq_ptr)
+    {
+        munmap(ring->cq_ptr, ring->cq_size);
+    }
+    if (ring->sq_ptr != NULL && ring->sq_ptr != MAP_FAILED)
+        munmap(ring->sq_ptr, ring->sq_size);
+    if (ring->fd >= 0)
+        close(ring->fd);
+    memset(ring, 0, sizeof(struct gmio_uring));
+    ring->fd = -1;
+}
+
+static bool gmio_uring_init(struct gmio_uring* ring, unsigned entries)
+{
+    struct io_uring_params p;
+    uint8_t* sq_ptr;
+    uint8_t* cq_ptr;
+    memset(&p, 0, sizeof(p));
+    memset(ring, 0, sizeof(struct gmio_uring));
+    ring->fd = gmio_uring_setup(entries, &p);
+    if (ring->fd < 0)
+        return false;
+
+    ring->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        ring->sq_size = ring->cq_size = GMIO_MAX(ring->sq_size, ring->cq_size);
+    ring->sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED)
+        goto label_error;
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ptr = ring->sq_ptr;
+    }
+    else {
+        ring->cq_ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ptr == MAP_FAILED)
+            goto label_error;
+    }
+    ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+        goto label_error;
+
+    sq_ptr = (uint8_t*)ring->sq_ptr;
+    cq_ptr = (uint8_t*)ring->cq_ptr;
+    ring->sq_tail = (unsigned*)(sq_ptr + p.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq_ptr + p.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq_ptr + p.sq_off.array);
+    ring->cq_head = (unsigned*)(cq_ptr + p.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq_ptr + p.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq_ptr + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq_ptr + p.cq_off.cqes);
+    return true;
+
+label_error:
+    gmio_uring_release(ring);
+    return false;
+}
+
+/* Submits queued SQEs, then waits for at least \p min_complete completions */
+static bool gmio_uring_submit_and_wait(
+        struct gmio_uring* ring, unsigned min_complete)
+{
+    const unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int res;
+    do {
+        res = gmio_uring_enter(ring->fd, ring->to_submit, min_complete, flags);
+    } while (res < 0 && errno == EINTR);
+    if (res < 0)
+        return false;
+    ring->to_submit -= GMIO_MIN((unsigned)res, ring->to_submit);
+    return true;
+}
+
+/* Queues a read SQE to fill the remaining part of slot \p islot */
+static void gmio_stream_uring_prep_read(
+        struct gmio_stream_uring_cookie* urc, unsigned islot)
+{
+    struct gmio_uring* ring = &urc->ring;
+    struct gmio_stream_uring_slot* slot = &urc->slots[islot];
+    const unsigned tail = *ring->sq_tail;
+    const unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    uint8_t* buffer = (uint8_t*)urc->iovecs[islot].iov_base + slot->len;
+
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->fd = urc->fd;
+    sqe->off = (uint64_t)(slot->offset + slot->len);
+    sqe->user_data = islot;
+    if (urc->registered_buffers) {
+        /* Kernel writes directly into the registered memblock */
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->addr = (uint64_t)(uintptr_t)buffer;
+        sqe->len = (uint32_t)(slot->request_len - slot->len);
+        sqe->buf_index = (uint16_t)islot;
+    }
+    else {
+        struct iovec* iov = &urc->request_iovecs[islot];
+        iov->iov_base = buffer;
+        iov->iov_len = slot->request_len - slot->len;
+        sqe->opcode = IORING_OP_READV;
+        sqe->addr = (uint64_t)(uintptr_t)iov;
+        sqe->len = 1;
+    }
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++ring->to_submit;
+    slot->state = GMIO_STREAM_URING_SLOT_INFLIGHT;
+}
+
+/* Requests reads for free slots, up to the end of file */
+static bool gmio_stream_uring_request_reads(struct gmio_stream_uring_cookie* urc)
+{
+    while (urc->queued_count < GMIO_STREAM_URING_DEPTH
+           && urc->submit_offset < urc->size
+           && !urc->source_end)
+    {
+        const unsigned islot =
+                (urc->head + urc->queued_count) % GMIO_STREAM_URING_DEPTH;
+        struct gmio_stream_uring_slot* slot = &urc->slots[islot];
+        slot->offset = urc->submit_offset;
+        slot->request_len =
+                (size_t)GMIO_MIN(
+                    (gmio_streamsize_t)urc->iovecs[islot].iov_len,
+                    urc->size - urc->submit_offset);
+        slot->len = 0;
+        slot->error = false;
+        gmio_stream_uring_prep_read(urc, islot);
+        urc->submit_offset += slot->request_len;
+        ++urc->queued_count;
+    }
+    return urc->ring.to_submit == 0 || gmio_uring_submit_and_wait(&urc->ring, 0);
+}
+
+/* Handles available completions */
+static void gmio_stream_uring_reap(struct gmio_stream_uring_cookie* urc)
+{
+    struct gmio_uring* ring = &urc->ring;
+    unsigned head = *ring->cq_head;
+    const unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const struct io_uring_cqe* cqe = &ring->cqes[head & *ring->cq_mask];
+        struct gmio_stream_uring_slot* slot = &urc->slots[cqe->user_data];
+        const int res = cqe->res;
+        ++head;
+        if (res == -EINTR || res == -EAGAIN) {
+            gmio_stream_uring_prep_read(urc, (unsigned)cqe->user_data);
+            continue;
+        }
+        slot->state = GMIO_STREAM_URING_SLOT_DONE;
+        if (res < 0) {
+            slot->error = true;
+        }
+        else if (res == 0) {
+            /* File was truncated */
+            slot->request_len = slot->len;
+        }
+        else {
+            slot->len += (size_t)res;
+            if (slot->len < slot->request_len) /* Short read, ask the rest */
+                gmio_stream_uring_prep_read(urc, (unsigned)cqe->user_data);
+        }
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+/* Waits for slot \p islot to be done */
+static bool gmio_stream_uring_wait(
+        struct gmio_stream_uring_cookie* urc, unsigned islot)
+{
+    gmio_stream_uring_reap(urc);
+    while (urc->slots[islot].state == GMIO_STREAM_URING_SLOT_INFLIGHT) {
+        if (!gmio_uring_submit_and_wait(&urc->ring, 1))
+            return false;
+        gmio_stream_uring_reap(urc);
+    }
+    return true;
+}
+
+/* Waits for all requests to complete, then frees all slots */
+static void gmio_stream_uring_cancel(struct gmio_stream_uring_cookie* urc)
+{
+    unsigned i;
+    for (i = 0; i < GMIO_STREAM_URING_DEPTH; ++i) {
+        if (!gmio_stream_uring_wait(urc, i))
+            urc->error = true;
+        urc->slots[i].state = GMIO_STREAM_URING_SLOT_FREE;
+    }
+    urc->head = 0;
+    urc->queued_count = 0;
+    urc->head_cursor = 0;
+}
+
+static bool gmio_stream_uring_at_end(void* cookie)
+{
+    return ((const struct gmio_stream_uring_cookie*)cookie)->at_end;
+}
+
+static int gmio_stream_uring_error(void* cookie)
+{
+    return ((const struct gmio_stream_uring_cookie*)cookie)->error ? 1 : 0;
+}
+
+static size_t gmio_stream_uring_read(
+        void* cookie, void* ptr, size_t item_size, size_t item_count)
+{
+    struct gmio_stream_uring_cookie* urc =
+            (struct gmio_stream_uring_cookie*)cookie;
+    const size_t size = item_size * item_count;
+    uint8_t* bytes = (uint8_t*)ptr;
+    size_t pos = 0;
+
+    while (pos < size && !urc->error) {
+        struct gmio_stream_uring_slot* slot = &urc->slots[urc->head];
+        if (urc->queued_count == 0) {
+            urc->at_end = true;
+            break;
+        }
+        if (!gmio_stream_uring_wait(urc, urc->head) || slot->error) {
+            urc->error = true;
+            break;
+        }
+        if (urc->head_cursor < slot->len) {
+            const uint8_t* buffer = (const uint8_t*)urc->iovecs[urc->head].iov_base;
+            const size_t copy_size =
+                    GMIO_MIN(slot->len - urc->head_cursor, size - pos);
+            memcpy(bytes + pos, buffer + urc->head_cursor, copy_size);
+            urc->head_cursor += copy_size;
+            pos += copy_size;
+            continue;
+        }
+
+        /* Slot consumed, request next read with it */
+        if (slot->len < slot->request_len)
+            urc->source_end = true; /* File was truncated meanwhile */
+        slot->state = GMIO_STREAM_URING_SLOT_FREE;
+        urc->head = (urc->head + 1) % GMIO_STREAM_URING_DEPTH;
+        --urc->queued_count;
+        urc->head_cursor = 0;
+        if (!gmio_stream_uring_request_reads(urc))
+            urc->error = true;
+    }
+    return item_size != 0 ? pos / item_size : 0;
+}
+
+static gmio_streamsize_t gmio_stream_uring_size(void* cookie)
+{
+    return ((const struct gmio_stream_uring_cookie*)cookie)->size;
+}
+
+static int gmio_stream_uring_get_pos(void* cookie, struct gmio_streampos* pos)
+{
+    const struct gmio_stream_uring_cookie* urc =
+            (const struct gmio_stream_uring_cookie*)cookie;
+    const gmio_streamoffset_t offset =
+            urc->queued_count > 0 ?
+                urc->slots[urc->head].offset
+                + (gmio_streamoffset_t)urc->head_cursor :
+                urc->submit_offset;
+    memcpy(pos->cookie, &offset, sizeof(gmio_streamoffset_t));
+    return 0;
+}
+
+static int gmio_stream_uring_set_pos(
+        void* cookie, const struct gmio_streampos* pos)
+{
+    struct gmio_stream_uring_cookie* urc =
+            (struct gmio_stream_uring_cookie*)cookie;
+    const struct gmio_stream_uring_slot* slot = &urc->slots[urc->head];
+    gmio_streamoffset_t offset;
+    memcpy(&offset, pos->cookie, sizeof(gmio_streamoffset_t));
+    if (offset < 0 || offset > urc->size)
+        return -1;
+
+    urc->at_end = false;
+    /* Fast path: offset is within the slot being consumed */
+    if (urc->queued_count > 0
+            && slot->state == GMIO_STREAM_URING_SLOT_DONE
+            && slot->offset <= offset
+            && offset <= slot->offset + (gmio_streamoffset_t)slot->len)
+    {
+        urc->head_cursor = (size_t)(offset - slot->offset);
+        return 0;
+    }
+
+    gmio_stream_uring_cancel(urc);
+    urc->submit_offset = offset;
+    urc->source_end = false;
+    urc->error = false;
+    return gmio_stream_uring_request_reads(urc) ? 0 : -1;
+}
+
+static void gmio_stream_uring_free(struct gmio_stream_uring_cookie* urc)
+{
+    gmio_uring_release(&urc->ring);
+    gmio_memblock_deallocate(&urc->memblock);
+    free(urc);
+}
+
+struct gmio_stream gmio_stream_uring(int fd)
+{
+    struct gmio_stream stream = gmio_stream_null();
+    struct gmio_stream_uring_cookie* urc = NULL;
+    struct stat st;
+    off_t offset;
+    unsigned i;
+
+    if (fd < 0 || fstat(fd, &st) != 0)
+        return stream;
+    offset = lseek(fd, 0, SEEK_CUR);
+    urc = calloc(1, sizeof(struct gmio_stream_uring_cookie));
+    if (urc == NULL)
+        return stream;
+    urc->fd = fd;
+    urc->ring.fd = -1;
+    urc->size = st.st_size;
+    urc->submit_offset = offset >= 0 ? offset : 0;
+    urc->memblock =
+            gmio_memblock_malloc(
+                GMIO_STREAM_URING_DEPTH * GMIO_STREAM_URING_BUFFER_SIZE);
+    if (urc->memblock.ptr == NULL
+            || !gmio_uring_init(&urc->ring, GMIO_STREAM_URING_DEPTH))
+    {
+        gmio_stream_uring_free(urc);
+        return stream;
+    }
+    for (i = 0; i < GMIO_STREAM_URING_DEPTH; ++i) {
+        urc->iovecs[i].iov_base =
+                (uint8_t*)urc->memblock.ptr + i * GMIO_STREAM_URING_BUFFER_SIZE;
+        urc->iovecs[i].iov_len = GMIO_STREAM_URING_BUFFER_SIZE;
+    }
+    /* Registration may fail(eg. RLIMIT_MEMLOCK), then use plain reads */
+    urc->registered_buffers =
+            gmio_uring_register(
+                urc->ring.fd,
+                IORING_REGISTER_BUFFERS,
+                urc->iovecs,
+                GMIO_STREAM_URING_DEPTH)
+            == 0;
+    if (!gmio_stream_uring_request_reads(urc)) {
+        gmio_stream_uring_cancel(urc);
+        gmio_stream_uring_free(urc);
+        return stream;
+    }
+
+    stream.cookie = urc;
+    stream.func_at_end = gmio_stream_uring_at_end;
+    stream.func_error = gmio_stream_uring_error;
+    stream.func_read = gmio_stream_uring_read;
+    stream.func_size = gmio_stream_uring_size;
+    stream.func_get_pos = gmio_stream_uring_get_pos;
+    stream.func_set_pos = gmio_stream_uring_set_pos;
+    return stream;
+}
+
+void gmio_stream_uring_close(struct gmio_stream* stream)
+{
+    if (stream != NULL && stream->cookie != NULL) {
+        struct gmio_stream_uring_cookie* urc =
+                (struct gmio_stream_uring_cookie*)stream->cookie;
+        /* Buffers must not be released while the kernel writes into them */
+        gmio_stream_uring_cancel(urc);
+        gmio_stream_uring_free(urc);
+        *stream = gmio_stream_null();
+    }
+}
+
+#else /* !GMIO_HAVE_LINUX_IO_URING */
+
+struct gmio_stream gmio_stream_uring(int fd)
+{
+    GMIO_UNUSED(fd);
+    return gmio_stream_null();
+}
+
+void gmio_stream_uring_close(struct gmio_stream* stream)
+{
+    GMIO_UNUSED(stream);
+}
+
+#endif /* GMIO_HAVE_LINUX_IO_URING */
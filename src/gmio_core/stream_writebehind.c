@@ -0,0 +1,283 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "stream.h"
+#include "internal/helper_stream.h"
+#include "internal/min_max.h"
+#include "internal/thread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum { GMIO_STREAM_WRITEBEHIND_DEFAULT_BUFFER_SIZE = 128 * 1024 /* 128KB */ };
+
+/* Data of a stream created with gmio_stream_writebehind()
+ *
+ * Buffers [head, head + queued_count) of the ring are waiting to be written
+ * by the write-behind thread, buffer <tt>head + queued_count</tt> is the one
+ * being filled by the caller */
+struct gmio_stream_writebehind_cookie
+{
+    struct gmio_stream sink;
+    struct gmio_thread* thread;
+    struct gmio_mutex* mutex;
+    struct gmio_cond* cond; /* Signaled when any member below mutex changes */
+    uint8_t** buffers;
+    size_t* buffer_lens;
+    unsigned buffer_count;
+    size_t buffer_size;
+
+    /* Accessed only by the writing thread */
+    unsigned fill; /* Index of the buffer being filled */
+    size_t fill_len; /* Length of data in the buffer being filled */
+
+    /* Accessed only with mutex locked */
+    unsigned head;
+    unsigned queued_count;
+    bool error; /* A write to sink failed, next buffers are discarded */
+    bool quit;
+};
+
+/* Function of the write-behind thread */
+static void gmio_stream_writebehind_run(void* arg)
+{
+    struct gmio_stream_writebehind_cookie* wbc =
+            (struct gmio_stream_writebehind_cookie*)arg;
+    gmio_mutex_lock(wbc->mutex);
+    for (;;) {
+        const uint8_t* buffer;
+        size_t len;
+        bool ok = true;
+        while (wbc->queued_count == 0 && !wbc->quit)
+            gmio_cond_wait(wbc->cond, wbc->mutex);
+        if (wbc->queued_count == 0) /* quit, and nothing left to write */
+            break;
+
+        /* Write the head buffer, outside of the lock */
+        buffer = wbc->buffers[wbc->head];
+        len = wbc->buffer_lens[wbc->head];
+        if (!wbc->error) {
+            gmio_mutex_unlock(wbc->mutex);
+            ok = gmio_stream_write_bytes(&wbc->sink, buffer, len) == len
+                    && gmio_stream_error(&wbc->sink) == 0;
+            gmio_mutex_lock(wbc->mutex);
+        }
+        if (!ok)
+            wbc->error = true;
+        wbc->head = (wbc->head + 1) % wbc->buffer_count;
+        --wbc->queued_count;
+        gmio_cond_broadcast(wbc->cond);
+    }
+    gmio_mutex_unlock(wbc->mutex);
+}
+
+/* Queues the buffer being filled then waits for a free one
+ *
+ * Returns false if a previous write to sink failed */
+static bool gmio_stream_writebehind_queue(
+        struct gmio_stream_writebehind_cookie* wbc)
+{
+    bool error;
+    gmio_mutex_lock(wbc->mutex);
+    if (wbc->fill_len > 0) {
+        wbc->buffer_lens[wbc->fill] = wbc->fill_len;
+        wbc->fill = (wbc->fill + 1) % wbc->buffer_count;
+        ++wbc->queued_count;
+        gmio_cond_broadcast(wbc->cond);
+    }
+    while (wbc->queued_count == wbc->buffer_count)
+        gmio_cond_wait(wbc->cond, wbc->mutex);
+    error = wbc->error;
+    gmio_mutex_unlock(wbc->mutex);
+    wbc->fill_len = 0;
+    return !error;
+}
+
+/* Queues the buffer being filled then waits for all buffers to be written,
+ * the write-behind thread is then idle
+ *
+ * Returns false if a write to sink failed */
+static bool gmio_stream_writebehind_drain(
+        struct gmio_stream_writebehind_cookie* wbc)
+{
+    bool error;
+    gmio_stream_writebehind_queue(wbc);
+    gmio_mutex_lock(wbc->mutex);
+    while (wbc->queued_count > 0)
+        gmio_cond_wait(wbc->cond, wbc->mutex);
+    error = wbc->error;
+    gmio_mutex_unlock(wbc->mutex);
+    return !error;
+}
+
+static int gmio_stream_writebehind_error(void* cookie)
+{
+    struct gmio_stream_writebehind_cookie* wbc =
+            (struct gmio_stream_writebehind_cookie*)cookie;
+    bool error;
+    gmio_mutex_lock(wbc->mutex);
+    error = wbc->error;
+    gmio_mutex_unlock(wbc->mutex);
+    return error ? 1 : 0;
+}
+
+static size_t gmio_stream_writebehind_write(
+        void* cookie, const void* ptr, size_t item_size, size_t item_count)
+{
+    struct gmio_stream_writebehind_cookie* wbc =
+            (struct gmio_stream_writebehind_cookie*)cookie;
+    const size_t size = item_size * item_count;
+    const uint8_t* bytes = (const uint8_t*)ptr;
+    size_t pos = 0;
+
+    /* Surface any error that occurred since the previous call */
+    if (gmio_stream_writebehind_error(cookie) != 0)
+        return 0;
+
+    while (pos < size) {
+        const size_t copy_size =
+                GMIO_MIN(wbc->buffer_size - wbc->fill_len, size - pos);
+        uint8_t* const fill_ptr = wbc->buffers[wbc->fill] + wbc->fill_len;
+        memcpy(fill_ptr, bytes + pos, copy_size);
+        wbc->fill_len += copy_size;
+        pos += copy_size;
+        if (wbc->fill_len == wbc->buffer_size
+                && !gmio_stream_writebehind_queue(wbc))
+        {
+            break;
+        }
+    }
+    return item_size != 0 ? pos / item_size : 0;
+}
+
+static int gmio_stream_writebehind_get_pos(
+        void* cookie, struct gmio_streampos* pos)
+{
+    struct gmio_stream_writebehind_cookie* wbc =
+            (struct gmio_stream_writebehind_cookie*)cookie;
+    if (!gmio_stream_writebehind_drain(wbc))
+        return -1;
+    return gmio_stream_get_pos(&wbc->sink, pos);
+}
+
+static int gmio_stream_writebehind_set_pos(
+        void* cookie, const struct gmio_streampos* pos)
+{
+    struct gmio_stream_writebehind_cookie* wbc =
+            (struct gmio_stream_writebehind_cookie*)cookie;
+    if (!gmio_stream_writebehind_drain(wbc))
+        return -1;
+    return gmio_stream_set_pos(&wbc->sink, pos);
+}
+
+static void gmio_stream_writebehind_free(
+        struct gmio_stream_writebehind_cookie* wbc)
+{
+    unsigned i;
+    if (wbc->buffers != NULL) {
+        for (i = 0; i < wbc->buffer_count; ++i)
+            free(wbc->buffers[i]);
+    }
+    free(wbc->buffers);
+    free(wbc->buffer_lens);
+    gmio_cond_destroy(wbc->cond);
+    gmio_mutex_destroy(wbc->mutex);
+    free(wbc);
+}
+
+struct gmio_stream gmio_stream_writebehind(
+        const struct gmio_stream* stream,
+        size_t buffer_size,
+        unsigned buffer_count)
+{
+    struct gmio_stream wbstream = gmio_stream_null();
+    struct gmio_stream_writebehind_cookie* wbc = NULL;
+    bool ok = false;
+    unsigned i;
+
+    if (stream == NULL || stream->func_write == NULL)
+        return wbstream;
+    wbc = calloc(1, sizeof(struct gmio_stream_writebehind_cookie));
+    if (wbc == NULL)
+        return wbstream;
+
+    wbc->sink = *stream;
+    wbc->buffer_size =
+            buffer_size != 0 ?
+                buffer_size : GMIO_STREAM_WRITEBEHIND_DEFAULT_BUFFER_SIZE;
+    wbc->buffer_count = GMIO_MAX(buffer_count, 2);
+    wbc->mutex = gmio_mutex_create();
+    wbc->cond = gmio_cond_create();
+    wbc->buffers = calloc(wbc->buffer_count, sizeof(uint8_t*));
+    wbc->buffer_lens = calloc(wbc->buffer_count, sizeof(size_t));
+    ok = wbc->mutex != NULL
+            && wbc->cond != NULL
+            && wbc->buffers != NULL
+            && wbc->buffer_lens != NULL;
+    for (i = 0; ok && i < wbc->buffer_count; ++i) {
+        wbc->buffers[i] = malloc(wbc->buffer_size);
+        ok = wbc->buffers[i] != NULL;
+    }
+    if (ok) {
+        wbc->thread = gmio_thread_create(gmio_stream_writebehind_run, wbc);
+        ok = wbc->thread != NULL;
+    }
+    if (!ok) {
+        gmio_stream_writebehind_free(wbc);
+        return wbstream;
+    }
+
+    wbstream.cookie = wbc;
+    wbstream.func_error = gmio_stream_writebehind_error;
+    wbstream.func_write = gmio_stream_writebehind_write;
+    if (stream->func_get_pos != NULL)
+        wbstream.func_get_pos = gmio_stream_writebehind_get_pos;
+    if (stream->func_set_pos != NULL)
+        wbstream.func_set_pos = gmio_stream_writebehind_set_pos;
+    return wbstream;
+}
+
+int gmio_stream_writebehind_close(struct gmio_stream* stream)
+{
+    int error = 0;
+    if (stream != NULL && stream->cookie != NULL) {
+        struct gmio_stream_writebehind_cookie* wbc =
+                (struct gmio_stream_writebehind_cookie*)stream->cookie;
+        gmio_stream_writebehind_drain(wbc);
+        gmio_mutex_lock(wbc->mutex);
+        wbc->quit = true;
+        gmio_cond_broadcast(wbc->cond);
+        gmio_mutex_unlock(wbc->mutex);
+        gmio_thread_join(wbc->thread);
+        error = wbc->error ? -1 : 0;
+        gmio_stream_writebehind_free(wbc);
+        *stream = gmio_stream_null();
+    }
+    return error;
+}
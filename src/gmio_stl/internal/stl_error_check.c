@@ -36,7 +36,9 @@
 bool gmio_stl_check_mesh(int *error, const struct gmio_stl_mesh* mesh)
 {
     if (mesh == NULL
-            || (mesh->triangle_count > 0 && mesh->func_get_triangle == NULL))
+            || (mesh->triangle_count > 0
+                && mesh->func_get_triangle == NULL
+                && mesh->func_get_triangles == NULL))
     {
         *error = GMIO_STL_ERROR_NULL_FUNC_GET_TRIANGLE;
     }
@@ -39,6 +39,8 @@ typedef void (*gmio_stl_triangle_func_fix_endian_t)(struct gmio_stl_triangle*);
 /* gmio_stl_mesh */
 typedef void (*gmio_stl_mesh_func_get_triangle_t)(
         const void*, uint32_t, struct gmio_stl_triangle*);
+typedef void (*gmio_stl_mesh_func_get_triangles_t)(
+        const void*, uint32_t, uint32_t, struct gmio_stl_triangle*);
 
 /* gmio_stl_mesh_creator */
 typedef void (*gmio_stl_mesh_creator_func_ascii_begin_solid_t)(
@@ -47,4 +49,6 @@ typedef void (*gmio_stl_mesh_creator_func_binary_begin_solid_t)(
         void*, uint32_t, const struct gmio_stlb_header*);
 typedef void (*gmio_stl_mesh_creator_func_add_triangle_t)(
         void*, uint32_t, const struct gmio_stl_triangle*);
+typedef void (*gmio_stl_mesh_creator_func_add_triangles_t)(
+        void*, uint32_t, const struct gmio_stl_triangle*, uint32_t);
 typedef void (*gmio_stl_mesh_creator_func_end_solid_t)(void*);
@@ -0,0 +1,54 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include "../../gmio_core/global.h"
+#include "../stl_triangle_soa.h"
+
+#include <stddef.h>
+
+/*! Returns true if \p creator was returned by gmio_stl_mesh_creator_soa() */
+bool gmio_stl_mesh_creator_is_soa(const struct gmio_stl_mesh_creator* creator);
+
+/*! Transposes the \p count facet records of \p records(host byte order) into
+ *  the arrays of \p soa, at indexes starting from \p first_tri_id
+ *
+ *  Records are \p stride bytes apart, this is \c GMIO_STLB_TRIANGLE_RAWSIZE
+ *  for packed records and <tt>sizeof(struct gmio_stl_triangle)</tt> for an
+ *  array of gmio_stl_triangle objects.\n
+ *  Records beyond gmio_stl_triangle_soa::capacity are ignored, then
+ *  gmio_stl_triangle_soa::count is updated if needed.
+ */
+void gmio_stl_triangle_soa_add_records(
+        struct gmio_stl_triangle_soa* soa,
+        uint32_t first_tri_id,
+        const uint8_t* records,
+        size_t stride,
+        uint32_t count);
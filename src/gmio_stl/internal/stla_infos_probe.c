@@ -37,6 +37,7 @@
 #include "../../gmio_core/internal/stringstream.h"
 #include "../stl_error.h"
 #include "stla_parsing.h"
+#include "stla_scan_mask.h"
 #include "stl_error_check.h"
 
 #include <string.h>
@@ -51,27 +52,279 @@ static const char* gmio_stringstream_skip_until_ascii_space(
     return curr_char;
 }
 
-/* Eats \p str case-insensitive, stops on any difference */
-static bool gmio_stringstream_icase_eat(
-        struct gmio_stringstream* sstream, const char* str)
+/* Kind of the word found by gmio_stla_scan_facets() */
+enum gmio_stla_scan_word
 {
-    const char* c = gmio_stringstream_next_char(sstream);
-    while (c != NULL && *str != 0) {
-        if (!gmio_ascii_char_iequals(*c, *str))
-            return false;
-        c = gmio_stringstream_next_char(sstream);
-        ++str;
+    GMIO_STLA_SCAN_WORD_OTHER,
+    GMIO_STLA_SCAN_WORD_FACET,
+    GMIO_STLA_SCAN_WORD_ENDSOLID,
+    /* Not enough chars available to decide */
+    GMIO_STLA_SCAN_WORD_TRUNCATED
+};
+
+/* Max length of keyword checked by gmio_stla_scan_word_kind() */
+#define GMIO_STLA_SCAN_KEYWORD_MAXLEN 8
+
+/* Returns the kind of the word starting at \p word, whose first char is
+ * either 'e' or 'f'(case-insensitive). Only the first \p len chars of the word
+ * are available */
+static enum gmio_stla_scan_word gmio_stla_scan_word_kind(
+        const char* word, size_t len)
+{
+    const bool is_f = (*word | 0x20) == 'f';
+    const char* keyword = is_f ? "facet" : "endsolid";
+    size_t i = 1;
+    while (keyword[i] != 0) {
+        if (i >= len)
+            return GMIO_STLA_SCAN_WORD_TRUNCATED;
+        if (!gmio_ascii_char_iequals(word[i], keyword[i]))
+            return GMIO_STLA_SCAN_WORD_OTHER;
+        ++i;
+    }
+    return is_f ? GMIO_STLA_SCAN_WORD_FACET : GMIO_STLA_SCAN_WORD_ENDSOLID;
+}
+
+/* State of gmio_stla_scan_words() kept between successive buffers */
+struct gmio_stla_scan_state
+{
+    uint32_t facet_count;
+    /* Is char before current scan position a space(or stream begin) ? */
+    bool prev_is_space;
+    bool endsolid_found;
+};
+
+/* Chars are classified by chunks of 16 bytes, giving for each char a group of
+ * (1 << GMIO_STLA_SCAN_CHAR_SHIFT) bits in masks of type gmio_stla_scan_mask_t
+ *
+ * NEON has no movemask instruction, the 4-bit per char mask is obtained by
+ * narrowing the comparison vector */
+#if defined(GMIO_ASCII_SCAN_SSE2)
+typedef unsigned gmio_stla_scan_mask_t;
+#  define GMIO_STLA_SCAN_CHAR_SHIFT 0
+#elif defined(GMIO_ASCII_SCAN_NEON)
+typedef uint64_t gmio_stla_scan_mask_t;
+#  define GMIO_STLA_SCAN_CHAR_SHIFT 2
+#endif
+
+#ifdef GMIO_STLA_SCAN_CHAR_SHIFT
+/* Sets masks of space chars and of 'e'/'f' chars(case-insensitive) */
+GMIO_INLINE void gmio_stla_scan_classify(
+        const char* chunk,
+        gmio_stla_scan_mask_t* mask_space,
+        gmio_stla_scan_mask_t* mask_ef)
+{
+#  if defined(GMIO_ASCII_SCAN_SSE2)
+    const __m128i vec = _mm_or_si128(
+                _mm_loadu_si128((const __m128i*)chunk), _mm_set1_epi8(0x20));
+    const __m128i is_ef = _mm_or_si128(
+                _mm_cmpeq_epi8(vec, _mm_set1_epi8('e')),
+                _mm_cmpeq_epi8(vec, _mm_set1_epi8('f')));
+    *mask_space = gmio_ascii_space_mask_sse2(chunk);
+    *mask_ef = (unsigned)_mm_movemask_epi8(is_ef);
+#  elif defined(GMIO_ASCII_SCAN_NEON)
+    const uint8x16_t vec =
+            vorrq_u8(vld1q_u8((const uint8_t*)chunk), vdupq_n_u8(0x20));
+    const uint8x16_t is_ef = vorrq_u8(
+                vceqq_u8(vec, vdupq_n_u8('e')), vceqq_u8(vec, vdupq_n_u8('f')));
+    const uint8x16_t is_space = gmio_ascii_space_vec_neon(chunk);
+    *mask_space = vget_lane_u64(vreinterpret_u64_u8(
+            vshrn_n_u16(vreinterpretq_u16_u8(is_space), 4)), 0);
+    *mask_ef = vget_lane_u64(vreinterpret_u64_u8(
+            vshrn_n_u16(vreinterpretq_u16_u8(is_ef), 4)), 0);
+#  endif
+}
+
+/* Returns the index of the lowest bit set in non-null \p mask */
+GMIO_INLINE unsigned gmio_stla_scan_ctz(gmio_stla_scan_mask_t mask)
+{
+#  if defined(GMIO_ASCII_SCAN_SSE2)
+    return gmio_ascii_scan_ctz(mask);
+#  elif defined(__GNUC__)
+    return (unsigned)__builtin_ctzll(mask);
+#  else
+    unsigned i = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++i;
     }
-    return *str == 0;
+    return i;
+#  endif
 }
+#endif /* GMIO_STLA_SCAN_CHAR_SHIFT */
 
-/* Callback invoked by gmio_stringstream for handling also stream total size */
-static size_t gmio_stringstream_read__flagsize(
+/* Scans words in [\p begin, \p end) : counts the ones starting with "facet"
+ * and stops after the first one starting with "endsolid"(case-insensitive)
+ *
+ * Only word starts(non-space char preceded by a space) being 'e' or 'f' are
+ * checked, they are found by chunks of 16 chars when SIMD is available
+ *
+ * Returns the position where the scan stopped. Unless \p final is true, the
+ * scan can stop before a word whose kind cannot be decided with the chars
+ * available : then the caller has to scan it again with next chars */
+static const char* gmio_stla_scan_words(
+        const char* begin,
+        const char* end,
+        bool final,
+        struct gmio_stla_scan_state* state)
+{
+    const char* p = begin;
+    bool prev_is_space = state->prev_is_space;
+
+#ifdef GMIO_STLA_SCAN_CHAR_SHIFT
+    while (end - p >= 16) {
+        gmio_stla_scan_mask_t mask_space = 0;
+        gmio_stla_scan_mask_t mask_ef = 0;
+        gmio_stla_scan_mask_t mask_word;
+        gmio_stla_scan_classify(p, &mask_space, &mask_ef);
+        mask_word = (gmio_stla_scan_mask_t)gmio_stla_scan_word_start_mask(
+                    mask_space,
+                    mask_ef,
+                    prev_is_space,
+                    GMIO_STLA_SCAN_CHAR_SHIFT);
+        while (mask_word != 0) {
+            const unsigned i =
+                    gmio_stla_scan_ctz(mask_word) >> GMIO_STLA_SCAN_CHAR_SHIFT;
+            const char* word = p + i;
+            switch (gmio_stla_scan_word_kind(word, end - word)) {
+            case GMIO_STLA_SCAN_WORD_FACET:
+                ++state->facet_count;
+                break;
+            case GMIO_STLA_SCAN_WORD_ENDSOLID:
+                state->endsolid_found = true;
+                return word + GMIO_STLA_SCAN_KEYWORD_MAXLEN;
+            case GMIO_STLA_SCAN_WORD_TRUNCATED:
+                if (!final) {
+                    state->prev_is_space = true;
+                    return word;
+                }
+                break;
+            case GMIO_STLA_SCAN_WORD_OTHER:
+                break;
+            }
+            mask_word &= ~(gmio_stla_scan_mask_t)(
+                        gmio_stla_scan_char_mask(GMIO_STLA_SCAN_CHAR_SHIFT)
+                        << (i << GMIO_STLA_SCAN_CHAR_SHIFT));
+        }
+        prev_is_space =
+                gmio_stla_scan_last_is_space(
+                    mask_space, GMIO_STLA_SCAN_CHAR_SHIFT);
+        p += 16;
+    }
+#endif
+
+    for (; p < end; ++p) {
+        const bool is_space = gmio_ascii_isspace(*p);
+        if (!is_space && prev_is_space
+                && ((*p | 0x20) == 'e' || (*p | 0x20) == 'f'))
+        {
+            switch (gmio_stla_scan_word_kind(p, end - p)) {
+            case GMIO_STLA_SCAN_WORD_FACET:
+                ++state->facet_count;
+                break;
+            case GMIO_STLA_SCAN_WORD_ENDSOLID:
+                state->endsolid_found = true;
+                return p + GMIO_STLA_SCAN_KEYWORD_MAXLEN;
+            case GMIO_STLA_SCAN_WORD_TRUNCATED:
+                if (!final) {
+                    state->prev_is_space = true;
+                    return p;
+                }
+                break;
+            case GMIO_STLA_SCAN_WORD_OTHER:
+                break;
+            }
+        }
+        prev_is_space = is_space;
+    }
+    state->prev_is_space = prev_is_space;
+    return p;
+}
+
+/* Counts the "facet" words from current position of \p sstream until the
+ * first "endsolid" word
+ *
+ * Contents are scanned by whole buffers instead of char by char, the few
+ * trailing chars of a truncated word are moved at buffer front before
+ * reading next chunk from stream. On return \p sstream is positioned just
+ * after "endsolid"(or at end of stream)
+ *
+ * Returns the final scan state */
+static struct gmio_stla_scan_state gmio_stla_scan_facets(
+        struct gmio_stringstream* sstream)
+{
+    char* const buff = sstream->strbuff.ptr;
+    const size_t capacity = sstream->strbuff.capacity;
+    /* Too small buffer can't hold a truncated keyword plus one more char */
+    const bool cannot_carry = capacity <= GMIO_STLA_SCAN_KEYWORD_MAXLEN;
+    struct gmio_stla_scan_state state = {0};
+    size_t len = sstream->strbuff_end - sstream->strbuff_at;
+    bool at_eof = false;
+    const char* stop = buff;
+
+    state.prev_is_space = true;
+    memmove(buff, sstream->strbuff_at, len);
+    for (;;) {
+        if (len < capacity) {
+            const size_t len_read =
+                    sstream->func_stream_read(
+                        sstream->cookie,
+                        &sstream->stream,
+                        buff + len,
+                        capacity - len);
+            at_eof = len_read == 0;
+            len += len_read;
+        }
+        stop = gmio_stla_scan_words(
+                    buff, buff + len, at_eof || cannot_carry, &state);
+        if (state.endsolid_found || (at_eof && stop == buff + len))
+            break;
+        /* Keep chars not scanned yet */
+        len = buff + len - stop;
+        memmove(buff, stop, len);
+    }
+
+    sstream->strbuff.len = len;
+    sstream->strbuff_end = buff + len;
+    sstream->strbuff_at = stop;
+    /* Keep gmio_stringstream_current_char() valid when "endsolid" ends the
+     * buffer */
+    if (stop == sstream->strbuff_end && !at_eof)
+        gmio_stringstream_next_chunk(sstream);
+    return state;
+}
+
+/* Cookie of gmio_stringstream_read__probe() */
+struct gmio_stla_probe_cookie
+{
+    /* Total size(in bytes) read from stream */
+    gmio_streamsize_t read_size;
+    /* Max size that can be read from stream, no limit if <= 0 */
+    gmio_streamsize_t size_limit;
+    /* Was some read cut by size_limit ? */
+    bool limit_reached;
+};
+
+/* Callback invoked by gmio_stringstream for handling stream total size and
+ * size limit */
+static size_t gmio_stringstream_read__probe(
         void* cookie, struct gmio_stream* stream, char* ptr, size_t len)
 {
-    gmio_streamsize_t* ptr_size = (gmio_streamsize_t*)(cookie);
-    const size_t len_read = gmio_stream_read_bytes(stream, ptr, len);
-    *ptr_size += len_read;
+    struct gmio_stla_probe_cookie* probe_cookie =
+            (struct gmio_stla_probe_cookie*)(cookie);
+    bool len_limited = false;
+    size_t len_read = 0;
+    if (probe_cookie->size_limit > 0) {
+        const gmio_streamsize_t remaining_size =
+                probe_cookie->size_limit - probe_cookie->read_size;
+        if (remaining_size < (gmio_streamsize_t)len) {
+            len = (size_t)remaining_size;
+            len_limited = true;
+        }
+    }
+    len_read = len != 0 ? gmio_stream_read_bytes(stream, ptr, len) : 0;
+    /* Stream may end before size_limit */
+    probe_cookie->limit_reached = len_limited && len_read == len;
+    probe_cookie->read_size += len_read;
     return len_read;
 }
 
@@ -92,6 +345,7 @@ int gmio_stla_infos_probe(
     /* Leave one byte to end of string buffer */
     const size_t mblock_size = opts->stream_memblock.size - 1;
     struct gmio_stringstream sstream = {0};
+    struct gmio_stla_probe_cookie probe_cookie = {0};
     int err = GMIO_ERROR_OK;
 
     if (flags == 0)
@@ -104,14 +358,9 @@ int gmio_stla_infos_probe(
     /* Initialize string stream */
     sstream.stream = *stream;
     sstream.strbuff = gmio_string(mblock_ptr, 0, mblock_size);
-    if (flag_size) {
-        infos->size = 0;
-        sstream.cookie = &infos->size;
-        sstream.func_stream_read = gmio_stringstream_read__flagsize;
-    }
-    else {
-        sstream.func_stream_read = gmio_stringstream_default_func_read;
-    }
+    probe_cookie.size_limit = opts->size_limit;
+    sstream.cookie = &probe_cookie;
+    sstream.func_stream_read = gmio_stringstream_read__probe;
     gmio_stringstream_init_pos(&sstream);
 
     if (flag_stla_solidname) {
@@ -143,49 +392,34 @@ int gmio_stla_infos_probe(
         sstream = parse_data.strstream;
     }
 
-    if (flag_facet_count) {
-        bool endfound = false;
-
-        infos->facet_count = 0;
-
-        while (!endfound) {
-            const char* c = gmio_stringstream_skip_ascii_spaces(&sstream);
-            if (c != NULL) {
-                if (gmio_ascii_char_iequals(*c, 'f')) {
-                    if (gmio_stringstream_icase_eat(&sstream, "acet"))
-                        ++infos->facet_count;
-                }
-                else {
-                    endfound =
-                            gmio_ascii_char_iequals(*c, 'e')
-                            && gmio_stringstream_icase_eat(&sstream, "ndsolid");
-                }
-            }
-            else {
-                endfound = true;
+    if (flag_facet_count || flag_size) {
+        /* Stops after "endsolid" token, as needed by flag_size */
+        const struct gmio_stla_scan_state scan = gmio_stla_scan_facets(&sstream);
+        if (!scan.endsolid_found && probe_cookie.limit_reached) {
+            /* Extrapolate infos from the contents read so far */
+            const gmio_streamsize_t total_size =
+                    GMIO_MAX(gmio_stream_size(stream), probe_cookie.read_size);
+            const double facet_count =
+                    (double)scan.facet_count
+                    * ((double)total_size / (double)probe_cookie.read_size);
+            if (flag_facet_count) {
+                infos->facet_count =
+                        facet_count < 4294967295. ?
+                            (uint32_t)facet_count :
+                            0xFFFFFFFF;
             }
-            gmio_stringstream_skip_until_ascii_space(&sstream);
+            if (flag_size)
+                infos->size = total_size;
+            infos->estimated_flags =
+                    flags & (GMIO_STL_INFO_FLAG_FACET_COUNT
+                             | GMIO_STL_INFO_FLAG_SIZE);
+            return err;
         }
+        if (flag_facet_count)
+            infos->facet_count = scan.facet_count;
     }
 
     if (flag_size) {
-        /* On case flag_facet_count is on, we should already be after "endsolid"
-         * token */
-        if (!flag_facet_count) {
-            bool endfound = false;
-            while (!endfound) {
-                const char* c = gmio_stringstream_skip_ascii_spaces(&sstream);
-                if (c != NULL) {
-                    endfound =
-                            gmio_ascii_char_iequals(*c, 'e')
-                            && gmio_stringstream_icase_eat(&sstream, "ndsolid");
-                }
-                else {
-                    endfound = true;
-                }
-                gmio_stringstream_skip_until_ascii_space(&sstream);
-            }
-        }
         {
             /* Eat whole line containing "endsolid" */
             const char* c = gmio_stringstream_current_char(&sstream);
@@ -203,8 +437,13 @@ int gmio_stla_infos_probe(
              * stringstream's current char */
             const int end_offset =
                     gmio_stringstream_current_char(&sstream) != NULL ? 1 : 0;
-            infos->size -= sstream.strbuff_end - sstream.strbuff_at + end_offset;
+            infos->size =
+                    probe_cookie.read_size
+                    - (sstream.strbuff_end - sstream.strbuff_at + end_offset);
             infos->size = GMIO_MAX(0, infos->size);
+            /* "endsolid" line may continue after size_limit */
+            if (end_offset == 0 && probe_cookie.limit_reached)
+                infos->estimated_flags |= GMIO_STL_INFO_FLAG_SIZE;
         }
     }
 
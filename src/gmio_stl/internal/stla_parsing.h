@@ -85,6 +85,10 @@ struct gmio_stla_parse_data
 /* Fixed maximum length of any gmio_string when parsing */
 enum { GMIO_STLA_READ_STRING_MAX_LEN = 1024 };
 
+/* Count of triangles parsed before being handed over to
+ * gmio_stl_mesh_creator::func_add_triangles() */
+enum { GMIO_STLA_READ_TRIANGLE_BATCH_SIZE = 64 };
+
 /* Used as general STLA parsing error code */
 enum { GMIO_STLA_PARSE_ERROR = 1 };
 
@@ -0,0 +1,85 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include "../../gmio_core/global.h"
+
+/* Masks built when classifying a chunk of 16 STL ascii chars give for each
+ * char a group of (1 << char_shift) bits, char_shift depending on the SIMD
+ * layout : 0 with SSE2 movemask, 2 with NEON narrowing(4 bits per char)
+ *
+ * Functions below are written for any layout so they can be checked on all
+ * of them whatever the host CPU */
+
+/*! Returns the mask of the bits of a single char */
+GMIO_INLINE uint64_t gmio_stla_scan_char_mask(unsigned char_shift);
+
+/*! Returns the mask of word starts(non-space char preceded by a space) among
+ *  the chars flagged in \p mask_sel
+ *
+ *  \p prev_is_space tells if the char before the chunk is a space */
+GMIO_INLINE uint64_t gmio_stla_scan_word_start_mask(
+        uint64_t mask_space,
+        uint64_t mask_sel,
+        bool prev_is_space,
+        unsigned char_shift);
+
+/*! Returns true if the last char of the chunk is a space */
+GMIO_INLINE bool gmio_stla_scan_last_is_space(
+        uint64_t mask_space, unsigned char_shift);
+
+
+
+/*
+ * -- Implementation
+ */
+
+uint64_t gmio_stla_scan_char_mask(unsigned char_shift)
+{
+    return (UINT64_C(1) << (1u << char_shift)) - 1;
+}
+
+uint64_t gmio_stla_scan_word_start_mask(
+        uint64_t mask_space,
+        uint64_t mask_sel,
+        bool prev_is_space,
+        unsigned char_shift)
+{
+    const uint64_t mask_prev_space =
+            (mask_space << (1u << char_shift))
+            | (prev_is_space ? gmio_stla_scan_char_mask(char_shift) : 0);
+    return ~mask_space & mask_prev_space & mask_sel;
+}
+
+bool gmio_stla_scan_last_is_space(uint64_t mask_space, unsigned char_shift)
+{
+    return ((mask_space >> (15u << char_shift))
+            & gmio_stla_scan_char_mask(char_shift)) != 0;
+}
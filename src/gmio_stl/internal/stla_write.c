@@ -43,15 +43,20 @@
 #include "../../gmio_core/internal/helper_task_iface.h"
 #include "../../gmio_core/internal/min_max.h"
 #include "../../gmio_core/internal/safe_cast.h"
+#include "../../gmio_core/internal/thread.h"
 
 #if GMIO_FLOAT2STR_LIB == GMIO_FLOAT2STR_LIB_DOUBLE_CONVERSION
 #  include "../../gmio_core/internal/google_doubleconversion.h"
 #  define gmio_write_coords gmio_write_coords_gdc
+#elif GMIO_FLOAT2STR_LIB == GMIO_FLOAT2STR_LIB_RYU
+#  include "../../gmio_core/internal/ryu.h"
+#  define gmio_write_coords gmio_write_coords_ryu
 #else
 #  define gmio_write_coords gmio_write_coords_printf
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 /*
@@ -75,7 +80,9 @@
 enum {
     GMIO_STLA_FACET_SIZE = 321,
     GMIO_STLA_FACET_SIZE_P2 = 512,
-    GMIO_STLA_SOLID_NAME_MAX_LEN = 512
+    GMIO_STLA_SOLID_NAME_MAX_LEN = 512,
+    /* Count of triangles fetched per gmio_stl_mesh::func_get_triangles() */
+    GMIO_STLA_WRITE_TRIANGLE_BATCH_SIZE = 64
 };
 
 /* Fucntions for raw strings(ie. "const char*") */
@@ -155,6 +162,47 @@ GMIO_INLINE char* gmio_write_coords_gdc(
 }
 #endif /* GMIO_FLOAT2STR_LIB_DOUBLE_CONVERSION */
 
+#if GMIO_FLOAT2STR_LIB == GMIO_FLOAT2STR_LIB_RYU
+GMIO_INLINE char* gmio_write_coords_ryu(
+        char* buffer,
+        const struct gmio_vec3f_text_format* format,
+        const struct gmio_vec3f* coords)
+{
+    const enum gmio_float_text_format coord_format = format->coord_format;
+    const uint8_t coord_prec = format->coord_prec;
+    buffer += gmio_float2str_ryu(
+                coords->x, buffer, 64, coord_format, coord_prec);
+    buffer = gmio_write_char(buffer, ' ');
+    buffer += gmio_float2str_ryu(
+                coords->y, buffer, 64, coord_format, coord_prec);
+    buffer = gmio_write_char(buffer, ' ');
+    buffer += gmio_float2str_ryu(
+                coords->z, buffer, 64, coord_format, coord_prec);
+    return buffer;
+}
+#endif /* GMIO_FLOAT2STR_LIB_RYU */
+
+GMIO_INLINE char* gmio_write_facet(
+        char* buffer,
+        const struct gmio_vec3f_text_format* format,
+        const struct gmio_stl_triangle* tri)
+{
+    buffer = gmio_write_rawstr(buffer, "facet normal ");
+    buffer = gmio_write_coords(buffer, format, &tri->n);
+
+    buffer = gmio_write_rawstr(buffer, "\nouter loop");
+    buffer = gmio_write_rawstr(buffer, "\n vertex ");
+    buffer = gmio_write_coords(buffer, format, &tri->v1);
+    buffer = gmio_write_rawstr(buffer, "\n vertex ");
+    buffer = gmio_write_coords(buffer, format, &tri->v2);
+    buffer = gmio_write_rawstr(buffer, "\n vertex ");
+    buffer = gmio_write_coords(buffer, format, &tri->v3);
+    buffer = gmio_write_rawstr(buffer, "\nendloop");
+
+    buffer = gmio_write_rawstr(buffer, "\nendfacet\n");
+    return buffer;
+}
+
 GMIO_INLINE bool gmio_stream_flush_buffer(
         struct gmio_stream* stream, char* buffer, const char* buffer_offset)
 {
@@ -163,6 +211,242 @@ GMIO_INLINE bool gmio_stream_flush_buffer(
     return write_count == n;
 }
 
+/* Writes as text \p facet_count facets of \p mesh, starting from facet
+ * \p first_facet. \p tri_batch must be able to hold
+ * GMIO_STLA_WRITE_TRIANGLE_BATCH_SIZE triangles
+ *
+ * Returns the position after the last character written to \p buffer */
+static char* gmio_write_facets(
+        char* buffer,
+        const struct gmio_vec3f_text_format* format,
+        const struct gmio_stl_mesh* mesh,
+        uint32_t first_facet,
+        uint32_t facet_count,
+        struct gmio_stl_triangle* tri_batch)
+{
+    const uint32_t end_facet = first_facet + facet_count;
+    uint32_t ifacet = first_facet;
+    if (mesh->func_get_triangles != NULL) {
+        while (ifacet < end_facet) {
+            const uint32_t batch_count =
+                    GMIO_MIN(GMIO_STLA_WRITE_TRIANGLE_BATCH_SIZE,
+                             end_facet - ifacet);
+            uint32_t ibatch;
+            mesh->func_get_triangles(
+                        mesh->cookie, ifacet, batch_count, tri_batch);
+            for (ibatch = 0; ibatch < batch_count; ++ibatch)
+                buffer = gmio_write_facet(buffer, format, &tri_batch[ibatch]);
+            ifacet += batch_count;
+        }
+    }
+    else {
+        for (; ifacet < end_facet; ++ifacet) {
+            mesh->func_get_triangle(mesh->cookie, ifacet, tri_batch);
+            buffer = gmio_write_facet(buffer, format, tri_batch);
+        }
+    }
+    return buffer;
+}
+
+/* Shared state of the facet write loop when facets are formatted by several
+ * threads
+ *
+ * Facets are split into chunks of the size of a memblock, chunk \c i being
+ * formatted by thread <tt>i % thread_count</tt>. The calling thread formats
+ * its own chunks and flushes all of them to the stream, in order.
+ * Members below mutex are accessed only with mutex locked */
+struct gmio_stla_write_context
+{
+    const struct gmio_stl_mesh* mesh;
+    const struct gmio_vec3f_text_format* format;
+    uint32_t total_facet_count;
+    uint32_t chunk_facet_count; /* Count of facets per chunk */
+    uint32_t chunk_count;
+    unsigned thread_count; /* Including the calling thread */
+    struct gmio_mutex* mutex;
+    struct gmio_cond* cond; /* Signaled when any member below changes */
+    bool stop; /* Workers have to exit as soon as possible */
+};
+
+/* Worker thread of gmio_stla_write(), formats chunks into its own memblock */
+struct gmio_stla_write_worker
+{
+    struct gmio_stla_write_context* context;
+    struct gmio_memblock memblock;
+    struct gmio_thread* thread;
+    unsigned id; /* Index of the first chunk to be formatted, >= 1 */
+    size_t text_len; /* Length of the formatted text in memblock */
+    bool text_ready; /* Memblock holds a chunk not yet flushed */
+};
+
+/* Returns the position after the last character written for chunk \p ichunk */
+static char* gmio_stla_write_format_chunk(
+        const struct gmio_stla_write_context* ctx,
+        char* buffer,
+        uint32_t ichunk,
+        struct gmio_stl_triangle* tri_batch)
+{
+    const uint32_t first_facet = ichunk * ctx->chunk_facet_count;
+    const uint32_t facet_count =
+            GMIO_MIN(ctx->chunk_facet_count,
+                     ctx->total_facet_count - first_facet);
+    return gmio_write_facets(
+                buffer, ctx->format, ctx->mesh,
+                first_facet, facet_count, tri_batch);
+}
+
+static void gmio_stla_write_worker_run(void* arg)
+{
+    struct gmio_stla_write_worker* worker = (struct gmio_stla_write_worker*)arg;
+    struct gmio_stla_write_context* ctx = worker->context;
+    struct gmio_stl_triangle tri_batch[GMIO_STLA_WRITE_TRIANGLE_BATCH_SIZE];
+    uint32_t ichunk;
+
+    for (ichunk = worker->id;
+         ichunk < ctx->chunk_count;
+         ichunk += ctx->thread_count)
+    {
+        char* buffer = worker->memblock.ptr;
+        size_t text_len;
+        bool stop;
+
+        /* Wait for the previous chunk to be flushed */
+        gmio_mutex_lock(ctx->mutex);
+        while (worker->text_ready && !ctx->stop)
+            gmio_cond_wait(ctx->cond, ctx->mutex);
+        stop = ctx->stop;
+        gmio_mutex_unlock(ctx->mutex);
+        if (stop)
+            break;
+
+        text_len =
+                gmio_stla_write_format_chunk(ctx, buffer, ichunk, tri_batch)
+                - buffer;
+        gmio_mutex_lock(ctx->mutex);
+        worker->text_len = text_len;
+        worker->text_ready = true;
+        gmio_cond_broadcast(ctx->cond);
+        gmio_mutex_unlock(ctx->mutex);
+    }
+}
+
+/* Writes facets of \p mesh with \p thread_count threads (the calling one
+ * included), \p mblock being the memblock of the calling thread
+ *
+ * Returns false if facets could not be written this way(eg. threads could
+ * not be started), nothing being written then */
+static bool gmio_stla_write_parallel(
+        struct gmio_stream* stream,
+        const struct gmio_stl_mesh* mesh,
+        const struct gmio_vec3f_text_format* format,
+        const struct gmio_task_iface* task,
+        struct gmio_memblock* mblock,
+        unsigned thread_count,
+        int* error)
+{
+    struct gmio_stla_write_context ctx = {0};
+    struct gmio_stla_write_worker* workers = NULL;
+    struct gmio_stl_triangle tri_batch[GMIO_STLA_WRITE_TRIANGLE_BATCH_SIZE];
+    unsigned worker_count = 0; /* Count of started worker threads */
+    unsigned i_worker;
+    uint32_t ichunk;
+    bool started = false;
+
+    ctx.mesh = mesh;
+    ctx.format = format;
+    ctx.total_facet_count = mesh->triangle_count;
+    ctx.chunk_facet_count =
+            gmio_size_to_uint32(mblock->size / GMIO_STLA_FACET_SIZE_P2);
+    ctx.chunk_count =
+            (ctx.total_facet_count + ctx.chunk_facet_count - 1)
+            / ctx.chunk_facet_count;
+    ctx.thread_count = GMIO_MIN(thread_count, ctx.chunk_count);
+    if (ctx.thread_count <= 1)
+        return false;
+
+    /* Allocate resources, then start all worker threads : the chunk of a
+     * worker depends on the count of threads */
+    ctx.mutex = gmio_mutex_create();
+    ctx.cond = gmio_cond_create();
+    workers = calloc(ctx.thread_count - 1, sizeof(*workers));
+    if (ctx.mutex != NULL && ctx.cond != NULL && workers != NULL) {
+        for (i_worker = 0; i_worker < ctx.thread_count - 1; ++i_worker) {
+            workers[i_worker].memblock = gmio_memblock_malloc(mblock->size);
+            if (workers[i_worker].memblock.ptr == NULL)
+                break;
+        }
+        started = i_worker == ctx.thread_count - 1;
+        while (started && worker_count < ctx.thread_count - 1) {
+            struct gmio_stla_write_worker* worker = &workers[worker_count];
+            worker->context = &ctx;
+            worker->id = worker_count + 1;
+            worker->thread =
+                    gmio_thread_create(gmio_stla_write_worker_run, worker);
+            started = worker->thread != NULL;
+            if (started)
+                ++worker_count;
+        }
+    }
+
+    /* Flush chunks in order, the calling thread formats its own ones */
+    *error = GMIO_ERROR_OK;
+    for (ichunk = 0;
+         started && ichunk < ctx.chunk_count && gmio_no_error(*error);
+         ++ichunk)
+    {
+        const unsigned chunk_thread_id = ichunk % ctx.thread_count;
+        gmio_task_iface_handle_progress(
+                    task,
+                    ichunk * ctx.chunk_facet_count,
+                    ctx.total_facet_count);
+        if (chunk_thread_id == 0) {
+            char* buffer = mblock->ptr;
+            char* buffpos =
+                    gmio_stla_write_format_chunk(&ctx, buffer, ichunk, tri_batch);
+            if (!gmio_stream_flush_buffer(stream, buffer, buffpos))
+                *error = GMIO_ERROR_STREAM;
+        }
+        else {
+            struct gmio_stla_write_worker* worker =
+                    &workers[chunk_thread_id - 1];
+            char* buffer = worker->memblock.ptr;
+            gmio_mutex_lock(ctx.mutex);
+            while (!worker->text_ready)
+                gmio_cond_wait(ctx.cond, ctx.mutex);
+            gmio_mutex_unlock(ctx.mutex);
+            if (!gmio_stream_flush_buffer(
+                        stream, buffer, buffer + worker->text_len))
+            {
+                *error = GMIO_ERROR_STREAM;
+            }
+            gmio_mutex_lock(ctx.mutex);
+            worker->text_ready = false;
+            gmio_cond_broadcast(ctx.cond);
+            gmio_mutex_unlock(ctx.mutex);
+        }
+
+        /* Task control */
+        if (gmio_no_error(*error) && gmio_task_iface_is_stop_requested(task))
+            *error = GMIO_ERROR_TASK_STOPPED;
+    }
+
+    /* Stop workers, which may still be waiting after an error */
+    gmio_mutex_lock(ctx.mutex);
+    ctx.stop = true;
+    gmio_cond_broadcast(ctx.cond);
+    gmio_mutex_unlock(ctx.mutex);
+    for (i_worker = 0; i_worker < worker_count; ++i_worker)
+        gmio_thread_join(workers[i_worker].thread);
+    if (workers != NULL) {
+        for (i_worker = 0; i_worker < ctx.thread_count - 1; ++i_worker)
+            gmio_memblock_deallocate(&workers[i_worker].memblock);
+    }
+    free(workers);
+    gmio_cond_destroy(ctx.cond);
+    gmio_mutex_destroy(ctx.mutex);
+    return started;
+}
+
 int gmio_stla_write(
         struct gmio_stream* stream,
         const struct gmio_stl_mesh* mesh,
@@ -184,6 +468,7 @@ int gmio_stla_write(
     uint32_t ifacet = 0; /* for-loop counter on facets */
     int error = GMIO_ERROR_OK;
     struct gmio_vec3f_text_format vec_txtformat = {0};
+    struct gmio_stl_triangle tri_batch[GMIO_STLA_WRITE_TRIANGLE_BATCH_SIZE];
 
     /* Make options non NULL */
     opts = opts != NULL ? opts : &default_opts;
@@ -229,41 +514,29 @@ int gmio_stla_write(
         }
     }
 
+    /* Write solid's facets with several threads */
+    if (opts->thread_count > 1
+            && gmio_stla_write_parallel(
+                stream, mesh, &vec_txtformat, task, mblock,
+                opts->thread_count, &error))
+    {
+        ifacet = total_facet_count;
+    }
+
     /* Write solid's facets */
-    for (ifacet = 0;
+    for (;
          ifacet < total_facet_count && gmio_no_error(error);
          ifacet += buffer_facet_count)
     {
-        const uint32_t clamped_facet_count =
-                GMIO_MIN(ifacet + buffer_facet_count, total_facet_count);
-        struct gmio_stl_triangle tri;
-        uint32_t ibuffer_facet;
+        const uint32_t facet_count =
+                GMIO_MIN(buffer_facet_count, total_facet_count - ifacet);
         char* buffpos = mblock_ptr;
 
         gmio_task_iface_handle_progress(task, ifacet, total_facet_count);
 
         /* Writing of facets is buffered */
-        for (ibuffer_facet = ifacet;
-             ibuffer_facet < clamped_facet_count;
-             ++ibuffer_facet)
-        {
-            mesh->func_get_triangle(mesh->cookie, ibuffer_facet, &tri);
-
-            buffpos = gmio_write_rawstr(buffpos, "facet normal ");
-            buffpos = gmio_write_coords(buffpos, &vec_txtformat, &tri.n);
-
-            buffpos = gmio_write_rawstr(buffpos, "\nouter loop");
-            buffpos = gmio_write_rawstr(buffpos, "\n vertex ");
-            buffpos = gmio_write_coords(buffpos, &vec_txtformat, &tri.v1);
-            buffpos = gmio_write_rawstr(buffpos, "\n vertex ");
-            buffpos = gmio_write_coords(buffpos, &vec_txtformat, &tri.v2);
-            buffpos = gmio_write_rawstr(buffpos, "\n vertex ");
-            buffpos = gmio_write_coords(buffpos, &vec_txtformat, &tri.v3);
-            buffpos = gmio_write_rawstr(buffpos, "\nendloop");
-
-            buffpos = gmio_write_rawstr(buffpos, "\nendfacet\n");
-        } /* end for (ibuffer_facet) */
-
+        buffpos = gmio_write_facets(
+                    buffpos, &vec_txtformat, mesh, ifacet, facet_count, tri_batch);
         if (!gmio_stream_flush_buffer(stream, mblock_ptr, buffpos))
             error = GMIO_ERROR_STREAM;
 
@@ -29,7 +29,21 @@
 
 #include "stlb_byte_swap.h"
 
+#include "../stl_constants.h"
 #include "../../gmio_core/internal/byte_swap.h"
+#include "../../gmio_core/internal/cpu_features.h"
+
+#include <string.h>
+
+#if defined(GMIO_HAVE_SSE2) || defined(GMIO_HAVE_SSSE3_DISPATCH)
+#  include <emmintrin.h>
+#endif
+#ifdef GMIO_HAVE_SSSE3_DISPATCH
+#  include <tmmintrin.h>
+#endif
+#ifdef GMIO_HAVE_NEON
+#  include <arm_neon.h>
+#endif
 
 void gmio_stl_triangle_bswap(struct gmio_stl_triangle* triangle)
 {
@@ -42,3 +56,115 @@ void gmio_stl_triangle_bswap(struct gmio_stl_triangle* triangle)
     if (attr_byte_count != 0)
         triangle->attribute_byte_count = gmio_uint16_bswap(attr_byte_count);
 }
+
+/* Byte-swap of the uint16 "attribute byte count" ending a facet record */
+GMIO_INLINE void gmio_stlb_facet_attr_bswap(uint8_t* record)
+{
+    const uint8_t b = record[GMIO_STLA_TRIANGLE_RAWSIZE];
+    record[GMIO_STLA_TRIANGLE_RAWSIZE] = record[GMIO_STLA_TRIANGLE_RAWSIZE + 1];
+    record[GMIO_STLA_TRIANGLE_RAWSIZE + 1] = b;
+}
+
+#if !defined(GMIO_HAVE_SSE2) && !defined(GMIO_HAVE_NEON)
+static void gmio_stlb_facets_bswap_scalar(uint8_t* buffer, uint32_t facet_count)
+{
+    uint32_t i_facet;
+    for (i_facet = 0; i_facet < facet_count; ++i_facet) {
+        int i;
+        for (i = 0; i < 12; ++i) {
+            uint8_t* coord_ptr = buffer + i * sizeof(uint32_t);
+            uint32_t coord;
+            memcpy(&coord, coord_ptr, sizeof(uint32_t));
+            coord = gmio_uint32_bswap(coord);
+            memcpy(coord_ptr, &coord, sizeof(uint32_t));
+        }
+        gmio_stlb_facet_attr_bswap(buffer);
+        buffer += GMIO_STLB_TRIANGLE_RAWSIZE;
+    }
+}
+#endif
+
+/* The 12 XYZ coords of a record are 48 contiguous bytes, ie three 128b
+ * vectors. Records being 50 bytes long, wider vectors(AVX2) would straddle
+ * two records and bring nothing */
+
+#ifdef GMIO_HAVE_SSE2
+GMIO_INLINE __m128i gmio_mm_bswap32_sse2(__m128i x)
+{
+    /* Swap bytes of each 16b word, then swap 16b words of each 32b word */
+    x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+static void gmio_stlb_facets_bswap_sse2(uint8_t* buffer, uint32_t facet_count)
+{
+    uint32_t i_facet;
+    for (i_facet = 0; i_facet < facet_count; ++i_facet) {
+        __m128i* vec_ptr = (__m128i*)buffer;
+        const __m128i v0 = gmio_mm_bswap32_sse2(_mm_loadu_si128(vec_ptr));
+        const __m128i v1 = gmio_mm_bswap32_sse2(_mm_loadu_si128(vec_ptr + 1));
+        const __m128i v2 = gmio_mm_bswap32_sse2(_mm_loadu_si128(vec_ptr + 2));
+        _mm_storeu_si128(vec_ptr, v0);
+        _mm_storeu_si128(vec_ptr + 1, v1);
+        _mm_storeu_si128(vec_ptr + 2, v2);
+        gmio_stlb_facet_attr_bswap(buffer);
+        buffer += GMIO_STLB_TRIANGLE_RAWSIZE;
+    }
+}
+#endif /* GMIO_HAVE_SSE2 */
+
+#ifdef GMIO_HAVE_SSSE3_DISPATCH
+GMIO_TARGET_SSSE3
+static void gmio_stlb_facets_bswap_ssse3(uint8_t* buffer, uint32_t facet_count)
+{
+    const __m128i mask =
+            _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    uint32_t i_facet;
+    for (i_facet = 0; i_facet < facet_count; ++i_facet) {
+        __m128i* vec_ptr = (__m128i*)buffer;
+        const __m128i v0 = _mm_shuffle_epi8(_mm_loadu_si128(vec_ptr), mask);
+        const __m128i v1 = _mm_shuffle_epi8(_mm_loadu_si128(vec_ptr + 1), mask);
+        const __m128i v2 = _mm_shuffle_epi8(_mm_loadu_si128(vec_ptr + 2), mask);
+        _mm_storeu_si128(vec_ptr, v0);
+        _mm_storeu_si128(vec_ptr + 1, v1);
+        _mm_storeu_si128(vec_ptr + 2, v2);
+        gmio_stlb_facet_attr_bswap(buffer);
+        buffer += GMIO_STLB_TRIANGLE_RAWSIZE;
+    }
+}
+#endif /* GMIO_HAVE_SSSE3_DISPATCH */
+
+#ifdef GMIO_HAVE_NEON
+static void gmio_stlb_facets_bswap_neon(uint8_t* buffer, uint32_t facet_count)
+{
+    uint32_t i_facet;
+    for (i_facet = 0; i_facet < facet_count; ++i_facet) {
+        const uint8x16_t v0 = vrev32q_u8(vld1q_u8(buffer));
+        const uint8x16_t v1 = vrev32q_u8(vld1q_u8(buffer + 16));
+        const uint8x16_t v2 = vrev32q_u8(vld1q_u8(buffer + 32));
+        vst1q_u8(buffer, v0);
+        vst1q_u8(buffer + 16, v1);
+        vst1q_u8(buffer + 32, v2);
+        gmio_stlb_facet_attr_bswap(buffer);
+        buffer += GMIO_STLB_TRIANGLE_RAWSIZE;
+    }
+}
+#endif /* GMIO_HAVE_NEON */
+
+void gmio_stlb_facets_bswap(uint8_t* buffer, uint32_t facet_count)
+{
+#ifdef GMIO_HAVE_SSSE3_DISPATCH
+    if (gmio_cpu_supports_ssse3()) {
+        gmio_stlb_facets_bswap_ssse3(buffer, facet_count);
+        return;
+    }
+#endif
+#if defined(GMIO_HAVE_SSE2)
+    gmio_stlb_facets_bswap_sse2(buffer, facet_count);
+#elif defined(GMIO_HAVE_NEON)
+    gmio_stlb_facets_bswap_neon(buffer, facet_count);
+#else
+    gmio_stlb_facets_bswap_scalar(buffer, facet_count);
+#endif
+}
@@ -38,3 +38,11 @@
  *  the "attribute byte count" member.
  */
 void gmio_stl_triangle_bswap(struct gmio_stl_triangle* triangle);
+
+/*! Specific byte-swap of \p facet_count STL binary facet records(each one of
+ *  \c GMIO_STLB_TRIANGLE_RAWSIZE bytes) contiguous in \p buffer
+ *
+ *  Same as gmio_stl_triangle_bswap() but directly on the packed records, using
+ *  SIMD instructions when supported by the running CPU.
+ */
+void gmio_stlb_facets_bswap(uint8_t* buffer, uint32_t facet_count);
@@ -51,7 +51,27 @@ int gmio_stlb_infos_probe(
         unsigned flags,
         const struct gmio_stl_infos_probe_options* opts)
 {
-    if (flags != 0) {
+    const gmio_streamsize_t facets_offset =
+            GMIO_STLB_HEADER_SIZE + sizeof(uint32_t);
+    const bool limit_before_facets =
+            opts->size_limit > 0 && opts->size_limit < facets_offset;
+
+    if (flags != 0 && limit_before_facets) {
+        /* Header and facet count can't be read, deduce from stream size */
+        const gmio_streamsize_t size = gmio_stream_size(stream);
+        const gmio_streamsize_t facets_size = size - facets_offset;
+        if (flags & GMIO_STL_INFO_FLAG_FACET_COUNT) {
+            infos->facet_count =
+                    facets_size > 0 ?
+                        (uint32_t)(facets_size / GMIO_STLB_TRIANGLE_RAWSIZE) :
+                        0;
+        }
+        if (flags & GMIO_STL_INFO_FLAG_SIZE)
+            infos->size = size;
+        infos->estimated_flags =
+                flags & (GMIO_STL_INFO_FLAG_FACET_COUNT | GMIO_STL_INFO_FLAG_SIZE);
+    }
+    else if (flags != 0) {
         const enum gmio_endianness byte_order =
                 gmio_stl_format_to_endianness(opts->format_hint);
         uint32_t facet_count = 0;
@@ -83,5 +103,5 @@ gmio_streamsize_t gmio_stlb_infos_size(uint32_t facet_count)
 {
     return GMIO_STLB_HEADER_SIZE
             + sizeof(uint32_t)
-            + facet_count * GMIO_STLB_TRIANGLE_RAWSIZE;
+            + (gmio_streamsize_t)facet_count * GMIO_STLB_TRIANGLE_RAWSIZE;
 }
@@ -0,0 +1,112 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include "../../gmio_core/global.h"
+#include "../stl_constants.h"
+#include "../stl_triangle.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* Returns the count of bytes to skip from \p ptr so it is suitably aligned
+ * for an array of gmio_stl_triangle objects */
+GMIO_INLINE size_t gmio_stl_triangle_array_align_offset(const void* ptr);
+
+/* Returns the maximum count of gmio_stl_triangle objects that can be stored
+ * in the memory block of \p size bytes beginning at \p ptr */
+GMIO_INLINE size_t gmio_stl_triangle_array_capacity(const void* ptr, size_t size);
+
+/* Spreads in-place the \p count packed facet records(beginning at \p buffer)
+ * into an array of gmio_stl_triangle objects
+ *
+ * Facets are moved backwards, so that no record gets overwritten before it
+ * was moved(the gmio_stl_triangle stride is larger than the record size).
+ *
+ * Returns a pointer to the first gmio_stl_triangle, located at offset
+ * gmio_stl_triangle_array_align_offset() of \p buffer */
+GMIO_INLINE struct gmio_stl_triangle* gmio_stlb_triangle_array_unpack(
+        uint8_t* buffer, uint32_t count);
+
+/* Inverse operation of gmio_stlb_triangle_array_unpack(): packs in-place
+ * the \p count gmio_stl_triangle objects beginning at \p triangles into facet
+ * records, the first one being stored at \p buffer
+ *
+ * \p triangles is expected to be located at offset
+ * gmio_stl_triangle_array_align_offset() of \p buffer */
+GMIO_INLINE void gmio_stlb_triangle_array_pack(
+        const struct gmio_stl_triangle* triangles, uint32_t count, uint8_t* buffer);
+
+
+
+/*
+ * Implementation
+ */
+
+size_t gmio_stl_triangle_array_align_offset(const void* ptr)
+{
+    const size_t misalign = (size_t)ptr % sizeof(float);
+    return misalign != 0 ? sizeof(float) - misalign : 0;
+}
+
+size_t gmio_stl_triangle_array_capacity(const void* ptr, size_t size)
+{
+    const size_t offset = gmio_stl_triangle_array_align_offset(ptr);
+    return size > offset ?
+                (size - offset) / sizeof(struct gmio_stl_triangle) :
+                0;
+}
+
+struct gmio_stl_triangle* gmio_stlb_triangle_array_unpack(
+        uint8_t* buffer, uint32_t count)
+{
+    struct gmio_stl_triangle* triangles =
+            (struct gmio_stl_triangle*)(
+                buffer + gmio_stl_triangle_array_align_offset(buffer));
+    uint32_t i = count;
+    while (i > 0) {
+        --i;
+        memmove(&triangles[i],
+                buffer + i * GMIO_STLB_TRIANGLE_RAWSIZE,
+                GMIO_STLB_TRIANGLE_RAWSIZE);
+    }
+    return triangles;
+}
+
+void gmio_stlb_triangle_array_pack(
+        const struct gmio_stl_triangle* triangles, uint32_t count, uint8_t* buffer)
+{
+    uint32_t i;
+    for (i = 0; i < count; ++i) {
+        memmove(buffer + i * GMIO_STLB_TRIANGLE_RAWSIZE,
+                &triangles[i],
+                GMIO_STLB_TRIANGLE_RAWSIZE);
+    }
+}
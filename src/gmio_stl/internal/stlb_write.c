@@ -32,6 +32,7 @@
 #include "stl_funptr_typedefs.h"
 #include "stl_error_check.h"
 #include "stlb_byte_swap.h"
+#include "stlb_triangle_array.h"
 #include "../stl_error.h"
 #include "../stl_io.h"
 #include "../stl_io_options.h"
@@ -44,7 +45,10 @@
 #include "../../gmio_core/internal/min_max.h"
 #include "../../gmio_core/internal/helper_stream.h"
 #include "../../gmio_core/internal/safe_cast.h"
+#include "../../gmio_core/internal/stream_pwrite.h"
+#include "../../gmio_core/internal/thread.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 GMIO_INLINE void encode_facet(
@@ -85,19 +89,218 @@ static void gmio_stlb_encode_facets_byteswap(
         const uint32_t facet_count,
         const uint32_t i_facet_offset)
 {
-    const gmio_stl_mesh_func_get_triangle_t func_get_triangle =
-            mesh->func_get_triangle;
-    const void* cookie = mesh->cookie;
-    struct gmio_stl_triangle triangle;
+    gmio_stlb_encode_facets(mesh, buffer, facet_count, i_facet_offset);
+    gmio_stlb_facets_bswap(buffer, facet_count);
+}
+
+/* Fetches the \p facet_count mesh triangles with
+ * gmio_stl_mesh::func_get_triangles() into \p buffer, that is used as an array
+ * of gmio_stl_triangle objects(see gmio_stlb_triangle_array_unpack()) */
+static struct gmio_stl_triangle* gmio_stlb_get_triangles(
+        const struct gmio_stl_mesh* mesh,
+        uint8_t* buffer,
+        const uint32_t facet_count,
+        const uint32_t i_facet_offset)
+{
+    struct gmio_stl_triangle* triangles =
+            (struct gmio_stl_triangle*)(
+                buffer + gmio_stl_triangle_array_align_offset(buffer));
     uint32_t i_facet;
+    for (i_facet = 0; i_facet < facet_count; ++i_facet)
+        triangles[i_facet].attribute_byte_count = 0;
+    mesh->func_get_triangles(
+                mesh->cookie, i_facet_offset, facet_count, triangles);
+    return triangles;
+}
 
-    triangle.attribute_byte_count = 0;
-    for (i_facet = 0; i_facet < facet_count; ++i_facet) {
-        func_get_triangle(cookie, i_facet_offset + i_facet, &triangle);
-        gmio_stl_triangle_bswap(&triangle);
-        encode_facet(&triangle, buffer);
-        buffer += GMIO_STLB_TRIANGLE_RAWSIZE;
+static void gmio_stlb_encode_facets_batch(
+        const struct gmio_stl_mesh* mesh,
+        uint8_t* buffer,
+        const uint32_t facet_count,
+        const uint32_t i_facet_offset)
+{
+    const struct gmio_stl_triangle* triangles =
+            gmio_stlb_get_triangles(mesh, buffer, facet_count, i_facet_offset);
+    gmio_stlb_triangle_array_pack(triangles, facet_count, buffer);
+}
+
+static void gmio_stlb_encode_facets_batch_byteswap(
+        const struct gmio_stl_mesh* mesh,
+        uint8_t* buffer,
+        const uint32_t facet_count,
+        const uint32_t i_facet_offset)
+{
+    gmio_stlb_encode_facets_batch(mesh, buffer, facet_count, i_facet_offset);
+    gmio_stlb_facets_bswap(buffer, facet_count);
+}
+
+/* Returns the count of facets that can be encoded at once in \p mblock */
+static uint32_t gmio_stlb_write_facet_count_max(
+        const struct gmio_memblock* mblock, bool batch)
+{
+    /* With batch, the memblock must be able to hold fetched triangles */
+    return batch ?
+                gmio_size_to_uint32(
+                    gmio_stl_triangle_array_capacity(mblock->ptr, mblock->size)) :
+                gmio_size_to_uint32(mblock->size / GMIO_STLB_TRIANGLE_RAWSIZE);
+}
+
+/* Shared state of the facet write loop run concurrently by several threads,
+ * each chunk of facets being written at its own offset in the stream.
+ * Members below mutex are accessed only with mutex locked */
+struct gmio_stlb_write_context
+{
+    struct gmio_stream* stream;
+    const struct gmio_stl_mesh* mesh;
+    const struct gmio_task_iface* task;
+    func_gmio_stlb_encode_facets_t func_encode_facets;
+    bool batch;
+    gmio_streamoffset_t base_offset; /* Stream offset of the first facet */
+    uint32_t total_facet_count;
+    struct gmio_mutex* mutex;
+    uint32_t i_facet; /* Index of the next facet to be encoded */
+    uint32_t written_facet_count;
+    int error;
+};
+
+/* Worker thread of gmio_stlb_write(), holds its own memblock */
+struct gmio_stlb_write_worker
+{
+    struct gmio_stlb_write_context* context;
+    struct gmio_memblock memblock;
+    struct gmio_thread* thread;
+};
+
+/* Encodes and writes chunks of facets until all facets are written or error */
+static void gmio_stlb_write_facets_parallel(
+        struct gmio_stlb_write_context* ctx, struct gmio_memblock* mblock)
+{
+    const uint32_t max_facet_count_per_write =
+            gmio_stlb_write_facet_count_max(mblock, ctx->batch);
+    uint32_t write_facet_count = 0;
+
+    do {
+        uint32_t i_facet = 0; /* Index of the first facet to write */
+
+        /* Pick next chunk of facets */
+        write_facet_count = 0;
+        gmio_mutex_lock(ctx->mutex);
+        if (gmio_no_error(ctx->error)
+                && ctx->i_facet < ctx->total_facet_count)
+        {
+            write_facet_count =
+                    GMIO_MIN(max_facet_count_per_write,
+                             ctx->total_facet_count - ctx->i_facet);
+            i_facet = ctx->i_facet;
+            ctx->i_facet += write_facet_count;
+        }
+        gmio_mutex_unlock(ctx->mutex);
+
+        /* Encode and write the chunk, outside of the lock */
+        if (write_facet_count > 0) {
+            const size_t write_size =
+                    write_facet_count * GMIO_STLB_TRIANGLE_RAWSIZE;
+            const gmio_streamoffset_t offset =
+                    (gmio_streamoffset_t)i_facet * GMIO_STLB_TRIANGLE_RAWSIZE;
+            bool write_ok;
+            ctx->func_encode_facets(
+                        ctx->mesh, mblock->ptr, write_facet_count, i_facet);
+            write_ok =
+                    gmio_stream_pwrite(
+                        ctx->stream,
+                        mblock->ptr,
+                        write_size,
+                        ctx->base_offset,
+                        offset)
+                    == write_size;
+            gmio_mutex_lock(ctx->mutex);
+            ctx->written_facet_count += write_facet_count;
+            if (!write_ok)
+                ctx->error = GMIO_ERROR_STREAM;
+            if (gmio_no_error(ctx->error)
+                    && gmio_task_iface_is_stop_requested(ctx->task))
+            {
+                ctx->error = GMIO_ERROR_TASK_STOPPED;
+            }
+            gmio_task_iface_handle_progress(
+                        ctx->task,
+                        ctx->written_facet_count,
+                        ctx->total_facet_count);
+            gmio_mutex_unlock(ctx->mutex);
+        }
+    } while (write_facet_count > 0);
+}
+
+static void gmio_stlb_write_worker_run(void* arg)
+{
+    struct gmio_stlb_write_worker* worker = (struct gmio_stlb_write_worker*)arg;
+    gmio_stlb_write_facets_parallel(worker->context, &worker->memblock);
+}
+
+/* Writes facets of \p ctx->mesh with \p thread_count threads (the calling one
+ * included), using positioned writes
+ *
+ * Returns false if facets could not be written this way(eg. the stream does
+ * not support positioned writes), nothing being written then */
+static bool gmio_stlb_write_parallel(
+        struct gmio_stlb_write_context* ctx,
+        struct gmio_memblock* mblock,
+        unsigned thread_count,
+        int* error)
+{
+    struct gmio_stlb_write_worker* workers = NULL;
+    unsigned worker_count = 0; /* Count of threads besides the calling one */
+    unsigned i_worker;
+
+    if (!gmio_stream_pwrite_begin(ctx->stream, &ctx->base_offset))
+        return false;
+    ctx->mutex = gmio_mutex_create();
+    if (ctx->mutex == NULL)
+        return false;
+
+    gmio_task_iface_handle_progress(ctx->task, 0, ctx->total_facet_count);
+
+    /* Start worker threads, each one with a memblock of the same size */
+    workers = calloc(thread_count - 1, sizeof(*workers));
+    if (workers != NULL) {
+        while (worker_count < thread_count - 1) {
+            struct gmio_stlb_write_worker* worker = &workers[worker_count];
+            worker->context = ctx;
+            worker->memblock = gmio_memblock_malloc(mblock->size);
+            if (worker->memblock.ptr == NULL)
+                break;
+            worker->thread =
+                    gmio_thread_create(gmio_stlb_write_worker_run, worker);
+            if (worker->thread == NULL) {
+                gmio_memblock_deallocate(&worker->memblock);
+                break;
+            }
+            ++worker_count;
+        }
+    }
+
+    /* Write facets, the calling thread takes part too */
+    gmio_stlb_write_facets_parallel(ctx, mblock);
+    for (i_worker = 0; i_worker < worker_count; ++i_worker) {
+        gmio_thread_join(workers[i_worker].thread);
+        gmio_memblock_deallocate(&workers[i_worker].memblock);
     }
+    free(workers);
+    gmio_mutex_destroy(ctx->mutex);
+    ctx->mutex = NULL;
+
+    /* Move stream position after the last facet */
+    *error = ctx->error;
+    if (!gmio_stream_pwrite_end(
+                ctx->stream,
+                ctx->base_offset
+                + (gmio_streamoffset_t)ctx->total_facet_count
+                  * GMIO_STLB_TRIANGLE_RAWSIZE)
+            && gmio_no_error(*error))
+    {
+        *error = GMIO_ERROR_STREAM;
+    }
+    return true;
 }
 
 int gmio_stlb_write(
@@ -111,26 +314,34 @@ int gmio_stlb_write(
     const struct gmio_task_iface* task = opts != NULL ? &opts->task_iface : NULL;
     struct gmio_memblock_helper mblock_helper =
             gmio_memblock_helper(opts != NULL ? &opts->stream_memblock : NULL);
-    const size_t mblock_size = mblock_helper.memblock.size;
     const uint32_t facet_count = mesh != NULL ? mesh->triangle_count : 0;
+    const bool byteswap = byte_order != GMIO_ENDIANNESS_HOST;
+    const bool batch = mesh != NULL && mesh->func_get_triangles != NULL;
     const func_gmio_stlb_encode_facets_t func_encode_facets =
-            byte_order != GMIO_ENDIANNESS_HOST ?
-                gmio_stlb_encode_facets_byteswap :
-                gmio_stlb_encode_facets;
+            batch ?
+                (byteswap ?
+                     gmio_stlb_encode_facets_batch_byteswap :
+                     gmio_stlb_encode_facets_batch) :
+                (byteswap ?
+                     gmio_stlb_encode_facets_byteswap :
+                     gmio_stlb_encode_facets);
+    void* const mblock_ptr = mblock_helper.memblock.ptr;
 
     /* Variables */
     uint32_t i_facet = 0; /* Facet counter */
     uint32_t write_facet_count =
-            gmio_size_to_uint32(mblock_size / GMIO_STLB_TRIANGLE_RAWSIZE);
-    void* const mblock_ptr = mblock_helper.memblock.ptr;
+            gmio_stlb_write_facet_count_max(&mblock_helper.memblock, batch);
     int error = GMIO_ERROR_OK;
 
     /* Make options non NULL */
     opts = opts != NULL ? opts : &default_opts;
 
     /* Check validity of input parameters */
-    if (!gmio_check_memblock(&error, &mblock_helper.memblock))
+    if (!gmio_check_memblock_size(
+                &error, &mblock_helper.memblock, GMIO_STLB_MIN_CONTENTS_SIZE))
+    {
         goto label_end;
+    }
     if (!gmio_stl_check_mesh(&error, mesh))
         goto label_end;
     if (!gmio_stlb_check_byteorder(&error, byte_order))
@@ -143,6 +354,23 @@ int gmio_stlb_write(
             goto label_end;
     }
 
+    /* Write triangles with several threads */
+    if (opts->thread_count > 1 && facet_count > 0) {
+        struct gmio_stlb_write_context ctx = {0};
+        ctx.stream = stream;
+        ctx.mesh = mesh;
+        ctx.task = task;
+        ctx.func_encode_facets = func_encode_facets;
+        ctx.batch = batch;
+        ctx.total_facet_count = facet_count;
+        ctx.error = GMIO_ERROR_OK;
+        if (gmio_stlb_write_parallel(
+                    &ctx, &mblock_helper.memblock, opts->thread_count, &error))
+        {
+            goto label_end;
+        }
+    }
+
     /* Write triangles */
     for (i_facet = 0;
          i_facet < facet_count && gmio_no_error(error);
@@ -47,7 +47,7 @@ enum gmio_stl_error
     GMIO_STL_ERROR_UNKNOWN_FORMAT = GMIO_STL_ERROR_TAG + 0x01,
 
     /*! Common STL write error indicating gmio_stl_mesh::func_get_triangle()
-     *  pointer is NULL */
+     *  and gmio_stl_mesh::func_get_triangles() pointers are NULL */
     GMIO_STL_ERROR_NULL_FUNC_GET_TRIANGLE,
 
     /* Specific error codes returned by STL_ascii read function */
@@ -54,6 +54,7 @@ int gmio_stl_infos_probe(
     if (opts != NULL)
         ovrdn_opts = *opts;
     ovrdn_opts.stream_memblock = mblock_helper.memblock;
+    infos->estimated_flags = 0;
 
     /* Guess format when left unspecified */
     if (format == GMIO_STL_FORMAT_UNKNOWN) {
@@ -94,10 +95,29 @@ int gmio_stl_infos_probe_file(
         unsigned flags,
         const struct gmio_stl_infos_probe_options *options)
 {
-    FILE* file = fopen(filepath, "rb");
+    FILE* file = NULL;
+    if (options != NULL && options->use_file_mmap) {
+        struct gmio_stream stream = gmio_stream_mmap(filepath);
+        if (stream.cookie != NULL) {
+            const int error = gmio_stl_infos_probe(infos, &stream, flags, options);
+            gmio_stream_mmap_close(&stream);
+            return error;
+        }
+    }
+    file = fopen(filepath, "rb");
     if (file != NULL) {
         struct gmio_stream stream = gmio_stream_stdio(file);
-        const int error = gmio_stl_infos_probe(infos, &stream, flags, options);
+        int error;
+        if (options != NULL && options->use_file_readahead) {
+            struct gmio_stream rastream = gmio_stream_readahead(&stream, 0, 0);
+            if (rastream.cookie != NULL) {
+                error = gmio_stl_infos_probe(infos, &rastream, flags, options);
+                gmio_stream_readahead_close(&rastream);
+                fclose(file);
+                return error;
+            }
+        }
+        error = gmio_stl_infos_probe(infos, &stream, flags, options);
         fclose(file);
         return error;
     }
@@ -66,6 +66,15 @@ struct gmio_stl_infos
 
     /*! STL binary only: header(80-bytes) of STL data */
     struct gmio_stlb_header stlb_header;
+
+    /*! Bitor combination of gmio_stl_info_flag values telling which infos are
+     *  estimates, because gmio_stl_infos_probe_options::size_limit was reached
+     *  before they could be exactly found
+     *
+     *  Only GMIO_STL_INFO_FLAG_FACET_COUNT and GMIO_STL_INFO_FLAG_SIZE can be
+     *  set. An estimated facet count is extrapolated from the average size of
+     *  the facets read so far and the total size of the stream(when known) */
+    unsigned estimated_flags;
 };
 
 /*! Flags(OR-combinations) for each STL info */
@@ -105,8 +114,26 @@ struct gmio_stl_infos_probe_options
     enum gmio_stl_format format_hint;
 
     /*! Restrict gmio_stl_infos_probe() to not read further this limit(in bytes)
-     *  \warning Not yet supported */
+     *
+     *  When the limit is reached, the infos found are partial and
+     *  gmio_stl_infos::estimated_flags tells which ones are estimates.
+     *  STL binary needs the first 84 bytes(header and facet count), with a
+     *  smaller limit the facet count is deduced from the stream size.
+     *
+     *  No limit if <tt> size_limit <= 0 </tt>(the default). The format guess
+     *  always reads a fixed-size chunk from stream, regardless of this limit */
     gmio_streamsize_t size_limit;
+
+    /*! Flag allowing gmio_stl_infos_probe_file() to memory-map the input file
+     *
+     *  See gmio_stl_read_options::use_file_mmap */
+    bool use_file_mmap;
+
+    /*! Flag allowing gmio_stl_infos_probe_file() to prefetch the input file
+     *  in a background thread
+     *
+     *  See gmio_stl_read_options::use_file_readahead */
+    bool use_file_readahead;
 };
 
 GMIO_C_LINKAGE_BEGIN
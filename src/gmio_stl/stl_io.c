@@ -63,10 +63,29 @@ int gmio_stl_read_file(
         struct gmio_stl_mesh_creator* mesh_creator,
         const struct gmio_stl_read_options* options)
 {
-    FILE* file = fopen(filepath, "rb");
+    FILE* file = NULL;
+    if (options != NULL && options->use_file_mmap) {
+        struct gmio_stream stream = gmio_stream_mmap(filepath);
+        if (stream.cookie != NULL) {
+            const int error = gmio_stl_read(&stream, mesh_creator, options);
+            gmio_stream_mmap_close(&stream);
+            return error;
+        }
+    }
+    file = fopen(filepath, "rb");
     if (file != NULL) {
         struct gmio_stream stream = gmio_stream_stdio(file);
-        const int error = gmio_stl_read(&stream, mesh_creator, options);
+        int error;
+        if (options != NULL && options->use_file_readahead) {
+            struct gmio_stream rastream = gmio_stream_readahead(&stream, 0, 0);
+            if (rastream.cookie != NULL) {
+                error = gmio_stl_read(&rastream, mesh_creator, options);
+                gmio_stream_readahead_close(&rastream);
+                fclose(file);
+                return error;
+            }
+        }
+        error = gmio_stl_read(&stream, mesh_creator, options);
         fclose(file);
         return error;
     }
@@ -101,7 +120,26 @@ int gmio_stl_write_file(
     FILE* file = fopen(filepath, "wb");
     if (file != NULL) {
         struct gmio_stream stream = gmio_stream_stdio(file);
-        const int error = gmio_stl_write(format, &stream, mesh, options);
+        int error;
+        /* Multithreaded STL binary writes directly into the FILE* */
+        if (options != NULL
+                && options->use_file_writebehind
+                && (format == GMIO_STL_FORMAT_ASCII
+                    || options->thread_count <= 1))
+        {
+            struct gmio_stream wbstream = gmio_stream_writebehind(&stream, 0, 0);
+            if (wbstream.cookie != NULL) {
+                error = gmio_stl_write(format, &wbstream, mesh, options);
+                if (gmio_stream_writebehind_close(&wbstream) != 0
+                        && gmio_no_error(error))
+                {
+                    error = GMIO_ERROR_STREAM;
+                }
+                fclose(file);
+                return error;
+            }
+        }
+        error = gmio_stl_write(format, &stream, mesh, options);
         fclose(file);
         return error;
     }
@@ -51,7 +51,8 @@ GMIO_C_LINKAGE_BEGIN
  *
  *  The user mesh is created sequentially by calling
  *  gmio_stl_mesh_creator::func_add_triangle() with each triangle read from
- *  the stream.
+ *  the stream, or gmio_stl_mesh_creator::func_add_triangles() with chunks of
+ *  triangles if this batch function is set.
  *
  *  It does nothing on the triangles read : no checking(eg. for Nan values),
  *  normals are given as they are.
@@ -84,7 +85,8 @@ GMIO_API int gmio_stl_read(
  *
  *  \return Error code (see gmio_core/error.h and stl_error.h)
  *
- *  \sa gmio_stl_read(), gmio_stream_stdio(FILE*)
+ *  \sa gmio_stl_read(), gmio_stream_stdio(FILE*), gmio_stream_mmap()
+ *  \sa gmio_stl_read_options::use_file_mmap
  */
 GMIO_API int gmio_stl_read_file(
                 const char* filepath,
@@ -117,6 +119,9 @@ GMIO_API int gmio_stla_read(
  *  \return Error code (see gmio_core/error.h and stl_error.h)
  *  \retval GMIO_ERROR_INVALID_MEMBLOCK_SIZE
  *          if <tt>options->stream_memblock.size < GMIO_STLB_MIN_CONTENTS_SIZE</tt>
+ *  \retval GMIO_STL_ERROR_FACET_COUNT
+ *          if <tt>options->stlb_facet_first</tt> is greater than the facet count
+ *          or if the stream is too short for the facets to be read
  *
  *  \sa gmio_stl_read(), gmio_stl_read_file()
  */
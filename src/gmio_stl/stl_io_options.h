@@ -90,6 +90,105 @@ struct gmio_stl_read_options
      *  \c LC_NUMERIC checking is enabled by default.
      */
     bool stla_dont_check_lc_numeric;
+
+    /*! Flag allowing gmio_stl_read_file() to memory-map the input file
+     *
+     *  If \c true then the file is accessed with gmio_stream_mmap() instead of
+     *  a standard \c FILE*. This avoids the copy from the kernel into the
+     *  \c FILE* buffer and makes seek operations cheap. If the file cannot be
+     *  mapped(or memory-mapping is not supported on the target platform) then
+     *  gmio_stl_read_file() silently falls back to \c FILE*.
+     *
+     *  Useful only with gmio_stl_read_file(), ignored otherwise.
+     *
+     *  Memory-mapping is disabled by default.
+     */
+    bool use_file_mmap;
+
+    /*! Flag allowing gmio_stl_read_file() to prefetch the input file in a
+     *  background thread
+     *
+     *  If \c true then the \c FILE* stream is wrapped with
+     *  gmio_stream_readahead(), so reading of the next chunks overlaps with
+     *  the decoding of the current one. If the read-ahead stream cannot be
+     *  created then gmio_stl_read_file() silently reads the \c FILE*
+     *  directly.\n
+     *  Ignored if the file is memory-mapped(see
+     *  gmio_stl_read_options::use_file_mmap).
+     *
+     *  Useful only with gmio_stl_read_file(), ignored otherwise.
+     *
+     *  Read-ahead is disabled by default.
+     */
+    bool use_file_readahead;
+
+    /*! Count of threads used to decode STL facets
+     *
+     *  <b>STL binary:</b>\n
+     *  If greater than \c 1 then gmio_stlb_read() starts
+     *  <tt>thread_count - 1</tt> additional threads, each one with a memblock
+     *  of the same size as gmio_stl_read_options::stream_memblock. Chunks of
+     *  facets are read from the stream in turn, then byte-swapped(if needed)
+     *  and handed over to the mesh creator concurrently.
+     *
+     *  In that case gmio_stl_mesh_creator::func_add_triangle() and
+     *  gmio_stl_mesh_creator::func_add_triangles() are called from several
+     *  threads at the same time, in no particular order, but always with
+     *  distinct triangle indexes : a typical thread-safe mesh creator
+     *  preallocates its storage in gmio_stl_mesh_creator::func_begin_solid()
+     *  and then just writes triangles at their index.\n
+     *  gmio_stl_mesh_creator::func_begin_solid() and
+     *  gmio_stl_mesh_creator::func_end_solid() are called by the calling
+     *  thread. gmio_task_iface functions may be called from any of the threads
+     *  but never concurrently.
+     *
+     *  <b>STL ascii:</b>\n
+     *  Effective only if the input stream was created with gmio_stream_mmap()
+     *  (see gmio_stl_read_options::use_file_mmap), ignored otherwise.
+     *  gmio_stla_read() then splits the facets of the solid into at most
+     *  \p thread_count chunks, at "facet" keywords near evenly spaced offsets,
+     *  and parses each chunk in its own thread. Triangles of a chunk are kept
+     *  in memory until they are handed over to the mesh creator, in order
+     *  and from the calling thread : no thread-safety is required from the
+     *  mesh creator. gmio_task_iface functions may be called from any of the
+     *  threads but never concurrently.
+     *
+     *  Ignored if threads are not supported on the target platform.
+     *
+     *  Value \c 0 (the default) has the same effect as \c 1.
+     */
+    unsigned thread_count;
+
+    /*! Index of the first facet to be read, STL binary only
+     *
+     *  gmio_stlb_read() then seeks directly to this facet(see
+     *  gmio_stl_read_options::stlb_facet_count). The default \c 0 means from
+     *  the first facet.
+     *
+     *  Ignored for STL ascii.
+     */
+    uint32_t stlb_facet_first;
+
+    /*! Count of facets to be read from gmio_stl_read_options::stlb_facet_first,
+     *  STL binary only
+     *
+     *  The range is truncated to the facet count declared in the STL binary
+     *  contents. The default \c 0 means up to the last facet.
+     *
+     *  The mesh creator sees only the facets of the range :
+     *  gmio_stl_mesh_creator_infos::stlb_triangle_count is the count of facets
+     *  in the range, and triangle indexes passed to
+     *  gmio_stl_mesh_creator::func_add_triangle() start from \c 0 for the
+     *  first facet of the range(the facet index in the file being
+     *  <tt>tri_id + stlb_facet_first</tt>). Progress is reported against the
+     *  count of facets in the range too.
+     *
+     *  This allows out-of-core processing of huge meshes by windows of facets,
+     *  or the reading of a mesh by several independent readers.
+     *
+     *  Ignored for STL ascii.
+     */
+    uint32_t stlb_facet_count;
 };
 
 /*! Options of function gmio_stl_write()
@@ -136,6 +235,11 @@ struct gmio_stl_write_options
      *
      *  Defaulted to \c GMIO_FLOAT_TEXT_FORMAT_DECIMAL_LOWERCASE when calling
      *  gmio_stl_write() with \c options==NULL
+     *
+     *  When gmio is built with <tt>GMIO_FLOAT2STR_LIB=ryu</tt>, the
+     *  GMIO_FLOAT_TEXT_FORMAT_SHORTEST_xxx formats write the shortest text that
+     *  reads back to the same float, as long as it doesn't need more than
+     *  stla_float32_prec significant digits
      */
     enum gmio_float_text_format stla_float32_format;
 
@@ -157,6 +261,54 @@ struct gmio_stl_write_options
      *    \li OR <tt>stlb_header == NULL</tt>
      */
     struct gmio_stlb_header stlb_header;
+
+    /*! Flag allowing gmio_stl_write_file() to write the output file from a
+     *  background thread
+     *
+     *  If \c true then the \c FILE* stream is wrapped with
+     *  gmio_stream_writebehind(), so output I/O overlaps with the encoding of
+     *  the next facets. If the write-behind stream cannot be created then
+     *  gmio_stl_write_file() silently writes the \c FILE* directly.\n
+     *  Ignored for STL binary formats when
+     *  gmio_stl_write_options::thread_count is greater than \c 1, facets being
+     *  then directly written at their offset in the file.
+     *
+     *  Useful only with gmio_stl_write_file(), ignored otherwise.
+     *
+     *  Write-behind is disabled by default.
+     */
+    bool use_file_writebehind;
+
+    /*! Count of threads used to encode and write STL facets
+     *
+     *  If greater than \c 1 then <tt>thread_count - 1</tt> additional threads
+     *  are started, each one with a memblock of the same size as
+     *  gmio_stl_write_options::stream_memblock. Chunks of facets are encoded
+     *  concurrently and the output is the same as with a single thread.
+     *
+     *  In that case gmio_stl_mesh::func_get_triangle() and
+     *  gmio_stl_mesh::func_get_triangles() are called from several threads at
+     *  the same time, in no particular order, but always with distinct
+     *  triangle indexes.
+     *
+     *  <b>STL binary:</b>\n
+     *  Each chunk is written directly at its final offset in the output file.
+     *  This requires an output stream created with gmio_stream_stdio() on a
+     *  seekable file(as gmio_stl_write_file() does), facets are written by the
+     *  calling thread only otherwise. gmio_task_iface functions may be called
+     *  from any of the threads but never concurrently.
+     *
+     *  <b>STL ascii:</b>\n
+     *  Chunk \c i is formatted by thread <tt>i % thread_count</tt>, then all
+     *  chunks are written to the output stream in order by the calling thread.
+     *  Any kind of stream is supported. gmio_task_iface functions are called
+     *  by the calling thread only.
+     *
+     *  Ignored if threads are not supported on the target platform.
+     *
+     *  Value \c 0 (the default) has the same effect as \c 1.
+     */
+    unsigned thread_count;
 };
 
 /*! @} */
@@ -55,6 +55,21 @@ struct gmio_stl_mesh
             const void* cookie,
             uint32_t tri_id,
             struct gmio_stl_triangle* triangle);
+
+    /*! Optional function that stores the \p count consecutive mesh triangles
+     *  starting at index \p first_tri_id into the array \p triangles
+     *
+     *  If set, then it is called instead of func_get_triangle() : the writers
+     *  fetch triangles by chunks(typically as many as fits in one memblock)
+     *  instead of one by one.
+     *  For a mesh already stored as a contiguous array of gmio_stl_triangle,
+     *  this can be a single \c memcpy().
+     */
+    void (*func_get_triangles)(
+            const void* cookie,
+            uint32_t first_tri_id,
+            uint32_t count,
+            struct gmio_stl_triangle* triangles);
 };
 
 /*! @} */
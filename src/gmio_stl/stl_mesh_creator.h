@@ -105,6 +105,23 @@ struct gmio_stl_mesh_creator
      *  The function is called at the end of the read process, ie. after all
      *  triangles have been added */
     void (*func_end_solid)(void* cookie);
+
+    /*! Optional function that adds a batch of consecutive triangles to the
+     *  user mesh
+     *
+     *  The argument \p triangles points to an array of \p count triangles,
+     *  the first one being the mesh triangle of index \p first_tri_id. This
+     *  array is owned by the reader and is valid only during the call.
+     *
+     *  If set, then it is called instead of func_add_triangle() : the readers
+     *  hand over triangles by chunks(typically the contents of one decoded
+     *  memblock) instead of one by one.
+     */
+    void (*func_add_triangles)(
+            void* cookie,
+            uint32_t first_tri_id,
+            const struct gmio_stl_triangle* triangles,
+            uint32_t count);
 };
 
 /*! @} */
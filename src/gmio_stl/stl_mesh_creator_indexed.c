@@ -0,0 +1,453 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "stl_mesh_creator_indexed.h"
+
+#include "stl_format.h"
+#include "../gmio_core/error.h"
+#include "../gmio_core/internal/convert.h"
+#include "../gmio_core/internal/min_max.h"
+#include "../gmio_core/internal/thread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    /* Average size(in bytes) of an STL ascii facet, to estimate the count of
+     * triangles from gmio_stl_mesh_creator_infos::stla_stream_size */
+    GMIO_STLA_FACET_SIZE_AVG = 200
+};
+
+/* Marks an empty slot of the hash table */
+#define GMIO_WELD_SLOT_EMPTY 0xFFFFFFFF
+
+/* Slot of the open-addressing hash table, hash is kept to avoid the
+ * comparison of vertices in most collisions and to grow the table */
+struct gmio_weld_slot
+{
+    uint32_t vertex_id;
+    uint32_t hash;
+};
+
+/* Welding key of a vertex : bit patterns of coords, or coords of grid cell */
+struct gmio_weld_key
+{
+    uint32_t c[3];
+    /* Bit i set if c[i] is a bit pattern, not a grid cell coord */
+    uint32_t exact_mask;
+};
+
+struct gmio_stl_mesh_creator_indexed_cookie
+{
+    struct gmio_stl_mesh_indexed mesh;
+    struct gmio_vec3f* vertices;
+    uint32_t* indices;
+    size_t vertex_capacity;
+    size_t triangle_capacity;
+    struct gmio_weld_slot* slots;
+    size_t slot_mask; /* Count of slots minus one(count is a power of 2) */
+    double inv_tolerance; /* 0 if welding on bit patterns */
+    struct gmio_mutex* mutex;
+    int error;
+};
+
+/* Returns the key of \p coord, \p exact is set to true if this is the bit
+ * pattern of \p coord */
+static uint32_t gmio_weld_coord_key(
+        float coord, double inv_tolerance, bool* exact)
+{
+    if (inv_tolerance > 0.) {
+        const double cell = coord * inv_tolerance;
+        /* False for NaN and infinities */
+        if (cell >= -2147483648. && cell < 2147483648.) {
+            /* Floor of the cell coord, without libm */
+            int32_t icell = (int32_t)cell;
+            if (cell < icell)
+                --icell;
+            *exact = false;
+            return (uint32_t)icell;
+        }
+    }
+    /* Welding on bit patterns, or cell coord not representable */
+    {
+        const uint32_t bits = gmio_convert_uint32(coord);
+        *exact = true;
+        return (bits & 0x7FFFFFFF) != 0 ? bits : 0; /* -0.f -> +0.f */
+    }
+}
+
+static struct gmio_weld_key gmio_weld_key(
+        const struct gmio_vec3f* v, double inv_tolerance)
+{
+    struct gmio_weld_key key;
+    bool exact[3];
+    key.c[0] = gmio_weld_coord_key(v->x, inv_tolerance, &exact[0]);
+    key.c[1] = gmio_weld_coord_key(v->y, inv_tolerance, &exact[1]);
+    key.c[2] = gmio_weld_coord_key(v->z, inv_tolerance, &exact[2]);
+    key.exact_mask =
+            (exact[0] ? 1 : 0) | (exact[1] ? 2 : 0) | (exact[2] ? 4 : 0);
+    return key;
+}
+
+static uint32_t gmio_weld_hash(const struct gmio_weld_key* key)
+{
+    uint32_t h =
+            key->c[0] * 0x9E3779B1u
+            ^ key->c[1] * 0x85EBCA77u
+            ^ key->c[2] * 0xC2B2AE3Du
+            ^ key->exact_mask;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    return h;
+}
+
+static bool gmio_weld_key_equal(
+        const struct gmio_weld_key* lhs, const struct gmio_weld_key* rhs)
+{
+    return lhs->c[0] == rhs->c[0]
+            && lhs->c[1] == rhs->c[1]
+            && lhs->c[2] == rhs->c[2]
+            && lhs->exact_mask == rhs->exact_mask;
+}
+
+/* Returns the smallest power of 2 greater or equal to \p n */
+static size_t gmio_pow2_ceil(size_t n)
+{
+    size_t p = 16;
+    while (p < n)
+        p *= 2;
+    return p;
+}
+
+/* Allocates a hash table of at least 2 * vertex_capacity slots(load factor
+ * kept below 0.5) then inserts the existing vertices */
+static bool gmio_weld_rehash(
+        struct gmio_stl_mesh_creator_indexed_cookie* cookie,
+        size_t vertex_capacity)
+{
+    const size_t slot_count = gmio_pow2_ceil(2 * vertex_capacity);
+    struct gmio_weld_slot* slots =
+            (struct gmio_weld_slot*)malloc(
+                slot_count * sizeof(struct gmio_weld_slot));
+    size_t i;
+    if (slots == NULL)
+        return false;
+    memset(slots, 0xFF, slot_count * sizeof(struct gmio_weld_slot));
+    if (cookie->slots != NULL) {
+        for (i = 0; i <= cookie->slot_mask; ++i) {
+            const struct gmio_weld_slot* slot = &cookie->slots[i];
+            if (slot->vertex_id != GMIO_WELD_SLOT_EMPTY) {
+                size_t j = slot->hash & (slot_count - 1);
+                while (slots[j].vertex_id != GMIO_WELD_SLOT_EMPTY)
+                    j = (j + 1) & (slot_count - 1);
+                slots[j] = *slot;
+            }
+        }
+        free(cookie->slots);
+    }
+    else {
+        /* Table was released by func_end_solid(), insert all vertices */
+        uint32_t id;
+        for (id = 0; id < cookie->mesh.vertex_count; ++id) {
+            const struct gmio_weld_key key =
+                    gmio_weld_key(&cookie->vertices[id], cookie->inv_tolerance);
+            const uint32_t hash = gmio_weld_hash(&key);
+            size_t j = hash & (slot_count - 1);
+            while (slots[j].vertex_id != GMIO_WELD_SLOT_EMPTY)
+                j = (j + 1) & (slot_count - 1);
+            slots[j].vertex_id = id;
+            slots[j].hash = hash;
+        }
+    }
+    cookie->slots = slots;
+    cookie->slot_mask = slot_count - 1;
+    return true;
+}
+
+static bool gmio_weld_reserve_vertices(
+        struct gmio_stl_mesh_creator_indexed_cookie* cookie, size_t count)
+{
+    if (count > cookie->vertex_capacity) {
+        struct gmio_vec3f* vertices =
+                (struct gmio_vec3f*)realloc(
+                    cookie->vertices, count * sizeof(struct gmio_vec3f));
+        if (vertices == NULL)
+            return false;
+        cookie->vertices = vertices;
+        cookie->vertex_capacity = count;
+        cookie->mesh.vertices = vertices;
+    }
+    return (cookie->slots != NULL && (2 * count) <= (cookie->slot_mask + 1))
+            || gmio_weld_rehash(cookie, count);
+}
+
+static bool gmio_weld_reserve_triangles(
+        struct gmio_stl_mesh_creator_indexed_cookie* cookie, size_t count)
+{
+    if (count > cookie->triangle_capacity) {
+        uint32_t* indices =
+                (uint32_t*)realloc(cookie->indices, 3 * count * sizeof(uint32_t));
+        if (indices == NULL)
+            return false;
+        cookie->indices = indices;
+        cookie->triangle_capacity = count;
+        cookie->mesh.indices = indices;
+    }
+    return true;
+}
+
+/* Returns the index of the vertex welded with \p v, that is added if needed.
+ * Returns GMIO_WELD_SLOT_EMPTY on memory error */
+static uint32_t gmio_weld_vertex(
+        struct gmio_stl_mesh_creator_indexed_cookie* cookie,
+        const struct gmio_vec3f* v)
+{
+    const struct gmio_weld_key key = gmio_weld_key(v, cookie->inv_tolerance);
+    const uint32_t hash = gmio_weld_hash(&key);
+    const uint32_t vertex_count = cookie->mesh.vertex_count;
+    size_t i = hash & cookie->slot_mask;
+    while (cookie->slots[i].vertex_id != GMIO_WELD_SLOT_EMPTY) {
+        const struct gmio_weld_slot* slot = &cookie->slots[i];
+        if (slot->hash == hash) {
+            const struct gmio_weld_key slot_key =
+                    gmio_weld_key(
+                        &cookie->vertices[slot->vertex_id],
+                        cookie->inv_tolerance);
+            if (gmio_weld_key_equal(&key, &slot_key))
+                return slot->vertex_id;
+        }
+        i = (i + 1) & cookie->slot_mask;
+    }
+
+    /* New vertex */
+    if (vertex_count == GMIO_WELD_SLOT_EMPTY - 1)
+        return GMIO_WELD_SLOT_EMPTY;
+    if (vertex_count >= cookie->vertex_capacity
+            || 2 * ((size_t)vertex_count + 1) > cookie->slot_mask + 1)
+    {
+        const size_t capacity =
+                GMIO_MAX(2 * cookie->vertex_capacity, (size_t)vertex_count + 1);
+        if (!gmio_weld_reserve_vertices(cookie, capacity))
+            return GMIO_WELD_SLOT_EMPTY;
+        /* Table changed, find the new empty slot */
+        i = hash & cookie->slot_mask;
+        while (cookie->slots[i].vertex_id != GMIO_WELD_SLOT_EMPTY)
+            i = (i + 1) & cookie->slot_mask;
+    }
+    cookie->slots[i].vertex_id = vertex_count;
+    cookie->slots[i].hash = hash;
+    cookie->vertices[vertex_count] = *v;
+    cookie->mesh.vertex_count = vertex_count + 1;
+    return vertex_count;
+}
+
+/* Releases all the storage of \p cookie, keeping the options */
+static void gmio_stl_mesh_creator_indexed_clear(
+        struct gmio_stl_mesh_creator_indexed_cookie* cookie)
+{
+    free(cookie->vertices);
+    free(cookie->indices);
+    free(cookie->slots);
+    cookie->vertices = NULL;
+    cookie->indices = NULL;
+    cookie->slots = NULL;
+    cookie->slot_mask = 0;
+    cookie->vertex_capacity = 0;
+    cookie->triangle_capacity = 0;
+    memset(&cookie->mesh, 0, sizeof(struct gmio_stl_mesh_indexed));
+    cookie->error = GMIO_ERROR_OK;
+}
+
+static void gmio_stl_mesh_creator_indexed_begin_solid(
+        void* cookie, const struct gmio_stl_mesh_creator_infos* infos)
+{
+    struct gmio_stl_mesh_creator_indexed_cookie* icookie =
+            (struct gmio_stl_mesh_creator_indexed_cookie*)cookie;
+    size_t tri_count = 0;
+    if (infos->format == GMIO_STL_FORMAT_ASCII)
+        tri_count = (size_t)(infos->stla_stream_size / GMIO_STLA_FACET_SIZE_AVG);
+    else if (infos->format & GMIO_STL_FORMAT_TAG_BINARY)
+        tri_count = infos->stlb_triangle_count;
+
+    gmio_stl_mesh_creator_indexed_clear(icookie);
+    /* Closed meshes have about half as many vertices as triangles */
+    if (!gmio_weld_reserve_triangles(icookie, GMIO_MAX(tri_count, 16))
+            || !gmio_weld_reserve_vertices(icookie, tri_count / 2 + 16))
+    {
+        icookie->error = GMIO_ERROR_MEMORY_ALLOC;
+    }
+}
+
+static void gmio_stl_mesh_creator_indexed_add_triangles(
+        void* cookie,
+        uint32_t first_tri_id,
+        const struct gmio_stl_triangle* triangles,
+        uint32_t count)
+{
+    struct gmio_stl_mesh_creator_indexed_cookie* icookie =
+            (struct gmio_stl_mesh_creator_indexed_cookie*)cookie;
+    const size_t end_tri_id = (size_t)first_tri_id + count;
+    uint32_t i;
+
+    gmio_mutex_lock(icookie->mutex);
+    if (icookie->error == GMIO_ERROR_OK
+            && icookie->slots == NULL
+            && !gmio_weld_reserve_vertices(
+                icookie, icookie->mesh.vertex_count + (size_t)count))
+    {
+        icookie->error = GMIO_ERROR_MEMORY_ALLOC;
+    }
+    if (icookie->error == GMIO_ERROR_OK
+            && end_tri_id > icookie->triangle_capacity)
+    {
+        const size_t capacity =
+                GMIO_MAX(2 * icookie->triangle_capacity, end_tri_id);
+        if (!gmio_weld_reserve_triangles(icookie, capacity))
+            icookie->error = GMIO_ERROR_MEMORY_ALLOC;
+    }
+    for (i = 0; i < count && icookie->error == GMIO_ERROR_OK; ++i) {
+        const struct gmio_stl_triangle* tri = &triangles[i];
+        uint32_t* tri_indices = icookie->indices + 3 * ((size_t)first_tri_id + i);
+        tri_indices[0] = gmio_weld_vertex(icookie, &tri->v1);
+        tri_indices[1] = gmio_weld_vertex(icookie, &tri->v2);
+        tri_indices[2] = gmio_weld_vertex(icookie, &tri->v3);
+        if (tri_indices[0] == GMIO_WELD_SLOT_EMPTY
+                || tri_indices[1] == GMIO_WELD_SLOT_EMPTY
+                || tri_indices[2] == GMIO_WELD_SLOT_EMPTY)
+        {
+            icookie->error = GMIO_ERROR_MEMORY_ALLOC;
+        }
+    }
+    if (icookie->error == GMIO_ERROR_OK) {
+        icookie->mesh.triangle_count =
+                GMIO_MAX(icookie->mesh.triangle_count, (uint32_t)end_tri_id);
+    }
+    gmio_mutex_unlock(icookie->mutex);
+}
+
+static void gmio_stl_mesh_creator_indexed_add_triangle(
+        void* cookie, uint32_t tri_id, const struct gmio_stl_triangle* triangle)
+{
+    gmio_stl_mesh_creator_indexed_add_triangles(cookie, tri_id, triangle, 1);
+}
+
+static void gmio_stl_mesh_creator_indexed_end_solid(void* cookie)
+{
+    struct gmio_stl_mesh_creator_indexed_cookie* icookie =
+            (struct gmio_stl_mesh_creator_indexed_cookie*)cookie;
+    /* Hash table is no longer needed, shrink vertices to their actual count */
+    free(icookie->slots);
+    icookie->slots = NULL;
+    icookie->slot_mask = 0;
+    if (icookie->mesh.vertex_count > 0
+            && icookie->mesh.vertex_count < icookie->vertex_capacity)
+    {
+        struct gmio_vec3f* vertices =
+                (struct gmio_vec3f*)realloc(
+                    icookie->vertices,
+                    icookie->mesh.vertex_count * sizeof(struct gmio_vec3f));
+        if (vertices != NULL) {
+            icookie->vertices = vertices;
+            icookie->vertex_capacity = icookie->mesh.vertex_count;
+            icookie->mesh.vertices = vertices;
+        }
+    }
+}
+
+struct gmio_stl_mesh_creator gmio_stl_mesh_creator_indexed(
+        const struct gmio_stl_mesh_creator_indexed_options* opts)
+{
+    struct gmio_stl_mesh_creator creator = {0};
+    struct gmio_stl_mesh_creator_indexed_cookie* cookie =
+            (struct gmio_stl_mesh_creator_indexed_cookie*)calloc(
+                1, sizeof(struct gmio_stl_mesh_creator_indexed_cookie));
+    if (cookie == NULL)
+        return creator;
+    if (opts != NULL && opts->weld_tolerance > 0.f)
+        cookie->inv_tolerance = 1. / opts->weld_tolerance;
+    /* NULL if threads are not supported, then calls are not serialized */
+    cookie->mutex = gmio_mutex_create();
+#ifdef GMIO_HAVE_THREADS
+    if (cookie->mutex == NULL) {
+        free(cookie);
+        return creator;
+    }
+#endif
+
+    creator.cookie = cookie;
+    creator.func_begin_solid = gmio_stl_mesh_creator_indexed_begin_solid;
+    creator.func_add_triangle = gmio_stl_mesh_creator_indexed_add_triangle;
+    creator.func_add_triangles = gmio_stl_mesh_creator_indexed_add_triangles;
+    creator.func_end_solid = gmio_stl_mesh_creator_indexed_end_solid;
+    return creator;
+}
+
+static bool gmio_stl_mesh_creator_is_indexed(
+        const struct gmio_stl_mesh_creator* creator)
+{
+    return creator != NULL
+            && creator->cookie != NULL
+            && creator->func_begin_solid
+               == gmio_stl_mesh_creator_indexed_begin_solid;
+}
+
+const struct gmio_stl_mesh_indexed* gmio_stl_mesh_creator_indexed_mesh(
+        const struct gmio_stl_mesh_creator* creator)
+{
+    if (gmio_stl_mesh_creator_is_indexed(creator)) {
+        const struct gmio_stl_mesh_creator_indexed_cookie* cookie =
+                (const struct gmio_stl_mesh_creator_indexed_cookie*)creator->cookie;
+        return &cookie->mesh;
+    }
+    return NULL;
+}
+
+int gmio_stl_mesh_creator_indexed_error(
+        const struct gmio_stl_mesh_creator* creator)
+{
+    if (gmio_stl_mesh_creator_is_indexed(creator)) {
+        const struct gmio_stl_mesh_creator_indexed_cookie* cookie =
+                (const struct gmio_stl_mesh_creator_indexed_cookie*)creator->cookie;
+        return cookie->error;
+    }
+    return GMIO_ERROR_UNKNOWN;
+}
+
+void gmio_stl_mesh_creator_indexed_close(struct gmio_stl_mesh_creator* creator)
+{
+    if (gmio_stl_mesh_creator_is_indexed(creator)) {
+        struct gmio_stl_mesh_creator_indexed_cookie* cookie =
+                (struct gmio_stl_mesh_creator_indexed_cookie*)creator->cookie;
+        gmio_stl_mesh_creator_indexed_clear(cookie);
+        gmio_mutex_destroy(cookie->mutex);
+        free(cookie);
+        memset(creator, 0, sizeof(struct gmio_stl_mesh_creator));
+    }
+}
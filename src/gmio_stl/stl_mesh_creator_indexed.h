@@ -0,0 +1,143 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+/*! \file stl_mesh_creator_indexed.h
+ *  Built-in mesh creator welding vertices of STL facets
+ *
+ *  \addtogroup gmio_stl
+ *  @{
+ */
+
+#pragma once
+
+#include "stl_global.h"
+#include "stl_mesh_creator.h"
+#include "../gmio_core/vecgeom.h"
+
+#include <stddef.h>
+
+/*! Indexed triangle mesh, where vertices shared by facets are stored once */
+struct gmio_stl_mesh_indexed
+{
+    /*! Array of the unique vertices */
+    const struct gmio_vec3f* vertices;
+
+    /*! Count of items in gmio_stl_mesh_indexed::vertices */
+    uint32_t vertex_count;
+
+    /*! Array of <tt>3 * triangle_count</tt> indexes in
+     *  gmio_stl_mesh_indexed::vertices, the vertices of triangle \c i are at
+     *  indexes <tt>3*i</tt>, <tt>3*i + 1</tt> and <tt>3*i + 2</tt> */
+    const uint32_t* indices;
+
+    /*! Count of triangles */
+    uint32_t triangle_count;
+};
+
+/*! Options of function gmio_stl_mesh_creator_indexed()
+ *
+ *  Initialising gmio_stl_mesh_creator_indexed_options with \c {0} (or \c {} in
+ *  C++) is the convenient way to set default values(passing \c NULL to
+ *  gmio_stl_mesh_creator_indexed() has the same effect).
+ */
+struct gmio_stl_mesh_creator_indexed_options
+{
+    /*! Size of the cells of the grid used to weld vertices
+     *
+     *  If \c 0 (the default) then vertices are welded only if their coords
+     *  have the same bit patterns(\c -0.f and \c +0.f being considered
+     *  equal).\n
+     *  Otherwise coords are snapped to a regular grid of step
+     *  \p weld_tolerance, and vertices falling into the same cell are welded :
+     *  the first vertex read in a cell is the one kept. Note that two close
+     *  vertices lying on each side of a cell boundary are not welded.
+     */
+    float weld_tolerance;
+};
+
+GMIO_C_LINKAGE_BEGIN
+
+/*! Returns a mesh creator building a gmio_stl_mesh_indexed
+ *
+ *  Vertices are welded while triangles are read, with a hash table using
+ *  open addressing. Storage is preallocated in
+ *  gmio_stl_mesh_creator::func_begin_solid() from
+ *  gmio_stl_mesh_creator_infos::stlb_triangle_count(or an estimation based on
+ *  gmio_stl_mesh_creator_infos::stla_stream_size), and then grows only if this
+ *  estimation was too low. The hash table is released in
+ *  gmio_stl_mesh_creator::func_end_solid(), after which only vertices and
+ *  indices are kept.
+ *
+ *  Facet normals and attributes are not kept, normals can be recomputed from
+ *  vertices(see gmio_stl_triangle_compute_normal()).
+ *
+ *  The creator can be used with gmio_stl_read_options::thread_count greater
+ *  than \c 1 : calls are then serialized. Triangles keep their index but the
+ *  order of vertices may vary from one read to another.
+ *
+ *  The returned creator must be released with
+ *  gmio_stl_mesh_creator_indexed_close()
+ *
+ *  \return A creator with gmio_stl_mesh_creator::cookie set to \c NULL if
+ *          memory or the mutex serializing calls could not be allocated
+ */
+GMIO_API struct gmio_stl_mesh_creator gmio_stl_mesh_creator_indexed(
+        const struct gmio_stl_mesh_creator_indexed_options* opts);
+
+/*! Returns the mesh built by a creator created with
+ *  gmio_stl_mesh_creator_indexed()
+ *
+ *  The mesh is owned by \p creator and is valid until
+ *  gmio_stl_mesh_creator_indexed_close()
+ *
+ *  \return \c NULL if \p creator was not created with
+ *          gmio_stl_mesh_creator_indexed()
+ */
+GMIO_API const struct gmio_stl_mesh_indexed* gmio_stl_mesh_creator_indexed_mesh(
+        const struct gmio_stl_mesh_creator* creator);
+
+/*! Returns the error that occurred while building the mesh
+ *
+ *  \retval GMIO_ERROR_OK if no error occurred
+ *  \retval GMIO_ERROR_MEMORY_ALLOC if storage could not be allocated, the
+ *          mesh then holds only the triangles added before
+ */
+GMIO_API int gmio_stl_mesh_creator_indexed_error(
+        const struct gmio_stl_mesh_creator* creator);
+
+/*! Releases the resources of a creator created with
+ *  gmio_stl_mesh_creator_indexed()
+ *
+ *  \p creator is reset to a creator with all members set to \c NULL */
+GMIO_API void gmio_stl_mesh_creator_indexed_close(
+        struct gmio_stl_mesh_creator* creator);
+
+GMIO_C_LINKAGE_END
+
+/*! @} */
@@ -0,0 +1,321 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "stl_triangle_soa.h"
+#include "internal/stl_triangle_soa.h"
+
+#include "stl_format.h"
+#include "stl_triangle.h"
+#include "../gmio_core/internal/cpu_features.h"
+#include "../gmio_core/internal/min_max.h"
+
+#include <string.h>
+
+#if defined(GMIO_HAVE_SSE2)
+#  include <emmintrin.h>
+#elif defined(GMIO_HAVE_NEON)
+#  include <arm_neon.h>
+#endif
+
+/* The 12 coords of a facet record are 48 contiguous bytes, ie three blocks of
+ * four floats. Four records are transposed at once : the 4x4 matrix made of
+ * the same block of each record is transposed, giving four coords of the same
+ * kind ready to be stored in SoA arrays. The transposition being its own
+ * inverse, the same is done the other way for SoA to records */
+
+enum { GMIO_STL_TRIANGLE_COORD_COUNT = 12 };
+
+/* Fills \p arrays with the SoA arrays, in the order of coords in a record */
+static void gmio_stl_triangle_soa_arrays(
+        const struct gmio_stl_triangle_soa* soa,
+        float* arrays[GMIO_STL_TRIANGLE_COORD_COUNT])
+{
+    const struct gmio_stl_coords_soa* coords[4];
+    unsigned i;
+    coords[0] = &soa->n;
+    coords[1] = &soa->v1;
+    coords[2] = &soa->v2;
+    coords[3] = &soa->v3;
+    for (i = 0; i < 4; ++i) {
+        arrays[3*i] = coords[i]->x;
+        arrays[3*i + 1] = coords[i]->y;
+        arrays[3*i + 2] = coords[i]->z;
+    }
+}
+
+#if defined(GMIO_HAVE_SSE2)
+static void gmio_stl_records_to_soa_x4(
+        const uint8_t* records, size_t stride, float** arrays, uint32_t id)
+{
+    unsigned iblock;
+    for (iblock = 0; iblock < 3; ++iblock) {
+        const uint8_t* block = records + iblock * 4 * sizeof(float);
+        __m128 c0 = _mm_loadu_ps((const float*)block);
+        __m128 c1 = _mm_loadu_ps((const float*)(block + stride));
+        __m128 c2 = _mm_loadu_ps((const float*)(block + 2 * stride));
+        __m128 c3 = _mm_loadu_ps((const float*)(block + 3 * stride));
+        float** block_arrays = arrays + iblock * 4;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        if (block_arrays[0] != NULL)
+            _mm_storeu_ps(block_arrays[0] + id, c0);
+        if (block_arrays[1] != NULL)
+            _mm_storeu_ps(block_arrays[1] + id, c1);
+        if (block_arrays[2] != NULL)
+            _mm_storeu_ps(block_arrays[2] + id, c2);
+        if (block_arrays[3] != NULL)
+            _mm_storeu_ps(block_arrays[3] + id, c3);
+    }
+}
+
+GMIO_INLINE __m128 gmio_mm_loadu_ps_or_zero(const float* ptr)
+{
+    return ptr != NULL ? _mm_loadu_ps(ptr) : _mm_setzero_ps();
+}
+
+static void gmio_stl_soa_to_records_x4(
+        float* const* arrays, uint32_t id, uint8_t* records, size_t stride)
+{
+    unsigned iblock;
+    for (iblock = 0; iblock < 3; ++iblock) {
+        float* const* block_arrays = arrays + iblock * 4;
+        uint8_t* block = records + iblock * 4 * sizeof(float);
+        __m128 c0 = gmio_mm_loadu_ps_or_zero(
+                    block_arrays[0] != NULL ? block_arrays[0] + id : NULL);
+        __m128 c1 = gmio_mm_loadu_ps_or_zero(
+                    block_arrays[1] != NULL ? block_arrays[1] + id : NULL);
+        __m128 c2 = gmio_mm_loadu_ps_or_zero(
+                    block_arrays[2] != NULL ? block_arrays[2] + id : NULL);
+        __m128 c3 = gmio_mm_loadu_ps_or_zero(
+                    block_arrays[3] != NULL ? block_arrays[3] + id : NULL);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps((float*)block, c0);
+        _mm_storeu_ps((float*)(block + stride), c1);
+        _mm_storeu_ps((float*)(block + 2 * stride), c2);
+        _mm_storeu_ps((float*)(block + 3 * stride), c3);
+    }
+}
+#elif defined(GMIO_HAVE_NEON)
+GMIO_INLINE void gmio_neon_transpose4(float32x4_t c[4])
+{
+    const float32x4x2_t t01 = vtrnq_f32(c[0], c[1]);
+    const float32x4x2_t t23 = vtrnq_f32(c[2], c[3]);
+    c[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    c[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    c[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    c[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+static void gmio_stl_records_to_soa_x4(
+        const uint8_t* records, size_t stride, float** arrays, uint32_t id)
+{
+    unsigned iblock;
+    unsigned i;
+    for (iblock = 0; iblock < 3; ++iblock) {
+        const uint8_t* block = records + iblock * 4 * sizeof(float);
+        float** block_arrays = arrays + iblock * 4;
+        float32x4_t c[4];
+        for (i = 0; i < 4; ++i)
+            c[i] = vreinterpretq_f32_u8(vld1q_u8(block + i * stride));
+        gmio_neon_transpose4(c);
+        for (i = 0; i < 4; ++i) {
+            if (block_arrays[i] != NULL)
+                vst1q_f32(block_arrays[i] + id, c[i]);
+        }
+    }
+}
+
+static void gmio_stl_soa_to_records_x4(
+        float* const* arrays, uint32_t id, uint8_t* records, size_t stride)
+{
+    unsigned iblock;
+    unsigned i;
+    for (iblock = 0; iblock < 3; ++iblock) {
+        float* const* block_arrays = arrays + iblock * 4;
+        uint8_t* block = records + iblock * 4 * sizeof(float);
+        float32x4_t c[4];
+        for (i = 0; i < 4; ++i) {
+            c[i] = block_arrays[i] != NULL ?
+                        vld1q_f32(block_arrays[i] + id) :
+                        vdupq_n_f32(0.f);
+        }
+        gmio_neon_transpose4(c);
+        for (i = 0; i < 4; ++i)
+            vst1q_u8(block + i * stride, vreinterpretq_u8_f32(c[i]));
+    }
+}
+#endif
+
+void gmio_stl_triangle_soa_add_records(
+        struct gmio_stl_triangle_soa* soa,
+        uint32_t first_tri_id,
+        const uint8_t* records,
+        size_t stride,
+        uint32_t count)
+{
+    const uint32_t end_tri_id =
+            first_tri_id < soa->capacity ?
+                first_tri_id + GMIO_MIN(count, soa->capacity - first_tri_id) :
+                0;
+    float* arrays[GMIO_STL_TRIANGLE_COORD_COUNT];
+    uint32_t id = first_tri_id;
+
+    if (end_tri_id == 0)
+        return; /* Nothing to store */
+    gmio_stl_triangle_soa_arrays(soa, arrays);
+#if defined(GMIO_HAVE_SSE2) || defined(GMIO_HAVE_NEON)
+    for (; id + 4 <= end_tri_id; id += 4) {
+        gmio_stl_records_to_soa_x4(records, stride, arrays, id);
+        records += 4 * stride;
+    }
+#endif
+    for (; id < end_tri_id; ++id) {
+        unsigned i;
+        for (i = 0; i < GMIO_STL_TRIANGLE_COORD_COUNT; ++i) {
+            if (arrays[i] != NULL)
+                memcpy(arrays[i] + id, records + i * sizeof(float), sizeof(float));
+        }
+        records += stride;
+    }
+    if (soa->attribute_byte_count != NULL) {
+        records -= (size_t)(end_tri_id - first_tri_id) * stride;
+        for (id = first_tri_id; id < end_tri_id; ++id) {
+            memcpy(soa->attribute_byte_count + id,
+                   records + GMIO_STL_TRIANGLE_COORD_COUNT * sizeof(float),
+                   sizeof(uint16_t));
+            records += stride;
+        }
+    }
+    /* Not written if already known(binary STL), so safe with several threads */
+    if (end_tri_id > soa->count)
+        soa->count = end_tri_id;
+}
+
+static void gmio_stl_mesh_creator_soa_begin_solid(
+        void* cookie, const struct gmio_stl_mesh_creator_infos* infos)
+{
+    struct gmio_stl_triangle_soa* soa = (struct gmio_stl_triangle_soa*)cookie;
+    soa->count = 0;
+    if (infos->format & GMIO_STL_FORMAT_TAG_BINARY)
+        soa->count = GMIO_MIN(infos->stlb_triangle_count, soa->capacity);
+}
+
+static void gmio_stl_mesh_creator_soa_add_triangles(
+        void* cookie,
+        uint32_t first_tri_id,
+        const struct gmio_stl_triangle* triangles,
+        uint32_t count)
+{
+    gmio_stl_triangle_soa_add_records(
+                (struct gmio_stl_triangle_soa*)cookie,
+                first_tri_id,
+                (const uint8_t*)triangles,
+                sizeof(struct gmio_stl_triangle),
+                count);
+}
+
+static void gmio_stl_mesh_creator_soa_add_triangle(
+        void* cookie, uint32_t tri_id, const struct gmio_stl_triangle* triangle)
+{
+    gmio_stl_mesh_creator_soa_add_triangles(cookie, tri_id, triangle, 1);
+}
+
+struct gmio_stl_mesh_creator gmio_stl_mesh_creator_soa(
+        struct gmio_stl_triangle_soa* soa)
+{
+    struct gmio_stl_mesh_creator creator = {0};
+    creator.cookie = soa;
+    creator.func_begin_solid = gmio_stl_mesh_creator_soa_begin_solid;
+    creator.func_add_triangle = gmio_stl_mesh_creator_soa_add_triangle;
+    creator.func_add_triangles = gmio_stl_mesh_creator_soa_add_triangles;
+    return creator;
+}
+
+bool gmio_stl_mesh_creator_is_soa(const struct gmio_stl_mesh_creator* creator)
+{
+    return creator != NULL
+            && creator->cookie != NULL
+            && creator->func_add_triangles
+               == gmio_stl_mesh_creator_soa_add_triangles;
+}
+
+static void gmio_stl_mesh_soa_get_triangles(
+        const void* cookie,
+        uint32_t first_tri_id,
+        uint32_t count,
+        struct gmio_stl_triangle* triangles)
+{
+    const struct gmio_stl_triangle_soa* soa =
+            (const struct gmio_stl_triangle_soa*)cookie;
+    const bool has_normals =
+            soa->n.x != NULL && soa->n.y != NULL && soa->n.z != NULL;
+    float* arrays[GMIO_STL_TRIANGLE_COORD_COUNT];
+    uint32_t i = 0;
+
+    gmio_stl_triangle_soa_arrays(soa, arrays);
+#if defined(GMIO_HAVE_SSE2) || defined(GMIO_HAVE_NEON)
+    for (; i + 4 <= count; i += 4) {
+        gmio_stl_soa_to_records_x4(
+                    arrays,
+                    first_tri_id + i,
+                    (uint8_t*)&triangles[i],
+                    sizeof(struct gmio_stl_triangle));
+    }
+#endif
+    for (; i < count; ++i) {
+        float* coords = &triangles[i].n.x;
+        unsigned j;
+        for (j = 0; j < GMIO_STL_TRIANGLE_COORD_COUNT; ++j)
+            coords[j] = arrays[j] != NULL ? arrays[j][first_tri_id + i] : 0.f;
+    }
+    for (i = 0; i < count; ++i) {
+        struct gmio_stl_triangle* tri = &triangles[i];
+        tri->attribute_byte_count =
+                soa->attribute_byte_count != NULL ?
+                    soa->attribute_byte_count[first_tri_id + i] :
+                    0;
+        if (!has_normals)
+            gmio_stl_triangle_compute_normal(tri);
+    }
+}
+
+static void gmio_stl_mesh_soa_get_triangle(
+        const void* cookie, uint32_t tri_id, struct gmio_stl_triangle* triangle)
+{
+    gmio_stl_mesh_soa_get_triangles(cookie, tri_id, 1, triangle);
+}
+
+struct gmio_stl_mesh gmio_stl_mesh_soa(const struct gmio_stl_triangle_soa* soa)
+{
+    struct gmio_stl_mesh mesh = {0};
+    mesh.cookie = soa;
+    mesh.triangle_count = soa != NULL ? soa->count : 0;
+    mesh.func_get_triangle = gmio_stl_mesh_soa_get_triangle;
+    mesh.func_get_triangles = gmio_stl_mesh_soa_get_triangles;
+    return mesh;
+}
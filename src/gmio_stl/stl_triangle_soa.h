@@ -0,0 +1,122 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+/*! \file stl_triangle_soa.h
+ *  STL triangles stored as a structure of arrays(SoA)
+ *
+ *  \addtogroup gmio_stl
+ *  @{
+ */
+
+#pragma once
+
+#include "stl_global.h"
+#include "stl_mesh.h"
+#include "stl_mesh_creator.h"
+
+/*! XYZ coords of a sequence of points, one array per coord */
+struct gmio_stl_coords_soa
+{
+    float* x;
+    float* y;
+    float* z;
+};
+
+/*! Sequence of STL triangles stored as a structure of arrays(SoA)
+ *
+ *  Coords of item \c i are <tt>v1.x[i]</tt>, <tt>v1.y[i]</tt>, ... This layout
+ *  is suitable for vectorized processing(each array can be loaded into SIMD
+ *  registers as is), unlike the array of gmio_stl_triangle objects(AoS) where
+ *  coords are interleaved.
+ *
+ *  All arrays are owned by the caller.
+ */
+struct gmio_stl_triangle_soa
+{
+    /*! Normals of the triangles, optional(set the three arrays to \c NULL to
+     *  ignore) */
+    struct gmio_stl_coords_soa n;
+
+    /*! First vertices of the triangles */
+    struct gmio_stl_coords_soa v1;
+
+    /*! Second vertices of the triangles */
+    struct gmio_stl_coords_soa v2;
+
+    /*! Third vertices of the triangles */
+    struct gmio_stl_coords_soa v3;
+
+    /*! "Attribute byte count" of the triangles, optional(can be \c NULL).
+     *  Meaningful only for binary STL */
+    uint16_t* attribute_byte_count;
+
+    /*! Count of items each array can hold */
+    uint32_t capacity;
+
+    /*! Count of triangles stored in the arrays */
+    uint32_t count;
+};
+
+GMIO_C_LINKAGE_BEGIN
+
+/*! Returns a mesh creator filling the arrays of \p soa
+ *
+ *  gmio_stl_triangle_soa::count is reset at the beginning of the solid, then
+ *  set to the count of triangles read. Triangles whose index is not less than
+ *  gmio_stl_triangle_soa::capacity are ignored : the count of triangles can be
+ *  known beforehand with gmio_stl_infos_probe().
+ *
+ *  gmio_stlb_read() detects this creator and transposes the facet records read
+ *  from the stream directly into the arrays(using SIMD shuffles when
+ *  available), with no intermediate gmio_stl_triangle objects nor per-triangle
+ *  callback.\n
+ *  The creator can be used with gmio_stl_read_options::thread_count greater
+ *  than \c 1.
+ *
+ *  \p soa must remain valid as long as the creator is used.
+ */
+GMIO_API struct gmio_stl_mesh_creator gmio_stl_mesh_creator_soa(
+        struct gmio_stl_triangle_soa* soa);
+
+/*! Returns a mesh reading its gmio_stl_triangle_soa::count triangles from the
+ *  arrays of \p soa, to be used with gmio_stl_write()
+ *
+ *  If gmio_stl_triangle_soa::n is not provided then normals are computed with
+ *  gmio_stl_triangle_compute_normal(). If
+ *  gmio_stl_triangle_soa::attribute_byte_count is \c NULL then attributes are
+ *  written as zero.
+ *
+ *  \p soa must remain valid as long as the mesh is used.
+ */
+GMIO_API struct gmio_stl_mesh gmio_stl_mesh_soa(
+        const struct gmio_stl_triangle_soa* soa);
+
+GMIO_C_LINKAGE_END
+
+/*! @} */
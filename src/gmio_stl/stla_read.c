@@ -44,8 +44,11 @@
 #include "../gmio_core/internal/helper_task_iface.h"
 #include "../gmio_core/internal/min_max.h"
 #include "../gmio_core/internal/safe_cast.h"
+#include "../gmio_core/internal/stream_mmap.h"
 #include "../gmio_core/internal/stringstream.h"
+#include "../gmio_core/internal/string_ascii_scan.h"
 #include "../gmio_core/internal/string_ascii_utils.h"
+#include "../gmio_core/internal/thread.h"
 
 #include <ctype.h>
 #include <stdlib.h>
@@ -125,6 +128,18 @@ static size_t gmio_stringstream_stla_read(
 /* Root function, parses a whole solid */
 static void parse_solid(struct gmio_stla_parse_data* data);
 
+/* Parses a whole solid from memory-mapped \p stream with several threads
+ *
+ * Returns false(and then does nothing) if \p stream is not memory-mapped or
+ * if resources could not be allocated, otherwise the result of parsing is
+ * stored in \p error */
+static bool gmio_stla_read_parallel(
+        struct gmio_stream* stream,
+        struct gmio_stl_mesh_creator* mesh_creator,
+        const struct gmio_stl_read_options* opts,
+        gmio_streamsize_t stream_size,
+        int* error);
+
 int gmio_stla_read(
         struct gmio_stream* stream,
         struct gmio_stl_mesh_creator* mesh_creator,
@@ -160,6 +175,17 @@ int gmio_stla_read(
                 gmio_stream_size(stream);
     parse_data.strstream_cookie.is_stop_requested = false;
 
+    if (opts->thread_count > 1
+            && gmio_stla_read_parallel(
+                stream,
+                mesh_creator,
+                opts,
+                parse_data.strstream_cookie.stream_size,
+                &error))
+    {
+        goto label_end;
+    }
+
     parse_data.strstream.stream = *stream;
     parse_data.strstream.strbuff.ptr = mblock->ptr;
     parse_data.strstream.strbuff.capacity = mblock->size;
@@ -435,6 +461,29 @@ int gmio_stla_eat_next_token(
     }
 }
 
+/* Returns true if \p word(of length \p word_len) matches \p keyword, which
+ * must be lowercase. Comparison is case-insensitive and done with whole-word
+ * integer compares rather than char by char */
+GMIO_INLINE bool stla_keyword_iequals(
+        const char* word, size_t word_len, const struct gmio_const_string* keyword)
+{
+    if (word_len != keyword->len)
+        return false;
+#ifdef GMIO_HAVE_INT64_TYPE
+    if (word_len <= sizeof(uint64_t)) {
+        /* Setting bit 0x20 lowers ASCII letters, and maps no other char to a
+         * letter. Padding bytes become 0x20 in both words */
+        const uint64_t lower_mask = (~(uint64_t)0 / 0xFF) * 0x20;
+        uint64_t word_bits = 0;
+        uint64_t keyword_bits = 0;
+        memcpy(&word_bits, word, word_len);
+        memcpy(&keyword_bits, keyword->ptr, word_len);
+        return (word_bits | lower_mask) == (keyword_bits | lower_mask);
+    }
+#endif
+    return gmio_ascii_strincmp(word, keyword->ptr, word_len) == 0;
+}
+
 int gmio_stla_eat_next_token_inplace(
         struct gmio_stla_parse_data* data,
         enum gmio_stla_token expected_token)
@@ -445,6 +494,24 @@ int gmio_stla_eat_next_token_inplace(
 
     data->token = unknown_token;
     const char* stream_char = gmio_stringstream_skip_ascii_spaces(sstream);
+
+    /* Fast path: whole word is available in the current strbuff */
+    if (stream_char != NULL) {
+        const char* word_end =
+                gmio_ascii_find_space(stream_char, sstream->strbuff_end);
+        if (word_end < sstream->strbuff_end
+                && stla_keyword_iequals(
+                    stream_char,
+                    word_end - stream_char,
+                    &stla_tokcstr[expected_token]))
+        {
+            sstream->strbuff_at = word_end;
+            data->token = expected_token;
+            return 0; /* Success */
+        }
+    }
+
+    /* Slow path: word spans two chunks, or error */
     while (!error) {
         if (stream_char == NULL || gmio_ascii_isspace(*stream_char)) {
             if (*expected_token_str == 0) {
@@ -664,17 +731,33 @@ void parse_facets(struct gmio_stla_parse_data* data)
 {
     const gmio_stl_mesh_creator_func_add_triangle_t func_add_triangle =
             data->creator->func_add_triangle;
+    const gmio_stl_mesh_creator_func_add_triangles_t func_add_triangles =
+            data->creator->func_add_triangles;
     void* creator_cookie = data->creator->cookie;
     struct gmio_string* token_str = &data->token_str;
     uint32_t i_facet = 0;
-    struct gmio_stl_triangle facet;
+    struct gmio_stl_triangle batch[GMIO_STLA_READ_TRIANGLE_BATCH_SIZE];
+    uint32_t batch_count = 0; /* Count of triangles pending in batch[] */
 
-    facet.attribute_byte_count = 0;
+    memset(batch, 0, sizeof(batch));
     while (data->token == FACET_token && stla_parsing_can_continue(data)) {
-        if (parse_facet(data, &facet) == 0) {
+        struct gmio_stl_triangle* facet = &batch[batch_count];
+        if (parse_facet(data, facet) == 0) {
             /* Add triangle to user mesh */
-            if (func_add_triangle != NULL)
-                func_add_triangle(creator_cookie, i_facet, &facet);
+            if (func_add_triangles != NULL) {
+                ++batch_count;
+                if (batch_count == GMIO_STLA_READ_TRIANGLE_BATCH_SIZE) {
+                    func_add_triangles(
+                                creator_cookie,
+                                i_facet + 1 - batch_count,
+                                batch,
+                                batch_count);
+                    batch_count = 0;
+                }
+            }
+            else if (func_add_triangle != NULL) {
+                func_add_triangle(creator_cookie, i_facet, facet);
+            }
             /* Eat next unknown token */
             token_str->len = 0;
             const enum gmio_eat_word_error eat_error =
@@ -692,6 +775,11 @@ void parse_facets(struct gmio_stla_parse_data* data)
             stla_error_msg(data, "Invalid facet");
         }
     }
+
+    /* Flush triangles still pending */
+    if (batch_count > 0)
+        func_add_triangles(
+                    creator_cookie, i_facet - batch_count, batch, batch_count);
 }
 
 void parse_solid(struct gmio_stla_parse_data* data)
@@ -700,3 +788,371 @@ void parse_solid(struct gmio_stla_parse_data* data)
     parse_facets(data);
     parse_endsolid(data);
 }
+
+/* --------------------------------------------------------------------------
+ * STLA parallel parsing
+ * -------------------------------------------------------------------------- */
+
+/* Minimum size(in bytes) of the contents parsed by one thread */
+enum { GMIO_STLA_READ_MIN_CHUNK_SIZE = 256 * 1024 };
+
+/* Count of facets parsed by a thread between two progress notifications */
+enum { GMIO_STLA_READ_PROGRESS_FACET_COUNT = 4096 };
+
+/* State shared by the threads of gmio_stla_read_parallel(). Members are
+ * accessed only with mutex locked */
+struct gmio_stla_read_parallel_context
+{
+    const struct gmio_task_iface* task;
+    struct gmio_mutex* mutex;
+    gmio_streamsize_t stream_size;
+    gmio_streamoffset_t parsed_size;
+    bool is_stop_requested;
+};
+
+/* Part of the facets of a solid, parsed by one thread
+ *
+ * Contents of a chunk starts with "facet normal" keywords. Triangles are kept
+ * in memory until they are handed over to the mesh creator */
+struct gmio_stla_read_chunk
+{
+    struct gmio_stla_read_parallel_context* context;
+    struct gmio_stla_parse_data parse_data;
+    char token_buffer[GMIO_STLA_READ_STRING_MAX_LEN];
+    struct gmio_stl_triangle* triangles;
+    size_t triangle_count;
+    size_t triangle_capacity;
+    int error; /* Error other than parsing, ie. allocation failure */
+    struct gmio_thread* thread;
+};
+
+/* Callback used for gmio_stringstream::func_stream_read, when the whole
+ * contents is already in gmio_stringstream::strbuff */
+static size_t gmio_stringstream_memory_read(
+        void* cookie, struct gmio_stream* stream, char* ptr, size_t len)
+{
+    GMIO_UNUSED(cookie);
+    GMIO_UNUSED(stream);
+    GMIO_UNUSED(ptr);
+    GMIO_UNUSED(len);
+    return 0;
+}
+
+/* Initializes \p data so it parses in-place contents [begin, end) */
+static void stla_parse_data_init_memory(
+        struct gmio_stla_parse_data* data,
+        const char* begin,
+        const char* end,
+        char* token_buffer,
+        struct gmio_stl_mesh_creator* mesh_creator)
+{
+    data->token = unknown_token;
+    data->token_str =
+            gmio_string(token_buffer, 0, GMIO_STLA_READ_STRING_MAX_LEN);
+    data->error = false;
+    memset(&data->strstream_cookie, 0, sizeof(data->strstream_cookie));
+    data->strstream.stream = gmio_stream_null();
+    /* strbuff is never written since func_stream_read() reads nothing */
+    data->strstream.strbuff.ptr = (char*)begin;
+    data->strstream.strbuff.len = end - begin;
+    data->strstream.strbuff.capacity = end - begin;
+    data->strstream.strbuff_end = end;
+    data->strstream.strbuff_at = begin;
+    data->strstream.cookie = NULL;
+    data->strstream.func_stream_read = gmio_stringstream_memory_read;
+    data->creator = mesh_creator;
+}
+
+/* Returns the position of the first contents not parsed yet by \p data, that
+ * was initialized with stla_parse_data_init_memory() */
+static const char* stla_parse_data_memory_pos(
+        const struct gmio_stla_parse_data* data)
+{
+    const struct gmio_string* strbuff = &data->strstream.strbuff;
+    /* strbuff is empty once contents is exhausted */
+    return strbuff->len > 0 ?
+                data->strstream.strbuff_at :
+                strbuff->ptr + strbuff->capacity;
+}
+
+/* Returns the position of the first "facet normal" keywords found in
+ * [begin, end) after the word under \p begin, or \p end if there is none */
+static const char* stla_find_facet_boundary(const char* begin, const char* end)
+{
+    const char* it = gmio_ascii_find_space(begin, end);
+    while (it < end) {
+        const char* word = gmio_ascii_find_nonspace(it, end);
+        const char* word_end = gmio_ascii_find_space(word, end);
+        if (stla_keyword_iequals(
+                    word, word_end - word, &stla_tokcstr[FACET_token]))
+        {
+            const char* next = gmio_ascii_find_nonspace(word_end, end);
+            const char* next_end = gmio_ascii_find_space(next, end);
+            if (stla_keyword_iequals(
+                        next, next_end - next, &stla_tokcstr[NORMAL_token]))
+            {
+                return word;
+            }
+        }
+        it = word_end;
+    }
+    return end;
+}
+
+/* Accounts \p parsed_size bytes of contents in task progress, and polls stop
+ * request */
+static void stla_read_chunk_notify(
+        struct gmio_stla_read_chunk* chunk, size_t parsed_size)
+{
+    struct gmio_stla_read_parallel_context* ctx = chunk->context;
+    gmio_mutex_lock(ctx->mutex);
+    ctx->parsed_size += parsed_size;
+    if (!ctx->is_stop_requested)
+        ctx->is_stop_requested = gmio_task_iface_is_stop_requested(ctx->task);
+    gmio_task_iface_handle_progress(
+                ctx->task, ctx->parsed_size, ctx->stream_size);
+    chunk->parse_data.strstream_cookie.is_stop_requested =
+            ctx->is_stop_requested;
+    gmio_mutex_unlock(ctx->mutex);
+}
+
+/* Parses the facets of \p chunk until end of its contents, or until a token
+ * other than "facet" is found(which is left for parse_endsolid()) */
+static void stla_read_chunk_parse(struct gmio_stla_read_chunk* chunk)
+{
+    struct gmio_stla_parse_data* data = &chunk->parse_data;
+    struct gmio_stringstream* sstream = &data->strstream;
+    const char* notified_pos = sstream->strbuff_at;
+    unsigned notify_countdown = GMIO_STLA_READ_PROGRESS_FACET_COUNT;
+
+    while (stla_parsing_can_continue(data)
+           && gmio_stringstream_skip_ascii_spaces(sstream) != NULL)
+    {
+        struct gmio_stl_triangle* facet = NULL;
+        data->token_str.len = 0;
+        if (gmio_stringstream_eat_word(sstream, &data->token_str)
+                != GMIO_EAT_WORD_ERROR_OK)
+        {
+            stla_error_msg(
+                        data, "failure to get next word with gmio_eat_word()");
+            break;
+        }
+        data->token = stla_find_token_from_string(&data->token_str);
+        if (data->token != FACET_token)
+            break;
+
+        if (chunk->triangle_count == chunk->triangle_capacity) {
+            const size_t capacity =
+                    chunk->triangle_capacity > 0 ?
+                        2 * chunk->triangle_capacity :
+                        sstream->strbuff.capacity / 256 + 16;
+            void* triangles =
+                    realloc(chunk->triangles,
+                            capacity * sizeof(struct gmio_stl_triangle));
+            if (triangles == NULL) {
+                chunk->error = GMIO_ERROR_MEMORY_ALLOC;
+                break;
+            }
+            chunk->triangles = (struct gmio_stl_triangle*)triangles;
+            chunk->triangle_capacity = capacity;
+        }
+
+        facet = &chunk->triangles[chunk->triangle_count];
+        memset(facet, 0, sizeof(struct gmio_stl_triangle));
+        if (parse_facet(data, facet) != 0) {
+            stla_error_msg(data, "Invalid facet");
+            break;
+        }
+        ++chunk->triangle_count;
+
+        if (--notify_countdown == 0) {
+            const char* pos = stla_parse_data_memory_pos(data);
+            stla_read_chunk_notify(chunk, pos - notified_pos);
+            notified_pos = pos;
+            notify_countdown = GMIO_STLA_READ_PROGRESS_FACET_COUNT;
+        }
+    }
+    stla_read_chunk_notify(
+                chunk, stla_parse_data_memory_pos(data) - notified_pos);
+}
+
+/* Entry point of the threads created by gmio_stla_read_parallel() */
+static void stla_read_chunk_run(void* arg)
+{
+    stla_read_chunk_parse((struct gmio_stla_read_chunk*)arg);
+}
+
+/* Hands over the triangles of \p chunk to the mesh creator */
+static void stla_read_chunk_add_triangles(
+        const struct gmio_stla_read_chunk* chunk,
+        struct gmio_stl_mesh_creator* creator,
+        uint32_t first_tri_id)
+{
+    const uint32_t count = (uint32_t)chunk->triangle_count;
+    if (count == 0)
+        return;
+    if (creator->func_add_triangles != NULL) {
+        creator->func_add_triangles(
+                    creator->cookie, first_tri_id, chunk->triangles, count);
+    }
+    else if (creator->func_add_triangle != NULL) {
+        uint32_t i;
+        for (i = 0; i < count; ++i) {
+            creator->func_add_triangle(
+                        creator->cookie, first_tri_id + i, &chunk->triangles[i]);
+        }
+    }
+}
+
+bool gmio_stla_read_parallel(
+        struct gmio_stream* stream,
+        struct gmio_stl_mesh_creator* mesh_creator,
+        const struct gmio_stl_read_options* opts,
+        gmio_streamsize_t stream_size,
+        int* error)
+{
+    struct gmio_stla_read_parallel_context ctx = {0};
+    struct gmio_stla_read_chunk* chunks = NULL;
+    size_t chunk_count = 0;
+    size_t i_chunk;
+    char header_token_buffer[GMIO_STLA_READ_STRING_MAX_LEN];
+    struct gmio_stla_parse_data header;
+    /* Parse data where "endsolid" is expected, NULL until found */
+    struct gmio_stla_parse_data* endsolid_data = NULL;
+    uint32_t i_facet = 0;
+    /* Same bound as gmio_stringstream_stla_read(), the solid may be followed
+     * by other ones in the mapping */
+    const size_t read_size = gmio_streamsize_to_size(stream_size + 1);
+    size_t contents_size = 0;
+    const char* contents = gmio_stream_mmap_current(stream, &contents_size);
+    const char* contents_end = NULL;
+
+    if (contents == NULL)
+        return false;
+    contents_size = GMIO_MIN(contents_size, read_size);
+    contents_end = contents + contents_size;
+    chunks = calloc(opts->thread_count, sizeof(struct gmio_stla_read_chunk));
+    if (chunks == NULL)
+        return false;
+
+    ctx.task = &opts->task_iface;
+    ctx.stream_size = stream_size;
+    *error = GMIO_ERROR_OK;
+
+    /* Parse "solid <name>" */
+    stla_parse_data_init_memory(
+                &header,
+                contents,
+                contents_end,
+                header_token_buffer,
+                mesh_creator);
+    header.strstream_cookie.stream_size = stream_size;
+    parse_beginsolid(&header);
+    if (header.error) {
+        *error = GMIO_STL_ERROR_PARSING;
+        goto label_end;
+    }
+
+    if (header.token == FACET_token) {
+        /* Split facets at "facet" keywords near evenly spaced offsets */
+        const char* body =
+                stla_parse_data_memory_pos(&header)
+                - stla_tokcstr[FACET_token].len;
+        const size_t body_size = contents_end - body;
+        const size_t max_chunk_count =
+                GMIO_MAX(1, GMIO_MIN(
+                             opts->thread_count,
+                             body_size / GMIO_STLA_READ_MIN_CHUNK_SIZE));
+        const char* chunk_begin = body;
+        ctx.parsed_size = body - contents;
+        while (chunk_count < max_chunk_count && chunk_begin < contents_end) {
+            struct gmio_stla_read_chunk* chunk = &chunks[chunk_count];
+            const char* target =
+                    body + (body_size / max_chunk_count) * (chunk_count + 1);
+            const char* chunk_end =
+                    chunk_count + 1 < max_chunk_count ?
+                        stla_find_facet_boundary(
+                            GMIO_MAX(target, chunk_begin), contents_end) :
+                        contents_end;
+            chunk->context = &ctx;
+            stla_parse_data_init_memory(
+                        &chunk->parse_data,
+                        chunk_begin,
+                        chunk_end,
+                        chunk->token_buffer,
+                        mesh_creator);
+            chunk_begin = chunk_end;
+            ++chunk_count;
+        }
+
+        /* Parse chunks concurrently, the calling thread takes the first one
+         * and any chunk whose thread could not be started */
+        if (chunk_count > 1)
+            ctx.mutex = gmio_mutex_create();
+        for (i_chunk = 1; ctx.mutex != NULL && i_chunk < chunk_count; ++i_chunk) {
+            chunks[i_chunk].thread =
+                    gmio_thread_create(stla_read_chunk_run, &chunks[i_chunk]);
+        }
+
+        /* Hand over triangles in order */
+        for (i_chunk = 0; i_chunk < chunk_count; ++i_chunk) {
+            struct gmio_stla_read_chunk* chunk = &chunks[i_chunk];
+            if (chunk->thread != NULL) {
+                gmio_thread_join(chunk->thread);
+                chunk->thread = NULL;
+            }
+            else if (endsolid_data == NULL) {
+                stla_read_chunk_parse(chunk);
+            }
+            if (endsolid_data != NULL)
+                continue; /* Solid already complete, or error */
+
+            stla_read_chunk_add_triangles(chunk, mesh_creator, i_facet);
+            i_facet += (uint32_t)chunk->triangle_count;
+            free(chunk->triangles);
+            chunk->triangles = NULL;
+
+            if (chunk->error != GMIO_ERROR_OK)
+                *error = chunk->error;
+            else if (chunk->parse_data.error)
+                *error = GMIO_STL_ERROR_PARSING;
+            else if (chunk->parse_data.strstream_cookie.is_stop_requested)
+                *error = GMIO_ERROR_TASK_STOPPED;
+            /* Token is still "endfacet" if the end of chunk was reached */
+            if (*error != GMIO_ERROR_OK
+                    || chunk->parse_data.token != ENDFACET_token
+                    || i_chunk + 1 == chunk_count)
+            {
+                endsolid_data = &chunk->parse_data;
+                /* Remaining threads can give up */
+                gmio_mutex_lock(ctx.mutex);
+                ctx.is_stop_requested = true;
+                gmio_mutex_unlock(ctx.mutex);
+            }
+        }
+    }
+    else {
+        endsolid_data = &header;
+    }
+
+    /* Parse "endsolid <name>" */
+    if (*error == GMIO_ERROR_OK) {
+        size_t parsed_size;
+        parse_endsolid(endsolid_data);
+        if (endsolid_data->error)
+            *error = GMIO_STL_ERROR_PARSING;
+        parsed_size = stla_parse_data_memory_pos(endsolid_data) - contents;
+        /* Consume the whole bound, as the buffered reading of
+         * gmio_stringstream_stla_read() does(eg. line feed after "endsolid",
+         * end-of-stream indicator when the bound goes past the mapping) */
+        gmio_stream_mmap_skip(stream, read_size);
+        gmio_task_iface_handle_progress(ctx.task, parsed_size, stream_size);
+    }
+
+label_end:
+    for (i_chunk = 0; i_chunk < chunk_count; ++i_chunk)
+        free(chunks[i_chunk].triangles);
+    free(chunks);
+    gmio_mutex_destroy(ctx.mutex);
+    return true;
+}
@@ -33,7 +33,9 @@
 #include "internal/helper_stl_mesh_creator.h"
 #include "internal/stl_funptr_typedefs.h"
 #include "internal/stl_error_check.h"
+#include "internal/stl_triangle_soa.h"
 #include "internal/stlb_byte_swap.h"
+#include "internal/stlb_triangle_array.h"
 
 #include "../gmio_core/endian.h"
 #include "../gmio_core/error.h"
@@ -45,7 +47,10 @@
 #include "../gmio_core/internal/helper_task_iface.h"
 #include "../gmio_core/internal/min_max.h"
 #include "../gmio_core/internal/safe_cast.h"
+#include "../gmio_core/internal/stream_skip.h"
+#include "../gmio_core/internal/thread.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 GMIO_INLINE void decode_facet(
@@ -57,13 +62,13 @@ GMIO_INLINE void decode_facet(
 
 typedef void (*func_gmio_stlb_decode_facets_t)(
         struct gmio_stl_mesh_creator*,
-        const uint8_t*,  /* buffer */
+        uint8_t*,        /* buffer */
         const uint32_t,  /* facet_count */
         const uint32_t); /* i_facet_offset */
 
 static void gmio_stlb_decode_facets(
         struct gmio_stl_mesh_creator* creator,
-        const uint8_t* buffer,
+        uint8_t* buffer,
         const uint32_t facet_count,
         const uint32_t i_facet_offset)
 {
@@ -84,24 +89,158 @@ static void gmio_stlb_decode_facets(
 
 static void gmio_stlb_decode_facets_byteswap(
         struct gmio_stl_mesh_creator* creator,
-        const uint8_t* buffer,
+        uint8_t* buffer,
         const uint32_t facet_count,
         const uint32_t i_facet_offset)
 {
-    const gmio_stl_mesh_creator_func_add_triangle_t func_add_triangle =
-            creator->func_add_triangle;
-    void* cookie = creator->cookie;
+    if (creator->func_add_triangle != NULL) {
+        gmio_stlb_facets_bswap(buffer, facet_count);
+        gmio_stlb_decode_facets(creator, buffer, facet_count, i_facet_offset);
+    }
+}
 
-    if (func_add_triangle != NULL) {
-        struct gmio_stl_triangle triangle;
-        uint32_t i_facet;
-        for (i_facet = 0; i_facet < facet_count; ++i_facet) {
-            decode_facet(buffer, &triangle);
-            buffer += GMIO_STLB_TRIANGLE_RAWSIZE;
-            gmio_stl_triangle_bswap(&triangle);
-            func_add_triangle(cookie, i_facet_offset + i_facet, &triangle);
+static void gmio_stlb_decode_facets_batch(
+        struct gmio_stl_mesh_creator* creator,
+        uint8_t* buffer,
+        const uint32_t facet_count,
+        const uint32_t i_facet_offset)
+{
+    const struct gmio_stl_triangle* triangles =
+            gmio_stlb_triangle_array_unpack(buffer, facet_count);
+    creator->func_add_triangles(
+                creator->cookie, i_facet_offset, triangles, facet_count);
+}
+
+static void gmio_stlb_decode_facets_batch_byteswap(
+        struct gmio_stl_mesh_creator* creator,
+        uint8_t* buffer,
+        const uint32_t facet_count,
+        const uint32_t i_facet_offset)
+{
+    gmio_stlb_facets_bswap(buffer, facet_count);
+    gmio_stlb_decode_facets_batch(
+                creator, buffer, facet_count, i_facet_offset);
+}
+
+/* Facet records are transposed directly into the arrays of the creator
+ * returned by gmio_stl_mesh_creator_soa() */
+static void gmio_stlb_decode_facets_soa(
+        struct gmio_stl_mesh_creator* creator,
+        uint8_t* buffer,
+        const uint32_t facet_count,
+        const uint32_t i_facet_offset)
+{
+    gmio_stl_triangle_soa_add_records(
+                (struct gmio_stl_triangle_soa*)creator->cookie,
+                i_facet_offset,
+                buffer,
+                GMIO_STLB_TRIANGLE_RAWSIZE,
+                facet_count);
+}
+
+static void gmio_stlb_decode_facets_soa_byteswap(
+        struct gmio_stl_mesh_creator* creator,
+        uint8_t* buffer,
+        const uint32_t facet_count,
+        const uint32_t i_facet_offset)
+{
+    gmio_stlb_facets_bswap(buffer, facet_count);
+    gmio_stlb_decode_facets_soa(creator, buffer, facet_count, i_facet_offset);
+}
+
+/* Shared state of the facet read loop, which can be run concurrently by
+ * several threads. Stream and task_iface are accessed only with mutex locked */
+struct gmio_stlb_read_context
+{
+    struct gmio_stream* stream;
+    struct gmio_stl_mesh_creator* creator;
+    const struct gmio_task_iface* task;
+    func_gmio_stlb_decode_facets_t func_decode_facets;
+    bool batch;
+    struct gmio_mutex* mutex;
+    uint32_t total_facet_count; /* Count of facets in the range to read */
+    uint32_t i_facet; /* Count of facets read from stream */
+    uint32_t decoded_facet_count; /* Count of facets given to creator */
+    bool stream_exhausted;
+    int error;
+};
+
+/* Worker thread of gmio_stlb_read(), holds its own memblock */
+struct gmio_stlb_read_worker
+{
+    struct gmio_stlb_read_context* context;
+    struct gmio_memblock memblock;
+    struct gmio_thread* thread;
+};
+
+/* Reads and decodes chunks of facets until end of stream or error */
+static void gmio_stlb_read_facets(
+        struct gmio_stlb_read_context* ctx, struct gmio_memblock* mblock)
+{
+    /* With batch, the memblock must be able to hold decoded triangles */
+    const uint32_t max_facet_count_per_read =
+            ctx->batch ?
+                gmio_size_to_uint32(
+                    gmio_stl_triangle_array_capacity(mblock->ptr, mblock->size)) :
+                gmio_size_to_uint32(mblock->size / GMIO_STLB_TRIANGLE_RAWSIZE);
+    uint32_t read_facet_count = 0;
+
+    do {
+        uint32_t i_facet = 0; /* Index of the first facet read */
+
+        /* Read next chunk of facets */
+        read_facet_count = 0;
+        gmio_mutex_lock(ctx->mutex);
+        if (gmio_no_error(ctx->error)
+                && !ctx->stream_exhausted
+                && ctx->i_facet < ctx->total_facet_count)
+        {
+            const uint32_t facet_count_to_read =
+                    GMIO_MIN(max_facet_count_per_read,
+                             ctx->total_facet_count - ctx->i_facet);
+            read_facet_count =
+                    gmio_size_to_uint32(
+                        gmio_stream_read(
+                            ctx->stream,
+                            mblock->ptr,
+                            GMIO_STLB_TRIANGLE_RAWSIZE,
+                            facet_count_to_read));
+            i_facet = ctx->i_facet;
+            ctx->i_facet += read_facet_count;
+            if (gmio_stream_error(ctx->stream) != 0) {
+                ctx->error = GMIO_ERROR_STREAM;
+                read_facet_count = 0;
+            }
+            else if (read_facet_count == 0) {
+                ctx->stream_exhausted = true; /* No more facet to read */
+            }
         }
-    }
+        gmio_mutex_unlock(ctx->mutex);
+
+        /* Decode the chunk, outside of the lock */
+        if (read_facet_count > 0) {
+            ctx->func_decode_facets(
+                        ctx->creator, mblock->ptr, read_facet_count, i_facet);
+            gmio_mutex_lock(ctx->mutex);
+            ctx->decoded_facet_count += read_facet_count;
+            if (gmio_no_error(ctx->error)
+                    && gmio_task_iface_is_stop_requested(ctx->task))
+            {
+                ctx->error = GMIO_ERROR_TASK_STOPPED;
+            }
+            gmio_task_iface_handle_progress(
+                        ctx->task,
+                        ctx->decoded_facet_count,
+                        ctx->total_facet_count);
+            gmio_mutex_unlock(ctx->mutex);
+        }
+    } while (read_facet_count > 0);
+}
+
+static void gmio_stlb_read_worker_run(void* arg)
+{
+    struct gmio_stlb_read_worker* worker = (struct gmio_stlb_read_worker*)arg;
+    gmio_stlb_read_facets(worker->context, &worker->memblock);
 }
 
 int gmio_stlb_read(
@@ -114,18 +253,22 @@ int gmio_stlb_read(
     struct gmio_memblock_helper mblock_helper =
             gmio_memblock_helper(opts != NULL ? &opts->stream_memblock : NULL);
     struct gmio_memblock* mblock = &mblock_helper.memblock;
-    const struct gmio_task_iface* task = opts != NULL ? &opts->task_iface : NULL;
     struct gmio_stlb_header header;
-    uint32_t i_facet = 0; /* Facet counter */
-    uint32_t total_facet_count = 0; /* Facet count, as declared in the stream */
+    struct gmio_stlb_read_context ctx = {0};
+    struct gmio_stlb_read_worker* workers = NULL;
+    unsigned worker_count = 0; /* Count of threads besides the calling one */
+    unsigned i_worker;
     int error = GMIO_ERROR_OK; /* Function result(error code) */
     /* Constants */
-    const func_gmio_stlb_decode_facets_t func_decode_facets =
-            byte_order != GMIO_ENDIANNESS_HOST ?
-                gmio_stlb_decode_facets_byteswap :
-                gmio_stlb_decode_facets;
-    const uint32_t max_facet_count_per_read =
-            gmio_size_to_uint32(mblock->size / GMIO_STLB_TRIANGLE_RAWSIZE);
+    const bool byteswap = byte_order != GMIO_ENDIANNESS_HOST;
+    const bool soa = gmio_stl_mesh_creator_is_soa(mesh_creator);
+    const bool batch =
+            !soa
+            && mesh_creator != NULL
+            && mesh_creator->func_add_triangles != NULL;
+    const unsigned thread_count = opts != NULL ? opts->thread_count : 0;
+    const uint32_t facet_first = opts != NULL ? opts->stlb_facet_first : 0;
+    const uint32_t facet_count = opts != NULL ? opts->stlb_facet_count : 0;
 
     /* Check validity of input parameters */
     if (!gmio_check_memblock_size(&error, mblock, GMIO_STLB_MIN_CONTENTS_SIZE))
@@ -144,9 +287,30 @@ int gmio_stlb_read(
         error = GMIO_STL_ERROR_FACET_COUNT;
         goto label_end;
     }
-    memcpy(&total_facet_count, mblock->ptr, sizeof(uint32_t));
+    memcpy(&ctx.total_facet_count, mblock->ptr, sizeof(uint32_t));
     if (byte_order != GMIO_ENDIANNESS_HOST)
-        total_facet_count = gmio_uint32_bswap(total_facet_count);
+        ctx.total_facet_count = gmio_uint32_bswap(ctx.total_facet_count);
+
+    /* Restrict to the requested range of facets */
+    if (facet_first > 0 || facet_count > 0) {
+        if (facet_first > ctx.total_facet_count) {
+            error = GMIO_STL_ERROR_FACET_COUNT;
+            goto label_end;
+        }
+        ctx.total_facet_count -= facet_first;
+        if (facet_count > 0)
+            ctx.total_facet_count = GMIO_MIN(facet_count, ctx.total_facet_count);
+        if (!gmio_stream_skip(
+                    stream,
+                    (gmio_streamoffset_t)facet_first * GMIO_STLB_TRIANGLE_RAWSIZE,
+                    mblock))
+        {
+            error = gmio_stream_error(stream) != 0 ?
+                        GMIO_ERROR_STREAM :
+                        GMIO_STL_ERROR_FACET_COUNT;
+            goto label_end;
+        }
+    }
 
     /* Callback to notify triangle count and header data */
     {
@@ -156,44 +320,64 @@ int gmio_stlb_read(
                     GMIO_STL_FORMAT_BINARY_LE :
                     GMIO_STL_FORMAT_BINARY_BE;
         infos.stlb_header = &header;
-        infos.stlb_triangle_count = total_facet_count;
+        infos.stlb_triangle_count = ctx.total_facet_count;
         gmio_stl_mesh_creator_begin_solid(mesh_creator, &infos);
     }
 
-    /* Read triangles */
-    gmio_task_iface_handle_progress(task, 0, total_facet_count);
-    while (gmio_no_error(error) && i_facet < total_facet_count) {
-        const uint32_t facet_count_to_read =
-                GMIO_MIN(max_facet_count_per_read,
-                         total_facet_count - i_facet);
-        const uint32_t read_facet_count =
-                gmio_size_to_uint32(
-                    gmio_stream_read(
-                        stream,
-                        mblock->ptr,
-                        GMIO_STLB_TRIANGLE_RAWSIZE,
-                        facet_count_to_read));
-
-        if (gmio_stream_error(stream) != 0)
-            error = GMIO_ERROR_STREAM;
-        else if (read_facet_count > 0)
-            error = GMIO_ERROR_OK;
-        else
-            break; /* Exit if no facet to read */
-
-        if (gmio_no_error(error)) {
-            func_decode_facets(
-                        mesh_creator, mblock->ptr, read_facet_count, i_facet);
-            i_facet += read_facet_count;
-            if (gmio_task_iface_is_stop_requested(task))
-                error = GMIO_ERROR_TASK_STOPPED;
+    ctx.stream = stream;
+    ctx.creator = mesh_creator;
+    ctx.task = opts != NULL ? &opts->task_iface : NULL;
+    ctx.batch = batch;
+    ctx.func_decode_facets =
+            soa ?
+                (byteswap ?
+                     gmio_stlb_decode_facets_soa_byteswap :
+                     gmio_stlb_decode_facets_soa) :
+            batch ?
+                (byteswap ?
+                     gmio_stlb_decode_facets_batch_byteswap :
+                     gmio_stlb_decode_facets_batch) :
+                (byteswap ?
+                     gmio_stlb_decode_facets_byteswap :
+                     gmio_stlb_decode_facets);
+    ctx.error = GMIO_ERROR_OK;
+
+    gmio_task_iface_handle_progress(ctx.task, 0, ctx.total_facet_count);
+
+    /* Start worker threads, each one with a memblock of the same size */
+    if (thread_count > 1 && ctx.total_facet_count > 0) {
+        ctx.mutex = gmio_mutex_create();
+        if (ctx.mutex != NULL)
+            workers = calloc(thread_count - 1, sizeof(*workers));
+        if (workers != NULL) {
+            while (worker_count < thread_count - 1) {
+                struct gmio_stlb_read_worker* worker = &workers[worker_count];
+                worker->context = &ctx;
+                worker->memblock = gmio_memblock_malloc(mblock->size);
+                if (worker->memblock.ptr == NULL)
+                    break;
+                worker->thread =
+                        gmio_thread_create(gmio_stlb_read_worker_run, worker);
+                if (worker->thread == NULL) {
+                    gmio_memblock_deallocate(&worker->memblock);
+                    break;
+                }
+                ++worker_count;
+            }
         }
-        gmio_task_iface_handle_progress(task, i_facet, total_facet_count);
-    } /* end while */
+    }
+
+    /* Read triangles, the calling thread takes part too */
+    gmio_stlb_read_facets(&ctx, mblock);
+    for (i_worker = 0; i_worker < worker_count; ++i_worker) {
+        gmio_thread_join(workers[i_worker].thread);
+        gmio_memblock_deallocate(&workers[i_worker].memblock);
+    }
+    error = ctx.error;
 
     if (gmio_no_error(error)) {
         gmio_stl_mesh_creator_end_solid(mesh_creator);
-        if (i_facet != total_facet_count) {
+        if (ctx.i_facet != ctx.total_facet_count) {
             error = GMIO_STL_ERROR_FACET_COUNT;
             goto label_end;
         }
@@ -210,6 +394,8 @@ int gmio_stlb_read(
     }
 
 label_end:
+    free(workers);
+    gmio_mutex_destroy(ctx.mutex);
     gmio_memblock_helper_release(&mblock_helper);
     return error;
 }
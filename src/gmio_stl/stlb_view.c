@@ -0,0 +1,122 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "stlb_view.h"
+
+#include "stl_error.h"
+#include "internal/stl_error_check.h"
+#include "internal/stlb_byte_swap.h"
+#include "internal/stlb_infos_probe.h"
+
+#include "../gmio_core/error.h"
+#include "../gmio_core/internal/byte_swap.h"
+
+#include <string.h>
+
+int gmio_stlb_view_init(
+        struct gmio_stlb_view* view,
+        const void* data,
+        size_t size,
+        enum gmio_endianness byte_order)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t facet_count = 0;
+    int error = GMIO_ERROR_OK;
+
+    memset(view, 0, sizeof(struct gmio_stlb_view));
+
+    /* Check validity of input parameters */
+    if (!gmio_stlb_check_byteorder(&error, byte_order))
+        return error;
+    if (bytes == NULL || size < GMIO_STLB_HEADER_SIZE)
+        return GMIO_STL_ERROR_HEADER_WRONG_SIZE;
+    if (size < GMIO_STLB_HEADER_SIZE + sizeof(uint32_t))
+        return GMIO_STL_ERROR_FACET_COUNT;
+
+    /* Check facet count against available contents */
+    memcpy(&facet_count, bytes + GMIO_STLB_HEADER_SIZE, sizeof(uint32_t));
+    if (byte_order != GMIO_ENDIANNESS_HOST)
+        facet_count = gmio_uint32_bswap(facet_count);
+    if ((uintmax_t)gmio_stlb_infos_size(facet_count) > size)
+        return GMIO_STL_ERROR_FACET_COUNT;
+
+    view->data = bytes;
+    view->size = (size_t)gmio_stlb_infos_size(facet_count);
+    view->byte_order = byte_order;
+    view->facet_count = facet_count;
+    return error;
+}
+
+const struct gmio_stlb_header* gmio_stlb_view_header(
+        const struct gmio_stlb_view* view)
+{
+    return (const struct gmio_stlb_header*)view->data;
+}
+
+const uint8_t* gmio_stlb_view_facet_data(
+        const struct gmio_stlb_view* view, uint32_t facet_id)
+{
+    return view->data
+            + GMIO_STLB_HEADER_SIZE
+            + sizeof(uint32_t)
+            + (size_t)facet_id * GMIO_STLB_TRIANGLE_RAWSIZE;
+}
+
+void gmio_stlb_view_get_triangle(
+        const struct gmio_stlb_view* view,
+        uint32_t facet_id,
+        struct gmio_stl_triangle* triangle)
+{
+    memcpy(triangle,
+           gmio_stlb_view_facet_data(view, facet_id),
+           GMIO_STLB_TRIANGLE_RAWSIZE);
+    if (view->byte_order != GMIO_ENDIANNESS_HOST)
+        gmio_stl_triangle_bswap(triangle);
+}
+
+struct gmio_stlb_view_iterator gmio_stlb_view_iterator(
+        const struct gmio_stlb_view* view)
+{
+    struct gmio_stlb_view_iterator it;
+    it.view = view;
+    it.facet_id = 0;
+    return it;
+}
+
+bool gmio_stlb_view_iterator_next(
+        struct gmio_stlb_view_iterator* it,
+        struct gmio_stl_triangle* triangle)
+{
+    if (it->facet_id < it->view->facet_count) {
+        gmio_stlb_view_get_triangle(it->view, it->facet_id, triangle);
+        ++it->facet_id;
+        return true;
+    }
+    return false;
+}
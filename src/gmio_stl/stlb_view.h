@@ -0,0 +1,155 @@
+/****************************************************************************
+** Copyright (c) 2017, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**     1. Redistributions of source code must retain the above copyright
+**        notice, this list of conditions and the following disclaimer.
+**
+**     2. Redistributions in binary form must reproduce the above
+**        copyright notice, this list of conditions and the following
+**        disclaimer in the documentation and/or other materials provided
+**        with the distribution.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+/*! \file stlb_view.h
+ *  Read-only view over STL binary contents held in memory
+ *
+ *  \addtogroup gmio_stl
+ *  @{
+ */
+
+#pragma once
+
+#include "stl_global.h"
+#include "stl_constants.h"
+#include "stl_triangle.h"
+#include "stlb_header.h"
+#include "../gmio_core/endian.h"
+
+#include <stddef.h>
+
+/*! Provides direct access to STL binary contents held in a contiguous buffer,
+ *  for example a memory-mapped file(see gmio_stream_mmap_data())
+ *
+ *  Unlike gmio_stlb_read(), facets are not decoded through a memblock nor
+ *  handed over to a gmio_stl_mesh_creator : they are accessed on demand
+ *  directly from the buffer. This is useful when only part of the mesh is
+ *  needed(bounding box, sampled facets, ...).
+ *
+ *  The view does not own the buffer, which must remain valid as long as the
+ *  view is used.
+ *
+ *  A gmio_stlb_view object must be initialised with gmio_stlb_view_init()
+ */
+struct gmio_stlb_view
+{
+    /*! Pointer on the beginning of STL binary contents(ie the header) */
+    const uint8_t* data;
+
+    /*! Size(in bytes) of the STL binary contents, as computed from
+     *  gmio_stlb_view::facet_count */
+    size_t size;
+
+    /*! Byte order of the STL binary contents */
+    enum gmio_endianness byte_order;
+
+    /*! Count of facets, as declared in the STL binary contents */
+    uint32_t facet_count;
+};
+
+/*! Forward iterator over the facets of a gmio_stlb_view
+ *
+ *  \sa gmio_stlb_view_iterator(), gmio_stlb_view_iterator_next()
+ */
+struct gmio_stlb_view_iterator
+{
+    /*! The view being iterated */
+    const struct gmio_stlb_view* view;
+
+    /*! Index of the next facet to be returned by
+     *  gmio_stlb_view_iterator_next() */
+    uint32_t facet_id;
+};
+
+GMIO_C_LINKAGE_BEGIN
+
+/*! Initialises \p view over the STL binary contents pointed to by \p data
+ *
+ *  The header and facet count are checked the same way as gmio_stlb_read(),
+ *  so the view is guaranteed to give access to gmio_stlb_view::facet_count
+ *  complete facets. \p size may be greater than the STL binary contents,
+ *  remaining bytes are ignored.
+ *
+ *  \pre <tt> view != NULL </tt>
+ *
+ *  \return Error code (see gmio_core/error.h and stl_error.h)
+ *  \retval GMIO_STL_ERROR_UNSUPPORTED_BYTE_ORDER if \p byte_order is unknown
+ *  \retval GMIO_STL_ERROR_HEADER_WRONG_SIZE if \p size is less than
+ *          \c GMIO_STLB_HEADER_SIZE
+ *  \retval GMIO_STL_ERROR_FACET_COUNT if the facet count is missing or if
+ *          \p size is too small for the declared facets
+ */
+GMIO_API int gmio_stlb_view_init(
+                struct gmio_stlb_view* view,
+                const void* data,
+                size_t size,
+                enum gmio_endianness byte_order);
+
+/*! Returns the header of the STL binary contents */
+GMIO_API const struct gmio_stlb_header* gmio_stlb_view_header(
+                const struct gmio_stlb_view* view);
+
+/*! Returns a pointer on the raw record(\c GMIO_STLB_TRIANGLE_RAWSIZE bytes)
+ *  of the facet at index \p facet_id
+ *
+ *  The record is in gmio_stlb_view::byte_order and is not necessarily aligned
+ *  for \c float access.
+ *
+ *  \pre <tt> facet_id < view->facet_count </tt>
+ */
+GMIO_API const uint8_t* gmio_stlb_view_facet_data(
+                const struct gmio_stlb_view* view, uint32_t facet_id);
+
+/*! Copies the facet at index \p facet_id into \p triangle, converted to host
+ *  byte order
+ *
+ *  \pre <tt> facet_id < view->facet_count </tt>
+ */
+GMIO_API void gmio_stlb_view_get_triangle(
+                const struct gmio_stlb_view* view,
+                uint32_t facet_id,
+                struct gmio_stl_triangle* triangle);
+
+/*! Returns an iterator positioned on the first facet of \p view */
+GMIO_API struct gmio_stlb_view_iterator gmio_stlb_view_iterator(
+                const struct gmio_stlb_view* view);
+
+/*! Copies the current facet of \p it into \p triangle and advances \p it to
+ *  the next facet
+ *
+ *  \return \c false if \p it is past the last facet(\p triangle is then left
+ *          untouched), \c true otherwise
+ */
+GMIO_API bool gmio_stlb_view_iterator_next(
+                struct gmio_stlb_view_iterator* it,
+                struct gmio_stl_triangle* triangle);
+
+GMIO_C_LINKAGE_END
+
+/*! @} */
@@ -130,6 +130,7 @@ void gmio_stl_mesh_occshape::init_C_members()
 {
     this->cookie = this;
     this->func_get_triangle = &gmio_stl_mesh_occshape::get_triangle;
+    this->func_get_triangles = NULL;
     this->triangle_count = 0;
 }
 
@@ -59,6 +59,7 @@ void gmio_stl_mesh_occmesh::init()
     // C members
     this->cookie = this;
     this->func_get_triangle = &gmio_stl_mesh_occmesh::get_triangle;
+    this->func_get_triangles = NULL;
     this->triangle_count = 0;
     // Count triangles
     const int domain_count = !m_mesh.IsNull() ? m_mesh->NbDomains() : 0;
@@ -162,6 +163,7 @@ void gmio_stl_mesh_creator_occmesh::init()
     this->cookie = this;
     this->func_begin_solid = &gmio_stl_mesh_creator_occmesh::begin_solid;
     this->func_add_triangle = &gmio_stl_mesh_creator_occmesh::add_triangle;
+    this->func_add_triangles = NULL;
     this->func_end_solid = NULL;
 }
 
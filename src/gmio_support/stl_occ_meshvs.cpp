@@ -53,6 +53,7 @@ void gmio_stl_mesh_occmeshvs::init()
     // C members
     this->cookie = this;
     this->func_get_triangle = &gmio_stl_mesh_occmeshvs::get_triangle;
+    this->func_get_triangles = NULL;
     this->triangle_count =
             !m_data_src.IsNull() ? m_data_src->GetAllElements().Extent() : 0;
     // Cache
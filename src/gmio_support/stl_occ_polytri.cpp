@@ -57,6 +57,7 @@ void gmio_stl_mesh_occpolytri::init()
     // C members
     this->cookie = this;
     this->func_get_triangle = &gmio_stl_mesh_occpolytri::get_triangle;
+    this->func_get_triangles = NULL;
     this->triangle_count = polytri_not_null ? m_polytri->NbTriangles() : 0;
     // Cache
     m_polytri_vec_node = polytri_not_null ? &m_polytri->Nodes() : NULL;
@@ -107,6 +108,7 @@ gmio_stl_mesh_creator_occpolytri::gmio_stl_mesh_creator_occpolytri()
     this->cookie = this;
     this->func_begin_solid = &gmio_stl_mesh_creator_occpolytri::begin_solid;
     this->func_add_triangle = &gmio_stl_mesh_creator_occpolytri::add_triangle;
+    this->func_add_triangles = NULL;
     this->func_end_solid = &gmio_stl_mesh_creator_occpolytri::end_solid;
 }
 
@@ -51,7 +51,14 @@ void all_tests()
     UTEST_RUN(test_amf_write_doc_1_zip);
     UTEST_RUN(test_amf_write_doc_1_zip64);
     UTEST_RUN(test_amf_write_doc_1_zip64_file);
+    UTEST_RUN(test_amf_write_doc_1_file_writebehind);
     UTEST_RUN(test_amf_write_doc_1_task_iface);
+    UTEST_RUN(test_amf_read_doc_1);
+    UTEST_RUN(test_amf_read_xml);
+    UTEST_RUN(test_amf_write_zip_thread_count);
+    UTEST_RUN(test_amf_write_format_thread_count);
+    UTEST_RUN(test_amf_write_bulk_callbacks);
+    UTEST_RUN(test_amf_write_bulk_callbacks_null);
 
     gmio_memblock_deallocate(&g_testamf_memblock);
 }
@@ -53,6 +53,8 @@ void all_tests()
     UTEST_RUN(test_internal__byte_codec);
     UTEST_RUN(test_internal__const_string);
     UTEST_RUN(test_internal__fast_atof);
+    UTEST_RUN(test_internal__eisel_lemire);
+    UTEST_RUN(test_internal__float2str_ryu);
     UTEST_RUN(test_internal__locale_utils);
     UTEST_RUN(test_internal__error_check);
     UTEST_RUN(test_internal__itoa);
@@ -60,6 +62,7 @@ void all_tests()
     UTEST_RUN(test_internal__safe_cast);
     UTEST_RUN(test_internal__stringstream);
     UTEST_RUN(test_internal__string_ascii_utils);
+    UTEST_RUN(test_internal__string_ascii_scan);
     UTEST_RUN(test_internal__benchmark_gmio_fast_atof);
     UTEST_RUN(test_internal__zip_utils);
     UTEST_RUN(test_internal__zlib_enumvalues);
@@ -57,16 +57,33 @@ void all_tests()
     UTEST_RUN(test_stl_triangle_compute_normal);
 
     UTEST_RUN(test_stl_internal__error_check);
+    UTEST_RUN(test_stl_internal__byte_swap);
+    UTEST_RUN(test_stl_internal__scan_mask);
 
     UTEST_RUN(test_stl_infos);
     UTEST_RUN(test_stl_infos_github8);
+    UTEST_RUN(test_stla_infos_chunks);
+    UTEST_RUN(test_stl_infos_size_limit);
 
     UTEST_RUN(test_stl_read);
     UTEST_RUN(test_stl_read_multi_solid);
     UTEST_RUN(test_stla_lc_numeric);
     UTEST_RUN(test_stla_write);
     UTEST_RUN(test_stlb_read);
+    UTEST_RUN(test_stl_read_batch);
+    UTEST_RUN(test_stl_read_file_mmap);
+    UTEST_RUN(test_stl_read_file_readahead);
+    UTEST_RUN(test_stlb_view);
+    UTEST_RUN(test_stlb_read_multithread);
+    UTEST_RUN(test_stlb_read_range);
+    UTEST_RUN(test_stla_read_multithread);
+    UTEST_RUN(test_stl_read_indexed);
+    UTEST_RUN(test_stl_read_soa);
+    UTEST_RUN(test_stl_write_soa);
     UTEST_RUN(test_stlb_write);
+    UTEST_RUN(test_stl_write_batch);
+    UTEST_RUN(test_stl_write_multithread);
+    UTEST_RUN(test_stl_write_file_writebehind);
     UTEST_RUN(test_stlb_header_write);
 
     UTEST_RUN(test_stlb_header_str);
@@ -117,6 +117,17 @@ static void gmio_stl_data__add_triangle(
     data->tri_array.count = tri_id + 1;
 }
 
+static void gmio_stl_data__add_triangles(
+        void* cookie,
+        uint32_t first_tri_id,
+        const struct gmio_stl_triangle* triangles,
+        uint32_t count)
+{
+    uint32_t i;
+    for (i = 0; i < count; ++i)
+        gmio_stl_data__add_triangle(cookie, first_tri_id + i, &triangles[i]);
+}
+
 static void gmio_stl_data__get_triangle(
         const void* cookie, uint32_t tri_id, struct gmio_stl_triangle* triangle)
 {
@@ -124,6 +135,18 @@ static void gmio_stl_data__get_triangle(
     *triangle = data->tri_array.ptr[tri_id];
 }
 
+static void gmio_stl_data__get_triangles(
+        const void* cookie,
+        uint32_t first_tri_id,
+        uint32_t count,
+        struct gmio_stl_triangle* triangles)
+{
+    const struct gmio_stl_data* data = (const struct gmio_stl_data*)cookie;
+    memcpy(triangles,
+           &data->tri_array.ptr[first_tri_id],
+           count * sizeof(struct gmio_stl_triangle));
+}
+
 struct gmio_stl_mesh_creator gmio_stl_data_mesh_creator(struct gmio_stl_data *data)
 {
     struct gmio_stl_mesh_creator creator = {0};
@@ -133,6 +156,15 @@ struct gmio_stl_mesh_creator gmio_stl_data_mesh_creator(struct gmio_stl_data *da
     return creator;
 }
 
+struct gmio_stl_mesh_creator gmio_stl_data_mesh_creator_batch(
+        struct gmio_stl_data* data)
+{
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(data);
+    creator.func_add_triangle = NULL;
+    creator.func_add_triangles = &gmio_stl_data__add_triangles;
+    return creator;
+}
+
 struct gmio_stl_mesh gmio_stl_data_mesh(const struct gmio_stl_data *data)
 {
     struct gmio_stl_mesh mesh = {0};
@@ -142,6 +174,14 @@ struct gmio_stl_mesh gmio_stl_data_mesh(const struct gmio_stl_data *data)
     return mesh;
 }
 
+struct gmio_stl_mesh gmio_stl_data_mesh_batch(const struct gmio_stl_data* data)
+{
+    struct gmio_stl_mesh mesh = gmio_stl_data_mesh(data);
+    mesh.func_get_triangle = NULL;
+    mesh.func_get_triangles = &gmio_stl_data__get_triangles;
+    return mesh;
+}
+
 bool gmio_stl_triangle_equal(
         const struct gmio_stl_triangle *lhs,
         const struct gmio_stl_triangle *rhs,
@@ -161,3 +201,15 @@ void gmio_stl_nop_get_triangle(
     GMIO_UNUSED(tri_id);
     GMIO_UNUSED(triangle);
 }
+
+void gmio_stl_nop_get_triangles(
+        const void* cookie,
+        uint32_t first_tri_id,
+        uint32_t count,
+        struct gmio_stl_triangle* triangles)
+{
+    GMIO_UNUSED(cookie);
+    GMIO_UNUSED(first_tri_id);
+    GMIO_UNUSED(count);
+    GMIO_UNUSED(triangles);
+}
@@ -58,6 +58,13 @@ void gmio_stl_nop_add_triangle(
 void gmio_stl_nop_get_triangle(
         const void* cookie, uint32_t tri_id, struct gmio_stl_triangle* triangle);
 
+/*! Callback for gmio_stl_mesh::func_get_triangles that does nothing */
+void gmio_stl_nop_get_triangles(
+        const void* cookie,
+        uint32_t first_tri_id,
+        uint32_t count,
+        struct gmio_stl_triangle* triangles);
+
 /*! Holds an array of STL triangles */
 struct gmio_stl_triangle_array
 {
@@ -84,4 +91,13 @@ struct gmio_stl_data
 };
 
 struct gmio_stl_mesh_creator gmio_stl_data_mesh_creator(struct gmio_stl_data* data);
+
+/*! Same as gmio_stl_data_mesh_creator() but triangles are added with
+ *  gmio_stl_mesh_creator::func_add_triangles() */
+struct gmio_stl_mesh_creator gmio_stl_data_mesh_creator_batch(
+        struct gmio_stl_data* data);
 struct gmio_stl_mesh gmio_stl_data_mesh(const struct gmio_stl_data* data);
+
+/*! Same as gmio_stl_data_mesh() but triangles are retrieved with
+ *  gmio_stl_mesh::func_get_triangles() */
+struct gmio_stl_mesh gmio_stl_data_mesh_batch(const struct gmio_stl_data* data);
@@ -40,8 +40,10 @@
 #include "../src/gmio_amf/amf_error.h"
 #include "../src/gmio_amf/amf_io.h"
 
+#include <math.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <zlib.h>
 
@@ -191,6 +193,64 @@ static void __tamf__get_document_element_metadata(
     }
 }
 
+static bool __tamf__get_object_mesh_vertices(
+        const void* cookie,
+        const struct gmio_amf_object_mesh_element_index* mesh_index,
+        uint32_t first_vertex_index,
+        uint32_t count,
+        struct gmio_vec3d* coords)
+{
+    GMIO_UNUSED(mesh_index);
+    const struct __tamf__document* doc = (const struct __tamf__document*)cookie;
+    memcpy(coords,
+           doc->mesh.vec_vertex + first_vertex_index,
+           count * sizeof(struct gmio_vec3d));
+    return true;
+}
+
+static bool __tamf__get_object_mesh_volume_triangles(
+        const void* cookie,
+        const struct gmio_amf_object_mesh_element_index* volume_index,
+        uint32_t first_triangle_index,
+        uint32_t count,
+        uint32_t* vertex_ids)
+{
+    GMIO_UNUSED(volume_index);
+    const struct __tamf__document* doc = (const struct __tamf__document*)cookie;
+    memcpy(vertex_ids,
+           doc->mesh.vec_triangle + first_triangle_index,
+           count * sizeof(struct __tamf__triangle));
+    return true;
+}
+
+/* Same as __tamf__get_object_mesh_vertices() but every other batch of 256
+ * vertices is reported with attributes */
+static bool __tamf__get_object_mesh_vertices_attr(
+        const void* cookie,
+        const struct gmio_amf_object_mesh_element_index* mesh_index,
+        uint32_t first_vertex_index,
+        uint32_t count,
+        struct gmio_vec3d* coords)
+{
+    __tamf__get_object_mesh_vertices(
+                cookie, mesh_index, first_vertex_index, count, coords);
+    return (first_vertex_index / 256) % 2 != 0;
+}
+
+/* Same as __tamf__get_object_mesh_volume_triangles() but every other batch of
+ * 256 triangles is reported with attributes */
+static bool __tamf__get_object_mesh_volume_triangles_attr(
+        const void* cookie,
+        const struct gmio_amf_object_mesh_element_index* volume_index,
+        uint32_t first_triangle_index,
+        uint32_t count,
+        uint32_t* vertex_ids)
+{
+    __tamf__get_object_mesh_volume_triangles(
+                cookie, volume_index, first_triangle_index, count, vertex_ids);
+    return (first_triangle_index / 256) % 2 != 0;
+}
+
 static const char* test_amf_write_doc_null()
 {
     struct gmio_stream stream = {0};
@@ -300,7 +360,7 @@ static const char* test_amf_write_doc_1_plaintext()
     if (gmio_error(error))
         printf("\n0x%x\n", error);
 #endif
-    UTEST_COMPARE_INT(error, GMIO_ERROR_OK);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
     /* printf("%s\n", wbuff.ptr); */
     return NULL;
 }
@@ -323,7 +383,7 @@ static const char* test_amf_write_doc_1_zip()
         struct gmio_amf_write_options options = {0};
         options.float64_prec = 9;
         const int error = __tamf__write_amf(&wbuff, &doc, &options);
-        UTEST_COMPARE_INT(error, GMIO_ERROR_OK);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
     }
 
     const size_t amf_data_len = wbuff.pos;
@@ -341,7 +401,7 @@ static const char* test_amf_write_doc_1_zip()
         options.zip_entry_filename_len = zip_entry_filename_len;
         options.dont_use_zip64_extensions = true;
         const int error = __tamf__write_amf(&wbuff, &doc, &options);
-        UTEST_COMPARE_INT(error, GMIO_ERROR_OK);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
 #if 1
         FILE* file = fopen("output.zip", "wb");
         fwrite(wbuff.ptr, 1, wbuff.pos, file);
@@ -410,7 +470,7 @@ static const char* test_amf_write_doc_1_zip64()
         struct gmio_amf_write_options options = {0};
         options.float64_prec = 9;
         const int error = __tamf__write_amf(&wbuff, &doc, &options);
-        UTEST_COMPARE_INT(error, GMIO_ERROR_OK);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
     }
 
     const uintmax_t amf_data_len = wbuff.pos;
@@ -423,7 +483,7 @@ static const char* test_amf_write_doc_1_zip64()
         options.zip_entry_filename = zip_entry_filename;
         options.zip_entry_filename_len = zip_entry_filename_len;
         const int error = __tamf__write_amf(&wbuff, &doc, &options);
-        UTEST_COMPARE_INT(error, GMIO_ERROR_OK);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
 #if 1
         FILE* file = fopen("output_64.zip", "wb");
         fwrite(wbuff.ptr, 1, wbuff.pos, file);
@@ -475,7 +535,51 @@ static const char* test_amf_write_doc_1_zip64_file()
     options.float64_prec = 9;
     options.create_zip_archive = true;
     const int error = gmio_amf_write_file("output_64_file.zip", &doc, &options);
-    UTEST_COMPARE_INT(error, GMIO_ERROR_OK);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    return NULL;
+}
+
+/* Returns true if files at \p filepath1 and \p filepath2 have the same
+ * contents */
+static bool __tamf__file_contents_equal(
+        const char* filepath1, const char* filepath2)
+{
+    FILE* f1 = fopen(filepath1, "rb");
+    FILE* f2 = fopen(filepath2, "rb");
+    bool equal = f1 != NULL && f2 != NULL;
+    while (equal && !feof(f1) && !feof(f2)) {
+        uint8_t buff1[1024];
+        uint8_t buff2[1024];
+        const size_t len1 = fread(buff1, 1, sizeof(buff1), f1);
+        const size_t len2 = fread(buff2, 1, sizeof(buff2), f2);
+        equal = len1 == len2 && memcmp(buff1, buff2, len1) == 0;
+    }
+    if (f1 != NULL)
+        fclose(f1);
+    if (f2 != NULL)
+        fclose(f2);
+    return equal;
+}
+
+/* Checks gmio_amf_write_file() gives the same output with
+ * gmio_amf_write_options::use_file_writebehind */
+static const char* test_amf_write_doc_1_file_writebehind()
+{
+    const struct __tamf__document testdoc = __tamf__create_doc_1();
+    const struct gmio_amf_document doc = __tamf_create_doc(&testdoc);
+    struct gmio_amf_write_options options = {0};
+    options.float64_prec = 9;
+    int error = gmio_amf_write_file("output_file.amf", &doc, &options);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    options.use_file_writebehind = true;
+    error = gmio_amf_write_file("output_file_wb.amf", &doc, &options);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    UTEST_ASSERT(__tamf__file_contents_equal(
+                     "output_file.amf", "output_file_wb.amf"));
+    /* ZIP archive contains timestamps, just check writing succeeds */
+    options.create_zip_archive = true;
+    error = gmio_amf_write_file("output_file_wb.zip", &doc, &options);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
     return NULL;
 }
 
@@ -502,6 +606,15 @@ static void __tamf__handle_progress(
     task->max_value = max_value;
 }
 
+static intmax_t __tamf__get_total_element_count(const void* cookie)
+{
+    const struct __tamf__document* doc = (const struct __tamf__document*)cookie;
+    return (intmax_t)doc->material_count
+            + doc->mesh.vertex_count
+            + doc->mesh.triangle_count
+            + doc->instance_count;
+}
+
 static const char* test_amf_write_doc_1_task_iface()
 {
     static const size_t wbuffsize = 8192;
@@ -509,14 +622,15 @@ static const char* test_amf_write_doc_1_task_iface()
     wbuff.ptr = g_testamf_memblock.ptr;
     wbuff.len = wbuffsize;
     const struct __tamf__document testdoc = __tamf__create_doc_1();
-    const struct gmio_amf_document doc = __tamf_create_doc(&testdoc);
+    struct gmio_amf_document doc = __tamf_create_doc(&testdoc);
     struct gmio_amf_write_options options = {0};
     struct __tamf__task task = {0};
     options.task_iface.cookie = &task;
     options.task_iface.func_handle_progress = __tamf__handle_progress;
     {
+        wbuff.pos = 0;
         const int error = __tamf__write_amf(&wbuff, &doc, &options);
-        UTEST_COMPARE_INT(error, GMIO_ERROR_OK);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
         UTEST_ASSERT(!task.progress_error);
         UTEST_COMPARE_INT(task.current_value, task.max_value);
         printf("\ninfo: max_value=%d\n", (int)task.max_value);
@@ -527,10 +641,627 @@ static const char* test_amf_write_doc_1_task_iface()
     task.trigger_stop_value = task.max_value / 2;
     options.task_iface.func_is_stop_requested = __tamf__is_stop_requested;
     {
+        wbuff.pos = 0;
         const int error = __tamf__write_amf(&wbuff, &doc, &options);
-        UTEST_COMPARE_INT(error, GMIO_ERROR_TASK_STOPPED);
+        UTEST_COMPARE_INT(GMIO_ERROR_TASK_STOPPED, error);
         UTEST_ASSERT(task.current_value < task.max_value);
     }
 
+    /* Maximum value of the task progress given upfront */
+    const intmax_t total_element_count =
+            __tamf__get_total_element_count(&testdoc);
+    doc.func_get_total_element_count = __tamf__get_total_element_count;
+    options.task_iface.func_is_stop_requested = NULL;
+    task.current_value = 0;
+    task.max_value = 0;
+    task.progress_error = false;
+    {
+        wbuff.pos = 0;
+        const int error = __tamf__write_amf(&wbuff, &doc, &options);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_ASSERT(!task.progress_error);
+        UTEST_COMPARE_INT(task.max_value, total_element_count);
+        UTEST_COMPARE_INT(task.current_value, total_element_count);
+    }
+
+    return NULL;
+}
+
+static bool __tamf__f64_equals(double lhs, double rhs)
+{
+    return fabs(lhs - rhs) < 1e-12;
+}
+
+/* Checks AMF document read against __tamf__document */
+struct __tamf__read_checker {
+    const struct __tamf__document* expected;
+    enum gmio_amf_unit unit;
+    uint32_t object_count;
+    uint32_t material_count;
+    uint32_t material_metadata_count;
+    uint32_t vertex_count;
+    uint32_t volume_count;
+    uint32_t triangle_count;
+    uint32_t instance_count;
+    bool end_document;
+    bool mismatch;
+};
+
+static void __tamf__read_begin_document(void* cookie, enum gmio_amf_unit unit)
+{
+    struct __tamf__read_checker* checker = (struct __tamf__read_checker*)cookie;
+    checker->unit = unit;
+}
+
+static void __tamf__read_add_document_element(
+        void* cookie,
+        enum gmio_amf_document_element element,
+        uint32_t element_index,
+        const void* ptr_element)
+{
+    struct __tamf__read_checker* checker = (struct __tamf__read_checker*)cookie;
+    if (element == GMIO_AMF_DOCUMENT_ELEMENT_OBJECT) {
+        ++checker->object_count;
+    }
+    else if (element == GMIO_AMF_DOCUMENT_ELEMENT_MATERIAL) {
+        const struct gmio_amf_material* material =
+                (const struct gmio_amf_material*)ptr_element;
+        const struct __tamf__material* expected =
+                &checker->expected->vec_material[element_index];
+        checker->mismatch |=
+                element_index != checker->material_count
+                || material->id != element_index
+                || !__tamf__f64_equals(material->color.r, expected->color[0])
+                || !__tamf__f64_equals(material->color.g, expected->color[1])
+                || !__tamf__f64_equals(material->color.b, expected->color[2]);
+        ++checker->material_count;
+    }
+}
+
+static void __tamf__read_add_document_element_metadata(
+        void* cookie,
+        enum gmio_amf_document_element element,
+        uint32_t element_index,
+        uint32_t metadata_index,
+        const struct gmio_amf_metadata* metadata)
+{
+    struct __tamf__read_checker* checker = (struct __tamf__read_checker*)cookie;
+    checker->mismatch |=
+            element != GMIO_AMF_DOCUMENT_ELEMENT_MATERIAL
+            || metadata_index != 0
+            || strcmp(metadata->type, "name") != 0
+            || strcmp(metadata->data,
+                      checker->expected->vec_material[element_index].name) != 0;
+    ++checker->material_metadata_count;
+}
+
+static void __tamf__read_add_object_mesh_vertices(
+        void* cookie,
+        const struct gmio_amf_object_mesh_element_index* first_vertex_index,
+        const struct gmio_vec3d* coords,
+        uint32_t count)
+{
+    struct __tamf__read_checker* checker = (struct __tamf__read_checker*)cookie;
+    const struct __tamf__mesh* mesh = &checker->expected->mesh;
+    uint32_t i;
+    checker->mismatch |= first_vertex_index->value != checker->vertex_count;
+    for (i = 0; i < count; ++i) {
+        const struct gmio_vec3d* expected =
+                &mesh->vec_vertex[first_vertex_index->value + i];
+        checker->mismatch |=
+                !__tamf__f64_equals(coords[i].x, expected->x)
+                || !__tamf__f64_equals(coords[i].y, expected->y)
+                || !__tamf__f64_equals(coords[i].z, expected->z);
+    }
+    checker->vertex_count += count;
+}
+
+static void __tamf__read_add_object_mesh_volume(
+        void* cookie,
+        const struct gmio_amf_object_mesh_element_index* volume_index,
+        const struct gmio_amf_volume* volume)
+{
+    struct __tamf__read_checker* checker = (struct __tamf__read_checker*)cookie;
+    checker->mismatch |= volume_index->value != 0 || volume->materialid != 1;
+    ++checker->volume_count;
+}
+
+static void __tamf__read_add_object_mesh_volume_triangles(
+        void* cookie,
+        const struct gmio_amf_object_mesh_element_index* volume_index,
+        uint32_t first_triangle_index,
+        const uint32_t* vertex_ids,
+        uint32_t count)
+{
+    struct __tamf__read_checker* checker = (struct __tamf__read_checker*)cookie;
+    const struct __tamf__mesh* mesh = &checker->expected->mesh;
+    GMIO_UNUSED(volume_index);
+    checker->mismatch |= first_triangle_index != checker->triangle_count;
+    checker->mismatch |=
+            memcmp(vertex_ids,
+                   &mesh->vec_triangle[first_triangle_index],
+                   3 * count * sizeof(uint32_t)) != 0;
+    checker->triangle_count += count;
+}
+
+static void __tamf__read_add_constellation_instance(
+        void* cookie,
+        uint32_t constellation_index,
+        uint32_t instance_index,
+        const struct gmio_amf_instance* instance)
+{
+    struct __tamf__read_checker* checker = (struct __tamf__read_checker*)cookie;
+    const struct gmio_amf_instance* expected =
+            &checker->expected->vec_instance[instance_index];
+    checker->mismatch |=
+            constellation_index != 0
+            || instance->objectid != expected->objectid
+            || !__tamf__f64_equals(instance->delta.x, expected->delta.x)
+            || !__tamf__f64_equals(instance->delta.y, expected->delta.y)
+            || !__tamf__f64_equals(instance->delta.z, expected->delta.z)
+            || !__tamf__f64_equals(instance->rot.x, expected->rot.x)
+            || !__tamf__f64_equals(instance->rot.y, expected->rot.y)
+            || !__tamf__f64_equals(instance->rot.z, expected->rot.z);
+    ++checker->instance_count;
+}
+
+static void __tamf__read_end_document(void* cookie)
+{
+    struct __tamf__read_checker* checker = (struct __tamf__read_checker*)cookie;
+    checker->end_document = true;
+}
+
+static struct gmio_amf_document_creator __tamf__create_read_checker(
+        struct __tamf__read_checker* checker)
+{
+    struct gmio_amf_document_creator creator = {0};
+    creator.cookie = checker;
+    creator.func_begin_document = __tamf__read_begin_document;
+    creator.func_add_document_element = __tamf__read_add_document_element;
+    creator.func_add_document_element_metadata =
+            __tamf__read_add_document_element_metadata;
+    creator.func_add_object_mesh_vertices =
+            __tamf__read_add_object_mesh_vertices;
+    creator.func_add_object_mesh_volume = __tamf__read_add_object_mesh_volume;
+    creator.func_add_object_mesh_volume_triangles =
+            __tamf__read_add_object_mesh_volume_triangles;
+    creator.func_add_constellation_instance =
+            __tamf__read_add_constellation_instance;
+    creator.func_end_document = __tamf__read_end_document;
+    return creator;
+}
+
+/* Reads AMF contents of \p rbuff and checks it matches \p testdoc */
+static int __tamf__stream_get_pos_failure(
+        void* cookie, struct gmio_streampos* pos)
+{
+    GMIO_UNUSED(cookie);
+    GMIO_UNUSED(pos);
+    return -1;
+}
+
+static int __tamf__stream_set_pos_failure(
+        void* cookie, const struct gmio_streampos* pos)
+{
+    GMIO_UNUSED(cookie);
+    GMIO_UNUSED(pos);
+    return -1;
+}
+
+static const char* __tamf__check_read_doc(
+        struct gmio_rw_buffer* rbuff,
+        const struct __tamf__document* testdoc,
+        const struct gmio_amf_read_options* opts)
+{
+    struct __tamf__read_checker checker = {0};
+    const struct gmio_amf_document_creator creator =
+            __tamf__create_read_checker(&checker);
+    struct gmio_stream stream = gmio_stream_buffer(rbuff);
+    unsigned i;
+    for (i = 0; i < 2; ++i) {
+        if (i == 1) { /* Stream position cannot be restored(eg. pipe) */
+            stream.func_get_pos = __tamf__stream_get_pos_failure;
+            stream.func_set_pos = __tamf__stream_set_pos_failure;
+        }
+        memset(&checker, 0, sizeof(checker));
+        checker.expected = testdoc;
+        rbuff->pos = 0;
+        const int error = gmio_amf_read(&stream, &creator, opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_ASSERT(!checker.mismatch);
+        UTEST_ASSERT(checker.end_document);
+        UTEST_COMPARE_INT(GMIO_AMF_UNIT_MILLIMETER, checker.unit);
+        UTEST_COMPARE_UINT(checker.object_count, 1);
+        UTEST_COMPARE_UINT(checker.material_count, testdoc->material_count);
+        UTEST_COMPARE_UINT(checker.material_metadata_count, testdoc->material_count);
+        UTEST_COMPARE_UINT(checker.vertex_count, testdoc->mesh.vertex_count);
+        UTEST_COMPARE_UINT(checker.volume_count, 1);
+        UTEST_COMPARE_UINT(checker.triangle_count, testdoc->mesh.triangle_count);
+        UTEST_COMPARE_UINT(checker.instance_count, testdoc->instance_count);
+    }
+    return NULL;
+}
+
+static const char* test_amf_read_doc_1()
+{
+    static const size_t wbuffsize = 8192;
+    struct gmio_rw_buffer wbuff = {0};
+    wbuff.ptr = g_testamf_memblock.ptr;
+    wbuff.len = wbuffsize;
+
+    const struct __tamf__document testdoc = __tamf__create_doc_1();
+    const struct gmio_amf_document doc = __tamf_create_doc(&testdoc);
+    /* Small memblock so XML tokens straddle buffer refills */
+    uint8_t small_memblock[128] = {0};
+    struct gmio_amf_read_options small_opts = {0};
+    small_opts.stream_memblock =
+            gmio_memblock(small_memblock, sizeof(small_memblock), NULL);
+
+    struct gmio_amf_write_options options = {0};
+    options.float64_prec = 17;
+    options.zip_entry_filename = zip_entry_filename;
+    options.zip_entry_filename_len = zip_entry_filename_len;
+    {   /* Plain text */
+        const int error = __tamf__write_amf(&wbuff, &doc, &options);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        wbuff.len = wbuff.pos;
+        const char* error_msg = __tamf__check_read_doc(&wbuff, &testdoc, NULL);
+        if (error_msg == NULL)
+            error_msg = __tamf__check_read_doc(&wbuff, &testdoc, &small_opts);
+        if (error_msg != NULL)
+            return error_msg;
+    }
+    {   /* ZIP and Zip64 */
+        unsigned i;
+        for (i = 0; i < 2; ++i) {
+            wbuff.pos = 0;
+            wbuff.len = wbuffsize;
+            options.create_zip_archive = true;
+            options.dont_use_zip64_extensions = i == 0;
+            const int error = __tamf__write_amf(&wbuff, &doc, &options);
+            UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+            wbuff.len = wbuff.pos;
+            const char* error_msg = __tamf__check_read_doc(&wbuff, &testdoc, NULL);
+            if (error_msg == NULL)
+                error_msg = __tamf__check_read_doc(&wbuff, &testdoc, &small_opts);
+            if (error_msg != NULL)
+                return error_msg;
+        }
+    }
+
+    {   /* Corrupted ZIP entry */
+        ((uint8_t*)wbuff.ptr)[GMIO_ZIP_SIZE_LOCAL_FILE_HEADER + zip_entry_filename_len + 40] ^= 0xFF;
+        wbuff.pos = 0;
+        struct gmio_stream stream = gmio_stream_buffer(&wbuff);
+        const int error = gmio_amf_read(&stream, NULL, NULL);
+        UTEST_ASSERT(gmio_error(error));
+    }
+
+    return NULL;
+}
+
+static const char* test_amf_read_xml()
+{
+    static const char amf_valid[] =
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!DOCTYPE amf>\n"
+            "<amf unit=\"inch\" version=\"1.1\">\n"
+            "  <!-- comment with <tags> -->\n"
+            "  <metadata type=\"name\">A &amp; B <![CDATA[<C>]]></metadata>\n"
+            "  <object id='3'><color><r>1</r></color>\n"
+            "    <mesh><vertices><vertex><coordinates>"
+            "<x>1.5</x><y>-2</y><z>1e3</z>"
+            "</coordinates></vertex></vertices>\n"
+            "      <volume materialid=\"2\" type=\"support\"/>\n"
+            "    </mesh>\n"
+            "  </object>\n"
+            "</amf>\n";
+    static const char* amf_invalid[] = {
+        "<amf><object></amf>",
+        "<amf><object>",
+        "<amf><object><mesh><volume><triangle><v1>x</v1></triangle>"
+        "</volume></mesh></object></amf>",
+        "no xml"
+    };
+
+    struct gmio_ro_buffer rbuff = gmio_ro_buffer(amf_valid, sizeof(amf_valid) - 1, 0);
+    struct gmio_stream stream = gmio_istream_buffer(&rbuff);
+    struct __tamf__document testdoc = {0};
+    struct __tamf__read_checker checker = {0};
+    struct gmio_amf_document_creator creator = {0};
+    checker.expected = &testdoc;
+    creator.cookie = &checker;
+    creator.func_begin_document = __tamf__read_begin_document;
+    creator.func_add_document_element = __tamf__read_add_document_element;
+    creator.func_add_object_mesh_volume = __tamf__read_add_object_mesh_volume;
+    creator.func_end_document = __tamf__read_end_document;
+    int error = gmio_amf_read(&stream, &creator, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    UTEST_COMPARE_INT(GMIO_AMF_UNIT_INCH, checker.unit);
+    UTEST_COMPARE_UINT(checker.object_count, 1);
+    UTEST_COMPARE_UINT(checker.volume_count, 1);
+    UTEST_ASSERT(checker.mismatch); /* materialid=2 */
+    UTEST_ASSERT(checker.end_document);
+
+    size_t i;
+    for (i = 0; i < GMIO_ARRAY_SIZE(amf_invalid); ++i) {
+        rbuff = gmio_ro_buffer(amf_invalid[i], strlen(amf_invalid[i]), 0);
+        error = gmio_amf_read(&stream, NULL, NULL);
+        UTEST_COMPARE_INT(GMIO_AMF_ERROR_XML_SYNTAX, error);
+    }
+
+    return NULL;
+}
+
+/* Returns doc_1 with its mesh replaced by a grid of \p grid_size^2 vertices,
+ * mesh arrays have to be released with free() */
+static struct __tamf__document __tamf__create_doc_grid(uint32_t grid_size)
+{
+    const uint32_t vertex_count = grid_size * grid_size;
+    const uint32_t triangle_count = 2 * (grid_size - 1) * (grid_size - 1);
+    struct gmio_vec3d* vertices =
+            malloc(vertex_count * sizeof(struct gmio_vec3d));
+    struct __tamf__triangle* triangles =
+            malloc(triangle_count * sizeof(struct __tamf__triangle));
+    struct __tamf__document testdoc = __tamf__create_doc_1();
+    uint32_t i, j;
+    for (i = 0; vertices != NULL && i < grid_size; ++i) {
+        for (j = 0; j < grid_size; ++j) {
+            struct gmio_vec3d* v = &vertices[i * grid_size + j];
+            v->x = i * 0.5;
+            v->y = j * 0.25;
+            v->z = (i * j) % 7;
+        }
+    }
+    for (i = 0; triangles != NULL && i + 1 < grid_size; ++i) {
+        for (j = 0; j + 1 < grid_size; ++j) {
+            const uint32_t v = i * grid_size + j;
+            struct __tamf__triangle* tri =
+                    &triangles[2 * (i * (grid_size - 1) + j)];
+            tri[0].vertex[0] = v;
+            tri[0].vertex[1] = v + 1;
+            tri[0].vertex[2] = v + grid_size;
+            tri[1].vertex[0] = v + 1;
+            tri[1].vertex[1] = v + grid_size + 1;
+            tri[1].vertex[2] = v + grid_size;
+        }
+    }
+    testdoc.mesh.vec_vertex = vertices;
+    testdoc.mesh.vertex_count = vertex_count;
+    testdoc.mesh.vec_triangle = triangles;
+    testdoc.mesh.triangle_count = triangle_count;
+    return testdoc;
+}
+
+/* Checks ZIP output deflated with several threads reads back the same as
+ * with a single thread, the document being large enough for many blocks */
+static const char* test_amf_write_zip_thread_count()
+{
+    const struct __tamf__document testdoc = __tamf__create_doc_grid(200);
+    struct gmio_rw_buffer wbuff = {0};
+    const char* error_msg = NULL;
+    uint32_t i;
+
+    wbuff.len = 8 * 1024 * 1024;
+    wbuff.ptr = malloc(wbuff.len);
+    UTEST_ASSERT(testdoc.mesh.vec_vertex != NULL
+                 && testdoc.mesh.vec_triangle != NULL
+                 && wbuff.ptr != NULL);
+    const struct gmio_amf_document doc = __tamf_create_doc(&testdoc);
+    struct gmio_amf_write_options options = {0};
+    options.float64_prec = 17;
+    options.create_zip_archive = true;
+    options.zip_entry_filename = zip_entry_filename;
+    options.zip_entry_filename_len = zip_entry_filename_len;
+    {
+        const unsigned thread_counts[] = { 1, 2, 4 };
+        size_t zip_len[GMIO_ARRAY_SIZE(thread_counts)] = {0};
+        for (i = 0; i < GMIO_ARRAY_SIZE(thread_counts) && error_msg == NULL; ++i) {
+            const size_t wbuff_capacity = wbuff.len;
+            int error = GMIO_ERROR_OK;
+            wbuff.pos = 0;
+            options.thread_count = thread_counts[i];
+            error = __tamf__write_amf(&wbuff, &doc, &options);
+            if (error != GMIO_ERROR_OK) {
+                error_msg = "gmio_amf_write() with thread_count failed";
+                break;
+            }
+            zip_len[i] = wbuff.pos;
+            wbuff.len = wbuff.pos;
+            error_msg = __tamf__check_read_doc(&wbuff, &testdoc, NULL);
+            wbuff.len = wbuff_capacity;
+        }
+        if (error_msg == NULL) {
+            printf("\ninfo: zip_len=%u (1 thread)  %u (4 threads)\n",
+                   (unsigned)zip_len[0], (unsigned)zip_len[2]);
+        }
+    }
+
+    free((void*)testdoc.mesh.vec_vertex);
+    free((void*)testdoc.mesh.vec_triangle);
+    free(wbuff.ptr);
+    return error_msg;
+}
+
+/* Checks mesh elements formatted with several threads give the same output as
+ * with a single thread */
+static const char* test_amf_write_format_thread_count()
+{
+    const struct __tamf__document testdoc = __tamf__create_doc_grid(200);
+    const struct gmio_amf_document doc = __tamf_create_doc(&testdoc);
+    const size_t wbuff_capacity = 16 * 1024 * 1024;
+    struct gmio_rw_buffer wbuff1 = gmio_rw_buffer(malloc(wbuff_capacity), wbuff_capacity, 0);
+    struct gmio_rw_buffer wbuff4 = gmio_rw_buffer(malloc(wbuff_capacity), wbuff_capacity, 0);
+    struct gmio_amf_write_options options = {0};
+    const char* error_msg = NULL;
+    int error = GMIO_ERROR_OK;
+
+    UTEST_ASSERT(testdoc.mesh.vec_vertex != NULL
+                 && testdoc.mesh.vec_triangle != NULL
+                 && wbuff1.ptr != NULL
+                 && wbuff4.ptr != NULL);
+    options.float64_prec = 17;
+    error = __tamf__write_amf(&wbuff1, &doc, &options);
+    if (error == GMIO_ERROR_OK) {
+        options.format_thread_count = 4;
+        error = __tamf__write_amf(&wbuff4, &doc, &options);
+    }
+    if (error != GMIO_ERROR_OK) {
+        error_msg = "gmio_amf_write() with format_thread_count failed";
+    }
+    else if (wbuff1.pos != wbuff4.pos
+             || memcmp(wbuff1.ptr, wbuff4.ptr, wbuff1.pos) != 0)
+    {
+        error_msg = "output differs with format_thread_count";
+    }
+
+    /* Formatting and deflate threads combined */
+    if (error_msg == NULL) {
+        options.create_zip_archive = true;
+        options.thread_count = 4;
+        options.zip_entry_filename = zip_entry_filename;
+        options.zip_entry_filename_len = zip_entry_filename_len;
+        wbuff4.pos = 0;
+        error = __tamf__write_amf(&wbuff4, &doc, &options);
+        if (error != GMIO_ERROR_OK) {
+            error_msg = "gmio_amf_write() ZIP with format_thread_count failed";
+        }
+        else {
+            wbuff4.len = wbuff4.pos;
+            error_msg = __tamf__check_read_doc(&wbuff4, &testdoc, NULL);
+        }
+    }
+
+    free((void*)testdoc.mesh.vec_vertex);
+    free((void*)testdoc.mesh.vec_triangle);
+    free(wbuff1.ptr);
+    free(wbuff4.ptr);
+    return error_msg;
+}
+
+/* Same as __tamf__get_object_mesh_element() but vertices have a normal */
+static void __tamf__get_object_mesh_element_normal(
+        const void* cookie,
+        const struct gmio_amf_object_mesh_element_index* element_index,
+        void* ptr_element)
+{
+    __tamf__get_object_mesh_element(cookie, element_index, ptr_element);
+    if (element_index->element_type == GMIO_AMF_MESH_ELEMENT_VERTEX) {
+        struct gmio_amf_vertex* ptr_vertex = (struct gmio_amf_vertex*)ptr_element;
+        ptr_vertex->has_normal = true;
+        ptr_vertex->normal.z = 1.;
+    }
+}
+
+/* Same as __tamf__get_object_mesh_volume_triangle() but triangles have a
+ * color */
+static void __tamf__get_object_mesh_volume_triangle_color(
+        const void* cookie,
+        const struct gmio_amf_object_mesh_element_index* volume_index,
+        uint32_t triangle_index,
+        struct gmio_amf_triangle* ptr_triangle)
+{
+    __tamf__get_object_mesh_volume_triangle(
+                cookie, volume_index, triangle_index, ptr_triangle);
+    ptr_triangle->has_color = true;
+    ptr_triangle->color.r = 1.;
+}
+
+/* Checks bulk vertex/triangle callbacks give the same output as the
+ * per-element ones, batches reported with attributes or not */
+static const char* test_amf_write_bulk_callbacks()
+{
+    const struct __tamf__document testdoc = __tamf__create_doc_grid(200);
+    const struct gmio_amf_document doc = __tamf_create_doc(&testdoc);
+    struct gmio_amf_document bulk_doc = doc;
+    const size_t wbuff_capacity = 16 * 1024 * 1024;
+    struct gmio_rw_buffer wbuff = gmio_rw_buffer(malloc(wbuff_capacity), wbuff_capacity, 0);
+    struct gmio_rw_buffer wbuff_bulk = gmio_rw_buffer(malloc(wbuff_capacity), wbuff_capacity, 0);
+    struct gmio_amf_write_options options = {0};
+    const char* error_msg = NULL;
+    unsigned i;
+
+    UTEST_ASSERT(testdoc.mesh.vec_vertex != NULL
+                 && testdoc.mesh.vec_triangle != NULL
+                 && wbuff.ptr != NULL
+                 && wbuff_bulk.ptr != NULL);
+    bulk_doc.func_get_object_mesh_vertices = __tamf__get_object_mesh_vertices;
+    bulk_doc.func_get_object_mesh_volume_triangles =
+            __tamf__get_object_mesh_volume_triangles;
+    bulk_doc.func_get_object_mesh_volume_triangle = NULL;
+    options.float64_prec = 17;
+    for (i = 0; i < 4 && error_msg == NULL; ++i) {
+        int error = GMIO_ERROR_OK;
+        options.format_thread_count = i % 2 == 0 ? 1 : 4;
+        if (i == 2) {
+            /* Batches with attributes fall back to per-element callbacks */
+            bulk_doc.func_get_object_mesh_vertices =
+                    __tamf__get_object_mesh_vertices_attr;
+            bulk_doc.func_get_object_mesh_volume_triangles =
+                    __tamf__get_object_mesh_volume_triangles_attr;
+            bulk_doc.func_get_object_mesh_volume_triangle =
+                    doc.func_get_object_mesh_volume_triangle;
+        }
+        wbuff.pos = 0;
+        wbuff_bulk.pos = 0;
+        error = __tamf__write_amf(&wbuff, &doc, &options);
+        if (error == GMIO_ERROR_OK)
+            error = __tamf__write_amf(&wbuff_bulk, &bulk_doc, &options);
+        if (error != GMIO_ERROR_OK) {
+            error_msg = "gmio_amf_write() with bulk callbacks failed";
+        }
+        else if (wbuff.pos != wbuff_bulk.pos
+                 || memcmp(wbuff.ptr, wbuff_bulk.ptr, wbuff.pos) != 0)
+        {
+            error_msg = "output differs with bulk callbacks";
+        }
+    }
+
+    free((void*)testdoc.mesh.vec_vertex);
+    free((void*)testdoc.mesh.vec_triangle);
+    free(wbuff.ptr);
+    free(wbuff_bulk.ptr);
+    return error_msg;
+}
+
+static const char* test_amf_write_bulk_callbacks_null()
+{
+    static const size_t wbuffsize = 8192;
+    struct gmio_rw_buffer wbuff = {0};
+    wbuff.ptr = g_testamf_memblock.ptr;
+    wbuff.len = wbuffsize;
+    const struct __tamf__document testdoc = __tamf__create_doc_1();
+    struct gmio_amf_document doc = __tamf_create_doc(&testdoc);
+    struct gmio_amf_write_options options = {0};
+    doc.func_get_object_mesh_element = __tamf__get_object_mesh_element_normal;
+    doc.func_get_object_mesh_volume_triangle =
+            __tamf__get_object_mesh_volume_triangle_color;
+    {   /* No bulk callbacks : attributes of vertices and triangles written */
+        const int error = __tamf__write_amf(&wbuff, &doc, &options);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_ASSERT(wbuff.pos < wbuffsize);
+        ((char*)wbuff.ptr)[wbuff.pos] = '\0';
+        UTEST_ASSERT(strstr((const char*)wbuff.ptr, "<normal>") != NULL);
+        UTEST_ASSERT(strstr((const char*)wbuff.ptr, "<triangle><color>") != NULL);
+    }
+    {   /* Bulk callbacks reporting attributes : same output */
+        char* wbuff_ptr = (char*)wbuff.ptr + wbuffsize;
+        struct gmio_rw_buffer wbuff_bulk = gmio_rw_buffer(wbuff_ptr, wbuffsize, 0);
+        doc.func_get_object_mesh_vertices = __tamf__get_object_mesh_vertices_attr;
+        doc.func_get_object_mesh_volume_triangles =
+                __tamf__get_object_mesh_volume_triangles_attr;
+        const int error = __tamf__write_amf(&wbuff_bulk, &doc, &options);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(wbuff.pos, wbuff_bulk.pos);
+        UTEST_ASSERT(memcmp(wbuff.ptr, wbuff_bulk.ptr, wbuff.pos) == 0);
+    }
+    {   /* Bulk callbacks reporting attributes need the per-element one */
+        doc.func_get_object_mesh_volume_triangle = NULL;
+        wbuff.pos = 0;
+        const int error = __tamf__write_amf(&wbuff, &doc, &options);
+        UTEST_COMPARE_INT(
+                    GMIO_AMF_ERROR_NULL_FUNC_GET_OBJECT_MESH_VOLUME_TRIANGLE,
+                    error);
+    }
     return NULL;
 }
@@ -33,7 +33,9 @@
 #include "../src/gmio_core/endian.h"
 #include "../src/gmio_core/error.h"
 #include "../src/gmio_core/stream.h"
+#include "../src/gmio_core/internal/min_max.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -111,6 +113,30 @@ static const char* test_core__error()
     return NULL;
 }
 
+/* Sink stream accepting at most \p capacity bytes, for write error checks */
+struct __tc__limited_sink
+{
+    size_t len;
+    size_t capacity;
+};
+
+static size_t __tc__limited_sink_write(
+        void* cookie, const void* ptr, size_t size, size_t count)
+{
+    struct __tc__limited_sink* sink = (struct __tc__limited_sink*)cookie;
+    const size_t write_count =
+            GMIO_MIN(count, (sink->capacity - sink->len) / size);
+    GMIO_UNUSED(ptr);
+    sink->len += write_count * size;
+    return write_count;
+}
+
+static int __tc__limited_sink_error(void* cookie)
+{
+    GMIO_UNUSED(cookie);
+    return 0;
+}
+
 static const char* test_core__stream()
 {
     const struct gmio_stream null_stream = gmio_stream_null();
@@ -118,5 +144,243 @@ static const char* test_core__stream()
     UTEST_ASSERT(memcmp(&null_stream, &null_bytes, sizeof(struct gmio_stream))
                  == 0);
 
+    /* gmio_stream_mmap() */
+    {
+        static const char filepath[] = "temp/stream_mmap.bin";
+        uint8_t bytes[1000];
+        uint8_t read_bytes[1000] = {0};
+        struct gmio_stream stream;
+        struct gmio_streampos pos;
+        size_t i;
+        FILE* file = fopen(filepath, "wb");
+        UTEST_ASSERT(file != NULL);
+        for (i = 0; i < sizeof(bytes); ++i)
+            bytes[i] = (uint8_t)(i * 7);
+        fwrite(bytes, 1, sizeof(bytes), file);
+        fclose(file);
+
+        stream = gmio_stream_mmap(filepath);
+        if (stream.cookie != NULL) { /* Memory-mapping may be unsupported */
+            UTEST_ASSERT(gmio_stream_mmap_data(&stream) != NULL);
+            UTEST_ASSERT(stream.func_size(stream.cookie) == sizeof(bytes));
+            UTEST_ASSERT(stream.func_write == NULL);
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, 100)
+                         == 100);
+            UTEST_ASSERT(stream.func_get_pos(stream.cookie, &pos) == 0);
+            /* Item-wise read stops on the last complete item */
+            UTEST_ASSERT(stream.func_read(
+                             stream.cookie, read_bytes + 100, 300, 4)
+                         == 3);
+            UTEST_ASSERT(stream.func_at_end(stream.cookie));
+            UTEST_ASSERT(memcmp(bytes, read_bytes, 1000) == 0);
+            /* Rewind to previously saved position */
+            UTEST_ASSERT(stream.func_set_pos(stream.cookie, &pos) == 0);
+            UTEST_ASSERT(!stream.func_at_end(stream.cookie));
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, 900)
+                         == 900);
+            UTEST_ASSERT(memcmp(bytes + 100, read_bytes, 900) == 0);
+            UTEST_ASSERT(stream.func_error(stream.cookie) == 0);
+            gmio_stream_mmap_close(&stream);
+            UTEST_ASSERT(stream.cookie == NULL);
+        }
+
+        UTEST_ASSERT(gmio_stream_mmap("temp/does_not_exist").cookie == NULL);
+    }
+
+    /* gmio_stream_readahead() */
+    {
+        static const char filepath[] = "temp/stream_readahead.bin";
+        static uint8_t bytes[10000];
+        static uint8_t read_bytes[10000];
+        struct gmio_stream stream;
+        struct gmio_stream file_stream;
+        struct gmio_streampos pos_begin;
+        struct gmio_streampos pos;
+        size_t i;
+        FILE* file = fopen(filepath, "wb");
+        UTEST_ASSERT(file != NULL);
+        for (i = 0; i < sizeof(bytes); ++i)
+            bytes[i] = (uint8_t)(i * 7);
+        fwrite(bytes, 1, sizeof(bytes), file);
+        fclose(file);
+
+        file = fopen(filepath, "rb");
+        UTEST_ASSERT(file != NULL);
+        file_stream = gmio_stream_stdio(file);
+        /* Small buffers so the ring is recycled many times */
+        stream = gmio_stream_readahead(&file_stream, 300, 3);
+        if (stream.cookie != NULL) { /* Threads may be unsupported */
+            UTEST_ASSERT(stream.func_size(stream.cookie) == sizeof(bytes));
+            UTEST_ASSERT(stream.func_write == NULL);
+            UTEST_ASSERT(stream.func_get_pos(stream.cookie, &pos_begin) == 0);
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, 100)
+                         == 100);
+            UTEST_ASSERT(stream.func_get_pos(stream.cookie, &pos) == 0);
+            UTEST_ASSERT(stream.func_read(
+                             stream.cookie, read_bytes + 100, 1, 5000)
+                         == 5000);
+            UTEST_ASSERT(memcmp(bytes, read_bytes, 5100) == 0);
+            /* Rewind to a position no longer held in buffers */
+            UTEST_ASSERT(stream.func_set_pos(stream.cookie, &pos) == 0);
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, 1000)
+                         == 1000);
+            UTEST_ASSERT(memcmp(bytes + 100, read_bytes, 1000) == 0);
+            /* Rewind within the current buffer */
+            UTEST_ASSERT(stream.func_get_pos(stream.cookie, &pos) == 0);
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, 10)
+                         == 10);
+            UTEST_ASSERT(stream.func_set_pos(stream.cookie, &pos) == 0);
+            /* Item-wise read stops on the last complete item */
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1000, 9)
+                         == 8);
+            UTEST_ASSERT(memcmp(bytes + 1100, read_bytes, 8900) == 0);
+            UTEST_ASSERT(stream.func_at_end(stream.cookie));
+            UTEST_ASSERT(stream.func_error(stream.cookie) == 0);
+            /* Rewind to the beginning */
+            UTEST_ASSERT(stream.func_set_pos(stream.cookie, &pos_begin) == 0);
+            UTEST_ASSERT(!stream.func_at_end(stream.cookie));
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, 20000)
+                         == sizeof(bytes));
+            UTEST_ASSERT(memcmp(bytes, read_bytes, sizeof(bytes)) == 0);
+            UTEST_ASSERT(stream.func_at_end(stream.cookie));
+            gmio_stream_readahead_close(&stream);
+            UTEST_ASSERT(stream.cookie == NULL);
+        }
+        fclose(file);
+    }
+
+    /* gmio_stream_uring() */
+    {
+        static const char filepath[] = "temp/stream_uring.bin";
+        /* Larger than all the in-flight buffers, so they are recycled */
+        const size_t size = 3 * 1024 * 1024 + 123;
+        uint8_t* bytes = (uint8_t*)malloc(size);
+        uint8_t* read_bytes = (uint8_t*)malloc(size);
+        struct gmio_stream stream;
+        struct gmio_streampos pos_begin;
+        struct gmio_streampos pos;
+        size_t i;
+        FILE* file = fopen(filepath, "wb");
+        UTEST_ASSERT(file != NULL);
+        UTEST_ASSERT(bytes != NULL && read_bytes != NULL);
+        for (i = 0; i < size; ++i)
+            bytes[i] = (uint8_t)(i * 7 + i / 1000);
+        fwrite(bytes, 1, size, file);
+        fclose(file);
+
+        file = fopen(filepath, "rb");
+        UTEST_ASSERT(file != NULL);
+        stream = gmio_stream_uring(fileno(file));
+        if (stream.cookie != NULL) { /* io_uring may be unsupported */
+            UTEST_ASSERT((size_t)stream.func_size(stream.cookie) == size);
+            UTEST_ASSERT(stream.func_write == NULL);
+            UTEST_ASSERT(stream.func_get_pos(stream.cookie, &pos_begin) == 0);
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, 100)
+                         == 100);
+            UTEST_ASSERT(stream.func_get_pos(stream.cookie, &pos) == 0);
+            UTEST_ASSERT(stream.func_read(
+                             stream.cookie, read_bytes + 100, 1, 2000000)
+                         == 2000000);
+            UTEST_ASSERT(memcmp(bytes, read_bytes, 2000100) == 0);
+            /* Rewind to a position no longer held in buffers */
+            UTEST_ASSERT(stream.func_set_pos(stream.cookie, &pos) == 0);
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, 1000)
+                         == 1000);
+            UTEST_ASSERT(memcmp(bytes + 100, read_bytes, 1000) == 0);
+            /* Rewind within the current buffer */
+            UTEST_ASSERT(stream.func_get_pos(stream.cookie, &pos) == 0);
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, 10)
+                         == 10);
+            UTEST_ASSERT(stream.func_set_pos(stream.cookie, &pos) == 0);
+            /* Item-wise read stops on the last complete item */
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1000, 4000)
+                         == (size - 1100) / 1000);
+            UTEST_ASSERT(memcmp(bytes + 1100, read_bytes, size - 1100) == 0);
+            UTEST_ASSERT(stream.func_at_end(stream.cookie));
+            UTEST_ASSERT(stream.func_error(stream.cookie) == 0);
+            /* Rewind to the beginning */
+            UTEST_ASSERT(stream.func_set_pos(stream.cookie, &pos_begin) == 0);
+            UTEST_ASSERT(!stream.func_at_end(stream.cookie));
+            UTEST_ASSERT(stream.func_read(stream.cookie, read_bytes, 1, size + 1)
+                         == size);
+            UTEST_ASSERT(memcmp(bytes, read_bytes, size) == 0);
+            UTEST_ASSERT(stream.func_at_end(stream.cookie));
+            gmio_stream_uring_close(&stream);
+            UTEST_ASSERT(stream.cookie == NULL);
+        }
+        fclose(file);
+        free(bytes);
+        free(read_bytes);
+    }
+
+    /* gmio_stream_writebehind() */
+    {
+        static const char filepath[] = "temp/stream_writebehind.bin";
+        static uint8_t bytes[10000];
+        static uint8_t read_bytes[10000];
+        struct gmio_stream stream;
+        struct gmio_stream file_stream;
+        struct gmio_streampos pos;
+        bool written = false;
+        size_t i;
+        FILE* file = fopen(filepath, "wb");
+        UTEST_ASSERT(file != NULL);
+        for (i = 0; i < sizeof(bytes); ++i)
+            bytes[i] = (uint8_t)(i * 7);
+        file_stream = gmio_stream_stdio(file);
+        /* Small buffers so the ring is recycled many times */
+        stream = gmio_stream_writebehind(&file_stream, 300, 3);
+        if (stream.cookie != NULL) { /* Threads may be unsupported */
+            UTEST_ASSERT(stream.func_read == NULL);
+            for (i = 0; i < sizeof(bytes); i += 70) {
+                const size_t len = GMIO_MIN(70, sizeof(bytes) - i);
+                UTEST_ASSERT(stream.func_write(stream.cookie, bytes + i, 1, len)
+                             == len);
+            }
+            /* Get position waits for pending data to be written */
+            UTEST_ASSERT(stream.func_get_pos(stream.cookie, &pos) == 0);
+            UTEST_ASSERT((size_t)ftell(file) == sizeof(bytes));
+            UTEST_ASSERT(stream.func_error(stream.cookie) == 0);
+            UTEST_ASSERT(gmio_stream_writebehind_close(&stream) == 0);
+            UTEST_ASSERT(stream.cookie == NULL);
+            written = true;
+        }
+        fclose(file);
+        if (written) {
+            file = fopen(filepath, "rb");
+            UTEST_ASSERT(file != NULL);
+            UTEST_ASSERT(fread(read_bytes, 1, sizeof(read_bytes), file)
+                         == sizeof(bytes));
+            UTEST_ASSERT(memcmp(bytes, read_bytes, sizeof(bytes)) == 0);
+            fclose(file);
+        }
+    }
+
+    /* gmio_stream_writebehind() with write error */
+    {
+        static uint8_t bytes[1000] = {0};
+        struct __tc__limited_sink sink = {0};
+        struct gmio_stream sink_stream = gmio_stream_null();
+        struct gmio_stream stream;
+        sink.capacity = 500;
+        sink_stream.cookie = &sink;
+        sink_stream.func_write = __tc__limited_sink_write;
+        sink_stream.func_error = __tc__limited_sink_error;
+        stream = gmio_stream_writebehind(&sink_stream, 100, 2);
+        if (stream.cookie != NULL) {
+            size_t i;
+            size_t write_count = 0;
+            UTEST_ASSERT(stream.func_get_pos == NULL);
+            for (i = 0; i < 20; ++i)
+                write_count += stream.func_write(stream.cookie, bytes, 1, 100);
+            /* Error is reported by next writes */
+            UTEST_ASSERT(write_count < 2000);
+            UTEST_ASSERT(stream.func_error(stream.cookie) != 0);
+            UTEST_ASSERT(stream.func_write(stream.cookie, bytes, 1, 10) == 0);
+            UTEST_ASSERT(gmio_stream_writebehind_close(&stream) != 0);
+            UTEST_ASSERT(sink.len == 500);
+        }
+    }
+
     return NULL;
 }
@@ -31,6 +31,7 @@
 
 #include "../benchmarks/commons/benchmark_tools.h"
 #include "../src/gmio_core/internal/c99_stdio_compat.h"
+#include "../src/gmio_core/internal/eisel_lemire.h"
 #include "../src/gmio_core/internal/fast_atof.h"
 
 #include <stdio.h>
@@ -39,6 +40,9 @@
 
 static float __tc__float_array[1024] = {0};
 
+/* Text of __tc__float_array items, with "%f" and "%E" formats */
+static char __tc__float_str_array[2 * 1024][32] = {{0}};
+
 static void __tc__fill_float_array()
 {
     const float fmax = 1e6;
@@ -51,23 +55,20 @@ static void __tc__fill_float_array()
         const double drand = (double)rand();
         const double drand_max = (double)RAND_MAX;
         const double dmax = (double)fmax;
-        __tc__float_array[i] = (float)(dsign * (drand / drand_max) * dmax);
+        const float f = (float)(dsign * (drand / drand_max) * dmax);
+        __tc__float_array[i] = f;
+        gmio_snprintf(__tc__float_str_array[2*i], 32, "%f", f);
+        gmio_snprintf(__tc__float_str_array[2*i + 1], 32, "%E", f);
     }
 }
 
 static void __tc__run_atof(float (*func_atof)(const char*))
 {
-    char strbuff[512] = {0};
     size_t iter;
     for (iter = 0; iter < 250; ++iter) {
         size_t i;
-        for (i = 0; i < GMIO_ARRAY_SIZE(__tc__float_array); ++i) {
-            const float f = __tc__float_array[i];
-            float fres = 0.f;
-            gmio_snprintf(strbuff, sizeof(strbuff), "%f", f);
-            fres = func_atof(strbuff);
-            gmio_snprintf(strbuff, sizeof(strbuff), "%E", f);
-            fres = func_atof(strbuff);
+        for (i = 0; i < GMIO_ARRAY_SIZE(__tc__float_str_array); ++i) {
+            volatile float fres = func_atof(__tc__float_str_array[i]);
             GMIO_UNUSED(fres);
         }
     }
@@ -78,12 +79,23 @@ static float __tc__float_strtod(const char* str)
     return (float)strtod(str, NULL);
 }
 
+static float __tc__float_eisel_lemire(const char* str)
+{
+    return gmio_eisel_lemire_strtof(str, NULL);
+}
+
 static void __tc__benchmark_fast_atof(const void* arg)
 {
     GMIO_UNUSED(arg);
     __tc__run_atof(&fast_atof);
 }
 
+static void __tc__benchmark_eisel_lemire(const void* arg)
+{
+    GMIO_UNUSED(arg);
+    __tc__run_atof(&__tc__float_eisel_lemire);
+}
+
 static void __tc__benchmark_strtod(const void* arg)
 {
     GMIO_UNUSED(arg);
@@ -93,13 +105,16 @@ static void __tc__benchmark_strtod(const void* arg)
 static const char* test_internal__benchmark_gmio_fast_atof()
 {
     struct benchmark_cmp_arg bmk_arg[] = {
-        { "str->float",
+        { "str->float fast_atof",
                 &__tc__benchmark_fast_atof, NULL,
                 &__tc__benchmark_strtod, NULL },
+        { "str->float eisel_lemire",
+                &__tc__benchmark_eisel_lemire, NULL,
+                &__tc__benchmark_strtod, NULL },
         {0}
     };
-    struct benchmark_cmp_result bmk_res[] = { {0}, {0} };
-    const struct benchmark_cmp_result_header header = { "fast_atof", "strtod" };
+    struct benchmark_cmp_result bmk_res[] = { {0}, {0}, {0} };
+    const struct benchmark_cmp_result_header header = { "gmio", "strtod" };
     struct benchmark_cmp_result_array bmk_res_array = {0};
 
     __tc__fill_float_array();
@@ -34,18 +34,25 @@
 #include "../src/gmio_core/error.h"
 #include "../src/gmio_core/internal/byte_codec.h"
 #include "../src/gmio_core/internal/byte_swap.h"
+#include "../src/gmio_core/internal/c99_math_compat.h"
+#include "../src/gmio_core/internal/c99_stdio_compat.h"
 #include "../src/gmio_core/internal/convert.h"
+#include "../src/gmio_core/internal/eisel_lemire.h"
 #include "../src/gmio_core/internal/error_check.h"
 #include "../src/gmio_core/internal/fast_atof.h"
 #include "../src/gmio_core/internal/file_utils.h"
+#include "../src/gmio_core/internal/float_format_utils.h"
 #include "../src/gmio_core/internal/helper_stream.h"
 #include "../src/gmio_core/internal/itoa.h"
 #include "../src/gmio_core/internal/locale_utils.h"
 #include "../src/gmio_core/internal/numeric_utils.h"
+#include "../src/gmio_core/internal/ryu.h"
 #include "../src/gmio_core/internal/ostringstream.h"
 #include "../src/gmio_core/internal/safe_cast.h"
 #include "../src/gmio_core/internal/stringstream.h"
+#include "../src/gmio_core/internal/stringstream_eisel_lemire.h"
 #include "../src/gmio_core/internal/stringstream_fast_atof.h"
+#include "../src/gmio_core/internal/string_ascii_scan.h"
 #include "../src/gmio_core/internal/string_ascii_utils.h"
 #include "../src/gmio_core/internal/zip_utils.h"
 #include "../src/gmio_core/internal/zlib_utils.h"
@@ -54,6 +61,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 static const char* test_internal__byte_swap()
 {
@@ -233,6 +241,292 @@ static const char* test_internal__fast_atof()
     return NULL;
 }
 
+/* Checks Eisel-Lemire conversions of \p val_str give the same bits as
+ * strtof(), which is correctly rounded */
+static bool __tc__check_eisel_lemire(const char* val_str)
+{
+    const float std_val = strtof(val_str, NULL);
+    const uint32_t std_bits = gmio_convert_uint32(std_val);
+    int accurate_count = 0;
+
+    { /* Test gmio_eisel_lemire_strtof() */
+        const float val = gmio_eisel_lemire_strtof(val_str, NULL);
+        if (gmio_convert_uint32(val) == std_bits)
+            ++accurate_count;
+        else
+            __tc__fprintf_atof_err("gmio_eisel_lemire_strtof", val_str, val, std_val);
+    }
+
+    { /* Test gmio_stringstream_eisel_lemire(), with numbers spanning chunks */
+        size_t capacity;
+        for (capacity = 1; capacity <= 64; capacity *= 4) {
+            char iobuff[64] = {0};
+            struct gmio_ro_buffer ibuff =
+                    gmio_ro_buffer(val_str, strlen(val_str), 0);
+            struct gmio_stringstream sstream =
+                    gmio_stringstream(
+                        gmio_istream_buffer(&ibuff),
+                        gmio_string(iobuff, 0, capacity));
+            const float val = gmio_stringstream_eisel_lemire(&sstream);
+            if (gmio_convert_uint32(val) != std_bits) {
+                __tc__fprintf_atof_err(
+                            "gmio_stringstream_eisel_lemire", val_str, val, std_val);
+                return false;
+            }
+        }
+        ++accurate_count;
+    }
+
+    return accurate_count == 2;
+}
+
+static const char* test_internal__eisel_lemire()
+{
+    static const char* values[] = {
+        "340282346638528859811704183484516925440.000000",
+        "3.402823466e+38F",
+        "-3.402823466e+37F",
+        "3402823466e+29F",
+        "340282356779733661637539395458142568448", /* Rounds to infinity */
+        "340282356779733661637539395458142568447", /* Rounds to FLT_MAX */
+        "1e39",
+        "-1e-50",
+        ".00234567",
+        "-.00234567",
+        "0000123456.789",
+        "-0.0690462109446526",
+        "1.175494351e-38F",
+        "1175494351e-47F",
+        "1.4e-45",          /* Smallest subnormal */
+        "7.006492321624085e-46", /* Halfway to smallest subnormal */
+        "7.006492321624086e-46",
+        "1.1754942e-38",    /* Largest subnormal */
+        "16777217",         /* Halfway between 2^24 and 2^24+2 : to even */
+        "16777219",
+        "0.1",
+        "0",
+        "-0.0",
+        "1e0",
+        "12.",
+        "4.9e+00",
+        "36.240989685",
+        "1.00000005960464477539062499999999999999999999999",
+        "1.000000059604644775390625",
+        "1.00000005960464477539062500000000000000000000001",
+        "0.000000000000000000000000000000000000000000001401298464324817070923729583289916131280261941876515771757068283889791082685860601486638188362121582031250"
+    };
+    const size_t random_count = 100000;
+    size_t i;
+    bool ok = true;
+
+    for (i = 0; i < GMIO_ARRAY_SIZE(values); ++i)
+        ok = ok && __tc__check_eisel_lemire(values[i]);
+
+    /* Long mantissas, rounding decided by digits far beyond the 19th */
+    for (i = 0; ok && i < 5; ++i) {
+        static const char* prefixes[] = {
+            "1.000000059604644775390625", /* Halfway 1 <-> 1+2^-23 */
+            "1.000000059604644775390625",
+            "16777217",                   /* Halfway 2^24 <-> 2^24+2 */
+            "-16777217",
+            "0."
+        };
+        static const char* suffixes[] = {
+            "", "1", "e-300", "1e-300", "1175494351e300"
+        };
+        char str[512] = {0};
+        const size_t prefix_len = strlen(prefixes[i]);
+        memcpy(str, prefixes[i], prefix_len);
+        memset(str + prefix_len, '0', 300);
+        strcpy(str + prefix_len + 300, suffixes[i]);
+        ok = __tc__check_eisel_lemire(str);
+    }
+    UTEST_COMPARE_UINT(
+                gmio_convert_uint32(1.0000001f),
+                gmio_convert_uint32(gmio_eisel_lemire_strtof(
+                    "1.000000059604644775390625"
+                    "000000000000000000000000000000000000000000000000000000000"
+                    "000000000000000000000000000000000000000000000000000000000"
+                    "0000000000000000000000000000000000000000000000001", NULL)));
+
+    /* Random finite floats, in various text formats */
+    srand((unsigned)time(NULL));
+    for (i = 0; ok && i < random_count; ++i) {
+        const uint32_t bits =
+                ((uint32_t)rand() << 16) ^ (uint32_t)rand() ^ ((uint32_t)rand() << 30);
+        const float val = gmio_convert_ufloat32(bits);
+        char str[64];
+        if (gmio_isfinite(val)) {
+            gmio_snprintf(str, sizeof(str), "%.9g", val);
+            ok = ok && __tc__check_eisel_lemire(str);
+            gmio_snprintf(str, sizeof(str), "%E", val);
+            ok = ok && __tc__check_eisel_lemire(str);
+            gmio_snprintf(str, sizeof(str), "%.7g", val);
+            ok = ok && __tc__check_eisel_lemire(str);
+        }
+        /* Random decimal digits */
+        gmio_snprintf(str, sizeof(str), "%u.%05u%05ue%d",
+                      (unsigned)rand(),
+                      (unsigned)(rand() % 100000),
+                      (unsigned)(rand() % 100000),
+                      (rand() % 90) - 50);
+        ok = ok && __tc__check_eisel_lemire(str);
+    }
+
+    /* No number */
+    {
+        const char* str = "e5";
+        const char* end_ptr = NULL;
+        UTEST_COMPARE_UINT(0, gmio_convert_uint32(gmio_eisel_lemire_strtof(str, &end_ptr)));
+        UTEST_ASSERT(end_ptr == str);
+        str = "-.";
+        UTEST_COMPARE_UINT(0, gmio_convert_uint32(gmio_eisel_lemire_strtof(str, &end_ptr)));
+        UTEST_ASSERT(end_ptr == str);
+        str = "2.5e";
+        UTEST_COMPARE_UINT(gmio_convert_uint32(2.5f), gmio_convert_uint32(gmio_eisel_lemire_strtof(str, &end_ptr)));
+        UTEST_ASSERT(end_ptr == str + 3);
+    }
+
+    UTEST_ASSERT(ok);
+
+    return NULL;
+}
+
+static bool __tc__check_float2str_ryu(
+        float val, enum gmio_float_text_format format, uint8_t prec)
+{
+    const struct gmio_string_16 std_format =
+            gmio_to_stdio_float_format(format, prec);
+    char str[64] = {0};
+    char std_str[64] = {0};
+    const int len = gmio_float2str_ryu(val, str, sizeof(str) - 1, format, prec);
+    const int std_len =
+            gmio_snprintf(std_str, sizeof(std_str), std_format.array, val);
+    const bool is_shortest_format =
+            format == GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE
+            || format == GMIO_FLOAT_TEXT_FORMAT_SHORTEST_UPPERCASE;
+    bool ok = len == std_len && strcmp(str, std_str) == 0;
+    if (!ok && is_shortest_format && gmio_isfinite(val)) {
+        /* Text can differ from the one of printf() but must not be longer and
+         * must read back
+         * to the same float */
+        const float read_val = strtof(str, NULL);
+        ok = len <= std_len
+                && gmio_convert_uint32(read_val) == gmio_convert_uint32(val);
+    }
+    if (!ok) {
+        fprintf(stderr,
+                "\ncheck_float2str_ryu() FAILURE\n"
+                "    format: %s\n"
+                "    value:  %.9g (0x%08X)\n"
+                "    ryu:    %s\n"
+                "    std:    %s\n",
+                std_format.array, val, gmio_convert_uint32(val), str, std_str);
+    }
+    return ok;
+}
+
+static const char* test_internal__float2str_ryu()
+{
+    static const float values[] = {
+        0.f, -0.f, 1.f, -1.f, 0.1f, 0.5f, 2.5f, 9.5f, 0.125f, 100.f,
+        99999.5f, 16777216.f, 123456789.f, 1e10f, 1e-4f, 9.9999995e-5f,
+        1e-5f, -1.5e-7f, 36.240989685f, 1e38f, 3.4028235e38f,
+        1.17549435e-38f /* Smallest normal */,
+        1.4e-45f /* Smallest subnormal */
+    };
+    static const enum gmio_float_text_format formats[] = {
+        GMIO_FLOAT_TEXT_FORMAT_DECIMAL_LOWERCASE,
+        GMIO_FLOAT_TEXT_FORMAT_DECIMAL_UPPERCASE,
+        GMIO_FLOAT_TEXT_FORMAT_SCIENTIFIC_LOWERCASE,
+        GMIO_FLOAT_TEXT_FORMAT_SCIENTIFIC_UPPERCASE,
+        GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE,
+        GMIO_FLOAT_TEXT_FORMAT_SHORTEST_UPPERCASE
+    };
+    const size_t random_count = 20000;
+    size_t i;
+    bool ok = true;
+
+    for (i = 0; i < GMIO_ARRAY_SIZE(values); ++i) {
+        size_t ifmt;
+        uint8_t prec;
+        for (ifmt = 0; ifmt < GMIO_ARRAY_SIZE(formats); ++ifmt) {
+            for (prec = 1; prec <= 9; ++prec)
+                ok = ok && __tc__check_float2str_ryu(values[i], formats[ifmt], prec);
+        }
+    }
+
+    /* Random floats */
+    srand((unsigned)time(NULL));
+    for (i = 0; ok && i < random_count; ++i) {
+        const uint32_t bits =
+                ((uint32_t)rand() << 16) ^ (uint32_t)rand() ^ ((uint32_t)rand() << 30);
+        const float val = gmio_convert_ufloat32(bits);
+        const uint8_t prec = 1 + (uint8_t)(rand() % 9);
+        size_t ifmt;
+        for (ifmt = 0; ifmt < GMIO_ARRAY_SIZE(formats); ++ifmt)
+            ok = ok && __tc__check_float2str_ryu(val, formats[ifmt], prec);
+    }
+    UTEST_ASSERT(ok);
+
+    /* Shortest texts */
+    {
+        static const struct {
+            float val;
+            const char* str;
+        } shortest[] = {
+            { 0.f, "0" },
+            { -0.f, "-0" },
+            { 0.1f, "0.1" },
+            { 100.f, "100" },
+            { 16777216.f, "16777216" },
+            { 1e10f, "1e+10" },
+            { 1e-4f, "0.0001" },
+            { -1.5e-5f, "-1.5e-05" },
+            { 3.4028235e38f, "3.4028235e+38" },
+            { 1.4e-45f, "1e-45" }
+        };
+        for (i = 0; i < GMIO_ARRAY_SIZE(shortest); ++i) {
+            char str[32] = {0};
+            gmio_float2str_ryu(
+                        shortest[i].val, str, sizeof(str) - 1,
+                        GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE, 9);
+            UTEST_COMPARE_CSTR(shortest[i].str, str);
+        }
+    }
+
+    /* Double values */
+    {
+        char str[64] = {0};
+        gmio_double2str_ryu(
+                    0.1, str, sizeof(str) - 1,
+                    GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE, 16);
+        UTEST_COMPARE_CSTR("0.1", str);
+        memset(str, 0, sizeof(str));
+        gmio_double2str_ryu(
+                    0.1f, str, sizeof(str) - 1,
+                    GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE, 16);
+        UTEST_COMPARE_CSTR("0.1000000014901161", str);
+        memset(str, 0, sizeof(str));
+        gmio_double2str_ryu(
+                    0.1f, str, sizeof(str) - 1,
+                    GMIO_FLOAT_TEXT_FORMAT_SHORTEST_LOWERCASE, 9);
+        UTEST_COMPARE_CSTR("0.1", str);
+        memset(str, 0, sizeof(str));
+        gmio_double2str_ryu(
+                    -2.5f, str, sizeof(str) - 1,
+                    GMIO_FLOAT_TEXT_FORMAT_DECIMAL_LOWERCASE, 16);
+        UTEST_COMPARE_CSTR("-2.5000000000000000", str);
+        memset(str, 0, sizeof(str));
+        gmio_double2str_ryu(
+                    1e300, str, sizeof(str) - 1,
+                    GMIO_FLOAT_TEXT_FORMAT_SCIENTIFIC_UPPERCASE, 3);
+        UTEST_COMPARE_CSTR("1.000E+300", str);
+    }
+
+    return NULL;
+}
+
 static const char* test_internal__safe_cast()
 {
 #if GMIO_TARGET_ARCH_BIT_SIZE > 32
@@ -421,6 +715,32 @@ static const char* test_internal__ostringstream()
     return NULL;
 }
 
+static const char* test_internal__string_ascii_scan()
+{
+    /* Compare gmio_ascii_find_[non]space() with plain scalar scans, for all
+     * sub-ranges of a string mixing spaces and non-spaces */
+    static const char str[] =
+            "  \t\n\r\v\f  facet normal  0.5 -1.2e+3\t 1e-2\n"
+            "    outer loop                      vertex\x01\x1F\x7F\x80\xFF"
+            "                                   endsolid ~!@";
+    const char* const str_end = str + sizeof(str) - 1;
+    const char* begin;
+    for (begin = str; begin != str_end; ++begin) {
+        const char* end;
+        for (end = begin; end <= str_end; ++end) {
+            const char* it_nonspace = begin;
+            const char* it_space = begin;
+            while (it_nonspace < end && gmio_ascii_isspace(*it_nonspace))
+                ++it_nonspace;
+            while (it_space < end && !gmio_ascii_isspace(*it_space))
+                ++it_space;
+            UTEST_ASSERT(gmio_ascii_find_nonspace(begin, end) == it_nonspace);
+            UTEST_ASSERT(gmio_ascii_find_space(begin, end) == it_space);
+        }
+    }
+    return NULL;
+}
+
 static const char* test_internal__string_ascii_utils()
 {
     char c; /* for loop counter */
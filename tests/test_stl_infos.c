@@ -112,3 +112,122 @@ static const char* test_stl_infos_github8()
     UTEST_COMPARE_INT(error, GMIO_STL_ERROR_INFO_NULL_SOLIDNAME);
     return NULL;
 }
+
+/* Probes facet count and size with memblocks of various sizes, so that
+ * keywords are split over successive stream chunks */
+static const char* test_stla_infos_chunks()
+{
+    static const char stla_contents[] =
+            "solid part\n"
+            "  facet normal 0 0 1\n"
+            "  endfacet\n"
+            "\tFACET normal 0 0 1 endfacet\n"
+            "FaCeT\n"
+            "  facetnormal 0 0 1\n"
+            "  facing fac et  xfacet efacet\n"
+            "  endfacet\n"
+            "endsolid part\n"
+            "solid second\n"
+            "  facet normal 0 0 1\n"
+            "  endfacet\n"
+            "endsolid second\n";
+    static const size_t mblock_sizes[] = { 10, 11, 16, 17, 23, 33, 1024 };
+    const char* filepath = "temp/infos_chunks.stla";
+    gmio_streamsize_t expected_size = -1;
+    size_t i;
+
+    {
+        FILE* file = fopen(filepath, "wb");
+        fwrite(stla_contents, 1, sizeof(stla_contents) - 1, file);
+        fclose(file);
+    }
+    for (i = 0; i < GMIO_ARRAY_SIZE(mblock_sizes); ++i) {
+        uint8_t mblock_bytes[1024];
+        FILE* file = fopen(filepath, "rb");
+        struct gmio_stream stream = gmio_stream_stdio(file);
+        struct gmio_stl_infos infos = {0};
+        struct gmio_stl_infos_probe_options opts = {0};
+        int error = GMIO_ERROR_OK;
+
+        opts.stream_memblock =
+                gmio_memblock(mblock_bytes, mblock_sizes[i], NULL);
+        opts.format_hint = GMIO_STL_FORMAT_ASCII;
+        error = gmio_stl_infos_probe(
+                    &infos,
+                    &stream,
+                    GMIO_STL_INFO_FLAG_FACET_COUNT | GMIO_STL_INFO_FLAG_SIZE,
+                    &opts);
+        fclose(file);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(4, infos.facet_count);
+        if (expected_size == -1)
+            expected_size = infos.size;
+        UTEST_COMPARE_INT(expected_size, infos.size);
+    }
+    /* Size of first solid stops at end of its "endsolid" line */
+    UTEST_COMPARE_INT(
+                strstr(stla_contents, "endsolid part") - stla_contents + 13,
+                expected_size);
+    return NULL;
+}
+
+/* Checks infos are estimated when gmio_stl_infos_probe_options::size_limit
+ * is reached */
+static const char* test_stl_infos_size_limit()
+{
+    const unsigned flags =
+            GMIO_STL_INFO_FLAG_FACET_COUNT | GMIO_STL_INFO_FLAG_SIZE;
+    struct gmio_stl_infos_probe_options opts = {0};
+    struct gmio_stl_infos infos_exact = {0};
+    struct gmio_stl_infos infos = {0};
+    int error = GMIO_ERROR_OK;
+
+    /* STL ascii */
+    {
+        const char* filepath = "models/solid_jburkardt_sphere.stla";
+        error = gmio_stl_infos_probe_file(&infos_exact, filepath, flags, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(0, infos_exact.estimated_flags);
+
+        /* Limit greater than file size */
+        opts.size_limit = 2 * infos_exact.size;
+        error = gmio_stl_infos_probe_file(&infos, filepath, flags, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(0, infos.estimated_flags);
+        UTEST_COMPARE_UINT(infos_exact.facet_count, infos.facet_count);
+        UTEST_COMPARE_INT(infos_exact.size, infos.size);
+
+        /* Limit at half file size */
+        opts.size_limit = infos_exact.size / 2;
+        error = gmio_stl_infos_probe_file(&infos, filepath, flags, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(flags, infos.estimated_flags);
+        UTEST_ASSERT(infos.facet_count >= infos_exact.facet_count * 9 / 10);
+        UTEST_ASSERT(infos.facet_count <= infos_exact.facet_count * 11 / 10);
+        UTEST_ASSERT(infos.size >= infos_exact.size);
+    }
+
+    /* STL binary */
+    {
+        const char* filepath = filepath_stlb_grabcad_arm11;
+        error = gmio_stl_infos_probe_file(&infos_exact, filepath, flags, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+
+        /* Limit after facet count : exact infos */
+        opts.size_limit = 100;
+        error = gmio_stl_infos_probe_file(&infos, filepath, flags, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(0, infos.estimated_flags);
+        UTEST_COMPARE_UINT(infos_exact.facet_count, infos.facet_count);
+
+        /* Limit within header : infos deduced from file size */
+        opts.size_limit = 40;
+        error = gmio_stl_infos_probe_file(&infos, filepath, flags, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(flags, infos.estimated_flags);
+        UTEST_COMPARE_UINT(infos_exact.facet_count, infos.facet_count);
+        UTEST_COMPARE_INT(infos_exact.size, infos.size);
+    }
+
+    return NULL;
+}
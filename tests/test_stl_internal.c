@@ -32,11 +32,15 @@
 #include "stl_utils.h"
 
 #include "../src/gmio_core/error.h"
+#include "../src/gmio_core/internal/string_ascii_utils.h"
 #include "../src/gmio_stl/internal/stl_error_check.h"
+#include "../src/gmio_stl/internal/stla_scan_mask.h"
+#include "../src/gmio_stl/internal/stlb_byte_swap.h"
 #include "../src/gmio_stl/stl_error.h"
 #include "../src/gmio_stl/stl_io.h"
 
 #include <stddef.h>
+#include <string.h>
 
 static const char* test_stl_internal__error_check()
 {
@@ -62,6 +66,13 @@ static const char* test_stl_internal__error_check()
         error = GMIO_ERROR_OK;
         UTEST_ASSERT(gmio_stl_check_mesh(&error, &mesh));
         UTEST_ASSERT(error == GMIO_ERROR_OK);
+
+        /* gmio_stl_mesh::func_get_triangles() alone is also fine */
+        mesh.triangle_count = 100;
+        mesh.func_get_triangle = NULL;
+        mesh.func_get_triangles = &gmio_stl_nop_get_triangles;
+        UTEST_ASSERT(gmio_stl_check_mesh(&error, &mesh));
+        UTEST_ASSERT(error == GMIO_ERROR_OK);
     }
 
     /* gmio_stlb_check_byteorder() */
@@ -77,3 +88,113 @@ static const char* test_stl_internal__error_check()
 
     return NULL;
 }
+
+static const char* test_stl_internal__byte_swap()
+{
+    /* gmio_stlb_facets_bswap() must give the same results as
+     * gmio_stl_triangle_bswap() */
+    enum { facet_count = 37 };
+    static uint8_t buff[facet_count * GMIO_STLB_TRIANGLE_RAWSIZE + 1];
+    uint8_t* records = buff + 1; /* Not aligned on purpose */
+    uint32_t i;
+
+    for (i = 0; i < sizeof(buff); ++i)
+        buff[i] = (uint8_t)(i * 31 + 7);
+    {
+        uint8_t records_orig[facet_count * GMIO_STLB_TRIANGLE_RAWSIZE];
+        memcpy(records_orig, records, sizeof(records_orig));
+        gmio_stlb_facets_bswap(records, facet_count);
+        for (i = 0; i < facet_count; ++i) {
+            const size_t offset = i * GMIO_STLB_TRIANGLE_RAWSIZE;
+            struct gmio_stl_triangle tri;
+            memcpy(&tri, records_orig + offset, GMIO_STLB_TRIANGLE_RAWSIZE);
+            gmio_stl_triangle_bswap(&tri);
+            UTEST_ASSERT(memcmp(&tri, records + offset, GMIO_STLB_TRIANGLE_RAWSIZE)
+                         == 0);
+        }
+
+        /* Swapping twice gives back original records */
+        gmio_stlb_facets_bswap(records, facet_count);
+        UTEST_ASSERT(memcmp(records_orig, records, sizeof(records_orig)) == 0);
+    }
+
+    return NULL;
+}
+
+/* Builds the masks of a 16-char chunk as SIMD classification would do, with
+ * groups of (1 << char_shift) bits per char */
+static void __tstl__scan_masks(
+        const char* chunk,
+        unsigned char_shift,
+        uint64_t* mask_space,
+        uint64_t* mask_ef)
+{
+    const uint64_t char_mask = gmio_stla_scan_char_mask(char_shift);
+    unsigned i;
+    *mask_space = 0;
+    *mask_ef = 0;
+    for (i = 0; i < 16; ++i) {
+        const char c = chunk[i] | 0x20;
+        if (gmio_ascii_isspace(chunk[i]))
+            *mask_space |= char_mask << (i << char_shift);
+        if (c == 'e' || c == 'f')
+            *mask_ef |= char_mask << (i << char_shift);
+    }
+}
+
+static const char* test_stl_internal__scan_mask()
+{
+    /* Word starts given by the masks must match a plain scalar scan, for the
+     * SSE2 layout(1 bit per char) as well as for the NEON one(4 bits) */
+    static const char str[] =
+            "e facet f\tfoo endsolid  effe\n"
+            "fffffffffffffffff  e  f  e  f  e"
+            "xfacet   \t\r\n  Facet\vENDSOLID e";
+    static const unsigned char_shifts[] = { 0, 2 };
+    const size_t shift_count = sizeof(char_shifts) / sizeof(*char_shifts);
+    size_t ichunk;
+    size_t ishift;
+    int iprev;
+
+    for (ishift = 0; ishift < shift_count; ++ishift) {
+        const unsigned char_shift = char_shifts[ishift];
+        const uint64_t char_mask = gmio_stla_scan_char_mask(char_shift);
+        UTEST_COMPARE_UINT((1u << (1u << char_shift)) - 1, char_mask);
+        for (ichunk = 0; ichunk + 16 < sizeof(str); ++ichunk) {
+            const char* chunk = str + ichunk;
+            uint64_t mask_space;
+            uint64_t mask_ef;
+            __tstl__scan_masks(chunk, char_shift, &mask_space, &mask_ef);
+            UTEST_ASSERT(
+                        gmio_stla_scan_last_is_space(mask_space, char_shift)
+                        == gmio_ascii_isspace(chunk[15]));
+            for (iprev = 0; iprev < 2; ++iprev) {
+                const bool prev_is_space = iprev != 0;
+                const uint64_t mask_word =
+                        gmio_stla_scan_word_start_mask(
+                            mask_space, mask_ef, prev_is_space, char_shift);
+                unsigned i;
+                for (i = 0; i < 16; ++i) {
+                    const char c = chunk[i] | 0x20;
+                    const bool prev_space =
+                            i == 0 ? prev_is_space :
+                                     gmio_ascii_isspace(chunk[i - 1]);
+                    const bool is_word_start =
+                            prev_space
+                            && !gmio_ascii_isspace(chunk[i])
+                            && (c == 'e' || c == 'f');
+                    const uint64_t bits =
+                            (mask_word >> (i << char_shift)) & char_mask;
+                    UTEST_ASSERT(bits == (is_word_start ? char_mask : 0));
+                }
+                /* No bit beyond the 16 chars */
+                if (char_shift < 2) {
+                    UTEST_ASSERT(
+                                (mask_word >> (16u << char_shift)) == 0);
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
@@ -34,6 +34,7 @@
 #include "stl_utils.h"
 
 #include "../src/gmio_core/error.h"
+#include "../src/gmio_core/internal/convert.h"
 #include "../src/gmio_core/internal/helper_stream.h"
 #include "../src/gmio_core/internal/locale_utils.h"
 #include "../src/gmio_core/internal/min_max.h"
@@ -42,6 +43,9 @@
 #include "../src/gmio_stl/stl_infos.h"
 #include "../src/gmio_stl/stl_io.h"
 #include "../src/gmio_stl/stl_io_options.h"
+#include "../src/gmio_stl/stl_mesh_creator_indexed.h"
+#include "../src/gmio_stl/stl_triangle_soa.h"
+#include "../src/gmio_stl/stlb_view.h"
 
 #include <locale.h>
 #include <stddef.h>
@@ -146,6 +150,998 @@ static const char* test_stlb_read()
     return NULL;
 }
 
+/* Reads \p filepath with both gmio_stl_mesh_creator::func_add_triangle() and
+ * gmio_stl_mesh_creator::func_add_triangles(), then checks results are equal */
+static const char* __tstl__test_stl_read_batch(
+        const char* filepath, const struct gmio_stl_read_options* opts)
+{
+    struct gmio_stl_data data = {0};
+    struct gmio_stl_data data_batch = {0};
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+    struct gmio_stl_mesh_creator creator_batch =
+            gmio_stl_data_mesh_creator_batch(&data_batch);
+    int error = gmio_stl_read_file(filepath, &creator, opts);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    error = gmio_stl_read_file(filepath, &creator_batch, opts);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    UTEST_COMPARE_UINT(data.tri_array.count, data_batch.tri_array.count);
+    for (size_t i = 0; i < data.tri_array.count; ++i) {
+        const struct gmio_stl_triangle* lhs = &data.tri_array.ptr[i];
+        const struct gmio_stl_triangle* rhs = &data_batch.tri_array.ptr[i];
+        UTEST_ASSERT(gmio_stl_triangle_equal(lhs, rhs, 0));
+    }
+    gmio_stl_triangle_array_free(&data.tri_array);
+    gmio_stl_triangle_array_free(&data_batch.tri_array);
+    return NULL;
+}
+
+/* Writes to \p filepath the big-endian version of binary STL test model */
+static const char* __tstl__write_be_model(const char* filepath)
+{
+    struct gmio_stl_data data = {0};
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+    int error = gmio_stl_read_file(filepath_stlb_grabcad_arm11, &creator, NULL);
+    if (error == GMIO_ERROR_OK) {
+        const struct gmio_stl_mesh mesh = gmio_stl_data_mesh(&data);
+        error = gmio_stl_write_file(
+                    GMIO_STL_FORMAT_BINARY_BE, filepath, &mesh, NULL);
+    }
+    gmio_stl_triangle_array_free(&data.tri_array);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    return NULL;
+}
+
+static const char* test_stl_read_batch()
+{
+    const char* model_fpath_be = "temp/solid_batch.be_stlb";
+    const char* res = NULL;
+
+    res = __tstl__write_be_model(model_fpath_be);
+    if (res == NULL)
+        res = __tstl__test_stl_read_batch(filepath_stlb_grabcad_arm11, NULL);
+    if (res == NULL)
+        res = __tstl__test_stl_read_batch(model_fpath_be, NULL);
+    if (res == NULL)
+        res = __tstl__test_stl_read_batch(filepath_stla_4meshs, NULL);
+    if (res == NULL)
+        res = __tstl__test_stl_read_batch(
+                    "models/solid_jburkardt_sphere.stla", NULL);
+
+    /* Memblock not aligned for gmio_stl_triangle */
+    if (res == NULL) {
+        static uint8_t buff[1025];
+        struct gmio_stl_read_options opts = {0};
+        opts.stream_memblock = gmio_memblock(buff + 1, 1024, NULL);
+        res = __tstl__test_stl_read_batch(filepath_stlb_grabcad_arm11, &opts);
+        if (res == NULL)
+            res = __tstl__test_stl_read_batch(model_fpath_be, &opts);
+    }
+
+    return res;
+}
+
+/* Thread-safe add_triangle(s) functions : storage of gmio_stl_data is
+ * preallocated by func_begin_solid() so triangles are just written at their
+ * index */
+static void __tstl__mt_add_triangle(
+        void* cookie, uint32_t tri_id, const struct gmio_stl_triangle* triangle)
+{
+    struct gmio_stl_data* data = (struct gmio_stl_data*)cookie;
+    data->tri_array.ptr[tri_id] = *triangle;
+}
+
+static void __tstl__mt_add_triangles(
+        void* cookie,
+        uint32_t first_tri_id,
+        const struct gmio_stl_triangle* triangles,
+        uint32_t count)
+{
+    struct gmio_stl_data* data = (struct gmio_stl_data*)cookie;
+    memcpy(&data->tri_array.ptr[first_tri_id],
+           triangles,
+           count * sizeof(struct gmio_stl_triangle));
+}
+
+struct __tstl__mt_task
+{
+    unsigned progress_count;
+    unsigned stop_at_progress_count;
+};
+
+static bool __tstl__mt_task_is_stop_requested(void* cookie)
+{
+    const struct __tstl__mt_task* task = (const struct __tstl__mt_task*)cookie;
+    return task->stop_at_progress_count != 0
+            && task->progress_count >= task->stop_at_progress_count;
+}
+
+static void __tstl__mt_task_handle_progress(
+        void* cookie, intmax_t value, intmax_t max_value)
+{
+    struct __tstl__mt_task* task = (struct __tstl__mt_task*)cookie;
+    GMIO_UNUSED(value);
+    GMIO_UNUSED(max_value);
+    ++task->progress_count;
+}
+
+/* Reads binary STL \p filepath with gmio_stl_read_options::thread_count and
+ * checks facets are equal to the single-threaded read */
+static const char* __tstl__test_stlb_read_multithread(
+        const char* filepath, bool batch)
+{
+    static uint8_t buff[20 * GMIO_STLB_TRIANGLE_RAWSIZE];
+    struct gmio_stl_data data = {0};
+    struct gmio_stl_data data_mt = {0};
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+    struct gmio_stl_mesh_creator creator_mt =
+            gmio_stl_data_mesh_creator(&data_mt);
+    struct gmio_stl_read_options opts = {0};
+    struct gmio_stl_infos infos = {0};
+    struct __tstl__mt_task task = {0};
+    uint32_t i;
+    int error;
+
+    error = gmio_stl_infos_probe_file(
+                &infos, filepath, GMIO_STL_INFO_FLAG_FACET_COUNT, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    error = gmio_stl_read_file(filepath, &creator, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+
+    /* Small memblock so facets are read in many chunks */
+    opts.stream_memblock = gmio_memblock(buff, sizeof(buff), NULL);
+    opts.thread_count = 4;
+    opts.task_iface.cookie = &task;
+    opts.task_iface.func_handle_progress = __tstl__mt_task_handle_progress;
+    creator_mt.func_add_triangle = __tstl__mt_add_triangle;
+    if (batch)
+        creator_mt.func_add_triangles = __tstl__mt_add_triangles;
+    error = gmio_stl_read_file(filepath, &creator_mt, &opts);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    data_mt.tri_array.count = infos.facet_count;
+    UTEST_COMPARE_UINT(data.tri_array.count, data_mt.tri_array.count);
+    for (i = 0; i < data.tri_array.count; ++i) {
+        const struct gmio_stl_triangle* lhs = &data.tri_array.ptr[i];
+        const struct gmio_stl_triangle* rhs = &data_mt.tri_array.ptr[i];
+        UTEST_ASSERT(gmio_stl_triangle_equal(lhs, rhs, 0));
+    }
+    UTEST_ASSERT(task.progress_count > 1);
+    gmio_stl_triangle_array_free(&data_mt.tri_array);
+
+    /* Stop request */
+    task.progress_count = 0;
+    task.stop_at_progress_count = 3;
+    opts.task_iface.func_is_stop_requested = __tstl__mt_task_is_stop_requested;
+    error = gmio_stl_read_file(filepath, &creator_mt, &opts);
+    UTEST_COMPARE_INT(GMIO_ERROR_TASK_STOPPED, error);
+
+    gmio_stl_triangle_array_free(&data.tri_array);
+    gmio_stl_triangle_array_free(&data_mt.tri_array);
+    return NULL;
+}
+
+static const char* test_stlb_read_multithread()
+{
+    const char* model_fpath_be = "temp/solid_mt.be_stlb";
+    const char* res = NULL;
+
+    res = __tstl__write_be_model(model_fpath_be);
+    if (res == NULL)
+        res = __tstl__test_stlb_read_multithread(filepath_stlb_grabcad_arm11, false);
+    if (res == NULL)
+        res = __tstl__test_stlb_read_multithread(filepath_stlb_grabcad_arm11, true);
+    if (res == NULL)
+        res = __tstl__test_stlb_read_multithread(model_fpath_be, false);
+    if (res == NULL)
+        res = __tstl__test_stlb_read_multithread(model_fpath_be, true);
+    return res;
+}
+
+/* Callback for gmio_stl_mesh::func_get_triangle that repeats the triangles of
+ * a gmio_stl_data */
+static void __tstl__get_triangle_repeat(
+        const void* cookie, uint32_t tri_id, struct gmio_stl_triangle* triangle)
+{
+    const struct gmio_stl_data* data = (const struct gmio_stl_data*)cookie;
+    *triangle = data->tri_array.ptr[tri_id % data->tri_array.count];
+}
+
+/* Writes \p count copies of the contents of file \p filepath_in to
+ * \p filepath_out */
+static const char* __tstl__concat_file(
+        const char* filepath_in, const char* filepath_out, unsigned count)
+{
+    FILE* infile = fopen(filepath_in, "rb");
+    FILE* outfile = fopen(filepath_out, "wb");
+    char buff[4096];
+    unsigned i;
+    for (i = 0; infile != NULL && outfile != NULL && i < count; ++i) {
+        size_t len;
+        fseek(infile, 0, SEEK_SET);
+        while ((len = fread(buff, 1, sizeof(buff), infile)) > 0)
+            fwrite(buff, 1, len, outfile);
+    }
+    if (infile != NULL)
+        fclose(infile);
+    if (outfile != NULL)
+        fclose(outfile);
+    UTEST_ASSERT(infile != NULL && outfile != NULL);
+    return NULL;
+}
+
+/* Reads ascii STL \p filepath with gmio_stl_read_options::thread_count and
+ * checks facets are equal to the single-threaded read */
+static const char* __tstl__test_stla_read_multithread(
+        const char* filepath, int expected_error)
+{
+    struct gmio_stl_data data = {0};
+    struct gmio_stl_data data_mt = {0};
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+    struct gmio_stl_mesh_creator creator_mt =
+            gmio_stl_data_mesh_creator_batch(&data_mt);
+    struct gmio_stl_read_options opts = {0};
+    struct __tstl__mt_task task = {0};
+    uint32_t i;
+    int error;
+
+    error = gmio_stl_read_file(filepath, &creator, NULL);
+    UTEST_COMPARE_INT(expected_error, error);
+
+    opts.use_file_mmap = true;
+    opts.thread_count = 4;
+    opts.task_iface.cookie = &task;
+    opts.task_iface.func_handle_progress = __tstl__mt_task_handle_progress;
+    error = gmio_stl_read_file(filepath, &creator_mt, &opts);
+    UTEST_COMPARE_INT(expected_error, error);
+    UTEST_COMPARE_UINT(data.tri_array.count, data_mt.tri_array.count);
+    UTEST_COMPARE_CSTR(data.solid_name, data_mt.solid_name);
+    for (i = 0; i < data.tri_array.count; ++i) {
+        const struct gmio_stl_triangle* lhs = &data.tri_array.ptr[i];
+        const struct gmio_stl_triangle* rhs = &data_mt.tri_array.ptr[i];
+        UTEST_ASSERT(gmio_stl_triangle_equal(lhs, rhs, 0));
+    }
+    UTEST_ASSERT(task.progress_count > 0);
+
+    gmio_stl_triangle_array_free(&data.tri_array);
+    gmio_stl_triangle_array_free(&data_mt.tri_array);
+    return NULL;
+}
+
+static const char* test_stla_read_multithread()
+{
+    const char* model_fpath = "temp/solid_mt.stla";
+    const char* model_fpath_trunc = "temp/solid_mt_trunc.stla";
+    const char* res = NULL;
+
+    /* Create ascii STL big enough to be split in several chunks */
+    {
+        struct gmio_stl_data data = {0};
+        struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+        struct gmio_stl_mesh mesh = {0};
+        struct gmio_stl_write_options opts = {0};
+        FILE* file = NULL;
+        char* contents = NULL;
+        long contents_size = 0;
+        int error = gmio_stl_read_file(
+                    filepath_stlb_grabcad_arm11, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        mesh = gmio_stl_data_mesh(&data);
+        mesh.triangle_count = 16 * data.tri_array.count;
+        mesh.func_get_triangle = __tstl__get_triangle_repeat;
+        mesh.func_get_triangles = NULL;
+        opts.stla_solid_name = "solid_mt";
+        error = gmio_stl_write_file(
+                    GMIO_STL_FORMAT_ASCII, model_fpath, &mesh, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        gmio_stl_triangle_array_free(&data.tri_array);
+
+        /* Truncated copy */
+        file = fopen(model_fpath, "rb");
+        UTEST_ASSERT(file != NULL);
+        fseek(file, 0, SEEK_END);
+        contents_size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        contents = malloc(contents_size);
+        UTEST_ASSERT(contents != NULL);
+        UTEST_ASSERT(fread(contents, 1, contents_size, file) == (size_t)contents_size);
+        fclose(file);
+        file = fopen(model_fpath_trunc, "wb");
+        UTEST_ASSERT(file != NULL);
+        fwrite(contents, 1, (2 * contents_size) / 3, file);
+        fclose(file);
+        free(contents);
+    }
+
+    res = __tstl__test_stla_read_multithread(model_fpath, GMIO_ERROR_OK);
+    if (res == NULL) {
+        res = __tstl__test_stla_read_multithread(
+                    model_fpath_trunc, GMIO_STL_ERROR_PARSING);
+    }
+    if (res == NULL) {
+        res = __tstl__test_stla_read_multithread(
+                    filepath_stla_4meshs, GMIO_ERROR_OK);
+    }
+    if (res == NULL) {
+        res = __tstl__test_stla_read_multithread(
+                    "models/solid_jburkardt_sphere.stla", GMIO_ERROR_OK);
+    }
+    if (res == NULL) {
+        res = __tstl__test_stla_read_multithread(
+                    "models/solid_empty.stla", GMIO_ERROR_OK);
+    }
+
+    /* Solids split in chunks must not run into the following ones */
+    if (res == NULL) {
+        const char* model_fpath_multi = "temp/solid_mt_multi.stla";
+        struct gmio_stl_data data = {0};
+        struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+        uint32_t triangle_count = 0;
+        unsigned solid_count = 0;
+        int error = gmio_stl_read_file(model_fpath, &creator, NULL);
+        triangle_count = data.tri_array.count;
+        gmio_stl_triangle_array_free(&data.tri_array);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        res = __tstl__concat_file(model_fpath, model_fpath_multi, 2);
+        if (res == NULL) {
+            struct gmio_stream stream = gmio_stream_mmap(model_fpath_multi);
+            struct gmio_stl_read_options opts = {0};
+            opts.thread_count = 4;
+            opts.func_stla_get_streamsize = gmio_stla_infos_probe_streamsize;
+            while (gmio_no_error(error) && !gmio_stream_at_end(&stream)) {
+                memset(&data, 0, sizeof(data));
+                error = gmio_stl_read(&stream, &creator, &opts);
+                if (gmio_no_error(error) && data.tri_array.count == triangle_count)
+                    ++solid_count;
+                gmio_stl_triangle_array_free(&data.tri_array);
+            }
+            gmio_stream_mmap_close(&stream);
+            UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+            UTEST_COMPARE_UINT(2, solid_count);
+        }
+    }
+
+    /* Stop request */
+    if (res == NULL) {
+        struct gmio_stl_mesh_creator null_creator = {0};
+        struct gmio_stl_read_options opts = {0};
+        struct __tstl__mt_task task = {0};
+        task.stop_at_progress_count = 2;
+        opts.use_file_mmap = true;
+        opts.thread_count = 4;
+        opts.task_iface.cookie = &task;
+        opts.task_iface.func_is_stop_requested = __tstl__mt_task_is_stop_requested;
+        opts.task_iface.func_handle_progress = __tstl__mt_task_handle_progress;
+        UTEST_COMPARE_INT(
+                    GMIO_ERROR_TASK_STOPPED,
+                    gmio_stl_read_file(model_fpath, &null_creator, &opts));
+    }
+    return res;
+}
+
+/* Checks facets of gmio_stlb_view over the contents of \p filepath are equal
+ * to the ones given by gmio_stl_read_file() */
+static const char* __tstl__test_stlb_view(
+        const char* filepath, enum gmio_endianness byte_order)
+{
+    struct gmio_stl_data data = {0};
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+    struct gmio_stlb_view view = {0};
+    struct gmio_stlb_view_iterator it;
+    struct gmio_stl_triangle tri;
+    uint8_t* contents = NULL;
+    size_t contents_size = 0;
+    uint32_t i;
+    int error;
+
+    { /* Load whole file in memory */
+        FILE* file = fopen(filepath, "rb");
+        UTEST_ASSERT(file != NULL);
+        fseek(file, 0, SEEK_END);
+        contents_size = (size_t)ftell(file);
+        fseek(file, 0, SEEK_SET);
+        contents = malloc(contents_size);
+        UTEST_ASSERT(fread(contents, 1, contents_size, file) == contents_size);
+        fclose(file);
+    }
+
+    error = gmio_stl_read_file(filepath, &creator, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+
+    error = gmio_stlb_view_init(&view, contents, contents_size, byte_order);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    UTEST_COMPARE_UINT(data.tri_array.count, view.facet_count);
+    UTEST_COMPARE_UINT(contents_size, view.size);
+    UTEST_ASSERT(memcmp(gmio_stlb_view_header(&view)->data,
+                        contents,
+                        GMIO_STLB_HEADER_SIZE)
+                 == 0);
+
+    /* Random access */
+    for (i = 0; i < view.facet_count; i += 7) {
+        gmio_stlb_view_get_triangle(&view, i, &tri);
+        UTEST_ASSERT(gmio_stl_triangle_equal(&data.tri_array.ptr[i], &tri, 0));
+    }
+
+    /* Iterator */
+    i = 0;
+    it = gmio_stlb_view_iterator(&view);
+    while (gmio_stlb_view_iterator_next(&it, &tri)) {
+        UTEST_ASSERT(gmio_stl_triangle_equal(&data.tri_array.ptr[i], &tri, 0));
+        ++i;
+    }
+    UTEST_COMPARE_UINT(view.facet_count, i);
+
+    /* Truncated contents */
+    error = gmio_stlb_view_init(&view, contents, contents_size - 1, byte_order);
+    UTEST_COMPARE_INT(GMIO_STL_ERROR_FACET_COUNT, error);
+    error = gmio_stlb_view_init(&view, contents, 83, byte_order);
+    UTEST_COMPARE_INT(GMIO_STL_ERROR_FACET_COUNT, error);
+    error = gmio_stlb_view_init(&view, contents, 79, byte_order);
+    UTEST_COMPARE_INT(GMIO_STL_ERROR_HEADER_WRONG_SIZE, error);
+    error = gmio_stlb_view_init(
+                &view, contents, contents_size, GMIO_ENDIANNESS_UNKNOWN);
+    UTEST_COMPARE_INT(GMIO_STL_ERROR_UNSUPPORTED_BYTE_ORDER, error);
+
+    free(contents);
+    gmio_stl_triangle_array_free(&data.tri_array);
+    return NULL;
+}
+
+/* Are coords \p a and \p b welded, -0.f and +0.f being considered equal ? */
+static bool __tstl__float32_welded(float a, float b)
+{
+    const uint32_t ua = gmio_convert_uint32(a);
+    const uint32_t ub = gmio_convert_uint32(b);
+    return ua == ub || ((ua | ub) & 0x7FFFFFFF) == 0;
+}
+
+/* Reads \p filepath with gmio_stl_mesh_creator_indexed() and checks the
+ * triangles of the indexed mesh are the ones read with no welding */
+static const char* __tstl__test_stl_read_indexed(
+        const char* filepath, unsigned thread_count)
+{
+    struct gmio_stl_data data = {0};
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+    struct gmio_stl_mesh_creator creator_indexed =
+            gmio_stl_mesh_creator_indexed(NULL);
+    const struct gmio_stl_mesh_indexed* mesh = NULL;
+    struct gmio_stl_read_options opts = {0};
+    uint32_t i;
+    int error;
+
+    error = gmio_stl_read_file(filepath, &creator, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    UTEST_ASSERT(creator_indexed.cookie != NULL);
+    opts.thread_count = thread_count;
+    error = gmio_stl_read_file(filepath, &creator_indexed, &opts);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    UTEST_COMPARE_INT(
+                GMIO_ERROR_OK,
+                gmio_stl_mesh_creator_indexed_error(&creator_indexed));
+    mesh = gmio_stl_mesh_creator_indexed_mesh(&creator_indexed);
+    UTEST_ASSERT(mesh != NULL);
+    UTEST_COMPARE_UINT(data.tri_array.count, mesh->triangle_count);
+    UTEST_ASSERT(mesh->vertex_count <= 3 * mesh->triangle_count);
+    for (i = 0; i < mesh->triangle_count; ++i) {
+        const struct gmio_stl_triangle* tri = &data.tri_array.ptr[i];
+        const struct gmio_vec3f* tri_vertices[3];
+        unsigned k;
+        tri_vertices[0] = &tri->v1;
+        tri_vertices[1] = &tri->v2;
+        tri_vertices[2] = &tri->v3;
+        for (k = 0; k < 3; ++k) {
+            const uint32_t id = mesh->indices[3*i + k];
+            UTEST_ASSERT(id < mesh->vertex_count);
+            UTEST_ASSERT(__tstl__float32_welded(
+                             mesh->vertices[id].x, tri_vertices[k]->x));
+            UTEST_ASSERT(__tstl__float32_welded(
+                             mesh->vertices[id].y, tri_vertices[k]->y));
+            UTEST_ASSERT(__tstl__float32_welded(
+                             mesh->vertices[id].z, tri_vertices[k]->z));
+        }
+    }
+    gmio_stl_mesh_creator_indexed_close(&creator_indexed);
+    UTEST_ASSERT(creator_indexed.cookie == NULL);
+    gmio_stl_triangle_array_free(&data.tri_array);
+    return NULL;
+}
+
+static const char* test_stl_read_indexed()
+{
+    const char* res = __tstl__test_stl_read_indexed(
+                filepath_stlb_grabcad_arm11, 0);
+    if (res == NULL)
+        res = __tstl__test_stl_read_indexed(filepath_stlb_grabcad_arm11, 4);
+    if (res == NULL)
+        res = __tstl__test_stl_read_indexed("models/solid_jburkardt_sphere.stla", 0);
+    if (res != NULL)
+        return res;
+
+    /* Shared vertices are stored once */
+    {
+        static const char filepath[] = "temp/solid_tetrahedron.stla";
+        static const char* const facets[] = {
+            "0 0 0", "1 0 0", "0 1 0",
+            "0 0 0", "0 0 1", "1 0 0",
+            "-0 0 0", "0 1 0", "0 0 1",
+            "1 0 0", "0 0 1", "0 1 0" };
+        struct gmio_stl_mesh_creator creator = gmio_stl_mesh_creator_indexed(NULL);
+        const struct gmio_stl_mesh_indexed* mesh = NULL;
+        int error;
+        unsigned k;
+        FILE* file = fopen(filepath, "wb");
+        UTEST_ASSERT(file != NULL);
+        fputs("solid tetrahedron\n", file);
+        for (k = 0; k < 12; ++k) {
+            if (k % 3 == 0)
+                fputs("facet normal 0 0 0\nouter loop\n", file);
+            fprintf(file, "vertex %s\n", facets[k]);
+            if (k % 3 == 2)
+                fputs("endloop\nendfacet\n", file);
+        }
+        fputs("endsolid\n", file);
+        fclose(file);
+        error = gmio_stl_read_file(filepath, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        mesh = gmio_stl_mesh_creator_indexed_mesh(&creator);
+        UTEST_COMPARE_UINT(4, mesh->triangle_count);
+        UTEST_COMPARE_UINT(4, mesh->vertex_count);
+        gmio_stl_mesh_creator_indexed_close(&creator);
+    }
+
+    /* Welding on a grid */
+    {
+        struct gmio_stl_mesh_creator_indexed_options opts = {0};
+        struct gmio_stl_mesh_creator creator;
+        const struct gmio_stl_mesh_indexed* mesh = NULL;
+        int error;
+        opts.weld_tolerance = 1e6f; /* Much larger than the model */
+        creator = gmio_stl_mesh_creator_indexed(&opts);
+        error = gmio_stl_read_file(filepath_stlb_grabcad_arm11, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        mesh = gmio_stl_mesh_creator_indexed_mesh(&creator);
+        UTEST_ASSERT(mesh->triangle_count > 0);
+        /* At most one vertex per octant */
+        UTEST_ASSERT(mesh->vertex_count <= 8);
+        gmio_stl_mesh_creator_indexed_close(&creator);
+    }
+
+    /* Cell coords out of int32 range are keyed on bit patterns */
+    {
+        static const char filepath[] = "temp/solid_huge_coords.stla";
+        struct gmio_stl_mesh_creator_indexed_options opts = {0};
+        struct gmio_stl_mesh_creator creator;
+        const struct gmio_stl_mesh_indexed* mesh = NULL;
+        int error;
+        FILE* file = fopen(filepath, "wb");
+        UTEST_ASSERT(file != NULL);
+        fputs("solid huge\n"
+              "facet normal 0 0 0\nouter loop\n"
+              "vertex 0 0 0\nvertex 3e38 0 0\nvertex 0 1 0\n"
+              "endloop\nendfacet\n"
+              "facet normal 0 0 0\nouter loop\n"
+              "vertex 3e38 0 0\nvertex -3e38 0 0\nvertex 0 1 0\n"
+              "endloop\nendfacet\n"
+              "endsolid\n",
+              file);
+        fclose(file);
+        opts.weld_tolerance = 1e-6f;
+        creator = gmio_stl_mesh_creator_indexed(&opts);
+        error = gmio_stl_read_file(filepath, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        mesh = gmio_stl_mesh_creator_indexed_mesh(&creator);
+        UTEST_COMPARE_UINT(2, mesh->triangle_count);
+        UTEST_COMPARE_UINT(4, mesh->vertex_count);
+        gmio_stl_mesh_creator_indexed_close(&creator);
+    }
+
+    return NULL;
+}
+
+/* Allocates the arrays of \p soa for \p capacity triangles, in a single
+ * block */
+static float* __tstl__triangle_soa_alloc(
+        struct gmio_stl_triangle_soa* soa, uint32_t capacity)
+{
+    float* coords = (float*)malloc(
+                12 * capacity * sizeof(float) + capacity * sizeof(uint16_t));
+    struct gmio_stl_coords_soa* soa_coords[4];
+    unsigned i;
+    soa_coords[0] = &soa->n;
+    soa_coords[1] = &soa->v1;
+    soa_coords[2] = &soa->v2;
+    soa_coords[3] = &soa->v3;
+    for (i = 0; i < 4; ++i) {
+        soa_coords[i]->x = coords + (3*i) * capacity;
+        soa_coords[i]->y = coords + (3*i + 1) * capacity;
+        soa_coords[i]->z = coords + (3*i + 2) * capacity;
+    }
+    soa->attribute_byte_count = (uint16_t*)(coords + 12 * capacity);
+    soa->capacity = capacity;
+    soa->count = 0;
+    return coords;
+}
+
+/* Returns the triangle of index \p i in \p soa */
+static struct gmio_stl_triangle __tstl__triangle_soa_at(
+        const struct gmio_stl_triangle_soa* soa, uint32_t i)
+{
+    struct gmio_stl_triangle tri;
+    tri.n.x = soa->n.x[i];  tri.n.y = soa->n.y[i];  tri.n.z = soa->n.z[i];
+    tri.v1.x = soa->v1.x[i]; tri.v1.y = soa->v1.y[i]; tri.v1.z = soa->v1.z[i];
+    tri.v2.x = soa->v2.x[i]; tri.v2.y = soa->v2.y[i]; tri.v2.z = soa->v2.z[i];
+    tri.v3.x = soa->v3.x[i]; tri.v3.y = soa->v3.y[i]; tri.v3.z = soa->v3.z[i];
+    tri.attribute_byte_count = soa->attribute_byte_count[i];
+    return tri;
+}
+
+/* Reads \p filepath with gmio_stl_mesh_creator_soa() and checks the triangles
+ * are the ones read with gmio_stl_data_mesh_creator() */
+static const char* __tstl__test_stl_read_soa(
+        const char* filepath, unsigned thread_count)
+{
+    struct gmio_stl_data data = {0};
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+    struct gmio_stl_triangle_soa soa = {0};
+    struct gmio_stl_mesh_creator creator_soa = gmio_stl_mesh_creator_soa(&soa);
+    struct gmio_stl_read_options opts = {0};
+    float* soa_block = NULL;
+    uint32_t i;
+    int error;
+
+    error = gmio_stl_read_file(filepath, &creator, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    soa_block = __tstl__triangle_soa_alloc(&soa, data.tri_array.count);
+    UTEST_ASSERT(soa_block != NULL);
+    opts.thread_count = thread_count;
+    error = gmio_stl_read_file(filepath, &creator_soa, &opts);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    UTEST_COMPARE_UINT(data.tri_array.count, soa.count);
+    for (i = 0; i < soa.count; ++i) {
+        const struct gmio_stl_triangle tri = __tstl__triangle_soa_at(&soa, i);
+        UTEST_ASSERT(gmio_stl_triangle_equal(&data.tri_array.ptr[i], &tri, 0));
+    }
+    free(soa_block);
+    gmio_stl_triangle_array_free(&data.tri_array);
+    return NULL;
+}
+
+static const char* test_stl_read_soa()
+{
+    const char* model_fpath_be = "temp/solid_soa.be_stlb";
+    const char* res = NULL;
+
+    res = __tstl__write_be_model(model_fpath_be);
+    if (res == NULL)
+        res = __tstl__test_stl_read_soa(filepath_stlb_grabcad_arm11, 0);
+    if (res == NULL)
+        res = __tstl__test_stl_read_soa(filepath_stlb_grabcad_arm11, 4);
+    if (res == NULL)
+        res = __tstl__test_stl_read_soa(model_fpath_be, 0);
+    if (res == NULL)
+        res = __tstl__test_stl_read_soa("models/solid_jburkardt_sphere.stla", 0);
+    if (res != NULL)
+        return res;
+
+    /* Triangles beyond capacity are ignored, normals are optional */
+    {
+        struct gmio_stl_triangle_soa soa = {0};
+        struct gmio_stl_mesh_creator creator = gmio_stl_mesh_creator_soa(&soa);
+        float* soa_block = __tstl__triangle_soa_alloc(&soa, 7);
+        int error;
+        soa.n.x = soa.n.y = soa.n.z = NULL;
+        error = gmio_stl_read_file(filepath_stlb_grabcad_arm11, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(7, soa.count);
+        free(soa_block);
+    }
+
+    return NULL;
+}
+
+/* Writes a mesh with gmio_stl_mesh_soa() and checks it reads back the same */
+static const char* test_stl_write_soa()
+{
+    const char* model_filepath_out = "temp/solid_soa.stl";
+    struct gmio_stl_data data = {0};
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+    struct gmio_stl_data data_out = {0};
+    struct gmio_stl_mesh_creator creator_out =
+            gmio_stl_data_mesh_creator(&data_out);
+    struct gmio_stl_triangle_soa soa = {0};
+    struct gmio_stl_mesh_creator creator_soa = gmio_stl_mesh_creator_soa(&soa);
+    struct gmio_stl_mesh mesh_soa;
+    float* soa_block = NULL;
+    uint32_t i;
+    int error;
+
+    error = gmio_stl_read_file(filepath_stlb_grabcad_arm11, &creator, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    soa_block = __tstl__triangle_soa_alloc(&soa, data.tri_array.count);
+    UTEST_ASSERT(soa_block != NULL);
+    error = gmio_stl_read_file(filepath_stlb_grabcad_arm11, &creator_soa, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+
+    mesh_soa = gmio_stl_mesh_soa(&soa);
+    UTEST_COMPARE_UINT(data.tri_array.count, mesh_soa.triangle_count);
+    error = gmio_stl_write_file(
+                GMIO_STL_FORMAT_BINARY_LE, model_filepath_out, &mesh_soa, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    error = gmio_stl_read_file(model_filepath_out, &creator_out, NULL);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    UTEST_COMPARE_UINT(data.tri_array.count, data_out.tri_array.count);
+    for (i = 0; i < data.tri_array.count; ++i) {
+        const struct gmio_stl_triangle* lhs = &data.tri_array.ptr[i];
+        const struct gmio_stl_triangle* rhs = &data_out.tri_array.ptr[i];
+        UTEST_ASSERT(gmio_stl_triangle_equal(lhs, rhs, 0));
+    }
+
+    /* Missing normals are computed */
+    soa.n.x = soa.n.y = soa.n.z = NULL;
+    soa.attribute_byte_count = NULL;
+    mesh_soa = gmio_stl_mesh_soa(&soa);
+    for (i = 0; i < 9; ++i) {
+        struct gmio_stl_triangle tri;
+        struct gmio_stl_triangle tri_expected = data.tri_array.ptr[i];
+        mesh_soa.func_get_triangle(mesh_soa.cookie, i, &tri);
+        gmio_stl_triangle_compute_normal(&tri_expected);
+        tri_expected.attribute_byte_count = 0;
+        UTEST_ASSERT(gmio_stl_triangle_equal(&tri_expected, &tri, 0));
+    }
+
+    free(soa_block);
+    gmio_stl_triangle_array_free(&data.tri_array);
+    gmio_stl_triangle_array_free(&data_out.tri_array);
+    return NULL;
+}
+
+/* Progress callback keeping the last reported values */
+static void __tstl__range_task_handle_progress(
+        void* cookie, intmax_t value, intmax_t max_value)
+{
+    intmax_t* progress = (intmax_t*)cookie;
+    progress[0] = value;
+    progress[1] = max_value;
+}
+
+/* Reads facets [first, first + count) of \p filepath and checks they are the
+ * ones of \p data */
+static const char* __tstl__test_stlb_read_range(
+        const struct gmio_stl_data* data,
+        const char* filepath,
+        uint32_t first,
+        uint32_t count,
+        const struct gmio_stl_read_options* base_opts)
+{
+    const uint32_t expected_count =
+            count > 0 ?
+                GMIO_MIN(count, data->tri_array.count - first) :
+                data->tri_array.count - first;
+    struct gmio_stl_data data_range = {0};
+    struct gmio_stl_mesh_creator creator =
+            gmio_stl_data_mesh_creator(&data_range);
+    struct gmio_stl_read_options opts = *base_opts;
+    intmax_t progress[2] = {0};
+    uint32_t i;
+    int error;
+
+    opts.stlb_facet_first = first;
+    opts.stlb_facet_count = count;
+    opts.task_iface.cookie = progress;
+    opts.task_iface.func_handle_progress = __tstl__range_task_handle_progress;
+    error = gmio_stl_read_file(filepath, &creator, &opts);
+    UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    UTEST_COMPARE_UINT(expected_count, data_range.tri_array.count);
+    UTEST_ASSERT(progress[0] == expected_count);
+    UTEST_ASSERT(progress[1] == expected_count);
+    for (i = 0; i < expected_count; ++i) {
+        const struct gmio_stl_triangle* lhs = &data->tri_array.ptr[first + i];
+        const struct gmio_stl_triangle* rhs = &data_range.tri_array.ptr[i];
+        UTEST_ASSERT(gmio_stl_triangle_equal(lhs, rhs, 0));
+    }
+    gmio_stl_triangle_array_free(&data_range.tri_array);
+    return NULL;
+}
+
+static const char* test_stlb_read_range()
+{
+    const char* model_fpath_be = "temp/solid_range.be_stlb";
+    struct gmio_stl_data data = {0};
+    struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+    const char* res = __tstl__write_be_model(model_fpath_be);
+    unsigned iopts;
+    if (res == NULL) {
+        const int error =
+                gmio_stl_read_file(filepath_stlb_grabcad_arm11, &creator, NULL);
+        if (error != GMIO_ERROR_OK)
+            res = "gmio_stl_read_file() failed";
+    }
+
+    /* FILE*, memory-mapped and read-ahead(that is not seekable) streams */
+    for (iopts = 0; iopts < 3 && res == NULL; ++iopts) {
+        struct gmio_stl_read_options opts = {0};
+        const uint32_t total = data.tri_array.count;
+        opts.use_file_mmap = iopts == 1;
+        opts.use_file_readahead = iopts == 2;
+        res = __tstl__test_stlb_read_range(
+                    &data, filepath_stlb_grabcad_arm11, 100, 250, &opts);
+        if (res == NULL) {
+            res = __tstl__test_stlb_read_range(
+                        &data, filepath_stlb_grabcad_arm11, 1000, 0, &opts);
+        }
+        if (res == NULL) { /* Range truncated to the last facet */
+            res = __tstl__test_stlb_read_range(
+                        &data, filepath_stlb_grabcad_arm11, total - 20, 100, &opts);
+        }
+        if (res == NULL) {
+            res = __tstl__test_stlb_read_range(
+                        &data, filepath_stlb_grabcad_arm11, total, 0, &opts);
+        }
+        if (res == NULL) {
+            res = __tstl__test_stlb_read_range(
+                        &data, model_fpath_be, 7, 13, &opts);
+        }
+        if (res == NULL) {
+            struct gmio_stl_data data_range = {0};
+            struct gmio_stl_mesh_creator creator_range =
+                    gmio_stl_data_mesh_creator(&data_range);
+            opts.stlb_facet_first = total + 1;
+            if (gmio_stl_read_file(
+                        filepath_stlb_grabcad_arm11, &creator_range, &opts)
+                    != GMIO_STL_ERROR_FACET_COUNT)
+            {
+                res = "first facet out of range not reported";
+            }
+            gmio_stl_triangle_array_free(&data_range.tri_array);
+        }
+    }
+
+    gmio_stl_triangle_array_free(&data.tri_array);
+    return res;
+}
+
+static const char* test_stlb_view()
+{
+    const char* model_fpath_be = "temp/solid_view.be_stlb";
+    const char* res = NULL;
+
+    res = __tstl__write_be_model(model_fpath_be);
+    if (res == NULL) {
+        res = __tstl__test_stlb_view(
+                    filepath_stlb_grabcad_arm11, GMIO_ENDIANNESS_LITTLE);
+    }
+    if (res == NULL)
+        res = __tstl__test_stlb_view(model_fpath_be, GMIO_ENDIANNESS_BIG);
+    return res;
+}
+
+/* Checks gmio_stl_read_file() and gmio_stl_infos_probe_file() give same
+ * results with gmio_stl_read_options::use_file_mmap */
+static const char* test_stl_read_file_mmap()
+{
+    static const char* filepaths[] = {
+        filepath_stlb_grabcad_arm11,
+        filepath_stla_4meshs,
+        "models/solid_jburkardt_sphere.stla"
+    };
+    size_t i;
+    for (i = 0; i < GMIO_ARRAY_SIZE(filepaths); ++i) {
+        const char* filepath = filepaths[i];
+        struct gmio_stl_data data = {0};
+        struct gmio_stl_data data_mmap = {0};
+        struct gmio_stl_mesh_creator creator =
+                gmio_stl_data_mesh_creator(&data);
+        struct gmio_stl_mesh_creator creator_mmap =
+                gmio_stl_data_mesh_creator(&data_mmap);
+        struct gmio_stl_read_options opts = {0};
+        struct gmio_stl_infos infos = {0};
+        struct gmio_stl_infos infos_mmap = {0};
+        struct gmio_stl_infos_probe_options probe_opts = {0};
+        const unsigned flags =
+                GMIO_STL_INFO_FLAG_FACET_COUNT | GMIO_STL_INFO_FLAG_SIZE;
+        size_t j;
+        int error;
+
+        error = gmio_stl_read_file(filepath, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        opts.use_file_mmap = true;
+        error = gmio_stl_read_file(filepath, &creator_mmap, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(data.tri_array.count, data_mmap.tri_array.count);
+        for (j = 0; j < data.tri_array.count; ++j) {
+            const struct gmio_stl_triangle* lhs = &data.tri_array.ptr[j];
+            const struct gmio_stl_triangle* rhs = &data_mmap.tri_array.ptr[j];
+            UTEST_ASSERT(gmio_stl_triangle_equal(lhs, rhs, 0));
+        }
+        gmio_stl_triangle_array_free(&data.tri_array);
+        gmio_stl_triangle_array_free(&data_mmap.tri_array);
+
+        error = gmio_stl_infos_probe_file(&infos, filepath, flags, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        probe_opts.use_file_mmap = true;
+        error = gmio_stl_infos_probe_file(
+                    &infos_mmap, filepath, flags, &probe_opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(infos.format, infos_mmap.format);
+        UTEST_COMPARE_UINT(infos.facet_count, infos_mmap.facet_count);
+        UTEST_COMPARE_UINT(infos.size, infos_mmap.size);
+    }
+
+    /* Non-existing file */
+    {
+        struct gmio_stl_read_options opts = {0};
+        opts.use_file_mmap = true;
+        UTEST_COMPARE_INT(
+                    GMIO_ERROR_STDIO,
+                    gmio_stl_read_file("does_not_exist.stl", NULL, &opts));
+    }
+
+    return NULL;
+}
+
+/* Checks gmio_stl_read_file() and gmio_stl_infos_probe_file() give same
+ * results with gmio_stl_read_options::use_file_readahead */
+static const char* test_stl_read_file_readahead()
+{
+    static const char* filepaths[] = {
+        filepath_stlb_grabcad_arm11,
+        filepath_stla_4meshs,
+        "models/solid_jburkardt_sphere.stla"
+    };
+    size_t i;
+    for (i = 0; i < GMIO_ARRAY_SIZE(filepaths); ++i) {
+        const char* filepath = filepaths[i];
+        struct gmio_stl_data data = {0};
+        struct gmio_stl_data data_ra = {0};
+        struct gmio_stl_mesh_creator creator =
+                gmio_stl_data_mesh_creator(&data);
+        struct gmio_stl_mesh_creator creator_ra =
+                gmio_stl_data_mesh_creator(&data_ra);
+        struct gmio_stl_read_options opts = {0};
+        struct gmio_stl_infos infos = {0};
+        struct gmio_stl_infos infos_ra = {0};
+        struct gmio_stl_infos_probe_options probe_opts = {0};
+        const unsigned flags =
+                GMIO_STL_INFO_FLAG_FACET_COUNT | GMIO_STL_INFO_FLAG_SIZE;
+        size_t j;
+        int error;
+
+        error = gmio_stl_read_file(filepath, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        opts.use_file_readahead = true;
+        error = gmio_stl_read_file(filepath, &creator_ra, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(data.tri_array.count, data_ra.tri_array.count);
+        for (j = 0; j < data.tri_array.count; ++j) {
+            const struct gmio_stl_triangle* lhs = &data.tri_array.ptr[j];
+            const struct gmio_stl_triangle* rhs = &data_ra.tri_array.ptr[j];
+            UTEST_ASSERT(gmio_stl_triangle_equal(lhs, rhs, 0));
+        }
+        gmio_stl_triangle_array_free(&data.tri_array);
+        gmio_stl_triangle_array_free(&data_ra.tri_array);
+
+        error = gmio_stl_infos_probe_file(&infos, filepath, flags, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        probe_opts.use_file_readahead = true;
+        error = gmio_stl_infos_probe_file(
+                    &infos_ra, filepath, flags, &probe_opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_COMPARE_UINT(infos.format, infos_ra.format);
+        UTEST_COMPARE_UINT(infos.facet_count, infos_ra.facet_count);
+        UTEST_COMPARE_UINT(infos.size, infos_ra.size);
+    }
+
+    /* Non-existing file */
+    {
+        struct gmio_stl_read_options opts = {0};
+        opts.use_file_readahead = true;
+        UTEST_COMPARE_INT(
+                    GMIO_ERROR_STDIO,
+                    gmio_stl_read_file("does_not_exist.stl", NULL, &opts));
+    }
+
+    return NULL;
+}
+
 static const char* test_stlb_header_write()
 {
     const char* filepath = "temp/solid.stlb";
@@ -266,6 +1262,176 @@ static const char* test_stlb_write()
     return NULL;
 }
 
+/* Returns true if files at \p filepath1 and \p filepath2 have the same
+ * contents */
+static bool __tstl__file_contents_equal(
+        const char* filepath1, const char* filepath2)
+{
+    FILE* f1 = fopen(filepath1, "rb");
+    FILE* f2 = fopen(filepath2, "rb");
+    bool equal = f1 != NULL && f2 != NULL;
+    while (equal && !feof(f1) && !feof(f2)) {
+        uint8_t buff1[1024];
+        uint8_t buff2[1024];
+        const size_t len1 = fread(buff1, 1, sizeof(buff1), f1);
+        const size_t len2 = fread(buff2, 1, sizeof(buff2), f2);
+        equal = len1 == len2 && memcmp(buff1, buff2, len1) == 0;
+    }
+    __tstl__fclose_2(f1, f2);
+    return equal;
+}
+
+static const char* test_stl_write_batch()
+{
+    static const enum gmio_stl_format formats[] = {
+        GMIO_STL_FORMAT_ASCII,
+        GMIO_STL_FORMAT_BINARY_LE,
+        GMIO_STL_FORMAT_BINARY_BE
+    };
+    const char* model_fpath_out = "temp/solid_write.stl";
+    const char* model_fpath_out_batch = "temp/solid_write_batch.stl";
+    struct gmio_stl_data data = {0};
+
+    /* Read input model file */
+    {
+        struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+        const int error = gmio_stl_read_file(
+                    filepath_stlb_grabcad_arm11, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    }
+
+    /* Check gmio_stl_mesh::func_get_triangles() gives the same output as
+     * gmio_stl_mesh::func_get_triangle() */
+    for (size_t i = 0; i < GMIO_ARRAY_SIZE(formats); ++i) {
+        static uint8_t buff[1025];
+        const struct gmio_stl_mesh mesh = gmio_stl_data_mesh(&data);
+        const struct gmio_stl_mesh mesh_batch = gmio_stl_data_mesh_batch(&data);
+        struct gmio_stl_write_options opts = {0};
+        int error = GMIO_ERROR_OK;
+        opts.stlb_header = data.header;
+        /* Memblock not aligned for gmio_stl_triangle */
+        if (formats[i] != GMIO_STL_FORMAT_ASCII)
+            opts.stream_memblock = gmio_memblock(buff + 1, 1024, NULL);
+        error = gmio_stl_write_file(
+                    formats[i], model_fpath_out, &mesh, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        error = gmio_stl_write_file(
+                    formats[i], model_fpath_out_batch, &mesh_batch, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_ASSERT(__tstl__file_contents_equal(
+                         model_fpath_out, model_fpath_out_batch));
+    }
+
+    gmio_stl_triangle_array_free(&data.tri_array);
+    return NULL;
+}
+
+/* Writes STL with gmio_stl_write_options::thread_count and checks output is
+ * the same as the single-threaded write */
+static const char* test_stl_write_multithread()
+{
+    static const enum gmio_stl_format formats[] = {
+        GMIO_STL_FORMAT_ASCII,
+        GMIO_STL_FORMAT_BINARY_LE,
+        GMIO_STL_FORMAT_BINARY_BE
+    };
+    const char* model_fpath_out = "temp/solid_write.stl";
+    const char* model_fpath_out_mt = "temp/solid_write_mt.stl";
+    struct gmio_stl_data data = {0};
+
+    /* Read input model file */
+    {
+        struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+        const int error = gmio_stl_read_file(
+                    filepath_stlb_grabcad_arm11, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    }
+
+    for (size_t i = 0; i < GMIO_ARRAY_SIZE(formats); ++i) {
+        static uint8_t buff[2048];
+        const struct gmio_stl_mesh mesh = gmio_stl_data_mesh(&data);
+        const struct gmio_stl_mesh mesh_batch = gmio_stl_data_mesh_batch(&data);
+        struct gmio_stl_write_options opts = {0};
+        struct __tstl__mt_task task = {0};
+        int error = GMIO_ERROR_OK;
+        opts.stlb_header = data.header;
+        opts.stla_solid_name = "solid_mt";
+        opts.stla_float32_format = GMIO_FLOAT_TEXT_FORMAT_SCIENTIFIC_LOWERCASE;
+        opts.stla_float32_prec = 7;
+        error = gmio_stl_write_file(formats[i], model_fpath_out, &mesh, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+
+        /* Small memblock so facets are written in many chunks */
+        opts.stream_memblock = gmio_memblock(buff, sizeof(buff), NULL);
+        opts.thread_count = 4;
+        opts.task_iface.cookie = &task;
+        opts.task_iface.func_handle_progress = __tstl__mt_task_handle_progress;
+        error = gmio_stl_write_file(
+                    formats[i], model_fpath_out_mt, &mesh, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_ASSERT(__tstl__file_contents_equal(
+                         model_fpath_out, model_fpath_out_mt));
+        UTEST_ASSERT(task.progress_count > 1);
+        error = gmio_stl_write_file(
+                    formats[i], model_fpath_out_mt, &mesh_batch, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_ASSERT(__tstl__file_contents_equal(
+                         model_fpath_out, model_fpath_out_mt));
+
+        /* Stop request */
+        task.progress_count = 0;
+        task.stop_at_progress_count = 3;
+        opts.task_iface.func_is_stop_requested =
+                __tstl__mt_task_is_stop_requested;
+        error = gmio_stl_write_file(
+                    formats[i], model_fpath_out_mt, &mesh, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_TASK_STOPPED, error);
+    }
+
+    gmio_stl_triangle_array_free(&data.tri_array);
+    return NULL;
+}
+
+/* Checks gmio_stl_write_file() gives the same output with
+ * gmio_stl_write_options::use_file_writebehind */
+static const char* test_stl_write_file_writebehind()
+{
+    static const enum gmio_stl_format formats[] = {
+        GMIO_STL_FORMAT_ASCII,
+        GMIO_STL_FORMAT_BINARY_LE,
+        GMIO_STL_FORMAT_BINARY_BE
+    };
+    const char* model_fpath_out = "temp/solid_write.stl";
+    const char* model_fpath_out_wb = "temp/solid_write_wb.stl";
+    struct gmio_stl_data data = {0};
+
+    /* Read input model file */
+    {
+        struct gmio_stl_mesh_creator creator = gmio_stl_data_mesh_creator(&data);
+        const int error = gmio_stl_read_file(
+                    filepath_stlb_grabcad_arm11, &creator, NULL);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+    }
+
+    for (size_t i = 0; i < GMIO_ARRAY_SIZE(formats); ++i) {
+        const struct gmio_stl_mesh mesh = gmio_stl_data_mesh(&data);
+        struct gmio_stl_write_options opts = {0};
+        int error = GMIO_ERROR_OK;
+        opts.stlb_header = data.header;
+        error = gmio_stl_write_file(formats[i], model_fpath_out, &mesh, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        opts.use_file_writebehind = true;
+        error = gmio_stl_write_file(
+                    formats[i], model_fpath_out_wb, &mesh, &opts);
+        UTEST_COMPARE_INT(GMIO_ERROR_OK, error);
+        UTEST_ASSERT(__tstl__file_contents_equal(
+                         model_fpath_out, model_fpath_out_wb));
+    }
+
+    gmio_stl_triangle_array_free(&data.tri_array);
+    return NULL;
+}
+
 static const char* test_stla_write()
 {
     const char* model_filepath = filepath_stlb_grabcad_arm11;